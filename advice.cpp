@@ -0,0 +1,317 @@
+/******************************************************************************/
+/*!
+ * @file:					  advice.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the advice engine.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <chrono>
+#include <string.h>
+
+/* Local includes */
+#include "advice.hpp"
+#include "rules.hpp"
+
+/* Private defines */
+#define ACE_VALUE				1
+#define TEN_VALUE				10
+#define DEALER_STAND			17
+#define FINAL_BUST			(ADVICE_DEALER_FINALS - 1)
+#define SURRENDER_EV			-0.5
+
+template <typename TRules>
+TAdviceEngine<TRules>::TAdviceEngine
+	(
+	void
+	) :
+	mStatesValid(false),
+	mCached(false),
+	mShuffles(0),
+	mDealt(0),
+	mCache(NULL),
+	mAdvices(0)
+	{
+	memset((void *)&mHole, 0, sizeof(mHole));
+	memset((void *)mCounts, 0, sizeof(mCounts));
+	memset((void *)mFinalsValid, 0, sizeof(mFinalsValid));
+	}
+
+/*
+ * Card probabilities of the dealer's shoe state. Kept, with the dealer
+ * outcomes worked out from them, while no card is dealt and the shoe is not
+ * shuffled.
+ */
+template <typename TRules>
+	void
+TAdviceEngine<TRules>::updateShoe
+	(
+	const TDealer 	&dealer,		// Dealer dealing the hand
+	const TCard 	&hole			// Dealer hole card, dealt but not seen
+	)
+	{
+	if (mCached && (mShuffles == dealer.getShuffles()) && (mDealt == dealer.getDealt()) &&
+			(mHole.value == hole.value))
+		return;
+	mCached = true;
+	mShuffles = dealer.getShuffles();
+	mDealt = dealer.getDealt();
+	mHole = hole;
+
+	// Cards the player has not seen: the shoe and the hole card
+	const unsigned int *left = dealer.getCardsLeft();
+	double total = 0.0;
+	mCounts[0] = 0;
+	for (unsigned int v = ACE_VALUE; v <= TEN_VALUE; v++)
+		{
+		mCounts[v] = left[v] + ((v == hole.value) ? 1 : 0);
+		total += (double)mCounts[v];
+		}
+	mP[0] = 0.0;
+	for (unsigned int v = ACE_VALUE; v <= TEN_VALUE; v++)
+		mP[v] = total ? (double)mCounts[v] / total : ((v == TEN_VALUE) ? 4.0 : 1.0) / 13.0;
+	mStatesValid = false;
+	memset((void *)mFinalsValid, 0, sizeof(mFinalsValid));
+	}
+
+/*
+ * Dealer finals from every [hard total][Ace held] state, highest totals first.
+ * Only worked out when an up card misses the dealer outcome cache.
+ */
+template <typename TRules>
+	void
+TAdviceEngine<TRules>::dealerStates
+	(
+	void
+	)
+	{
+	memset((void *)mDealerStates, 0, sizeof(mDealerStates));
+	for (int hard = ADVICE_MAX_HARD; hard >= 2; hard--)
+		for (int ace = 0; ace <= 1; ace++)
+			{
+			bool soft = ace && (hard + TEN_VALUE <= (int)TRules::BLACKJACK_VAL);
+			int score = soft ? hard + TEN_VALUE : hard;
+			if (score > (int)TRules::BLACKJACK_VAL)
+				{
+				mDealerStates[hard][ace][FINAL_BUST] = 1.0;
+				continue;
+				}
+			if ((score >= DEALER_STAND) && !(TRules::HIT_SOFT_17 && soft &&
+					(score == DEALER_STAND)))
+				{
+				mDealerStates[hard][ace][score - DEALER_STAND] = 1.0;
+				continue;
+				}
+			for (int v = ACE_VALUE; v <= TEN_VALUE; v++)
+				for (int f = 0; f < ADVICE_DEALER_FINALS; f++)
+					mDealerStates[hard][ace][f] += mP[v] *
+							mDealerStates[hard + v][ace || (v == ACE_VALUE)][f];
+			}
+	mStatesValid = true;
+	}
+
+/*
+ * Dealer final score distribution for an up card, given the dealer has no
+ * two card 21 (those hands end before the player acts)
+ * @return: ADVICE_DEALER_FINALS probabilities, 17 to 21 then bust
+ */
+template <typename TRules>
+	const double *
+TAdviceEngine<TRules>::getDealerFinals
+	(
+	unsigned int upCard		// Dealer up card value
+	)
+	{
+	double *finals = mFinals[upCard];
+	if (mFinalsValid[upCard])
+		return finals;
+	TDealerCacheKey key;
+	bool cacheable = mCache && !TDealerCache::makeKey(mCounts, upCard, TRules::FLAGS, key);
+	if (cacheable && mCache->lookup(key, finals))
+		{
+		mFinalsValid[upCard] = true;
+		return finals;
+		}
+	if (!mStatesValid)
+		dealerStates();
+
+	// Hole card that would make a two card 21
+	unsigned int natural = (upCard == ACE_VALUE) ? TEN_VALUE : (upCard == TEN_VALUE) ?
+			ACE_VALUE : 0;
+	double norm = 1.0 - (natural ? mP[natural] : 0.0);
+	memset((void *)finals, 0, ADVICE_DEALER_FINALS * sizeof(double));
+	for (unsigned int hole = ACE_VALUE; hole <= TEN_VALUE; hole++)
+		{
+		if ((hole == natural) || (norm <= 0.0))
+			continue;
+		int ace = (upCard == ACE_VALUE) || (hole == ACE_VALUE);
+		for (int f = 0; f < ADVICE_DEALER_FINALS; f++)
+			finals[f] += mP[hole] / norm * mDealerStates[upCard + hole][ace][f];
+		}
+	if (cacheable)
+		mCache->insert(key, finals);
+	mFinalsValid[upCard] = true;
+	return finals;
+	}
+
+/*
+ * Expected value of standing on 'score': win on a dealer bust or lower final
+ * score
+ * @return: Expected value, in bets
+ */
+template <typename TRules>
+	double
+TAdviceEngine<TRules>::stand
+	(
+	unsigned int score,			// Player score, not busted
+	const double *finals			// Dealer finals
+	) const
+	{
+	double ev = finals[FINAL_BUST];
+	for (int f = 0; f < FINAL_BUST; f++)
+		{
+		unsigned int dealerScore = DEALER_STAND + f;
+		if (dealerScore < score)
+			ev += finals[f];
+		else if ((dealerScore > score) || !TRules::PUSH_ON_TIE)
+			ev -= finals[f];
+		}
+	return ev;
+	}
+
+/*
+ * Best hit or stand expected value from every [hard total][Ace held] state
+ */
+template <typename TRules>
+	void
+TAdviceEngine<TRules>::playerPass
+	(
+	const double *finals			// Dealer finals
+	)
+	{
+	const int maxScore = (int)TStrategy::MAX_SCORE;
+	for (int score = 0; score <= maxScore; score++)
+		mStand[score] = stand(score, finals);
+	for (int hard = maxScore; hard >= 2; hard--)
+		for (int ace = 0; ace <= 1; ace++)
+			{
+			bool soft = ace && (hard + TEN_VALUE <= maxScore);
+			double hit = 0.0;
+			for (int v = ACE_VALUE; v <= TEN_VALUE; v++)
+				hit += mP[v] * ((hard + v > maxScore) ? -1.0 :
+						mBest[hard + v][ace || (v == ACE_VALUE)]);
+			double standEv = mStand[soft ? hard + TEN_VALUE : hard];
+			mBest[hard][ace] = (hit > standEv) ? hit : standEv;
+			}
+	}
+
+/*
+ * Expected value of hit, stand and every allowed ALLOW_* action for a hand
+ */
+template <typename TRules>
+	void
+TAdviceEngine<TRules>::advise
+	(
+	const TDealer 	&dealer,			// Dealer dealing the hand
+	const TCard 	&hole,			// Dealer hole card, not seen by the player
+	unsigned int 	score,			// Player score, not busted
+	bool 				soft,				// An Ace counts 11
+	unsigned int 	upCard,			// Dealer up card value
+	unsigned int 	pairValue,		// Card value of a splittable pair, 0 if none
+	unsigned int 	allowed,			// ALLOW_* actions on top of hit and stand
+	TAdvice 			&advice			// Out argument
+	)
+	{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	const int maxScore = (int)TStrategy::MAX_SCORE;
+	updateShoe(dealer, hole);
+	playerPass(getDealerFinals(upCard));
+
+	memset((void *)&advice, 0, sizeof(advice));
+	int hard = soft ? (int)score - TEN_VALUE : (int)score;
+	int ace = soft ? 1 : 0;
+	double hit = 0.0;
+	double doubled = 0.0;
+	for (int v = ACE_VALUE; v <= TEN_VALUE; v++)
+		{
+		int next = hard + v;
+		int nextAce = ace || (v == ACE_VALUE);
+		bool nextSoft = nextAce && (next + TEN_VALUE <= maxScore);
+		hit += mP[v] * ((next > maxScore) ? -1.0 : mBest[next][nextAce]);
+		doubled += 2.0 * mP[v] * ((next > maxScore) ? -1.0 :
+				mStand[nextSoft ? next + TEN_VALUE : next]);
+		}
+	advice.ev[ACTION_STAND] = mStand[score];
+	advice.valid[ACTION_STAND] = true;
+	advice.ev[ACTION_HIT] = hit;
+	advice.valid[ACTION_HIT] = true;
+	if (allowed & ALLOW_DOUBLE)
+		{
+		advice.ev[ACTION_DOUBLE] = doubled;
+		advice.valid[ACTION_DOUBLE] = true;
+		}
+	if (allowed & ALLOW_SURRENDER)
+		{
+		advice.ev[ACTION_SURRENDER] = SURRENDER_EV;
+		advice.valid[ACTION_SURRENDER] = true;
+		}
+	if ((allowed & ALLOW_SPLIT) && pairValue)
+		{
+		// One of the two hands: the pair card and a new one, played on
+		double one = 0.0;
+		for (int v = ACE_VALUE; v <= TEN_VALUE; v++)
+			{
+			int first = (int)pairValue + v;
+			int firstAce = (pairValue == ACE_VALUE) || (v == ACE_VALUE);
+			bool firstSoft = firstAce && (first + TEN_VALUE <= maxScore);
+			double standEv = mStand[firstSoft ? first + TEN_VALUE : first];
+			// Split Aces take one card each
+			if (pairValue == ACE_VALUE)
+				{
+				one += mP[v] * standEv;
+				continue;
+				}
+			double best = mBest[first][firstAce];
+			if (TRules::DOUBLE_AFTER_SPLIT)
+				{
+				double splitDouble = 0.0;
+				for (int w = ACE_VALUE; w <= TEN_VALUE; w++)
+					{
+					int next = first + w;
+					int nextAce = firstAce || (w == ACE_VALUE);
+					bool nextSoft = nextAce && (next + TEN_VALUE <= maxScore);
+					splitDouble += 2.0 * mP[w] * ((next > maxScore) ? -1.0 :
+							mStand[nextSoft ? next + TEN_VALUE : next]);
+					}
+				if (splitDouble > best)
+					best = splitDouble;
+				}
+			one += mP[v] * best;
+			}
+		advice.ev[ACTION_SPLIT] = 2.0 * one;
+		advice.valid[ACTION_SPLIT] = true;
+		}
+
+	advice.best = ACTION_STAND;
+	for (int a = 0; a < ACTION_TYPES_NR; a++)
+		if (advice.valid[a] && (advice.ev[a] > advice.ev[advice.best]))
+			advice.best = (TPlayerAction)a;
+
+	std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	mLatency.add(elapsed.count());
+	mAdvices++;
+	}
+
+/* Rule set specializations built into the library (see dispatchRules()) */
+template class TAdviceEngine< TRuleSet<0> >;
+template class TAdviceEngine< TRuleSet<1> >;
+template class TAdviceEngine< TRuleSet<2> >;
+template class TAdviceEngine< TRuleSet<3> >;
+template class TAdviceEngine< TRuleSet<4> >;
+template class TAdviceEngine< TRuleSet<5> >;
+template class TAdviceEngine< TRuleSet<6> >;
+template class TAdviceEngine< TRuleSet<7> >;
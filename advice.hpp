@@ -0,0 +1,106 @@
+/******************************************************************************/
+/*!
+ * @file:					  advice.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the advice engine. Expected
+ *  					value of every player action from the cards actually left
+ *  					in the shoe, fast enough for every console prompt.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __ADVICE_HPP__
+#define __ADVICE_HPP__
+
+/* Local includes */
+#include "dealer.hpp"
+#include "dealercache.hpp"
+#include "strategy.hpp"
+#include "tdigest.hpp"
+
+/* Defines */
+
+// Dealer final scores: 17 to 21 and bust
+#define ADVICE_DEALER_FINALS	DEALER_CACHE_FINALS
+// Highest hard total a dealer hand can reach before busting
+#define ADVICE_MAX_HARD			26
+
+/* Enumerations, type defines */
+
+/* Advice of one decision */
+typedef struct __Advice__
+	{
+	double ev[ACTION_TYPES_NR];		// Expected value per action, in bets
+	bool valid[ACTION_TYPES_NR];		// The action is allowed and evaluated
+	TPlayerAction best;					// Highest expected value
+	}TAdvice;
+
+/*
+ * The advice engine class
+ * Card probabilities are the shoe composition the player can infer: cards left
+ * in the shoe plus the unseen hole card. Within a hand cards are drawn at those
+ * probabilities. Dealer outcomes are cached per shoe state, dealt card and
+ * shuffle, so repeated prompts on one shoe state cost a player pass only, and,
+ * once a dealer outcome cache is set, per composition and up card in that
+ * cache, so a composition any engine sharing it met costs a lookup.
+ * Splits are valued without resplits.
+ * */
+template <typename TRules>
+class TAdviceEngine
+	{
+	public:
+		TAdviceEngine(void);
+		~TAdviceEngine(void){};
+		/*
+		 * Expected value of hit, stand and every allowed ALLOW_* action for a hand
+		 * of 'score' ('soft' if an Ace counts 11) against 'upCard'
+		 */
+		void advise(const TDealer &dealer, const TCard &hole, unsigned int score, bool soft,
+				unsigned int upCard, unsigned int pairValue, unsigned int allowed,
+				TAdvice &advice);
+		/*
+		 * Advice latency quantile
+		 * @return: Microseconds below which a fraction 'q' of the advices took
+		 */
+		double getLatency(double q) {return mLatency.quantile(q);};
+		const TTDigest &getLatencies(void) const {return mLatency;};
+		unsigned long long getAdvices(void) const {return mAdvices;};
+		// Dealer outcome cache to look up and fill (ex: sharedDealerCache()). NULL, none
+		void setDealerCache(TDealerCache *cache) {mCache = cache;};
+		TDealerCache *getDealerCache(void) const {return mCache;};
+
+	private:
+		// Card probabilities of the dealer's shoe state
+		void updateShoe(const TDealer &dealer, const TCard &hole);
+		// Dealer finals from every state, for the current card probabilities
+		void dealerStates(void);
+		// Dealer final score distribution for an up card, no two card 21
+		const double *getDealerFinals(unsigned int upCard);
+		// Expected value of standing on 'score'
+		double stand(unsigned int score, const double *finals) const;
+		// Best hit or stand expected value from every [hard total][Ace held] state
+		void playerPass(const double *finals);
+
+	private:
+		double mP[TDealer::VALUES_NR + 1];		// Card value probabilities
+		unsigned int mCounts[TDealer::VALUES_NR + 1];	// Cards not seen per value
+		// Dealer finals from every [hard total][Ace held] state
+		double mDealerStates[ADVICE_MAX_HARD + 1][2][ADVICE_DEALER_FINALS];
+		bool mStatesValid;
+		double mFinals[TDealer::VALUES_NR + 1][ADVICE_DEALER_FINALS];
+		bool mFinalsValid[TDealer::VALUES_NR + 1];
+		double mBest[TStrategy::MAX_SCORE + 1][2];
+		double mStand[TStrategy::MAX_SCORE + 1];
+		// Shoe state of the cached dealer outcomes
+		bool mCached;
+		unsigned long long mShuffles;
+		unsigned int mDealt;
+		TCard mHole;
+		TDealerCache *mCache;
+		unsigned long long mAdvices;
+		TTDigest mLatency;
+	};
+
+#endif /* __ADVICE_HPP__ */
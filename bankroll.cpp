@@ -0,0 +1,338 @@
+/******************************************************************************/
+/*!
+ * @file:					  bankroll.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the wager model and the bankroll / risk of ruin
+ *  					simulator.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <math.h>
+#include <mutex>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+/* Local includes */
+#include "bankroll.hpp"
+#include "blackjack.hpp"
+#include "misc.hpp"
+#include "tdigest.hpp"
+
+/* Private defines */
+// Sessions a worker claims at a time
+#define SESSIONS_BATCH			64
+// Sessions a worker plays before publishing its digest and counters
+#define SESSIONS_FLUSH			1024
+// t-digest compression
+#define DIGEST_COMPRESSION		200.0
+
+/* Reported quantile levels */
+static const double quantileLevels[BANKROLL_QUANTILES_NR] =
+	{
+	0.01, 0.05, 0.25, 0.50, 0.75, 0.95, 0.99
+	};
+
+TWager::TWager
+	(
+	double baseBet			// Bet below the first spread step
+	) :
+	mBaseBet(baseBet),
+	mStepsNr(0)
+	{
+	memset((void *)mSteps, 0, sizeof(mSteps));
+	}
+
+/*
+ * Add a bet spread step. Steps must be added in increasing true count.
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (too many steps or not increasing)
+ */
+	int
+TWager::addStep
+	(
+	int trueCount,				// Floored true count the step starts at
+	double multiplier			// Base bet multiplier
+	)
+	{
+	if ((mStepsNr >= WAGER_MAX_STEPS) || (multiplier <= 0.0) ||
+			(mStepsNr && (mSteps[mStepsNr - 1].trueCount >= trueCount)))
+		return -1;
+
+	mSteps[mStepsNr].trueCount = trueCount;
+	mSteps[mStepsNr].multiplier = multiplier;
+	mStepsNr++;
+	return 0;
+	}
+
+/*
+ * Bet for the argued true count
+ * @return: Bet
+ */
+	double
+TWager::getBet
+	(
+	double trueCount
+	) const
+	{
+	int tc = (int)floor(trueCount);
+	double multiplier = 1.0;
+	for (unsigned int i = 0; (i < mStepsNr) && (tc >= mSteps[i].trueCount); i++)
+		multiplier = mSteps[i].multiplier;
+	return mBaseBet * multiplier;
+	}
+
+/*
+ * Bankroll simulation for one rule set. Instantiated by dispatchRules().
+ * Workers publish their digests and counters under mLock every
+ * SESSIONS_FLUSH sessions; the caller thread reports progress from them.
+ */
+class TBankrollRunner
+	{
+	public:
+		TBankrollRunner(const TBankrollConfig &config, TBankrollResult &result,
+				TBankrollProgressFn progress, void *ctx);
+		template <typename TRules> int run(void);
+
+	private:
+		template <typename TRules> void worker(const TStrategy &strategy);
+		// Fill a result from the published counters and digest
+		void fillResult(TTDigest &digest, TBankrollResult &result);
+
+	private:
+		const TBankrollConfig &mConfig;
+		TBankrollResult &mResult;
+		TBankrollProgressFn mProgress;
+		void *mCtx;
+		std::atomic<unsigned long long> mNextSession;
+		std::chrono::steady_clock::time_point mStart;
+		// Published by the workers, under mLock
+		std::mutex mLock;
+		std::condition_variable mDone;
+		unsigned int mRunning;
+		TTDigest mDigest;
+		unsigned long long mSessions;
+		unsigned long long mRuined;
+		unsigned long long mHands;
+		double mSumFinal;
+	};
+
+TBankrollRunner::TBankrollRunner
+	(
+	const TBankrollConfig &config,	// In
+	TBankrollResult &result,			// Out argument
+	TBankrollProgressFn progress,		// Progress callback or NULL
+	void *ctx								// Progress callback argument
+	) :
+	mConfig(config),
+	mResult(result),
+	mProgress(progress),
+	mCtx(ctx),
+	mNextSession(0),
+	mRunning(0),
+	mDigest(DIGEST_COMPRESSION),
+	mSessions(0),
+	mRuined(0),
+	mHands(0),
+	mSumFinal(0.0)
+	{
+
+	}
+
+/*
+ * Fill a result from the published counters and the argued digest
+ */
+	void
+TBankrollRunner::fillResult
+	(
+	TTDigest &digest,				// Final bankrolls
+	TBankrollResult &result		// Out argument
+	)
+	{
+	memset((void *)&result, 0, sizeof(result));
+	result.sessions = mSessions;
+	result.ruined = mRuined;
+	result.hands = mHands;
+	if (mSessions)
+		{
+		double n = (double)mSessions;
+		result.riskOfRuin = (double)mRuined / n;
+		result.riskOfRuinSE = sqrt(result.riskOfRuin * (1.0 - result.riskOfRuin) / n);
+		result.meanFinal = mSumFinal / n;
+		}
+	for (unsigned int i = 0; i < BANKROLL_QUANTILES_NR; i++)
+		{
+		result.quantileLevels[i] = quantileLevels[i];
+		result.quantiles[i] = digest.quantile(quantileLevels[i]);
+		}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mStart;
+	result.elapsedSecs = elapsed.count();
+	}
+
+/*
+ * Play sessions until none is left. Every session has its own seed, so
+ * results do not depend on which worker plays it.
+ */
+template <typename TRules>
+	void
+TBankrollRunner::worker
+	(
+	const TStrategy &strategy		// Player policy
+	)
+	{
+	TTDigest digest(DIGEST_COMPRESSION);
+	unsigned long long sessions = 0, ruined = 0, hands = 0, unflushed = 0;
+	double sumFinal = 0.0;
+	const double baseBet = mConfig.wager.getBaseBet();
+	TCards cardDeck;
+	cardDeck.reserve(mConfig.decks * TDealer::CARDS_PER_DECK);
+
+	for (;;)
+		{
+		unsigned long long first = mNextSession.fetch_add(SESSIONS_BATCH);
+		if (first >= mConfig.sessions)
+			break;
+		unsigned long long last = first + SESSIONS_BATCH;
+		if (last > mConfig.sessions)
+			last = mConfig.sessions;
+
+		for (unsigned long long s = first; s < last; s++)
+			{
+			TBlackjack<TRules> bljck(TDealer(mixSeed(mConfig.seed, s), mConfig.decks), &strategy);
+			double bank = mConfig.bankroll;
+			bool isRuined = false;
+			cardDeck.clear();
+			for (unsigned long long h = 0; h < mConfig.sessionHands; h++)
+				{
+				if (bank < baseBet)
+					{
+					isRuined = true;
+					break;
+					}
+				// Bet on the count the player has seen, none right after a shuffle
+				double trueCount = bljck.isShuffleDue() ? 0.0 : bljck.getDealer().getTrueCount();
+				double bet = mConfig.wager.getBet(trueCount);
+				if (bet > bank)
+					bet = bank;
+				if (bljck.playHand(cardDeck))
+					continue;
+				bank += bet * bljck.getLastHandNet();
+				hands++;
+				}
+			if (bank < baseBet)
+				isRuined = true;
+
+			digest.add(bank);
+			sumFinal += bank;
+			sessions++;
+			ruined += isRuined;
+			unflushed++;
+			}
+
+		if (unflushed >= SESSIONS_FLUSH)
+			{
+			std::lock_guard<std::mutex> lock(mLock);
+			mDigest.merge(digest);
+			mSessions += sessions;
+			mRuined += ruined;
+			mHands += hands;
+			mSumFinal += sumFinal;
+			digest.clear();
+			sessions = ruined = hands = unflushed = 0;
+			sumFinal = 0.0;
+			}
+		}
+
+	std::lock_guard<std::mutex> lock(mLock);
+	mDigest.merge(digest);
+	mSessions += sessions;
+	mRuined += ruined;
+	mHands += hands;
+	mSumFinal += sumFinal;
+	mRunning--;
+	mDone.notify_all();
+	}
+
+/*
+ * Run the workers and report progress until every session is played
+ * @return: - 0 - Success simulating
+ */
+template <typename TRules>
+	int
+TBankrollRunner::run
+	(
+	void
+	)
+	{
+	TStrategy strategy((TPolicyType)mConfig.policy);
+	unsigned int threadsNr = mConfig.threads ? mConfig.threads :
+			std::thread::hardware_concurrency();
+	if (!threadsNr)
+		threadsNr = 1;
+
+	mStart = std::chrono::steady_clock::now();
+	mRunning = threadsNr;
+	std::vector<std::thread> threads;
+	for (unsigned int t = 0; t < threadsNr; t++)
+		threads.push_back(std::thread(&TBankrollRunner::worker<TRules>, this,
+				std::cref(strategy)));
+
+	if (mProgress && (mConfig.reportSecs > 0.0))
+		{
+		std::chrono::duration<double> period(mConfig.reportSecs);
+		std::unique_lock<std::mutex> lock(mLock);
+		while (mRunning)
+			{
+			if (mDone.wait_for(lock, period) == std::cv_status::no_timeout)
+				continue;
+			// Quantiles from a copy so workers are not held while computing them
+			TTDigest snapshot(mDigest);
+			TBankrollResult progress;
+			fillResult(snapshot, progress);
+			lock.unlock();
+			mProgress(progress, mCtx);
+			lock.lock();
+			}
+		}
+
+	for (unsigned int t = 0; t < threadsNr; t++)
+		threads[t].join();
+
+	fillResult(mDigest, mResult);
+	return 0;
+	}
+
+/*
+ * Play config.sessions independent sessions of config.sessionHands hands each
+ * @return: - 0 - Success simulating. Otherwise,
+ * 			Error (invalid configuration)
+ */
+	int
+simulateBankroll
+	(
+	const TBankrollConfig &config,	// In
+	TBankrollResult &result,			// Out argument
+	TBankrollProgressFn progress,		// Progress callback or NULL
+	void *ctx								// Progress callback argument
+	)
+	{
+	int ret = -1;   // Assume invalid configuration
+	memset((void *)&result, 0, sizeof(result));
+	// No table file is configured for table file policies
+	if (!config.decks || (config.rules >= RULES_VARIANTS_NR) ||
+			(config.policy == POLICY_TABLES) || (config.policy >= POLICY_TYPES_NR) ||
+			!config.sessions ||
+			(config.wager.getBaseBet() <= 0.0) || (config.bankroll <= 0.0))
+		return ret;
+
+	TBankrollRunner runner(config, result, progress, ctx);
+	ret = dispatchRules(config.rules, runner);
+	return ret;
+	}
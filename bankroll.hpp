@@ -0,0 +1,102 @@
+/******************************************************************************/
+/*!
+ * @file:					  bankroll.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the wager model and the
+ *  					bankroll / risk of ruin simulator.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __BANKROLL_HPP__
+#define __BANKROLL_HPP__
+
+/* Defines */
+
+// Bet spread steps
+#define WAGER_MAX_STEPS				8
+// Reported final bankroll quantiles
+#define BANKROLL_QUANTILES_NR		7
+
+/* Enumerations, type defines */
+
+/* Bet spread step: bets are multiplied once the true count reaches 'trueCount' */
+typedef struct __WagerStep__
+	{
+	int trueCount;
+	double multiplier;
+	}TWagerStep;
+
+/*
+ * Wager model
+ * Bet = baseBet times the multiplier of the highest step reached by the Hi-Lo
+ * true count (floored), or baseBet below the first step. A flat bet has no
+ * steps.
+ * */
+class TWager
+	{
+	public:
+		TWager(double baseBet = 1.0);
+		~TWager(void){};
+		/*
+		 * Add a bet spread step. Steps must be added in increasing true count.
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (too many steps or not increasing)
+		 */
+		int addStep(int trueCount, double multiplier);
+		// Bet for the argued true count
+		double getBet(double trueCount) const;
+		double getBaseBet(void) const {return mBaseBet;};
+
+	private:
+		double mBaseBet;
+		unsigned int mStepsNr;
+		TWagerStep mSteps[WAGER_MAX_STEPS];
+	};
+
+/* Bankroll simulation configuration */
+typedef struct __BankrollConfig__
+	{
+	unsigned int rules;						// TRuleFlags
+	unsigned int decks;						// Decks in the shoe
+	unsigned int policy;						// TPolicyType
+	unsigned long long seed;				// Sessions seed. Same seed, same sessions
+	unsigned long long sessions;			// Independent sessions
+	unsigned long long sessionHands;		// Hands per session (fixed length)
+	double bankroll;							// Session starting bankroll
+	TWager wager;								// Bet sizing
+	unsigned int threads;					// Worker threads. 0, one per hardware thread
+	double reportSecs;						// Progress report period. 0, none
+	}TBankrollConfig;
+
+/* Bankroll simulation results (also used for progress reports) */
+typedef struct __BankrollResult__
+	{
+	unsigned long long sessions;			// Sessions finished
+	unsigned long long ruined;				// Sessions left without the base bet
+	unsigned long long hands;				// Hands played
+	double riskOfRuin;						// Ruined sessions ratio
+	double riskOfRuinSE;						// Risk of ruin standard error
+	double meanFinal;							// Mean final bankroll
+	double quantileLevels[BANKROLL_QUANTILES_NR];
+	double quantiles[BANKROLL_QUANTILES_NR];	// Final bankroll quantiles
+	double elapsedSecs;
+	}TBankrollResult;
+
+/* Progress report callback, called from the simulateBankroll() caller thread */
+typedef void (*TBankrollProgressFn)(const TBankrollResult &progress, void *ctx);
+
+/*
+ * Play config.sessions independent sessions of config.sessionHands hands each,
+ * in parallel. A session ends early when the bankroll drops below the base bet
+ * (ruin). Final bankrolls feed a t-digest so memory does not grow with the
+ * session count.
+ * @return: - 0 - Success simulating. Otherwise,
+ * 			Error (invalid configuration)
+ */
+int simulateBankroll (const TBankrollConfig &config, TBankrollResult &result,
+		TBankrollProgressFn progress = 0, void *ctx = 0);
+
+#endif /* __BANKROLL_HPP__ */
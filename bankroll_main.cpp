@@ -0,0 +1,241 @@
+/******************************************************************************/
+/*!
+ * @file:					  bankroll_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-bankroll. Final bankroll quantiles and risk of
+ *  					ruin over many fixed length sessions.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "bankroll.hpp"
+#include "misc.hpp"
+#include "rules.hpp"
+#include "strategy.hpp"
+
+/* Library includes */
+#include <getopt.h>
+#include <iostream>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":hd:P:S:n:l:b:w:W:t:r:sp6";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "policy",   		required_argument,   NULL,    'P'   },
+   { "seed",   		required_argument,   NULL,    'S'   },
+   { "sessions",		required_argument,   NULL,    'n'   },
+   { "length",			required_argument,   NULL,    'l'   },
+   { "bankroll",		required_argument,   NULL,    'b'   },
+   { "bet",				required_argument,   NULL,    'w'   },
+   { "spread",			required_argument,   NULL,    'W'   },
+   { "threads",  		required_argument,   NULL,    't'   },
+   { "report",  		required_argument,   NULL,    'r'   },
+   { "s17",   		no_argument,         NULL,    's'   },
+   { "push-ties",		no_argument,         NULL,    'p'   },
+   { "pay-6-5",		no_argument,         NULL,    '6'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-bankroll: Bankroll quantiles and risk of ruin over fixed length sessions"
+   		<< std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -n, --sessions N" << std::endl;
+   std::cout << "      Independent sessions (default 100000)." << std::endl;
+   std::cout << "   -l, --length HANDS" << std::endl;
+   std::cout << "      Hands per session (default 1000)." << std::endl;
+   std::cout << "   -b, --bankroll UNITS" << std::endl;
+   std::cout << "      Starting bankroll (default 100)." << std::endl;
+   std::cout << "   -w, --bet UNITS" << std::endl;
+   std::cout << "      Base bet (default 1). A session is ruined below it." << std::endl;
+   std::cout << "   -W, --spread TC:MULT,..." << std::endl;
+   std::cout << "      Hi-Lo true count bet spread (ex: 1:2,2:4,3:8). Default flat bet." << std::endl;
+   std::cout << "   -d, --decks N, -P, --policy NAME, -S, --seed SEED, -t, --threads N" << std::endl;
+   std::cout << "      Shoe decks (default 6), player policy, seed and worker threads." << std::endl;
+   std::cout << "   -r, --report SECS" << std::endl;
+   std::cout << "      Progress report period (default 1, 0 for none)." << std::endl;
+   std::cout << "   -s, --s17, -p, --push-ties, -6, --pay-6-5" << std::endl;
+   std::cout << "      Rule variants, as for blackjack." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Parse a bet spread ("TC:MULT,TC:MULT,...")
+ * @return: - 0 - Success. Otherwise,
+ * 			Error
+ */
+	int
+parseSpread
+	(
+	const std::string &spread,		// Spread steps
+	TWager &wager						// In/Out argument
+	)
+	{
+	std::stringstream ss(spread);
+	std::string tok;
+	while (std::getline(ss, tok, ','))
+		{
+		int trueCount;
+		double multiplier;
+		if ((sscanf(tok.c_str(), "%d:%lf", &trueCount, &multiplier) != 2) ||
+				wager.addStep(trueCount, multiplier))
+			return -1;
+		}
+	return 0;
+	}
+
+/*
+ * Print a bankroll result
+ */
+	void
+printResult
+	(
+	const TBankrollResult &result,		// Result or progress
+	const char *header						// Printed header
+	)
+	{
+	printf("%s: %llu sessions, %llu hands, %.1f s (%.0f hands/s)\n", header, result.sessions,
+			result.hands, result.elapsedSecs,
+			result.elapsedSecs > 0.0 ? (double)result.hands / result.elapsedSecs : 0.0);
+	printf("  Risk of ruin   %.6f +/- %.6f (%llu ruined)\n", result.riskOfRuin,
+			result.riskOfRuinSE, result.ruined);
+	printf("  Mean final     %.2f\n", result.meanFinal);
+	printf("  Quantiles     ");
+	for (unsigned int i = 0; i < BANKROLL_QUANTILES_NR; i++)
+		printf(" p%02.0f=%.1f", result.quantileLevels[i] * 100.0, result.quantiles[i]);
+	printf("\n");
+	fflush(stdout);
+	}
+
+/*
+ * Progress report callback
+ */
+	void
+reportProgress
+	(
+	const TBankrollResult &progress,		// Results so far
+	void *												// Callback context, unused
+	)
+	{
+	printResult(progress, "Progress");
+	}
+
+/* Top level and binary entry point for the bankroll simulator
+ * @return: 0 - Success. Otherwise,
+ * 			Error
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	TBankrollConfig config;
+	config.rules = RULES_HOUSE;
+	config.decks = 6;
+	config.policy = POLICY_BASIC;
+	config.seed = 1;
+	config.sessions = 100000;
+	config.sessionHands = 1000;
+	config.bankroll = 100.0;
+	config.threads = 0;
+	config.reportSecs = 1.0;
+	double baseBet = 1.0;
+	std::string spread;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'd':
+				config.decks = strtoul(optarg, NULL, 10);
+				break;
+			case 'P':
+				{
+				TPolicyType policy;
+				if (policyFromName(optarg, policy))
+					{
+					log(LOG_ERR, "Unknown policy\n");
+					return -1;
+					}
+				config.policy = policy;
+				}
+				break;
+			case 'S':
+				config.seed = strtoull(optarg, NULL, 10);
+				break;
+			case 'n':
+				config.sessions = strtoull(optarg, NULL, 10);
+				break;
+			case 'l':
+				config.sessionHands = strtoull(optarg, NULL, 10);
+				break;
+			case 'b':
+				config.bankroll = strtod(optarg, NULL);
+				break;
+			case 'w':
+				baseBet = strtod(optarg, NULL);
+				break;
+			case 'W':
+				spread = optarg;
+				break;
+			case 't':
+				config.threads = strtoul(optarg, NULL, 10);
+				break;
+			case 'r':
+				config.reportSecs = strtod(optarg, NULL);
+				break;
+			case 's':
+				config.rules |= RULES_STAND_SOFT_17;
+				break;
+			case 'p':
+				config.rules |= RULES_PUSH_TIES;
+				break;
+			case '6':
+				config.rules |= RULES_PAY_6_5;
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+
+	config.wager = TWager(baseBet);
+	if (parseSpread(spread, config.wager))
+		{
+		log(LOG_ERR, "Invalid bet spread\n");
+		return -1;
+		}
+
+	TBankrollResult result;
+	if (simulateBankroll(config, result, reportProgress, NULL))
+		{
+		log(LOG_ERR, "Invalid bankroll configuration\n");
+		return -1;
+		}
+	printResult(result, "Final");
+	return 0;
+	}
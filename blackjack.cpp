@@ -12,6 +12,7 @@
 
 
 /* Library includes */
+#include <iomanip>
 #include <sstream>
 #include <unistd.h>
 
@@ -19,26 +20,55 @@
 #include "misc.hpp"
 #include "blackjack.hpp"
 
+/*
+ * Clear the stats and reserve the hands stack so no round allocates
+ */
+template <typename TRules, typename TObserver>
+	void
+TBlackjack<TRules, TObserver>::init
+	(
+	void
+	)
+	{
+	memset((void *)&mStats, 0, sizeof(mStats));
+	memset((void *)mDoubled, 0, sizeof(mDoubled));
+	mUserHandsNr = 0;
+	for (unsigned int i = 0; i < MAX_SPLIT_HANDS; i++)
+		mUserHands[i].reserve(BLACKJACK_VAL + 1);
+	mDealerCards.reserve(BLACKJACK_VAL + 1);
+	mSideBets = &sideBetTables();
+	}
+
 /*
  * User plays hand with dealer
  * @return: - 0 - Success playing hand with dealer. Otherwise
  * 			Error
  */
+template <typename TRules, typename TObserver>
 	int
-TBlackjack::playHand
+TBlackjack<TRules, TObserver>::playHand
 	(
 	TCards &cardDeck
 	)
 	{
-	TDealer dealer;
-	TCards userCards, dealerCards;   // User hand
+	TDealer &dealer = mDealer;
+	TCards &userCards = mUserHands[0];   // User hand, first of the split stack
+	TCards &dealerCards = mDealerCards;
 	int ret = -1; // Assumes failure playing hand
+	for (unsigned int i = 0; i < mUserHandsNr; i++)
+		{
+		mUserHands[i].clear();
+		mDoubled[i] = false;
+		}
+	mUserHandsNr = 1;
+	dealerCards.clear();
+	mLastNet = 0.0;
 	// Get successfully play hands
 	unsigned int HandsPlayed = getSuccessPlHandsCount();
-	// Check amount of hands played. Every six hands, cards are shuffle
-	if (!(HandsPlayed % SHUFFLE_PERIOD_PLAYS))
+	// Check amount of hands played. Every shuffle period (six hands per deck), cards are shuffle
+	if (!(HandsPlayed % mShufflePeriod))
 		{
-		if (HandsPlayed)
+		if (HandsPlayed && mVerbose)
 			{
 			std::stringstream ss;
 			ss << "Next count of " << HandsPlayed << " games (total games "
@@ -53,10 +83,31 @@ TBlackjack::playHand
 	ret = drawInitialCards(dealer, cardDeck, dealerCards, userCards);
 	if (ret)
 		{
-		log(LOG_INFO, "Error, when feeding first cards on the game\n\n");
+		if (mVerbose)
+			log(LOG_INFO, "Error, when feeding first cards on the game\n\n");
 		return ret;
 		}
 
+	// Insurance is offered before the dealer checks the hole card
+	if ((dealerCards.back().value == ACE_MIN_VAL) && offerInsurance())
+		{
+		bool soft;
+		mStats.insurances++;
+		if (getScore(dealerCards, soft, false) == (int)BLACKJACK_VAL)
+			{
+			mStats.insuranceWins++;
+			mLastNet += (double)TRules::INSURANCE_PAY / 2.0;
+			if (mVerbose)
+				log(LOG_INFO, "Insurance WINS. Dealer has 21\n\n");
+			}
+		else
+			{
+			mLastNet -= 0.5;
+			if (mVerbose)
+				log(LOG_INFO, "Insurance lost. Dealer does not have 21\n\n");
+			}
+		}
+
 	int iniRet = initBlackjackChks(dealerCards, userCards);
 	if (iniRet != HAND_OUTCOME_CONTINUE)
 		{
@@ -64,73 +115,163 @@ TBlackjack::playHand
 			return iniRet;
 		else
 			{
+			// Two card score, inline so the null observer costs nothing
+			unsigned int hard = userCards[0].value + userCards[1].value;
+			bool soft = ((userCards[0].value == ACE_MIN_VAL) ||
+					(userCards[1].value == ACE_MIN_VAL)) && (hard + ACE_MAX_VAL - ACE_MIN_VAL <=
+					BLACKJACK_VAL);
+			mObserver.onDecision(dealer, dealerCards.front(), soft ?
+					hard + ACE_MAX_VAL - ACE_MIN_VAL : hard, soft, dealerCards.back().value,
+					HISTORY_ACTION_NONE);
 			incSuccessPlHandsCount();  // Do not increment if error playing a hand
+			mObserver.onHandResult(mLastNet);
 			return 0;
 			}
 		}
 
-	// Player requests for cards
-	int userScore = userReqCards(dealer, cardDeck, userCards);
-	if (userScore == HAND_OUTCOME_BUSTED)
+	// Player plays every hand of the split stack, hands split later go last
+	int userScores[MAX_SPLIT_HANDS];
+	unsigned int liveHands = 0;		// Hands standing against the dealer
+	for (unsigned int hand = 0; hand < mUserHandsNr; hand++)
 		{
-		incSuccessPlHandsCount();  // Do not increment if error playing a hand
-		mStats.dealerWins++;
-		mStats.userBusts++;
-		return 0;
+		if (mVerbose && (mUserHandsNr > 1))
+			{
+			std::stringstream ss;
+			ss << "Split hand " << (hand + 1) << ":\n";
+			log(LOG_INFO, ss.str());
+			}
+		int userScore = userReqCards(dealer, cardDeck, hand);
+		userScores[hand] = userScore;
+		if ((userScore == HAND_OUTCOME_BUSTED) || (userScore == HAND_OUTCOME_SURRENDERED))
+			settleHand(hand, userScore);
+		else if ((userScore == HAND_OUTCOME_ERROR) || (userScore <= 0))
+			{
+			if (mVerbose)
+				{
+				std::stringstream ss;
+				ss << "Error, when user requqesting cards. User score is (" << userScore <<
+						"\n" << std::endl;
+				log(LOG_ERR, ss.str());
+				}
+			mStats.errors++;
+			return ret;
+			}
+		else
+			liveHands++;
 		}
-	else if ((userScore == HAND_OUTCOME_ERROR) || (userScore <= 0))
+	if (mUserHandsNr > 1)
+		mStats.splitHands += mUserHandsNr;
+
+	// Every hand busted or surrendered, the dealer does not draw
+	if (!liveHands)
 		{
-		std::stringstream ss;
-		ss << "Error, when user requqesting cards. User score is (" << userScore <<
-				"\n" << std::endl;
-		mStats.errors++;
-		return ret;
+		incSuccessPlHandsCount();  // Do not increment if error playing a hand
+		mObserver.onHandResult(mLastNet);
+		return 0;
 		}
 
 	// Dealer draw cards until lower threshold has been reached
-	unsigned int dealerScore = dealerReqCards(dealer, cardDeck, dealerCards);
+	int dealerScore = dealerReqCards(dealer, cardDeck, dealerCards);
 	if (dealerScore == HAND_OUTCOME_BUSTED)
 		{
 		mStats.dealerBusts++;
-		mStats.userWins++;
+		mObserver.onDealerBust(dealerCards[1].value);
+		for (unsigned int hand = 0; hand < mUserHandsNr; hand++)
+			if (userScores[hand] > 0)
+				settleHand(hand, HAND_OUTCOME_UWON);
 		incSuccessPlHandsCount();  // Do not increment if error playing a hand
+		mObserver.onHandResult(mLastNet);
 		return 0;
 		}
-	else if ((dealerScore == HAND_OUTCOME_ERROR) || (userScore <= 0))
+	else if ((dealerScore == HAND_OUTCOME_ERROR) || (dealerScore <= 0))
 		{
-		std::stringstream ss;
-		ss << "Error, when dealer withdrawing cards. Dealer score is (" << userScore <<
-				"\n" << std::endl;
+		if (mVerbose)
+			{
+			std::stringstream ss;
+			ss << "Error, when dealer withdrawing cards. Dealer score is (" << dealerScore <<
+					"\n" << std::endl;
+			log(LOG_ERR, ss.str());
+			}
 		mStats.errors++;
 		return ret;
 		}
 
 	// Scores are compared and winning side is computed. Stats are updated
-	compareScores(userScore, dealerScore);
+	mObserver.onDealerStand(dealerCards[1].value, dealerScore);
+	for (unsigned int hand = 0; hand < mUserHandsNr; hand++)
+		if (userScores[hand] > 0)
+			compareScores(userScores[hand], dealerScore, hand);
 	incSuccessPlHandsCount();  // Do not increment if error playing a hand
+	mObserver.onHandResult(mLastNet);
 
 	ret = 0;
 	return ret;
 	}
 
+/*
+ * Account the outcome of a stack hand: stats and last hand net result
+ */
+template <typename TRules, typename TObserver>
+	void
+TBlackjack<TRules, TObserver>::settleHand
+	(
+	const unsigned int hand,		// Split stack position
+	const int 			 outcome		// HAND_OUTCOME_UWON, DWON, PUSHED, BUSTED or SURRENDERED
+	)
+	{
+	double bet = mDoubled[hand] ? 2.0 : 1.0;
+	bool split = (mUserHandsNr > 1);
+	mStats.doubles += mDoubled[hand];
+	switch (outcome)
+		{
+		case HAND_OUTCOME_UWON:
+			mStats.userWins++;
+			mStats.doubleWins += mDoubled[hand];
+			mStats.splitWins += split;
+			mLastNet += bet;
+			break;
+		case HAND_OUTCOME_PUSHED:
+			mStats.pushes++;
+			mStats.doublePushes += mDoubled[hand];
+			break;
+		case HAND_OUTCOME_BUSTED:
+			mStats.userBusts++;
+			mStats.dealerWins++;
+			mLastNet -= bet;
+			break;
+		case HAND_OUTCOME_SURRENDERED:
+			mStats.surrenders++;
+			mStats.dealerWins++;
+			mLastNet -= 0.5;
+			break;
+		case HAND_OUTCOME_DWON:
+		default:
+			mStats.dealerWins++;
+			mLastNet -= bet;
+			break;
+		}
+	}
+
 /*
  * User plays hand with dealer
  * Rule:	- House (dealer) wins in an event of a score tie even if both
- * 		dealer and player have an score of 21.
+ * 		dealer and player have an score of 21, unless TRules::PUSH_ON_TIE.
  *
  * @return: - 0 - Success playing hand with dealer. Otherwise
  * 			Error
  */
+template <typename TRules, typename TObserver>
 	int
-TBlackjack::compareScores
+TBlackjack<TRules, TObserver>::compareScores
 	(
 	const int  userScore,    // User hand score
-	const int  dealerScore	 // Dealer hand score
+	const int  dealerScore,	 // Dealer hand score
+	const unsigned int hand	 // Split stack position of the user hand
 	)
 	{
 	int ret = -1;
-	if ((userScore < 0) || (dealerScore < 0) || (userScore > BLACKJACK_VAL) ||
-			(dealerScore > BLACKJACK_VAL))
+	if ((userScore < 0) || (dealerScore < 0) || (userScore > (int)BLACKJACK_VAL) ||
+			(dealerScore > (int)BLACKJACK_VAL))
 		{
 		std::stringstream ss;
 		ss << __FUNCTION__ << ": Error, invalid user (" << userScore << ") or dealer (" <<
@@ -139,23 +280,40 @@ TBlackjack::compareScores
 		return ret;
 		}
 
-	if (dealerScore >= userScore)
+	if (TRules::PUSH_ON_TIE && (dealerScore == userScore))
 		{
-		std::stringstream ss;
-		ss << "Dealer WINS. Dealer has higher or equivalent score than user.\n"
-				<< "Dealer score:" << dealerScore << ". User score:" << userScore <<
-				"\n" << std::endl;
-		mStats.dealerWins++;
-		log(LOG_INFO, ss.str());
+		settleHand(hand, HAND_OUTCOME_PUSHED);
+		if (mVerbose)
+			{
+			std::stringstream ss;
+			ss << "PUSH. Dealer and user have the same score.\n"
+					<< "Score:" << userScore << "\n" << std::endl;
+			log(LOG_INFO, ss.str());
+			}
+		}
+	else if (dealerScore >= userScore)
+		{
+		settleHand(hand, HAND_OUTCOME_DWON);
+		if (mVerbose)
+			{
+			std::stringstream ss;
+			ss << "Dealer WINS. Dealer has higher or equivalent score than user.\n"
+					<< "Dealer score:" << dealerScore << ". User score:" << userScore <<
+					"\n" << std::endl;
+			log(LOG_INFO, ss.str());
+			}
 		}
 	else
 		{
-		std::stringstream ss;
-		ss << "User WINS. User has higher score than dealer.\n"
-				<< "User score:" << userScore << ". Dealer score:" << dealerScore <<
-				"\n" << std::endl;
-		mStats.userWins++;
-		log(LOG_INFO, ss.str());
+		settleHand(hand, HAND_OUTCOME_UWON);
+		if (mVerbose)
+			{
+			std::stringstream ss;
+			ss << "User WINS. User has higher score than dealer.\n"
+					<< "User score:" << userScore << ". Dealer score:" << dealerScore <<
+					"\n" << std::endl;
+			log(LOG_INFO, ss.str());
+			}
 		}
 
 	ret = 0;
@@ -167,8 +325,9 @@ TBlackjack::compareScores
  * @return: - 0 - Success ditributing initial cards. Otherwise,
  * 			Error
  */
+template <typename TRules, typename TObserver>
 	int
-TBlackjack::drawInitialCards
+TBlackjack<TRules, TObserver>::drawInitialCards
 	(
 	TDealer 	 &dealer,			// In
 	TCards	 &cardDeck,			// In
@@ -181,29 +340,39 @@ TBlackjack::drawInitialCards
 
 	// Deal cards to user
 	TCard card = dealer.dealCard(cardDeck);
-	std::stringstream ss;
-	ss << "User has a(n) " << card.name << " and ";
 	userCards.push_back(card);
+	mObserver.onCardDealt(card, false);
 	card = dealer.dealCard(cardDeck);
-	ss << "a(n) " << card.name << "\n" << std::endl;
 	userCards.push_back(card);
-
-	log(LOG_INFO, ss.str());
+	mObserver.onCardDealt(card, false);
 
 	// Dealer feeds cards to him/herself
 	//First card is facing down
 	card = dealer.dealCard(cardDeck);
 	dealerCards.push_back(card);
+	mObserver.onCardDealt(card, true);
 	// The other is facing up
 	card = dealer.dealCard(cardDeck);
 	dealerCards.push_back(card);
+	mObserver.onCardDealt(card, true);
 
-	ss.str(std::string());
+	// Side bets on the first two cards and the up card
+	unsigned int first = cardCode(userCards[0]), second = cardCode(userCards[1]);
+	mStats.pairsOutcomes[evalPairs(*mSideBets, first, second)]++;
+	mStats.threeOutcomes[evalThree(*mSideBets, first, second, cardCode(card))]++;
 
-	ss << "Dealer has one card facing down. The other is a(n) " <<
-			card.name << "\n" << std::endl;
+	if (mVerbose)
+		{
+		std::stringstream ss;
+		ss << "User has a(n) " << cardName(userCards[0]) << " and ";
+		ss << "a(n) " << cardName(userCards[1]) << "\n" << std::endl;
+		log(LOG_INFO, ss.str());
 
-	log(LOG_INFO, ss.str());
+		ss.str(std::string());
+		ss << "Dealer has one card facing down. The other is a(n) " <<
+				cardName(card) << "\n" << std::endl;
+		log(LOG_INFO, ss.str());
+		}
 	return 0;
 	}
 
@@ -211,8 +380,9 @@ TBlackjack::drawInitialCards
  * Function:	verifyNatural
  * @return:		- True - if cards hand is a natural blackjack (face card and an Ace)
  */
+template <typename TRules, typename TObserver>
 	bool
-TBlackjack::verifyNatural
+TBlackjack<TRules, TObserver>::verifyNatural
 	(
 	TCards &cards
 	)
@@ -243,8 +413,9 @@ TBlackjack::verifyNatural
  * 			- HAND_OUTCOME_UWON		- User's hand is a Blackjack but dealer is not. User wins
  * 			- HAND_OUTCOME_ERROR		- Function could not determining initial conditions.
  */
+template <typename TRules, typename TObserver>
 	int
-TBlackjack::initBlackjackChks
+TBlackjack<TRules, TObserver>::initBlackjackChks
 	(
 	TCards	 &dealerCards,		//  Out argument
 	TCards	 &userCards			//  Out argument
@@ -269,46 +440,58 @@ TBlackjack::initBlackjackChks
 
 	if (dealerHasNat && userHasNat)
 		{
-		std::string str("\n -- Both Dealer and Player have Blackjack -- \n"
-				"The hand is a tie (aka 'push') \n");
-		log(LOG_INFO, str);
+		if (mVerbose)
+			{
+			std::string str("\n -- Both Dealer and Player have Blackjack -- \n"
+					"The hand is a tie (aka 'push') \n");
+			log(LOG_INFO, str);
 
-		str = "Dealer has: \n";
-		log(LOG_INFO, str);
-		printCards(dealerCards);
+			str = "Dealer has: \n";
+			log(LOG_INFO, str);
+			printCards(dealerCards);
 
-		str = "User has: \n";
-		log(LOG_INFO, str);
-		printCards(userCards);
-		std::stringstream  ss;
-		ss << std::endl;
+			str = "User has: \n";
+			log(LOG_INFO, str);
+			printCards(userCards);
+			std::stringstream  ss;
+			ss << std::endl;
 
-		log(LOG_INFO, ss.str());
+			log(LOG_INFO, ss.str());
+			}
 		mStats.pushes++;
 		ret = HAND_OUTCOME_PUSHED;
 		}
 	else if(dealerHasNat)
 		{
-		std::string str("\n  -- Dealer wins with a natural (Blackjack) --\n");
-		log(LOG_INFO, str);
-		str = "Dealer has won with: \n";
-		printCards(dealerCards);
-		std::stringstream  ss;
-		ss << std::endl;
-		log(LOG_INFO, ss.str());
+		if (mVerbose)
+			{
+			std::string str("\n  -- Dealer wins with a natural (Blackjack) --\n");
+			log(LOG_INFO, str);
+			str = "Dealer has won with: \n";
+			printCards(dealerCards);
+			std::stringstream  ss;
+			ss << std::endl;
+			log(LOG_INFO, ss.str());
+			}
 		mStats.dealerWins++;
+		mLastNet -= 1.0;
 		ret = HAND_OUTCOME_DWON;
 		}
 	else if(userHasNat)
 		{
-		std::string str("\n  --  Player wins with a Blackjack!!! --\n");
-		log(LOG_INFO, str);
-		str = "Player has won with: \n";
-		printCards(userCards);
-		std::stringstream  ss;
-		ss << std::endl;
-		log(LOG_INFO, ss.str());
+		if (mVerbose)
+			{
+			std::string str("\n  --  Player wins with a Blackjack!!! --\n");
+			log(LOG_INFO, str);
+			str = "Player has won with: \n";
+			printCards(userCards);
+			std::stringstream  ss;
+			ss << std::endl;
+			log(LOG_INFO, ss.str());
+			}
 		mStats.userWins++;
+		mStats.userNaturals++;
+		mLastNet += (double)TRules::NATURAL_PAY_NUM / (double)TRules::NATURAL_PAY_DEN;
 		ret = HAND_OUTCOME_UWON;
 		}
 	else
@@ -317,12 +500,16 @@ TBlackjack::initBlackjackChks
 		bool print = false;
 		if (getScore(dealerCards, soft, print) == BLACKJACK_VAL)
 			{
-			std::stringstream ss;
-			ss << "\n -- Dealer wins with " << BLACKJACK_VAL << " and user has a non " <<
-					"natural (Blackjack)\n";
-			log(LOG_INFO, ss.str());
+			if (mVerbose)
+				{
+				std::stringstream ss;
+				ss << "\n -- Dealer wins with " << BLACKJACK_VAL << " and user has a non " <<
+						"natural (Blackjack)\n";
+				log(LOG_INFO, ss.str());
+				}
 			mStats.dealerWins++;
-			ret = HAND_OUTCOME_UWON;
+			mLastNet -= 1.0;
+			ret = HAND_OUTCOME_DWON;
 			}
 		else
 			ret = HAND_OUTCOME_CONTINUE;
@@ -331,64 +518,243 @@ TBlackjack::initBlackjackChks
 	return ret;
 	}
 
+/*
+ * Player decision for the current hand, from the strategy if automated or
+ * from the console otherwise
+ * @return: - Player action (hit, stand or an allowed ALLOW_* one). Otherwise,
+ * 			Error requesting decision
+ */
+template <typename TRules, typename TObserver>
+	int
+TBlackjack<TRules, TObserver>::userDecision
+	(
+	const int  	 score,			// User hand score
+	const bool	 soft,			// User hand score is soft
+	const TCard	 &upCard,		// Dealer card facing up
+	const TCards &cards,			// User hand
+	const unsigned int allowed	// ALLOW_* actions on top of hit and stand
+	)
+	{
+	unsigned int pairValue = ((cards.size() == INIT_CARDS_NR) &&
+			(cards[0].value == cards[1].value)) ? cards[0].value : 0;
+	// The hole card is dealt first and not seen by the player
+	if (mStrategy)
+		{
+		double trueCount = mStrategy->usesCount() ?
+				mDealer.getTrueCount(&mDealerCards.front()) : 0.0;
+		return mStrategy->decide(score, soft, upCard.value, pairValue, allowed, trueCount);
+		}
+
+	if (mAdvisor)
+		{
+		double trueCount = mDealer.getTrueCount(&mDealerCards.front());
+		std::stringstream ss;
+		ss << "Suggested play: " << actionName(mAdvisor->decide(score, soft, upCard.value,
+				pairValue, allowed, trueCount)) << " (true count " << trueCount << ")\n";
+		log(LOG_INFO, ss.str());
+		}
+
+	// Expected value of every option, from the cards the player has not seen
+	if (mHints)
+		{
+		TAdvice advice;
+		mHints->advise(mDealer, mDealerCards.front(), score, soft, upCard.value, pairValue,
+				allowed, advice);
+		std::stringstream hint;
+		hint << std::showpos << std::fixed << std::setprecision(3) << "Hint: " <<
+				actionName(advice.best) << ", EV " << advice.ev[advice.best];
+		for (int a = 0; a < ACTION_TYPES_NR; a++)
+			if (advice.valid[a] && (a != advice.best))
+				hint << (" vs " + std::string(actionName((TPlayerAction)a))) << " " << advice.ev[a];
+		hint << "\n";
+		log(LOG_INFO, hint.str());
+		}
+
+	// Console options, in the order they are listed
+	static const char *optionKeys[] = {"H", "S", "D", "P", "R"};
+	static const char *optionNames[] = {"hit", "stand", "double down", "split", "surrender"};
+	static const int optionActions[] = {ACTION_HIT, ACTION_STAND, ACTION_DOUBLE,
+			ACTION_SPLIT, ACTION_SURRENDER};
+	static const unsigned int optionAllows[] = {0, 0, ALLOW_DOUBLE, ALLOW_SPLIT,
+			ALLOW_SURRENDER};
+	std::vector<std::string> options;
+	std::vector<int> actions;
+	std::stringstream ss;
+	ss << "What do you want to do?\n Please enter";
+	for (unsigned int i = 0; i < sizeof(optionKeys) / sizeof(optionKeys[0]); i++)
+		if (!optionAllows[i] || (allowed & optionAllows[i]))
+			{
+			ss << (options.empty() ? " '" : ", '") << optionKeys[i] << "' to " << optionNames[i];
+			options.push_back(optionKeys[i]);
+			actions.push_back(optionActions[i]);
+			}
+	ss << "\n";
+	int choice = reqChoice(ss.str(), options, MAX_VALID_INPUT_REQ_TRIES);
+	return (choice < 0) ? -1 : actions[choice];
+	}
+
+/*
+ * Offer insurance on an Ace up card, from the strategy if automated or
+ * from the console otherwise
+ * @return: - True - Player takes insurance
+ */
+template <typename TRules, typename TObserver>
+	bool
+TBlackjack<TRules, TObserver>::offerInsurance
+	(
+	void
+	)
+	{
+	if (mStrategy)
+		return mStrategy->takeInsurance(mDealer.getTrueCount(&mDealerCards.front()));
+
+	if (mAdvisor)
+		{
+		double trueCount = mDealer.getTrueCount(&mDealerCards.front());
+		std::stringstream ss;
+		ss << "Suggested play: " << (mAdvisor->takeInsurance(trueCount) ? "take" : "decline") <<
+				" insurance (true count " << trueCount << ")\n";
+		log(LOG_INFO, ss.str());
+		}
+
+	std::stringstream ss;
+	ss << "Dealer shows an Ace. Insurance costs half your bet and pays " <<
+			TRules::INSURANCE_PAY << ":1 if the dealer has " << BLACKJACK_VAL << ".\n" <<
+			" Please enter 'Y' to take insurance or 'N' to decline\n";
+	return reqInput(ss.str(), "N", "Y", MAX_VALID_INPUT_REQ_TRIES) == REQ_INPUT_CONT;
+	}
+
 /*
  * Function: userReqCards
- * Description:User requests cards as preferred.
+ * Description:User plays the hand at the argued hand stack position.
+ * 				Splits push new hands on the stack.
+ * Rules:	- Double down on any first two cards (after a split if
+ * 			  TRules::DOUBLE_AFTER_SPLIT) takes exactly one more card.
+ * 			- Pairs of the same value split while the stack has room. Split
+ * 			  Aces take one card each.
+ * 			- Late surrender on the first two cards, not after a split.
  * @return:	 User score or
- * 			- HAND_OUTCOME_BUSTED  - User went over BLACKJACK_VAL
- * 			- HAND_OUTCOME_ERROR	  - Error processing processing this function
+ * 			- HAND_OUTCOME_BUSTED  		- User went over BLACKJACK_VAL
+ * 			- HAND_OUTCOME_SURRENDERED - User surrendered
+ * 			- HAND_OUTCOME_ERROR	  		- Error processing processing this function
  */
+template <typename TRules, typename TObserver>
 	int
-TBlackjack::userReqCards
+TBlackjack<TRules, TObserver>::userReqCards
 	(
-	TDealer 	 &dealer,			// In
-	TCards	 &cardDeck,			// In
-	TCards	 &userCards			//  In/Out argument
+	TDealer 	 	 &dealer,			// In
+	TCards	 	 &cardDeck,			// In
+	unsigned int hand					// Split stack position
 	)
 	{
 	int ret = HAND_OUTCOME_ERROR;  // Assume system could not process user card requests
+	TCards &userCards = mUserHands[hand];
+	// Split hands get their second card when played
+	if (userCards.size() < INIT_CARDS_NR)
+		{
+		TCard card = dealer.dealCard(cardDeck);
+		userCards.push_back(card);
+		mObserver.onCardDealt(card, false);
+		}
 	// Print initial player score
-	log(LOG_INFO, "Currently,");
+	if (mVerbose)
+		log(LOG_INFO, "Currently,");
 
 	bool exit = false;  // Assume player would like to continue receiving cards
 	do
 		{
-		bool dummy;   // Place holder
-		log(LOG_INFO, " the user has:\n");
-		printCards(userCards);
-		log(LOG_INFO, "with a score of:\n");
-		int score = getScore(userCards, dummy);  // Get and print score
+		bool soft = false;   // Assume the hand score is not soft
+		if (mVerbose)
+			{
+			log(LOG_INFO, " the user has:\n");
+			printCards(userCards);
+			log(LOG_INFO, "with a score of:\n");
+			}
+		int score = getScore(userCards, soft, mVerbose);  // Get and print score
 		if (score <= 0)
 			return HAND_OUTCOME_ERROR;
 
-		if (score > BLACKJACK_VAL)
+		if (score > (int)BLACKJACK_VAL)
 			{
-			log(LOG_INFO, " Oooops, Player busted\n\n");
+			if (mVerbose)
+				log(LOG_INFO, " Oooops, Player busted\n\n");
 			return HAND_OUTCOME_BUSTED;
 			}
 
-		std::string reqStr("Do you want a Card?\n Please enter 'Y' to receive or 'N' "
-						"to stop receiving cards from dealer\n");
-		TReqInputRets retType = reqInput(reqStr, "N", "Y", MAX_VALID_INPUT_REQ_TRIES);
-		if ((retType == REQ_INPUT_ERR) || (retType == REQ_INPUT_EXIT))
+		bool split = (mUserHandsNr > 1);
+		bool splitAces = split && (userCards[0].value == ACE_MIN_VAL);
+		bool firstCards = (userCards.size() == INIT_CARDS_NR);
+		// Doubled hands and split Aces take no more cards
+		if (mDoubled[hand] || (splitAces && firstCards))
 			{
-			exit = true;
-			ret = score;
-			log(LOG_ERR, "Player Stands\n\n");
+			if (mVerbose)
+				log(LOG_ERR, "Player Stands\n\n");
+			return score;
 			}
-		else if (retType == REQ_INPUT_CONT)
-			{
-			// Get card from dealer
-			TCard card = dealer.dealCard(cardDeck);
-			userCards.push_back(card);
-			log(LOG_INFO, "Now, ");
-			}
-		else
+
+		unsigned int allowed = 0;
+		if (firstCards && (!split || TRules::DOUBLE_AFTER_SPLIT))
+			allowed |= ALLOW_DOUBLE;
+		if (firstCards && (userCards[0].value == userCards[1].value) &&
+				(mUserHandsNr < MAX_SPLIT_HANDS))
+			allowed |= ALLOW_SPLIT;
+		if (firstCards && !split && TRules::LATE_SURRENDER)
+			allowed |= ALLOW_SURRENDER;
+
+		int action = userDecision(score, soft, mDealerCards.back(), userCards, allowed);
+		mObserver.onDecision(dealer, mDealerCards.front(), score, soft,
+				mDealerCards.back().value, action);
+		switch (action)
 			{
-			std::stringstream ss;
-			ss << "Internal error, incorrect value (" << (unsigned int) retType <<
-					") returned from processing request input \n" << std::endl;
-			log(LOG_ERR,  ss.str());
+			case ACTION_HIT:
+				{
+				// Get card from dealer
+				TCard card = dealer.dealCard(cardDeck);
+				userCards.push_back(card);
+				mObserver.onCardDealt(card, false);
+				if (mVerbose)
+					log(LOG_INFO, "Now, ");
+				}
+				break;
+			case ACTION_DOUBLE:
+				{
+				mDoubled[hand] = true;
+				TCard card = dealer.dealCard(cardDeck);
+				userCards.push_back(card);
+				mObserver.onCardDealt(card, false);
+				if (mVerbose)
+					log(LOG_INFO, "Player doubles down. Now, ");
+				}
+				break;
+			case ACTION_SPLIT:
+				{
+				// The second card starts a new hand on top of the stack
+				TCards &newHand = mUserHands[mUserHandsNr];
+				newHand.clear();
+				newHand.push_back(userCards.back());
+				mDoubled[mUserHandsNr] = false;
+				mUserHandsNr++;
+				userCards.pop_back();
+				TCard card = dealer.dealCard(cardDeck);
+				userCards.push_back(card);
+				mObserver.onCardDealt(card, false);
+				mStats.splits++;
+				if (mVerbose)
+					log(LOG_INFO, "Player splits. Now, ");
+				}
+				break;
+			case ACTION_SURRENDER:
+				if (mVerbose)
+					log(LOG_INFO, "Player surrenders half the bet\n\n");
+				return HAND_OUTCOME_SURRENDERED;
+			case ACTION_STAND:
+			default:
+				// Input errors stand, as a plain 'N' would
+				exit = true;
+				ret = score;
+				if (mVerbose)
+					log(LOG_ERR, "Player Stands\n\n");
+				break;
 			}
 		}while(!exit);
 
@@ -398,58 +764,68 @@ TBlackjack::userReqCards
 /*
  * Function: dealerReqCards
  * Description:Dealer requests cards as rules dictate.
- * Rules: 	- Dealer must hit on soft 17.
+ * Rules: 	- Dealer must hit on soft 17 (unless TRules::HIT_SOFT_17 is false).
  * 			- Dealer must stand on hard 17 or higher soft or hard hands.
  * @return:	 User score or
  * 			- HAND_OUTCOME_BUSTED  - Dealer went over BLACKJACK_VAL
  * 			- HAND_OUTCOME_STAND	  - Dealer stands with value equal or less than
  * 			- HAND_OUTCOME_ERROR	  - Error processing processing this function
  */
+template <typename TRules, typename TObserver>
 	int
-TBlackjack::dealerReqCards
+TBlackjack<TRules, TObserver>::dealerReqCards
 	(
 	TDealer 	 &dealer,			// In
 	TCards	 &cardDeck,			// In
 	TCards	 &dealerCards		//  In/Out argument
 	)
 	{
-#define DEALER_HIT_LIMIT			17
-#define DEALER_HIT_SOFT_SCORE    DEALER_HIT_LIMIT
+	const int DEALER_HIT_LIMIT = TRules::DEALER_HIT_LIMIT;
+	const int DEALER_HIT_SOFT_SCORE = DEALER_HIT_LIMIT;
 	int ret = HAND_OUTCOME_ERROR;  // Assume system could not process user card requests
 	// Print initial player score
-	log(LOG_INFO, "Currently,");
+	if (mVerbose)
+		log(LOG_INFO, "Currently,");
 
 	bool exit = false;  // Assume player would like to continue receiving cards
 	do
 		{
 		bool isSoft = false;   // Assume the hand score is not soft
-		log(LOG_INFO, " the dealer has:\n");
-		printCards(dealerCards);
-		log(LOG_INFO, " with a score of:\n");
-		int score = getScore(dealerCards, isSoft);
+		if (mVerbose)
+			{
+			log(LOG_INFO, " the dealer has:\n");
+			printCards(dealerCards);
+			log(LOG_INFO, " with a score of:\n");
+			}
+		int score = getScore(dealerCards, isSoft, mVerbose);
 		if (score <= 0)
 			return HAND_OUTCOME_ERROR;
 
 		// Rules processing section
-		if (score > BLACKJACK_VAL)
+		if (score > (int)BLACKJACK_VAL)
 			{
-			log(LOG_INFO, " Oooops, Dealer busted\n\n");
+			if (mVerbose)
+				log(LOG_INFO, " Oooops, Dealer busted\n\n");
 			return HAND_OUTCOME_BUSTED;
 			}
-		else if ((score > (DEALER_HIT_LIMIT - 1)) && (score < (BLACKJACK_VAL + 1) ))
+		else if ((score > (DEALER_HIT_LIMIT - 1)) && (score < (int)(BLACKJACK_VAL + 1) ))
 			{
-			if (!(isSoft && (score == DEALER_HIT_SOFT_SCORE)))
+			if (!(TRules::HIT_SOFT_17 && isSoft && (score == DEALER_HIT_SOFT_SCORE)))
 				{// If not soft rule
-				log(LOG_INFO, " Dealer Stands\n\n");
+				if (mVerbose)
+					log(LOG_INFO, " Dealer Stands\n\n");
 				return (int)score;
 				}
 			}
 
-		sleep(1);  // Delay to let user read dealer drawing card execution
+		if (mVerbose)
+			consoleDelay(1);  // Delay to let user read dealer drawing card execution
 		// Get card from dealer
 		TCard card = dealer.dealCard(cardDeck);
 		dealerCards.push_back(card);
-		log(LOG_INFO, "Now, ");
+		mObserver.onCardDealt(card, true);
+		if (mVerbose)
+			log(LOG_INFO, "Now, ");
 		} while(!exit);
 	return ret;
 	}
@@ -460,8 +836,9 @@ TBlackjack::dealerReqCards
  * @return:	- User score.
  * 			- Less than zero if error
  */
+template <typename TRules, typename TObserver>
 	int
-TBlackjack::getScore
+TBlackjack<TRules, TObserver>::getScore
 	(
 	TCards	 	 &cards,			//  In argument
 	bool			 &soft,			//  Return value is soft
@@ -471,6 +848,7 @@ TBlackjack::getScore
 	unsigned int ret = 0;
 	bool aceFound = false;  // Assume Ace has not been found
 	unsigned int accum = 0;
+	soft = false;				// Assume no Ace is counted as ACE_MAX_VAL
 	for (TCards::iterator it = cards.begin(); it != cards.end(); it++)
 		{
 		if (it->value == ACE_MIN_VAL)
@@ -509,6 +887,7 @@ TBlackjack::getScore
 		if (accum <= ACE_MAX_VAL)
 			{// Value is soft
 			ret = accum - ACE_MIN_VAL + ACE_MAX_VAL;
+			soft = true;
 			if (print)
 				{
 				std::stringstream ss;
@@ -536,15 +915,16 @@ TBlackjack::getScore
  * @return: - 0 - Printing cards. Otherwise,
  * 			Error
  */
+template <typename TRules, typename TObserver>
 	int
-TBlackjack::printCards
+TBlackjack<TRules, TObserver>::printCards
 	(
 	TCards &cards
 	)
 	{
 	for (TCards::iterator it = cards.begin(); it != cards.end(); it++)
 		{
-		log(LOG_INFO, it->name);
+		log(LOG_INFO, cardName(*it));
 		if ((it + 1) == cards.end())
 			log(LOG_INFO, " ");
 		else
@@ -559,13 +939,14 @@ TBlackjack::printCards
  * @return: - 0 -  Printing stats, otherwise
  * 			Error
  */
+template <typename TRules, typename TObserver>
 	int
-TBlackjack::printStats
+TBlackjack<TRules, TObserver>::printStats
 	(
 	void
 	)
 	{
-	printf(" printing stats\n");
+	log(LOG_INFO, " printing stats\n");
 	int ret = -1;   // Assume error printing stats
 	std::stringstream ss;
 	unsigned long handsPlayed = getSuccessPlHandsCount();
@@ -591,9 +972,74 @@ TBlackjack::printStats
 			"Dealer Busts (over "<< BLACKJACK_VAL << "):\t\t" << mStats.dealerBusts << "( %" <<
 			(float)((float)mStats.dealerBusts/(float)handsPlayed) * 100 << ") \n" <<
 
-			"\nErrors executing game:" << mStats.errors  << "\n\n" <<
+			"Player naturals (paid " << TRules::NATURAL_PAY_NUM << ":" <<
+			TRules::NATURAL_PAY_DEN << "):\t" << mStats.userNaturals << "\n" <<
+
+			"Player net (bets):\t\t" << getNetUnits() << "\n" <<
 
-			 std::endl;
+			"Actions:\n" <<
+
+			"Doubles:\t\t" << mStats.doubles << " (won " << mStats.doubleWins <<
+			", pushed " << mStats.doublePushes << ")\n" <<
+
+			"Splits:\t\t\t" << mStats.splits << " (" << mStats.splitHands <<
+			" hands, won " << mStats.splitWins << ")\n" <<
+
+			"Surrenders:\t\t" << mStats.surrenders << "\n" <<
+
+			"Insurances:\t\t" << mStats.insurances << " (won " << mStats.insuranceWins <<
+			")\n" <<
+
+			"\nErrors executing game:" << mStats.errors  << "\n\n";
+	// Latencies only when typed, scripted game transcripts do not depend on timing
+	if (mHints && mHints->getAdvices() && isInputTyped())
+		{
+		ss << "Hints:\t\t\t" << mHints->getAdvices() << " (latency p50 " <<
+				mHints->getLatency(0.5) << " us, p99 " << mHints->getLatency(0.99) << " us";
+		// Hit rate only with a dealer outcome cache attached
+		if (mHints->getDealerCache())
+			{
+			TDealerCacheStats cache;
+			mHints->getDealerCache()->getStats(cache);
+			unsigned long long lookups = cache.hits + cache.misses;
+			ss << ", dealer cache hits " << (lookups ? 100.0 * cache.hits / lookups : 0.0) << "%";
+			}
+		ss << ")\n\n";
+		}
+	else if (mHints && mHints->getAdvices())
+		ss << "Hints:\t\t\t" << mHints->getAdvices() << "\n\n";
+	ss << std::endl;
 	log (LOG_INFO, ss.str());
 	return ret;
 	}
+
+/* Rule set specializations built into the library (see dispatchRules()) */
+template class TBlackjack< TRuleSet<0> >;
+template class TBlackjack< TRuleSet<1> >;
+template class TBlackjack< TRuleSet<2> >;
+template class TBlackjack< TRuleSet<3> >;
+template class TBlackjack< TRuleSet<4> >;
+template class TBlackjack< TRuleSet<5> >;
+template class TBlackjack< TRuleSet<6> >;
+template class TBlackjack< TRuleSet<7> >;
+/* Hand history engines (see simulate()) */
+template class TBlackjack< TRuleSet<0>, THistoryObserver >;
+template class TBlackjack< TRuleSet<1>, THistoryObserver >;
+template class TBlackjack< TRuleSet<2>, THistoryObserver >;
+template class TBlackjack< TRuleSet<3>, THistoryObserver >;
+template class TBlackjack< TRuleSet<4>, THistoryObserver >;
+template class TBlackjack< TRuleSet<5>, THistoryObserver >;
+template class TBlackjack< TRuleSet<6>, THistoryObserver >;
+template class TBlackjack< TRuleSet<7>, THistoryObserver >;
+/* Rare event engines (see simulate()) */
+template class TBlackjack< TRuleSet<0>, TRareObserver >;
+template class TBlackjack< TRuleSet<1>, TRareObserver >;
+template class TBlackjack< TRuleSet<2>, TRareObserver >;
+template class TBlackjack< TRuleSet<3>, TRareObserver >;
+template class TBlackjack< TRuleSet<4>, TRareObserver >;
+template class TBlackjack< TRuleSet<5>, TRareObserver >;
+template class TBlackjack< TRuleSet<6>, TRareObserver >;
+template class TBlackjack< TRuleSet<7>, TRareObserver >;
+/* Observer benchmark engines (see blackjack-observe) */
+template class TBlackjack< TRulesHouse, TObservers<TNullObserver, TNullObserver> >;
+template class TBlackjack< TRulesHouse, TObservers<TCardsObserver, TActionsObserver, TDealerObserver> >;
@@ -14,27 +14,56 @@
 #define __BLACKJACK_HPP__
 
 /* Local includes */
+#include "advice.hpp"
 #include "dealer.hpp"
+#include "observer.hpp"
+#include "rules.hpp"
+#include "sidebets.hpp"
+#include "strategy.hpp"
 #include <string.h>
 
+/*
+ * Blackjack game results stats
+ * Outcomes (pushes to dealerWins) count every hand a round ends with, so
+ * split rounds count once per split hand. A surrendered hand is a dealer win.
+ */
+typedef struct __TBlackJackStats__ {
+	unsigned long successPlyd;   // Successfully played hands (rounds)
+	unsigned long pushes;
+	unsigned long userBusts;
+	unsigned long dealerBusts;
+	unsigned long userWins;
+	unsigned long userNaturals;  // User wins with a natural, paid at the natural payout
+	unsigned long dealerWins;
+	unsigned long errors;    // General processing errors
+	// Per action outcomes
+	unsigned long doubles;		  // Doubled hands
+	unsigned long doubleWins;
+	unsigned long doublePushes;
+	unsigned long splits;		  // Split decisions
+	unsigned long splitHands;	  // Hands the splits ended with
+	unsigned long splitWins;
+	unsigned long surrenders;
+	unsigned long insurances;	  // Insurance bets taken
+	unsigned long insuranceWins;
+	// Side bets, one bet each on every dealt hand (see sidebets.hpp)
+	unsigned long long pairsOutcomes[PAIRS_OUTCOMES_NR];
+	unsigned long long threeOutcomes[THREE_OUTCOMES_NR];
+}TBlackJackStats;
+
 /*
  * The blackjack class
- * Carry out Blackjack Hands with one player and a dealer
+ * Carry out Blackjack Hands with one player and a dealer, under the compile
+ * time rule set TRules (see rules.hpp). The player can hit, stand, double
+ * down, split up to TRules::MAX_SPLIT_HANDS hands, surrender and take
+ * insurance. Split hands live in a fixed stack of hands reused every round.
+ * TObserver receives the events of every hand (see observer.hpp).
  * */
+template <typename TRules, typename TObserver = TNullObserver>
 class TBlackjack
 	{
-	// Typedefs
-	typedef struct __TBlackJackStats__ {
-		unsigned long successPlyd;   // Successfully played hands
-		unsigned long pushes;
-		unsigned long userBusts;
-		unsigned long dealerBusts;
-		unsigned long userWins;
-		unsigned long dealerWins;
-		unsigned long errors;    // General processing errors
-	}TBlackJackStats;
-
 	enum {
+		HAND_OUTCOME_SURRENDERED = -7,
 		HAND_OUTCOME_CONTINUE= -6,		// Continue playing hand
 		HAND_OUTCOME_UWON		= -5,		// User won
 		HAND_OUTCOME_DWON		= -4,		// Dealer won
@@ -45,13 +74,25 @@ class TBlackjack
 
 	// Number of plays per shuffle
 	static const unsigned int SHUFFLE_PERIOD_PLAYS   = 6;
-	static const unsigned int BLACKJACK_VAL = 21;
+	static const unsigned int BLACKJACK_VAL = TRules::BLACKJACK_VAL;
 	static const unsigned int INIT_CARDS_NR = 2;
 	static const unsigned int ACE_MIN_VAL 	 = 1;
 	static const unsigned int ACE_MAX_VAL   = 11;
+	static const unsigned int MAX_SPLIT_HANDS = TRules::MAX_SPLIT_HANDS;
 	// Function members
 	public:
-		TBlackjack(void) {memset((void *)&mStats, 0, sizeof(mStats));};
+		TBlackjack(void) : mStrategy(NULL), mAdvisor(NULL), mHints(NULL), mVerbose(true),
+			mShufflePeriod(SHUFFLE_PERIOD_PLAYS), mLastNet(0.0)
+			{init();};
+		/*
+		 * Automated blackjack. The player decisions are taken from the argued
+		 * strategy instead of the console and nothing is printed.
+		 */
+		TBlackjack(const TDealer &dealer, const TStrategy *strategy) :
+			mDealer(dealer), mStrategy(strategy), mAdvisor(NULL), mHints(NULL),
+			mVerbose(strategy == NULL),
+			mShufflePeriod(SHUFFLE_PERIOD_PLAYS * dealer.getDecks()), mLastNet(0.0)
+			{init();};
 		~TBlackjack(void){};
 		int playHand(TCards &cardDeck);
 		/*
@@ -73,8 +114,57 @@ class TBlackjack
 		int printStats (void);
 		// Get successfully played hands
 		unsigned int getSuccessPlHandsCount(void) {return mStats.successPlyd;};
+		// The next hand starts with a shuffle
+		bool isShuffleDue(void) const {return !(mStats.successPlyd % mShufflePeriod);};
+		// Hands played between shuffles. Defaults to six hands per deck
+		void setShufflePeriod(unsigned int hands) {mShufflePeriod = hands ? hands : 1;};
+		// Strategy whose decision is suggested at each console prompt. NULL, none
+		void setAdvisor(const TStrategy *advisor) {mAdvisor = advisor;};
+		// Engine hinting the expected value of every option at each console prompt. NULL, none
+		void setHints(TAdviceEngine<TRules> *hints) {mHints = hints;};
+		// Hand events observer
+		TObserver &getObserver(void) {return mObserver;};
+		const TObserver &getObserver(void) const {return mObserver;};
+		// Dealer dealing the hands (card counts)
+		const TDealer &getDealer(void) const {return mDealer;};
+		// Dealer dealing the hands, to set how its next shoes are shuffled
+		TDealer &getDealer(void) {return mDealer;};
+		/*
+		 * Start the next hand at the shoe position of an engine dealing the same
+		 * shoes (see TDealer::followShoe()). The caller copies the leader's cards.
+		 */
+		void followShoe(const TBlackjack &leader) {mDealer.followShoe(leader.mDealer);};
+		/*
+		 * Player net result of the last played hand, in bets, split hands,
+		 * doubles, surrender and insurance included
+		 * @return: +1 won, -1 lost, 0 push or error, natural payout on a natural
+		 */
+		double getLastHandNet(void) const {return mLastNet;};
+		// Get game results stats
+		const TBlackJackStats &getStats(void) const {return mStats;};
+		/*
+		 * Player net result in bets, naturals paid at the rule set payout
+		 * @return: Won bets minus lost bets
+		 */
+		double getNetUnits(void) const
+			{
+			double doubleLosses = (double)(mStats.doubles - mStats.doubleWins -
+					mStats.doublePushes);
+			return (double)mStats.userWins - (double)mStats.dealerWins +
+					(double)mStats.userNaturals * (double)(TRules::NATURAL_PAY_NUM -
+					TRules::NATURAL_PAY_DEN) / (double)TRules::NATURAL_PAY_DEN +
+					// Doubled hands win or lose a second bet
+					(double)mStats.doubleWins - doubleLosses +
+					// Surrendered hands get half the bet back
+					(double)mStats.surrenders / 2.0 +
+					// Insurance is half a bet
+					(double)mStats.insuranceWins * (double)TRules::INSURANCE_PAY / 2.0 -
+					(double)(mStats.insurances - mStats.insuranceWins) / 2.0;
+			};
 
 	private:
+		// Clear the stats and reserve the hands stack
+		void init(void);
 		// Increment successfully played hands
 		unsigned int incSuccessPlHandsCount(void) {return ++mStats.successPlyd;};
 		/*
@@ -84,6 +174,20 @@ class TBlackjack
 		 */
 		int drawInitialCards (TDealer &dealer, TCards &cardDeck,
 				TCards &dealerCards,TCards	&userCards);
+		/*
+		 * Player decision for the current hand, from the strategy if automated or
+		 * from the console otherwise
+		 * @return: - Player action (hit, stand or an allowed ALLOW_* one). Otherwise,
+		 * 			Error requesting decision
+		 */
+		int userDecision (const int score, const bool soft, const TCard &upCard,
+				const TCards &cards, const unsigned int allowed);
+		/*
+		 * Offer insurance on an Ace up card, from the strategy if automated or
+		 * from the console otherwise
+		 * @return: - True - Player takes insurance
+		 */
+		bool offerInsurance (void);
 		/*
 		 * Function: 		getScore
 		 * Description:	Calculates maximum potential cards score value from a hand
@@ -100,18 +204,20 @@ class TBlackjack
 		int printCards (TCards &cards);
 
 		/*
-		 * Function: playerReqCards
-		 * Description:User requests cards as preferred.
+		 * Function: userReqCards
+		 * Description:User plays the hand at the argued hand stack position.
+		 * 				Splits push new hands on the stack.
 		 * @return:	 User score or
-		 * 			- HAND_OUTCOME_BUSTED  - User went over BLACKJACK_VAL
-		 * 			- HAND_OUTCOME_ERROR	  - Error processing processing this function
+		 * 			- HAND_OUTCOME_BUSTED  		- User went over BLACKJACK_VAL
+		 * 			- HAND_OUTCOME_SURRENDERED - User surrendered
+		 * 			- HAND_OUTCOME_ERROR	  		- Error processing processing this function
 		 */
-		int userReqCards (TDealer &dealer, TCards &cardDeck, TCards &userCards);
+		int userReqCards (TDealer &dealer, TCards &cardDeck, unsigned int hand);
 
 		/*
 		 * Function: dealerReqCards
 		 * Description:Dealer requests cards as rules dictate.
-		 * Rules: 	- Dealer must hit on soft 17.
+		 * Rules: 	- Dealer must hit on soft 17 (unless TRules::HIT_SOFT_17 is false).
 		 * 			- Dealer must stand on hard 17 or higher soft or hard hands.
 		 * @return:	 User score or
 		 * 			- HAND_OUTCOME_BUSTED  - Dealer went over BLACKJACK_VAL
@@ -123,12 +229,17 @@ class TBlackjack
 		/*
 		 * User plays hand with dealer
 		 * Rule:	- House (dealer) wins in an event of a score tie even if both
-		 * 		dealer and player have an score of 21.
+		 * 		dealer and player have an score of 21, unless TRules::PUSH_ON_TIE.
 		 *
 		 * @return: - 0 - Success playing hand with dealer. Otherwise
 		 * 			Error
 		 */
-		int compareScores (const int userScore, const int dealerScore);
+		int compareScores (const int userScore, const int dealerScore, const unsigned int hand);
+		/*
+		 * Account the outcome of a stack hand: stats and last hand net result
+		 * (HAND_OUTCOME_UWON, DWON, PUSHED, BUSTED or SURRENDERED)
+		 */
+		void settleHand (const unsigned int hand, const int outcome);
 
 		/*
 		 * Function:	verifyNatural
@@ -139,6 +250,21 @@ class TBlackjack
 	private:
 		// Variable members
 		TBlackJackStats mStats;
+		TDealer mDealer;
+		const TStrategy *mStrategy;  // Automated player. NULL when playing from the console
+		const TStrategy *mAdvisor;	  // Console prompt suggestions. NULL, none
+		TAdviceEngine<TRules> *mHints;  // Console prompt expected values. NULL, none
+		bool mVerbose;					  // Print game progress
+		unsigned int mShufflePeriod;  // Hands played between shuffles
+		double mLastNet;				  // Player net result of the last hand, in bets
+		// Hands, kept across plays to avoid reallocations. mUserHands is the
+		// split stack, mUserHandsNr hands in use
+		TCards mUserHands[MAX_SPLIT_HANDS];
+		bool mDoubled[MAX_SPLIT_HANDS];
+		unsigned int mUserHandsNr;
+		TCards mDealerCards;
+		const TSideBetTables *mSideBets;
+		TObserver mObserver;
 	};
 
 #endif /* __BLACKJACK_HPP__ */
@@ -0,0 +1,176 @@
+/******************************************************************************/
+/*!
+ * @file:					  compare_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-compare. Plays two player policies hand by hand on
+ *  					the same shoes and reports their edge difference.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "misc.hpp"
+#include "rules.hpp"
+#include "simulator.hpp"
+#include "strategy.hpp"
+
+/* Library includes */
+#include <getopt.h>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":hn:d:P:Q:T:S:sp6";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "hands",   		required_argument,   NULL,    'n'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "policy",   		required_argument,   NULL,    'P'   },
+   { "against",  		required_argument,   NULL,    'Q'   },
+   { "tables",   		required_argument,   NULL,    'T'   },
+   { "seed",   		required_argument,   NULL,    'S'   },
+   { "s17",   		no_argument,         NULL,    's'   },
+   { "push-ties",		no_argument,         NULL,    'p'   },
+   { "pay-6-5",		no_argument,         NULL,    '6'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-compare: Edge difference of two player policies playing the same" << std::endl;
+   std::cout << "shoes hand by hand (common random numbers)" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -P, --policy NAME, -Q, --against NAME" << std::endl;
+   std::cout << "      Policies compared (default full against basic): basic, mimic," << std::endl;
+   std::cout << "      never-bust, tables or full." << std::endl;
+   std::cout << "   -n, --hands N" << std::endl;
+   std::cout << "      Hands each policy plays (default 1000000)." << std::endl;
+   std::cout << "   -d, --decks N, -S, --seed SEED" << std::endl;
+   std::cout << "      Shoe decks (default 6) and seed (default 1)." << std::endl;
+   std::cout << "   -T, --tables FILE" << std::endl;
+   std::cout << "      Table file for the 'tables' policy (see blackjack-tablegen)." << std::endl;
+   std::cout << "   -s, --s17, -p, --push-ties, -6, --pay-6-5" << std::endl;
+   std::cout << "      Rule variants, as for blackjack." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Policy of an option argument
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (unknown policy)
+ */
+	int
+parsePolicy
+	(
+	const char 		*name,		// Policy name
+	unsigned int 	&policy		// Out argument, TSimPolicy
+	)
+	{
+	TPolicyType type;
+	if (policyFromName(name, type))
+		{
+		log(LOG_ERR, "Unknown policy\n");
+		return -1;
+		}
+	policy = type;
+	return 0;
+	}
+
+/* Top level and binary entry point for the policy comparison
+ * @return: 0 - Success. Otherwise,
+ * 			Error
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	TSimConfig config;
+	simInitConfig(&config);
+	config.decks = 6;
+	config.seed = 1;
+	config.policy = SIM_POLICY_FULL_BASIC;
+	config.pairedPolicy = SIM_POLICY_BASIC;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'n':
+				config.hands = strtoull(optarg, NULL, 10);
+				break;
+			case 'd':
+				config.decks = strtoul(optarg, NULL, 10);
+				break;
+			case 'P':
+				if (parsePolicy(optarg, config.policy))
+					return -1;
+				break;
+			case 'Q':
+				if (parsePolicy(optarg, config.pairedPolicy))
+					return -1;
+				break;
+			case 'T':
+				config.tablesPath = optarg;
+				break;
+			case 'S':
+				config.seed = strtoull(optarg, NULL, 10);
+				break;
+			case 's':
+				config.rules |= RULES_STAND_SOFT_17;
+				break;
+			case 'p':
+				config.rules |= RULES_PUSH_TIES;
+				break;
+			case '6':
+				config.rules |= RULES_PAY_6_5;
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+
+	TSimResults results;
+	if (simulate(&config, &results) || !results.handsPlayed)
+		{
+		log(LOG_ERR, "Invalid simulation configuration\n");
+		return -1;
+		}
+	double n = (double)results.handsPlayed;
+	printf("%llu paired hands (%u decks, rules 0x%x, seed %llu), %.3f s\n",
+			results.handsPlayed, config.decks, config.rules, config.seed,
+			results.elapsedSecs);
+	printf("  %-10s EV %+.6f bets per hand\n", policyName((TPolicyType)config.policy),
+			results.netUnits / n);
+	printf("  %-10s EV %+.6f bets per hand\n", policyName((TPolicyType)config.pairedPolicy),
+			results.pairedNetUnits / n);
+	printf("  Difference %+.6f +/- %.6f (paired standard error)\n", results.diffMean,
+			results.diffStdErr);
+	printf("  Two independent runs would have a standard error of %.6f\n",
+			results.unpairedStdErr);
+	if (results.diffStdErr > 0.0)
+		printf("  Hands needed for the same confidence cut %.1fx\n",
+				(results.unpairedStdErr * results.unpairedStdErr) /
+				(results.diffStdErr * results.diffStdErr));
+	return 0;
+	}
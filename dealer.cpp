@@ -12,24 +12,255 @@
 /*
  * Library includes
  */
+#include <chrono>
 #include <random>
 #include <iostream>
 #include <sstream>
+#include <string.h>
 
 /* Local includes */
 #include "misc.hpp"
 #include "dealer.hpp"
+#include "shoefile.hpp"
 
 /* Private defines */
 #define MAX_CARD_VALUE  10
 #define ACE_VALUE			1
+#define JACK_RANK			11
+#define KING_RANK			13
+
+/* Hi-Lo count tag per card value, indexed by value (Ace is 1) */
+static const int hiLoTags[MAX_CARD_VALUE + 1] =
+	{
+	0, -1, 1, 1, 1, 1, 1, 0, 0, 0, -1
+	};
+
+/* Rank names for cardName(), indexed by rank */
+static const char *rankNames[] =
+	{
+	"", "Ace", "2", "3", "4", "5", "6", "7", "8", "9", "10", "Jack", "Queen", "King"
+	};
+
+/* Suit names for cardName(), indexed by TCardSuit */
+static const char *suitNames[SUITS_NR] =
+	{
+	"spades", "clubs", "diamonds", "hearts"
+	};
+
+/*
+ * Human readable card name (ex: "Queen of hearts")
+ * @return: Card name
+ */
+	std::string
+cardName
+	(
+	const TCard &card
+	)
+	{
+	if ((card.rank < 1) || (card.rank > 13) || (card.suit >= SUITS_NR))
+		return std::string("Unknown card");
+
+	return std::string(rankNames[card.rank]) + " of " + suitNames[card.suit];
+	}
+
+TDealer::TDealer
+	(
+	void
+	) :
+	mDecks(1),
+	mSeeded(false),
+	mVerbose(true),
+	mRunningCount(0),
+	mShoeSize(0),
+	mDealt(0),
+	mShuffles(0),
+	mTopNr(0),
+	mUnshuffled(0),
+	mWeighted(false),
+	mSuitWeight(1.0),
+	mWeightedCards(0),
+	mMaxWeight(1.0),
+	mWeightLeft(0.0),
+	mLikelihood(1.0),
+	mSource(NULL),
+	mSourceShoe(NULL),
+	mSourceShoes(0),
+	mShoeFile(NULL),
+	mFileFirst(0),
+	mFileCount(0),
+	mFileNext(0)
+	{
+	memset((void *)mRemoved, 0, sizeof(mRemoved));
+	memset((void *)mLeft, 0, sizeof(mLeft));
+	memset((void *)mTopValues, 0, sizeof(mTopValues));
+	memset((void *)mRankWeights, 0, sizeof(mRankWeights));
+	memset((void *)mWeights, 0, sizeof(mWeights));
+	}
 
 TDealer::TDealer
 	(
+	unsigned long long seed,		// Shuffle generator seed
+	unsigned int decks,				// Decks in the shoe
+	bool verbose						// Log dealer operations
+	) :
+	mDecks(decks ? decks : 1),
+	mSeeded(true),
+	mVerbose(verbose),
+	mRng(seed),
+	mRunningCount(0),
+	mShoeSize(0),
+	mDealt(0),
+	mShuffles(0),
+	mTopNr(0),
+	mUnshuffled(0),
+	mWeighted(false),
+	mSuitWeight(1.0),
+	mWeightedCards(0),
+	mMaxWeight(1.0),
+	mWeightLeft(0.0),
+	mLikelihood(1.0),
+	mSource(NULL),
+	mSourceShoe(NULL),
+	mSourceShoes(0),
+	mShoeFile(NULL),
+	mFileFirst(0),
+	mFileCount(0),
+	mFileNext(0)
+	{
+	memset((void *)mRemoved, 0, sizeof(mRemoved));
+	memset((void *)mLeft, 0, sizeof(mLeft));
+	memset((void *)mTopValues, 0, sizeof(mTopValues));
+	memset((void *)mRankWeights, 0, sizeof(mRankWeights));
+	memset((void *)mWeights, 0, sizeof(mWeights));
+	}
+
+/*
+ * Cards left out of every shuffled shoe, 'removed[rank - 1]' cards of
+ * each rank
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (more cards removed than the shoe holds)
+ */
+	int
+TDealer::setRemovedRanks
+	(
+	const unsigned int removed[RANKS_NR]		// Cards removed per rank
+	)
+	{
+	unsigned int total = 0;
+	for (unsigned int i = 0; i < RANKS_NR; i++)
+		{
+		if (removed[i] > (mDecks * SUITS_NR))
+			return -1;
+		total += removed[i];
+		}
+	// Keep at least one card so a shuffled shoe is never empty
+	if (total >= (mDecks * SUITS_NR * RANKS_NR))
+		return -1;
+
+	memcpy((void *)mRemoved, (const void *)removed, sizeof(mRemoved));
+	// Stratified shoes keep the filled decks between shuffles
+	mCardDeckTmp.clear();
+	return 0;
+	}
+
+/*
+ * Stratified shoes: a card of each argued value on top of every shuffle
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (more than MAX_TOP_CARDS values or an invalid value)
+ */
+	int
+TDealer::setTopValues
+	(
+	const unsigned int *values,		// Top card values in dealing order, 0 any
+	unsigned int 		 valuesNr		// Top cards. 0, plain shuffles
+	)
+	{
+	if (valuesNr > MAX_TOP_CARDS)
+		return -1;
+	for (unsigned int i = 0; i < valuesNr; i++)
+		if (values[i] > MAX_CARD_VALUE)
+			return -1;
+
+	if (valuesNr)
+		memcpy((void *)mTopValues, (const void *)values, valuesNr * sizeof(*values));
+	mTopNr = valuesNr;
+	mUnshuffled = 0;
+	return 0;
+	}
+
+/*
+ * Weighted shoes: cards drawn in proportion to their rank weight, times the
+ * suit weight for the suit of the first card of the shoe
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (a weight not positive)
+ */
+	int
+TDealer::setDrawWeights
+	(
+	const double *rankWeights,		// RANKS_NR weights, Ace first. NULL, plain shoe
+	double 		 suitWeight,		// Weight of the suit of the first card dealt
+	unsigned int weightedCards		// Cards of a shoe drawn weighted. 0, every card
+	)
+	{
+	mUnshuffled = 0;
+	mLikelihood = 1.0;
+	if (!rankWeights)
+		{
+		mWeighted = false;
+		return 0;
+		}
+	if (!(suitWeight > 0.0))
+		return -1;
+	double maxRank = 0.0;
+	for (unsigned int r = 0; r < RANKS_NR; r++)
+		{
+		if (!(rankWeights[r] > 0.0))
+			return -1;
+		if (rankWeights[r] > maxRank)
+			maxRank = rankWeights[r];
+		}
+	memcpy((void *)mRankWeights, (const void *)rankWeights, sizeof(mRankWeights));
+	mSuitWeight = suitWeight;
+	mWeightedCards = weightedCards;
+	mMaxWeight = maxRank * ((suitWeight > 1.0) ? suitWeight : 1.0);
+	mWeighted = true;
+	return 0;
+	}
+
+/*
+ * Draw a card of a weighted shoe with its weight and move it to the back. A
+ * card picked at random is kept with a probability of its weight over the
+ * largest one, so the draw costs a few tries whatever the shoe size.
+ */
 	void
+TDealer::drawWeighted
+	(
+	TCards &cardDeck
 	)
 	{
+	unsigned int size = cardDeck.size();
+	unsigned int sel;
+	double weight;
+	do
+		{
+		sel = mRng.bounded(size);
+		weight = mWeights[cardDeck[sel].rank - 1][cardDeck[sel].suit];
+		}
+	while (mRng.uniform() * mMaxWeight >= weight);
+	// Plain draw probability 1 / size over weighted draw weight / weight left
+	mLikelihood *= mWeightLeft / ((double)size * weight);
+	mWeightLeft -= weight;
+	std::swap(cardDeck[sel], cardDeck.back());
+	if (mDealt || (mSuitWeight == 1.0))
+		return;
 
+	// First card of the shoe: its suit weighs more from now on
+	unsigned int suit = cardDeck.back().suit;
+	for (unsigned int r = 0; r < RANKS_NR; r++)
+		mWeights[r][suit] *= mSuitWeight;
+	mWeightLeft = 0.0;
+	for (unsigned int i = 0; i + 1 < size; i++)
+		mWeightLeft += mWeights[cardDeck[i].rank - 1][cardDeck[i].suit];
 	}
 
 /*!
@@ -43,16 +274,121 @@ TDealer::dealCard
 	{
 
 	if (cardDeck.empty()) {
-		log  (LOG_ERR, "\nCard deck empty, shuffling\n\n");
+		if (mVerbose)
+			log  (LOG_ERR, "\nCard deck empty, shuffling\n\n");
 		shuffle(cardDeck);
 	}
 
+	// Weighted shoe: the next card is drawn with its weight, past the weighted
+	// ones at random. Stratified shoe: drawn from the unshuffled ones now
+	if (mWeighted && (!mWeightedCards || (mDealt < mWeightedCards)))
+		drawWeighted(cardDeck);
+	else if (mWeighted || (cardDeck.size() <= mUnshuffled))
+		{
+		std::swap(cardDeck[mRng.bounded(cardDeck.size())], cardDeck.back());
+		mUnshuffled = cardDeck.size() - 1;
+		}
 	TCard card = cardDeck.back();
 	cardDeck.pop_back();
+	mRunningCount += hiLoTags[card.value];
+	mLeft[card.value]--;
+	mDealt++;
 
 	return card;
 	}
 
+/*
+ * Hi-Lo true count: running count per deck left in the shoe
+ * @return: True count
+ */
+	double
+TDealer::getTrueCount
+	(
+	const TCard *hidden		// Dealt card left out of the count or NULL
+	) const
+	{
+	int runningCount = mRunningCount - (hidden ? hiLoTags[hidden->value] : 0);
+	unsigned int left = (mShoeSize > mDealt) ? (mShoeSize - mDealt) : 1;
+	if (hidden)
+		left++;
+	return (double)runningCount * (double)CARDS_PER_DECK / (double)left;
+	}
+
+/*
+ * Take the shoe position of a dealer shuffling the same shoes
+ */
+	void
+TDealer::followShoe
+	(
+	const TDealer &leader		// Dealer shuffling the same shoes
+	)
+	{
+	mRunningCount = leader.mRunningCount;
+	mShoeSize = leader.mShoeSize;
+	mDealt = leader.mDealt;
+	memcpy((void *)mLeft, (const void *)leader.mLeft, sizeof(mLeft));
+	// One of them ran out of cards mid hand and shuffled out of turn
+	if (mShuffles != leader.mShuffles)
+		{
+		mRng = leader.mRng;
+		mShuffles = leader.mShuffles;
+		mFileNext = leader.mFileNext;
+		}
+	}
+
+/*
+ * Fill the temporal deck with 'mDecks' decks in their fresh order
+ */
+	void
+TDealer::fillDecks
+	(
+	void
+	)
+	{
+	TCard card;
+	mCardDeckTmp.clear();
+
+	for (unsigned int deck = 0; deck < mDecks; deck++)
+		{
+		// Ace to 10
+		card.isFace = false;
+		for (unsigned int i = 1; i <= MAX_CARD_VALUE; i++)
+			{
+			card.value = i;
+			card.rank = i;
+			for (unsigned int suit = 0; suit < SUITS_NR; suit++)
+				{
+				card.suit = suit;
+				mCardDeckTmp.push_back(card);
+				}
+			}
+		// Insert higher ranks: Jacks, Queens and Kings
+		card.isFace = true;
+		card.value = MAX_CARD_VALUE;
+		for (unsigned int rank = JACK_RANK; rank <= KING_RANK; rank++)
+			{
+			card.rank = rank;
+			for (unsigned int suit = 0; suit < SUITS_NR; suit++)
+				{
+				card.suit = suit;
+				mCardDeckTmp.push_back(card);
+				}
+			}
+		}
+
+	// Leave removed cards out, last ones laid first
+	for (unsigned int i = 0; i < RANKS_NR; i++)
+		{
+		unsigned int left = mRemoved[i];
+		for (unsigned int pos = mCardDeckTmp.size(); left && pos; pos--)
+			if (mCardDeckTmp[pos - 1].rank == (i + 1))
+				{
+				mCardDeckTmp.erase(mCardDeckTmp.begin() + (pos - 1));
+				left--;
+				}
+		}
+	}
+
 /*
  * Dealer shuffles card
  * @return: - 0 - Success shuffling cards. Otherwise,
@@ -67,112 +403,224 @@ TDealer::shuffle
 	TCards &cardDeck
 	)
 	{
-	log (LOG_INFO, "Shuffling...\n\n");
-	TCard card;
-	// Temporal card storage
-	TCards cardDeckTmp;
+	if (mVerbose)
+		log (LOG_INFO, "Shuffling...\n\n");
+	// Shared shoe the leader shuffled right after the last one dealt
+	if (mSource && (mShuffles + 1 == mSource->mShuffles))
+		{
+		cardDeck.assign(mSourceShoe->begin(), mSourceShoe->end());
+		followShoe(*mSource);
+		mSourceShoes++;
+		return 0;
+		}
+	if (mShoeFile)
+		return shuffleFile(cardDeck);
+	if (mTopNr || mWeighted)
+		return shuffleTop(cardDeck);
 	// Remove all remaining cards on the deck
 	cardDeck.clear();
 
-	// Fill card deck
-	for (unsigned int i = 1; i <= MAX_CARD_VALUE; i++)
-		{
-		card.value = i;
-		card.isFace = false;
-		if (i == ACE_VALUE)
-			{
-			card.name = "Ace of spades";
-			cardDeckTmp.push_back(card);
-			card.name = "Ace of clubs";
-			cardDeckTmp.push_back(card);
-			card.name = "Ace of diamonds";
-			cardDeckTmp.push_back(card);
-			card.name = "Ace of hearts";
-			cardDeckTmp.push_back(card);
-			}
-		else
-			{
-			std::stringstream ss;
-			ss << i;    // Extremely unlikely to fail
-			card.name = ss.str() + " of spades";
-			cardDeckTmp.push_back(card);
-			card.name = ss.str() + " of clubs";
-			cardDeckTmp.push_back(card);
-			card.name = ss.str() + " of diamonds";
-			cardDeckTmp.push_back(card);
-			card.name = ss.str() + " of hearts";
-			cardDeckTmp.push_back(card);
-			card.value = i;
-			}
-		}
-	// Insert higher ranks
-	// Jacks
-	card.isFace = true;
-	card.name = "Jack of spades";
-	cardDeckTmp.push_back(card);
-	card.name = "Jack of clubs";
-	cardDeckTmp.push_back(card);
-	card.name = "Jack of diamonds";
-	cardDeckTmp.push_back(card);
-	card.name = "Jack of hearts";
-	cardDeckTmp.push_back(card);
-
-	// Queens
-	card.name = "Queen of spades";
-	cardDeckTmp.push_back(card);
-	card.name = "Queen of clubs";
-	cardDeckTmp.push_back(card);
-	card.name = "Queen of diamonds";
-	cardDeckTmp.push_back(card);
-	card.name = "Queen of hearts";
-	cardDeckTmp.push_back(card);
-
-	// Kings
-	card.name = "King of spades";
-	cardDeckTmp.push_back(card);
-	card.name = "King of clubs";
-	cardDeckTmp.push_back(card);
-	card.name = "King of diamonds";
-	cardDeckTmp.push_back(card);
-	card.name = "King of hearts";
-	cardDeckTmp.push_back(card);
-
-	// Now shuffle
+	// Fill card deck. The fresh decks are kept for the next shuffle
+	if (mCardDeckTmp.empty())
+		fillDecks();
+	TCards &cardDeckTmp = mCardDeckTmp;
+	mRunningCount = 0;
+	mShoeSize = cardDeckTmp.size();
+	mDealt = 0;
+	mShuffles++;
+	memset((void *)mLeft, 0, sizeof(mLeft));
+	for (unsigned int i = 0; i < cardDeckTmp.size(); i++)
+		mLeft[cardDeckTmp[i].value]++;
+
+	// Unseeded dealers deal from system entropy, a fresh seed every shoe
+	if (!mSeeded)
+		reseed();
+
+	/*
+	 * Fisher-Yates shuffle with the dealer's own batch generator: every order
+	 * equally likely, a buffered value and a multiply per card. Seeded dealers
+	 * reproduce their shoes.
+	 */
+	cardDeck.assign(cardDeckTmp.begin(), cardDeckTmp.end());
+	for (unsigned int i = cardDeck.size(); i > 1; i--)
+		std::swap(cardDeck[i - 1], cardDeck[mRng.bounded(i)]);
+	return 0;
+	}
+
+/*
+ * Restart the generator from 256 bits of system entropy. Systems without a
+ * random device fall back to the clock, never to a fixed seed.
+ */
+	void
+TDealer::reseed
+	(
+	void
+	)
+	{
+	uint64_t entropy[RNG_ENTROPY_WORDS];
 	try
 		{
 		std::random_device rd;
-		while(!cardDeckTmp.empty())
-			{
-			/*
-			 * Selecting randomly a card from the tmp deck to insert on the function
-			 * argued card deck
-			 */
-			unsigned int sel = rd() % cardDeckTmp.size();
-			TCard card = cardDeckTmp[sel];
-			cardDeckTmp.erase(cardDeckTmp.begin() + sel);
-			cardDeck.push_back(card);
-			}
+		for (unsigned int i = 0; i < RNG_ENTROPY_WORDS; i++)
+			entropy[i] = ((uint64_t)rd() << 32) | rd();
 		}
 	catch (std::exception &e)
 		{
-		log (LOG_INFO, "System does not implement true random generator diverting to"
-				 " pseudo number generator");
-		/*
-		 * Selecting randomly a card from the tmp deck to insert on the function
-		 * argued card deck. Using a uniform distribution to allow equal probabilities
-		 * for card selection from the deck.
-		 */
-		std::default_random_engine generator;
-		while(!cardDeckTmp.empty())
-			{
-			std::uniform_int_distribution<unsigned int> uniDist(0, cardDeckTmp.size() - 1);
-			unsigned int sel = uniDist(generator);
-			TCard card = cardDeckTmp[sel];
-			cardDeckTmp.erase(cardDeckTmp.begin() + sel);
-			cardDeck.push_back(card);
-			}
+		static bool logged = false;
+		if (!logged)
+			log (LOG_INFO, "System does not implement true random generator diverting to"
+					 " pseudo number generator seeded from the clock\n");
+		logged = true;
+		uint64_t now = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+		for (unsigned int i = 0; i < RNG_ENTROPY_WORDS; i++)
+			entropy[i] = mixSeed(now ^ (uint64_t)(uintptr_t)this, mShuffles * RNG_ENTROPY_WORDS + i);
+		}
+	mRng.seed(entropy, RNG_ENTROPY_WORDS);
+	}
+
+/*
+ * Corpus shoes: deal the shoes of a shoe file instead of shuffling. The card
+ * codes of the shoes dealt are checked here, so that shuffleFile() can map
+ * them without a test per card even when the corpus was never verified.
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (the file shoes are not of the dealer deck count, no such
+ * 			shoes or a code is not a card code)
+ */
+	int
+TDealer::setShoeFile
+	(
+	const TShoeFile 		*file,		// Open shoe file or NULL
+	unsigned long long 	first,		// First shoe dealt
+	unsigned long long 	count			// Shoes dealt before starting again. 0, to the end
+	)
+	{
+	int ret = -1;   // Assume the shoes do not fit the dealer
+	if (file)
+		{
+		// Corpus shoes are full shoes
+		for (unsigned int r = 0; r < RANKS_NR; r++)
+			if (mRemoved[r])
+				return ret;
+		if ((file->getDecks() != mDecks) || (first >= file->getShoesNr()) ||
+				(count > file->getShoesNr() - first) ||
+				file->checkCodes(first, count ? count : file->getShoesNr() - first))
+			return ret;
+		}
+	mShoeFile = file;
+	mFileFirst = first;
+	mFileCount = (file && !count) ? file->getShoesNr() - first : count;
+	mFileNext = 0;
+	ret = 0;
+	return ret;
+	}
+
+/*
+ * Shuffle taking the next shoe of the shoe file: the card codes are mapped to
+ * cards, no generator draws
+ * @return: - 0 - Success
+ */
+	int
+TDealer::shuffleFile
+	(
+	TCards &cardDeck
+	)
+	{
+	const TShoeFile &file = *mShoeFile;
+	const unsigned char *codes = file.getShoe(mFileFirst + mFileNext);
+	unsigned int size = file.getCardsPerShoe();
+	if (++mFileNext == mFileCount)
+		mFileNext = 0;
+	cardDeck.resize(size);
+	memset((void *)mLeft, 0, sizeof(mLeft));
+	for (unsigned int i = 0; i < size; i++)
+		{
+		cardDeck[i] = file.getCard(codes[i]);
+		mLeft[cardDeck[i].value]++;
 		}
+	mRunningCount = 0;
+	mShoeSize = size;
+	mDealt = 0;
+	mShuffles++;
 	return 0;
 	}
 
+/*
+ * Shuffle of a stratified or weighted shoe. The top cards are picked first, those of a
+ * given value at random among the shoe cards of that value, then the others
+ * among the rest. Nothing below them is shuffled: dealCard() draws each of
+ * those cards at random when it is reached, so a hand costs the cards it
+ * deals instead of a whole shoe shuffle.
+ * @return: - 0 - Success shuffling cards. Otherwise,
+ * 			Error (the shoe holds no card of a top card value)
+ */
+	int
+TDealer::shuffleTop
+	(
+	TCards &cardDeck
+	)
+	{
+	// The fresh decks are kept between stratified shuffles
+	if (mCardDeckTmp.empty())
+		fillDecks();
+	if (!mSeeded)
+		reseed();
+	cardDeck.assign(mCardDeckTmp.begin(), mCardDeckTmp.end());
+	mRunningCount = 0;
+	mShoeSize = cardDeck.size();
+	mDealt = 0;
+	mShuffles++;
+	memset((void *)mLeft, 0, sizeof(mLeft));
+	for (unsigned int i = 0; i < cardDeck.size(); i++)
+		mLeft[cardDeck[i].value]++;
+	mLikelihood = 1.0;
+	if (mWeighted)
+		{
+		// Drawn as they are dealt, nothing to lay on top
+		for (unsigned int r = 0; r < RANKS_NR; r++)
+			for (unsigned int s = 0; s < SUITS_NR; s++)
+				mWeights[r][s] = mRankWeights[r];
+		mWeightLeft = 0.0;
+		for (unsigned int i = 0; i < cardDeck.size(); i++)
+			mWeightLeft += mWeights[cardDeck[i].rank - 1][cardDeck[i].suit];
+		return 0;
+		}
 
+	unsigned int left[MAX_CARD_VALUE + 1];
+	memcpy((void *)left, (const void *)mLeft, sizeof(left));
+	unsigned int size = cardDeck.size();
+	if (mTopNr >= size)
+		return -1;
+	// Cards taken are moved past the end of the pool
+	TCard top[MAX_TOP_CARDS];
+	unsigned int pool = size;
+	// Cards of a value first, by rejection: a few tries per card
+	for (unsigned int t = 0; t < mTopNr; t++)
+		{
+		unsigned int value = mTopValues[t];
+		if (!value)
+			continue;
+		if (!left[value])
+			return -1;
+		left[value]--;
+		unsigned int sel;
+		do
+			sel = mRng.bounded(pool);
+		while (cardDeck[sel].value != value);
+		std::swap(cardDeck[sel], cardDeck[--pool]);
+		top[t] = cardDeck[pool];
+		}
+	// Then any card among the rest
+	for (unsigned int t = 0; t < mTopNr; t++)
+		{
+		if (mTopValues[t])
+			continue;
+		unsigned int sel = mRng.bounded(pool);
+		std::swap(cardDeck[sel], cardDeck[--pool]);
+		top[t] = cardDeck[pool];
+		}
+	// Laid in dealing order, the first one dealt last in the vector
+	for (unsigned int t = 0; t < mTopNr; t++)
+		cardDeck[size - 1 - t] = top[t];
+	mUnshuffled = size - mTopNr;
+	return 0;
+	}
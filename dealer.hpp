@@ -17,19 +17,45 @@
 #include <string>
 #include <vector>
 
+/* Local includes */
+#include "rng.hpp"
+
 /* Typedefines */
 
-/* Card Structure */
+/* Card suits, in the order the dealer lays them on a fresh deck */
+typedef enum __CardSuit__
+	{
+	SUIT_SPADES,
+	SUIT_CLUBS,
+	SUIT_DIAMONDS,
+	SUIT_HEARTS,
+	SUITS_NR
+	}TCardSuit;
+
+/*
+ * Card Structure
+ * Plain data so that decks and hands can be copied and reused without
+ * allocating. The human readable name is built on demand by cardName().
+ */
 typedef struct __Card__
 	{
 	unsigned int value;
-	std::string name;
 	bool isFace;       // The card is a high Face  value card
+	unsigned char rank;  // 1 (Ace) to 13 (King)
+	unsigned char suit;  // TCardSuit
 	}TCard;
 
 /* Card deck container */
 typedef std::vector<TCard> TCards;
 
+/*
+ * Human readable card name (ex: "Queen of hearts")
+ * @return: Card name
+ */
+std::string cardName(const TCard &card);
+
+class TShoeFile;
+
 /*
  * The dealer class
  * Implements dealer options
@@ -38,13 +64,155 @@ class TDealer
 	{
 
 	public:
+		// Card ranks, Ace (1) to King (13)
+		static const unsigned int RANKS_NR = 13;
+		static const unsigned int CARDS_PER_DECK = 52;
+		// Card values, Ace (1) to 10 value cards (10)
+		static const unsigned int VALUES_NR = 10;
+		// Cards a stratified shoe lays on top (see setTopValues())
+		static const unsigned int MAX_TOP_CARDS = 4;
+
+		// Dealer shuffling every shoe from system entropy
 		TDealer(void);
+		/*
+		 * Seeded dealer dealing from a shoe of 'decks' decks. The same seed always
+		 * produces the same sequence of shuffled shoes.
+		 */
+		TDealer(unsigned long long seed, unsigned int decks = 1, bool verbose = false);
 		~TDealer(void){};
 		TCard dealCard(TCards &cardDeck);
 		int shuffle(TCards &cardDeck);
+		// Number of decks the dealer's shoe is built from
+		unsigned int getDecks(void) const {return mDecks;};
+		// Restart the generator from 256 bits of system entropy, as dealers
+		// built without a seed do every shoe
+		void reseed(void);
+		/*
+		 * Cards left out of every shuffled shoe, 'removed[rank - 1]' cards of
+		 * each rank. Used to play from reduced shoes.
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (more cards removed than the shoe holds)
+		 */
+		int setRemovedRanks(const unsigned int removed[RANKS_NR]);
+		/*
+		 * Stratified shoes: every shuffle lays a card of each argued value on
+		 * top, in dealing order (0, any card), each picked at random among the
+		 * shoe cards of its value. The cards below are drawn at random as they
+		 * are dealt. 'valuesNr' 0, plain shuffles again.
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (more than MAX_TOP_CARDS values or an invalid value)
+		 */
+		int setTopValues(const unsigned int *values, unsigned int valuesNr);
+		/*
+		 * Weighted shoes (importance sampling): every card is drawn with a
+		 * probability in proportion to the weight of its rank, times
+		 * 'suitWeight' if it is of the suit of the first card dealt from the
+		 * shoe. Only the first 'weightedCards' cards of the shoe are weighted
+		 * (0, every card), the rest are plain draws that leave the likelihood
+		 * ratio as is. Cards are drawn at random as they are dealt, shuffles
+		 * only refill the shoe. NULL rank weights, plain shuffles again.
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (a weight not positive)
+		 */
+		int setDrawWeights(const double *rankWeights, double suitWeight = 1.0,
+				unsigned int weightedCards = 0);
+		/*
+		 * Likelihood ratio of the cards dealt since the last shuffle: their
+		 * probability from a plain shoe over that from the weighted one. 1 with
+		 * plain shoes.
+		 */
+		double getLikelihood(void) const {return mLikelihood;};
+		/*
+		 * Hi-Lo running count of the cards dealt since the last shuffle
+		 * (2 to 6 count +1, 10 value cards and Aces count -1)
+		 */
+		int getRunningCount(void) const {return mRunningCount;};
+		/*
+		 * Hi-Lo true count: running count per deck left in the shoe. A dealt
+		 * card the player has not seen (the dealer hole card) can be left out.
+		 * @return: True count
+		 */
+		double getTrueCount(const TCard *hidden = NULL) const;
+		/*
+		 * Take the shoe position of a dealer shuffling the same shoes (same seed
+		 * and decks): Hi-Lo count, cards dealt and, if it shuffled more often,
+		 * its generator. Keeps two engines dealing one shoe sequence in lockstep.
+		 */
+		void followShoe(const TDealer &leader);
+		/*
+		 * Shared shoes: every scheduled shuffle takes the shoe 'leader' last
+		 * shuffled into 'shoe' (a copy, no draws) and its position, instead of
+		 * shuffling one. It is taken only if it is the next shoe of the stream,
+		 * otherwise (the shoe ran out mid hand and the dealer is ahead) the
+		 * dealer shuffles its next one itself, with the generator it follows the
+		 * leader's with. NULL, plain shuffles again.
+		 */
+		void setShoeSource(const TDealer *leader, const TCards *shoe)
+			{mSource = leader; mSourceShoe = shoe;};
+		// Shoes taken from the leader, not shuffled
+		unsigned long long getSourceShoes(void) const {return mSourceShoes;};
+		/*
+		 * Corpus shoes: every shuffle takes the next shoe of a shoe file (see
+		 * shoefile.hpp) instead of shuffling one, shoes 'first' to
+		 * 'first + count - 1' in order and from 'first' again past the last one
+		 * ('count' 0, to the end of the file). Their card codes are checked once
+		 * here. The file must stay open while the dealer deals from it. NULL,
+		 * plain shuffles again.
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (the file shoes are not of the dealer deck count, no such
+		 * 			shoes or a code is not a card code)
+		 */
+		int setShoeFile(const TShoeFile *file, unsigned long long first = 0,
+				unsigned long long count = 0);
+		/*
+		 * Cards left in the shoe per card value, Ace (1) to 10 value cards (10).
+		 * Kept up to date as cards are dealt, index 0 unused.
+		 */
+		const unsigned int *getCardsLeft(void) const {return mLeft;};
+		// Shoes shuffled and cards dealt since the last shuffle, a shoe state stamp
+		unsigned long long getShuffles(void) const {return mShuffles;};
+		unsigned int getDealt(void) const {return mDealt;};
 
 	private:
+		// Fill the temporal deck with 'mDecks' decks in their fresh order
+		void fillDecks(void);
+		// Shuffle of a stratified shoe (see setTopValues())
+		int shuffleTop(TCards &cardDeck);
+		// Move a card drawn with its weight to the back of a weighted shoe
+		void drawWeighted(TCards &cardDeck);
+		// Shuffle taking the next shoe of the shoe file (see setShoeFile())
+		int shuffleFile(TCards &cardDeck);
 
+	private:
+		unsigned int mDecks;
+		bool mSeeded;   		// Shoes from the argued seed, not reseeded from system entropy
+		bool mVerbose;			// Log dealer operations
+		TBatchRng mRng;			// Shuffles and draws, a buffer of values at a time
+		TCards mCardDeckTmp;	// Temporal card storage, kept to avoid reallocations
+		unsigned int mRemoved[RANKS_NR];	// Cards left out of the shoe per rank
+		int mRunningCount;		// Hi-Lo running count since the last shuffle
+		unsigned int mShoeSize;	// Cards in the shoe when shuffled
+		unsigned int mDealt;		// Cards dealt since the last shuffle
+		unsigned long long mShuffles;	// Shoes shuffled
+		unsigned int mLeft[VALUES_NR + 1];	// Cards left in the shoe per card value
+		unsigned int mTopValues[MAX_TOP_CARDS];	// Stratified shoe top card values
+		unsigned int mTopNr;		// Stratified shoe top cards. 0, plain shuffles
+		unsigned int mUnshuffled;	// Cards at the bottom of the shoe not shuffled yet
+		bool mWeighted;			// Weighted shoe draws
+		double mRankWeights[RANKS_NR];
+		double mSuitWeight;		// Weight of the suit of the first card of the shoe
+		unsigned int mWeightedCards;	// Cards of a shoe drawn weighted. 0, every card
+		double mWeights[RANKS_NR][SUITS_NR];	// Weighted shoe card weights, per rank and suit
+		double mMaxWeight;
+		double mWeightLeft;		// Weight of the cards left in the shoe
+		double mLikelihood;		// Likelihood ratio of the draws since the last shuffle
+		const TDealer *mSource;	// Dealer shuffling the shared shoes. NULL, none
+		const TCards *mSourceShoe;	// Last shoe it shuffled
+		unsigned long long mSourceShoes;	// Shoes taken from it
+		const TShoeFile *mShoeFile;	// Corpus the shoes are taken from. NULL, none
+		unsigned long long mFileFirst;	// First shoe of the corpus dealt
+		unsigned long long mFileCount;	// Shoes of the corpus dealt before starting again
+		unsigned long long mFileNext;		// Next shoe, from mFileFirst
 	};
 
 #endif /* __DEALER_HPP__ */
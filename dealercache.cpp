@@ -0,0 +1,273 @@
+/******************************************************************************/
+/*!
+ * @file:					  dealercache.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the dealer outcome cache.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <chrono>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+/* Local includes */
+#include "dealercache.hpp"
+
+/* Private defines */
+#define LOW_COUNT_BITS		6		// Aces to nines
+#define TEN_COUNT_BITS		8		// 10 value cards
+#define TAG_VALID				(1ULL << 63)
+#define TAG_RULES_SHIFT		4
+
+TDealerCache::TDealerCache
+	(
+	unsigned int entries		// Entries to hold at most
+	) :
+	mShards(NULL),
+	mSets(NULL),
+	mSetsPerShard(0),
+	mSetsNr(0)
+	{
+	unsigned int shardsWays = DEALER_CACHE_SHARDS * DEALER_CACHE_WAYS;
+	mSetsPerShard = (entries + shardsWays - 1) / shardsWays;
+	if (!mSetsPerShard)
+		mSetsPerShard = 1;
+	mSetsNr = mSetsPerShard * DEALER_CACHE_SHARDS;
+	// Aligned by hand: containers do not align beyond max_align_t before C++17
+	void *mem = NULL;
+	if (posix_memalign(&mem, DEALER_CACHE_LINE, DEALER_CACHE_SHARDS * sizeof(TShard)))
+		throw std::bad_alloc();
+	mShards = (TShard *)mem;
+	for (unsigned int s = 0; s < DEALER_CACHE_SHARDS; s++)
+		new (&mShards[s]) TShard();
+	mem = NULL;
+	if (posix_memalign(&mem, DEALER_CACHE_LINE, (size_t)mSetsNr * sizeof(TSet)))
+		{
+		free(mShards);
+		throw std::bad_alloc();
+		}
+	mSets = (TSet *)mem;
+	clear();
+	}
+
+TDealerCache::~TDealerCache
+	(
+	void
+	)
+	{
+	for (unsigned int s = 0; s < DEALER_CACHE_SHARDS; s++)
+		mShards[s].~TShard();
+	free(mShards);
+	free(mSets);
+	}
+
+/*
+ * Key of an up card and shoe composition
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (a count too large to pack, the composition is not cached)
+ */
+	int
+TDealerCache::makeKey
+	(
+	const unsigned int counts[TDealer::VALUES_NR + 1],		// Cards per value, Ace (1) first
+	unsigned int 		 upCard,										// Dealer up card value
+	unsigned int 		 rules,										// TRuleFlags
+	TDealerCacheKey 	 &key											// Out argument
+	)
+	{
+	int ret = -1;   // Assume the composition does not pack
+	key.counts = 0;
+	for (unsigned int v = 1; v < TDealer::VALUES_NR; v++)
+		{
+		if (counts[v] >> LOW_COUNT_BITS)
+			return ret;
+		key.counts |= (uint64_t)counts[v] << ((v - 1) * LOW_COUNT_BITS);
+		}
+	if (counts[TDealer::VALUES_NR] >> TEN_COUNT_BITS)
+		return ret;
+	key.counts |= (uint64_t)counts[TDealer::VALUES_NR] << ((TDealer::VALUES_NR - 1) *
+			LOW_COUNT_BITS);
+	key.tag = TAG_VALID | ((uint64_t)rules << TAG_RULES_SHIFT) | upCard;
+	ret = 0;
+	return ret;
+	}
+
+/*
+ * Shard and set of a key: the high bits of the key hash pick the shard, the
+ * low ones the set
+ */
+	void
+TDealerCache::locate
+	(
+	const TDealerCacheKey &key,		// Key
+	TShard 				 *&shard,		// Out argument
+	TSet 					 *&set			// Out argument
+	)
+	{
+	uint64_t h = (key.counts ^ (key.tag * 0x9E3779B97F4A7C15ULL)) * 0xC2B2AE3D27D4EB4FULL;
+	h ^= h >> 29;
+	unsigned int s = (unsigned int)(h >> 58) % DEALER_CACHE_SHARDS;
+	unsigned int setNr = (unsigned int)(h % mSetsPerShard);
+	shard = &mShards[s];
+	set = &mSets[(size_t)s * mSetsPerShard + setNr];
+	}
+
+/*
+ * Copy out the distribution of a key and mark it recently used. One lookup
+ * every DEALER_CACHE_TIMING_SAMPLE of the thread is timed: two clock reads
+ * cost as much as a hit.
+ * @return: - true - Hit
+ */
+	bool
+TDealerCache::lookup
+	(
+	const TDealerCacheKey &key,								// Key
+	double 					 finals[DEALER_CACHE_FINALS]	// Out argument, on a hit
+	)
+	{
+	static thread_local unsigned int lookupsNr = 0;
+	bool timed = !(lookupsNr++ % DEALER_CACHE_TIMING_SAMPLE);
+	std::chrono::steady_clock::time_point start;
+	if (timed)
+		start = std::chrono::steady_clock::now();
+	TShard *shard;
+	TSet *set;
+	locate(key, shard, set);
+	bool hit = false;
+	shard->lock.lock();
+	for (unsigned int w = 0; !hit && (w < DEALER_CACHE_WAYS); w++)
+		if ((set->keys[w].tag == key.tag) && (set->keys[w].counts == key.counts))
+			{
+			memcpy((void *)finals, (const void *)set->finals[w], sizeof(set->finals[w]));
+			set->referenced |= 1 << w;
+			hit = true;
+			}
+	if (hit)
+		shard->hits++;
+	else
+		shard->misses++;
+	shard->lock.unlock();
+	if (!timed)
+		return hit;
+	unsigned long long nanos = (unsigned long long)std::chrono::duration_cast<
+			std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	(hit ? shard->timedHits : shard->timedMisses).fetch_add(1, std::memory_order_relaxed);
+	(hit ? shard->hitNanos : shard->missNanos).fetch_add(nanos, std::memory_order_relaxed);
+	return hit;
+	}
+
+/*
+ * Add the distribution of a key. A full set evicts the first entry the clock
+ * hand finds not referenced since it last passed, clearing the marks it
+ * passes over.
+ */
+	void
+TDealerCache::insert
+	(
+	const TDealerCacheKey &key,								// Key
+	const double 			 finals[DEALER_CACHE_FINALS]	// Distribution
+	)
+	{
+	TShard *shard;
+	TSet *set;
+	locate(key, shard, set);
+	std::lock_guard<std::mutex> guard(shard->lock);
+	unsigned int way = DEALER_CACHE_WAYS;
+	// Already added by another thread, or a free way
+	for (unsigned int w = 0; (way == DEALER_CACHE_WAYS) && (w < DEALER_CACHE_WAYS); w++)
+		if ((set->keys[w].tag == key.tag) && (set->keys[w].counts == key.counts))
+			way = w;
+	for (unsigned int w = 0; (way == DEALER_CACHE_WAYS) && (w < DEALER_CACHE_WAYS); w++)
+		if (!set->keys[w].tag)
+			way = w;
+	if (way == DEALER_CACHE_WAYS)
+		{
+		while (set->referenced & (1 << set->hand))
+			{
+			set->referenced &= ~(1 << set->hand);
+			set->hand = (set->hand + 1) % DEALER_CACHE_WAYS;
+			}
+		way = set->hand;
+		set->hand = (set->hand + 1) % DEALER_CACHE_WAYS;
+		shard->evictions++;
+		}
+	set->keys[way] = key;
+	memcpy((void *)set->finals[way], (const void *)finals, sizeof(set->finals[way]));
+	set->referenced |= 1 << way;
+	shard->inserts++;
+	}
+
+/*
+ * Counters added up over the shards
+ */
+	void
+TDealerCache::getStats
+	(
+	TDealerCacheStats &stats		// Out argument
+	)
+	{
+	memset((void *)&stats, 0, sizeof(stats));
+	stats.capacity = getCapacity();
+	for (unsigned int s = 0; s < DEALER_CACHE_SHARDS; s++)
+		{
+		TShard &shard = mShards[s];
+		std::lock_guard<std::mutex> guard(shard.lock);
+		stats.hits += shard.hits;
+		stats.misses += shard.misses;
+		stats.inserts += shard.inserts;
+		stats.evictions += shard.evictions;
+		stats.timedHits += shard.timedHits.load(std::memory_order_relaxed);
+		stats.timedMisses += shard.timedMisses.load(std::memory_order_relaxed);
+		stats.hitNanos += shard.hitNanos.load(std::memory_order_relaxed);
+		stats.missNanos += shard.missNanos.load(std::memory_order_relaxed);
+		const TSet *sets = &mSets[(size_t)s * mSetsPerShard];
+		for (unsigned int i = 0; i < mSetsPerShard; i++)
+			for (unsigned int w = 0; w < DEALER_CACHE_WAYS; w++)
+				stats.entries += (sets[i].keys[w].tag != 0);
+		}
+	}
+
+/*
+ * Drop every entry and reset the counters
+ */
+	void
+TDealerCache::clear
+	(
+	void
+	)
+	{
+	for (unsigned int s = 0; s < DEALER_CACHE_SHARDS; s++)
+		{
+		TShard &shard = mShards[s];
+		std::lock_guard<std::mutex> guard(shard.lock);
+		memset((void *)&mSets[(size_t)s * mSetsPerShard], 0, mSetsPerShard * sizeof(TSet));
+		shard.hits = 0;
+		shard.misses = 0;
+		shard.inserts = 0;
+		shard.evictions = 0;
+		shard.timedHits.store(0, std::memory_order_relaxed);
+		shard.timedMisses.store(0, std::memory_order_relaxed);
+		shard.hitNanos.store(0, std::memory_order_relaxed);
+		shard.missNanos.store(0, std::memory_order_relaxed);
+		}
+	}
+
+/*
+ * Dealer outcome cache of the process, built on first use
+ * @return: The cache
+ */
+	TDealerCache &
+sharedDealerCache
+	(
+	void
+	)
+	{
+	// Thread safe initialization of function statics (C++11)
+	static TDealerCache cache(DEALER_CACHE_ENTRIES);
+	return cache;
+	}
@@ -0,0 +1,152 @@
+/******************************************************************************/
+/*!
+ * @file:					  dealercache.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the dealer outcome cache: the
+ *  					dealer final score distribution of an up card and shoe
+ *  					composition, computed once and shared by every thread of
+ *  					the process.
+ *
+ *  The cache is split in DEALER_CACHE_SHARDS shards, each behind a lock of its
+ *  own on cache lines of its own, so threads only wait for one another when
+ *  their keys fall in the same shard at the same time. A shard is a set
+ *  associative table of DEALER_CACHE_WAYS entries per set: memory is fixed when
+ *  the cache is built and a full set evicts with the CLOCK (second chance)
+ *  policy, an approximation of least recently used.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __DEALERCACHE_HPP__
+#define __DEALERCACHE_HPP__
+
+/* Library includes */
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+/* Local includes */
+#include "dealer.hpp"
+
+/* Defines */
+
+// Dealer final scores: 17 to 21 and bust
+#define DEALER_CACHE_FINALS		6
+#define DEALER_CACHE_SHARDS		64
+#define DEALER_CACHE_WAYS			8
+#define DEALER_CACHE_LINE			64
+// Entries of the cache shared by the process (see sharedDealerCache())
+#define DEALER_CACHE_ENTRIES		(1 << 16)
+// Lookups per timed one, per thread: clock reads are kept off most lookups
+#define DEALER_CACHE_TIMING_SAMPLE	64
+
+/* Enumerations, type defines */
+
+/*
+ * Cache key: the cards left per value packed (Aces to nines 6 bits each, 10
+ * value cards 8 bits), the up card and the rule set
+ */
+typedef struct __DealerCacheKey__
+	{
+	uint64_t counts;
+	uint64_t tag;				// Up card value, rule flags and a valid bit
+	}TDealerCacheKey;
+
+/* Cache counters */
+typedef struct __DealerCacheStats__
+	{
+	unsigned long long hits;
+	unsigned long long misses;
+	unsigned long long inserts;
+	unsigned long long evictions;	// Entries replaced by an insert
+	unsigned long long timedHits;	// Hits timed, one lookup every DEALER_CACHE_TIMING_SAMPLE
+	unsigned long long timedMisses;
+	unsigned long long hitNanos;	// Time looking up the timed hits, locks included
+	unsigned long long missNanos;	// Time looking up the timed misses
+	unsigned int entries;			// Entries in use
+	unsigned int capacity;
+	}TDealerCacheStats;
+
+/*
+ * The dealer outcome cache class
+ * Thread safe. Entries hold copies: lookups copy the distribution out.
+ * */
+class TDealerCache
+	{
+	public:
+		// Cache of 'entries' entries, rounded up to a whole set per shard
+		TDealerCache(unsigned int entries = DEALER_CACHE_ENTRIES);
+		~TDealerCache(void);
+		/*
+		 * Key of an up card and shoe composition
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (a count too large to pack, the composition is not cached)
+		 */
+		static int makeKey(const unsigned int counts[TDealer::VALUES_NR + 1],
+				unsigned int upCard, unsigned int rules, TDealerCacheKey &key);
+		/*
+		 * Copy out the distribution of a key and mark it recently used
+		 * @return: - true - Hit
+		 */
+		bool lookup(const TDealerCacheKey &key, double finals[DEALER_CACHE_FINALS]);
+		// Add the distribution of a key, evicting an entry of its set if full
+		void insert(const TDealerCacheKey &key, const double finals[DEALER_CACHE_FINALS]);
+		// Counters added up over the shards
+		void getStats(TDealerCacheStats &stats);
+		// Drop every entry and reset the counters
+		void clear(void);
+		unsigned int getCapacity(void) const {return mSetsNr * DEALER_CACHE_WAYS;};
+
+	private:
+		/*
+		 * Set of DEALER_CACHE_WAYS entries, keys first so that a miss reads two
+		 * cache lines and a hit one or two more
+		 */
+		struct alignas(DEALER_CACHE_LINE) TSet
+			{
+			TDealerCacheKey keys[DEALER_CACHE_WAYS];
+			double finals[DEALER_CACHE_WAYS][DEALER_CACHE_FINALS];
+			unsigned char referenced;	// Way bits, used since the clock hand last passed
+			unsigned char hand;			// Clock hand
+			};
+
+		/* Shard: its lock and counters on cache lines of its own */
+		struct alignas(DEALER_CACHE_LINE) TShard
+			{
+			TShard(void) : hits(0), misses(0), inserts(0), evictions(0), timedHits(0),
+					timedMisses(0), hitNanos(0), missNanos(0) {};
+			std::mutex lock;
+			unsigned long long hits;		// Counters written under the lock
+			unsigned long long misses;
+			unsigned long long inserts;
+			unsigned long long evictions;
+			std::atomic<unsigned long long> timedHits;	// Timed out of the lock
+			std::atomic<unsigned long long> timedMisses;
+			std::atomic<unsigned long long> hitNanos;
+			std::atomic<unsigned long long> missNanos;
+			};
+
+		// Shard and set of a key
+		void locate(const TDealerCacheKey &key, TShard *&shard, TSet *&set);
+
+	private:
+		TDealerCache(const TDealerCache &);
+		TDealerCache &operator=(const TDealerCache &);
+
+	private:
+		TShard *mShards;
+		TSet *mSets;						// Shard by shard
+		unsigned int mSetsPerShard;
+		unsigned int mSetsNr;
+	};
+
+/*
+ * Dealer outcome cache of the process, shared by the advice engines it is
+ * set on (see TAdviceEngine::setDealerCache())
+ * @return: The cache, built on first use
+ */
+TDealerCache &sharedDealerCache (void);
+
+#endif /* __DEALERCACHE_HPP__ */
@@ -0,0 +1,372 @@
+/******************************************************************************/
+/*!
+ * @file:					  dealercache_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-dealercache. Worker threads ask the advice engine
+ *  					for every decision of the hands they deal, as the console
+ *  					prompts do, with no dealer outcome cache, a cache per
+ *  					thread or one cache they all share, and print the advice
+ *  					throughput and latency and the cache counters.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "advice.hpp"
+#include "dealercache.hpp"
+#include "misc.hpp"
+#include "rules.hpp"
+#include "tdigest.hpp"
+
+/* Library includes */
+#include <chrono>
+#include <getopt.h>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+/* Private defines */
+#define CACHE_DEFAULT_ADVICES		200000ULL
+#define CACHE_DEFAULT_DECKS		6
+// Shoe fraction dealt before a reshuffle
+#define CACHE_PENETRATION			0.75
+
+/* Dealer outcome caches the workers use */
+typedef enum __CacheMode__
+	{
+	CACHE_NONE,
+	CACHE_PRIVATE,				// One per thread
+	CACHE_SHARED,				// One for every thread
+	CACHE_MODES_NR
+	}TCacheMode;
+
+/* Benchmark configuration */
+typedef struct __CacheBench__
+	{
+	unsigned int decks;
+	unsigned long long seed;
+	unsigned long long advices;	// Per thread
+	unsigned int capacity;			// Entries per cache
+	unsigned int threadsNr;
+	}TCacheBench;
+
+/* What one worker did */
+typedef struct __CacheWork__
+	{
+	unsigned long long advices;
+	double bestEvSum;					// Sum of the best EVs, the same in every mode
+	TTDigest latency;					// Advice latency, microseconds
+	TDealerCacheStats stats;		// Of its own cache, private mode
+	}TCacheWork;
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":hj:n:d:c:S:Csp6";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "threads",  		required_argument,   NULL,    'j'   },
+   { "advices",  		required_argument,   NULL,    'n'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "capacity",  	required_argument,   NULL,    'c'   },
+   { "seed",   		required_argument,   NULL,    'S'   },
+   { "compare",  		no_argument,         NULL,    'C'   },
+   { "s17",   		no_argument,         NULL,    's'   },
+   { "push-ties",		no_argument,         NULL,    'p'   },
+   { "pay-6-5",		no_argument,         NULL,    '6'   },
+   { 0, 0, 0, 0 }
+   };
+
+static const char *modeNames[CACHE_MODES_NR] = {"none", "private", "shared"};
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-dealercache: Advice throughput and latency with the dealer outcome" << std::endl;
+   std::cout << "cache shared by the threads of the process" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -j, --threads N" << std::endl;
+   std::cout << "      Worker threads (default one per hardware thread)." << std::endl;
+   std::cout << "   -n, --advices N" << std::endl;
+   std::cout << "      Advices per thread (default " << CACHE_DEFAULT_ADVICES << ")." << std::endl;
+   std::cout << "   -d, --decks N" << std::endl;
+   std::cout << "      Decks per shoe (default " << CACHE_DEFAULT_DECKS << ")." << std::endl;
+   std::cout << "   -c, --capacity N" << std::endl;
+   std::cout << "      Entries per cache (default " << DEALER_CACHE_ENTRIES << ")." << std::endl;
+   std::cout << "   -S, --seed SEED" << std::endl;
+   std::cout << "      Seed of the thread seed streams (default 1)." << std::endl;
+   std::cout << "   -C, --compare" << std::endl;
+   std::cout << "      Also run with no cache and with a cache per thread, and check every" << std::endl;
+   std::cout << "      mode gives the same advices." << std::endl;
+   std::cout << "   -s, --s17, -p, --push-ties, -6, --pay-6-5" << std::endl;
+   std::cout << "      Rule variants, as for blackjack." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Worker thread: deal hands and ask for advice at every decision, following
+ * the advice while it is to hit
+ */
+template <typename TRules>
+	static void
+worker
+	(
+	const TCacheBench *bench,		// Configuration
+	unsigned int 		t,				// Thread number, its seed stream
+	TCacheMode 			mode,			// Caches used
+	TDealerCache 		*shared,		// Cache of every thread, shared mode
+	TCacheWork 			*work			// Out argument
+	)
+	{
+	TDealer dealer(mixSeed(bench->seed, t), bench->decks);
+	TCards deck;
+	dealer.shuffle(deck);
+	unsigned int reshuffle = (unsigned int)(bench->decks * TDealer::CARDS_PER_DECK *
+			(1.0 - CACHE_PENETRATION));
+	TAdviceEngine<TRules> engine;
+	TDealerCache *own = NULL;
+	if (mode == CACHE_PRIVATE)
+		own = new TDealerCache(bench->capacity);
+	engine.setDealerCache((mode == CACHE_SHARED) ? shared : own);
+	const unsigned int maxScore = TStrategy::MAX_SCORE;
+
+	work->bestEvSum = 0.0;
+	while (engine.getAdvices() < bench->advices)
+		{
+		if (deck.size() < reshuffle)
+			dealer.shuffle(deck);
+		TCard hole = dealer.dealCard(deck);
+		TCard up = dealer.dealCard(deck);
+		TCard first = dealer.dealCard(deck);
+		TCard second = dealer.dealCard(deck);
+		unsigned int hard = first.value + second.value;
+		bool ace = (first.value == 1) || (second.value == 1);
+		// Naturals end the hand before the player is prompted
+		if ((ace && (hard == 11)) || (up.value + hole.value == 11 &&
+				((up.value == 1) || (hole.value == 1))))
+			continue;
+		unsigned int pairValue = (first.value == second.value) ? first.value : 0;
+		unsigned int allowed = ALLOW_DOUBLE | ALLOW_SPLIT | ALLOW_SURRENDER;
+		TAdvice advice;
+		for (;;)
+			{
+			bool soft = ace && (hard + 10 <= maxScore);
+			unsigned int score = soft ? hard + 10 : hard;
+			engine.advise(dealer, hole, score, soft, up.value, pairValue, allowed, advice);
+			work->bestEvSum += advice.ev[advice.best];
+			if ((advice.best != ACTION_HIT) || (engine.getAdvices() >= bench->advices))
+				break;
+			TCard card = dealer.dealCard(deck);
+			hard += card.value;
+			ace = ace || (card.value == 1);
+			if ((hard >= maxScore) || (ace && (hard + 10 == maxScore)))
+				break;
+			pairValue = 0;
+			allowed = 0;
+			}
+		// The dealer draws too, so the next hand meets another composition
+		dealer.dealCard(deck);
+		}
+	work->advices = engine.getAdvices();
+	work->latency = engine.getLatencies();
+	memset((void *)&work->stats, 0, sizeof(work->stats));
+	if (own)
+		{
+		own->getStats(work->stats);
+		delete own;
+		}
+	}
+
+/* Runs the workers of one mode with the rule set of the table */
+struct TCacheRunner
+	{
+	const TCacheBench *bench;
+	TCacheMode mode;
+	TDealerCache *shared;
+	std::vector<TCacheWork> *works;
+	double elapsedSecs;
+
+	template <typename TRules>
+		int
+	run
+		(
+		void
+		)
+		{
+		std::vector<std::thread> threads;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned int t = 0; t < bench->threadsNr; t++)
+			threads.push_back(std::thread(worker<TRules>, bench, t, mode, shared,
+					&(*works)[t]));
+		for (unsigned int t = 0; t < bench->threadsNr; t++)
+			threads[t].join();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		elapsedSecs = elapsed.count();
+		return 0;
+		}
+	};
+
+/*
+ * Run the workers in one mode and print what they did
+ * @return: - 0 - Success. Otherwise,
+ * 			Error
+ */
+	static int
+runMode
+	(
+	const TCacheBench &bench,		// Configuration
+	unsigned int 		rules,		// TRuleFlags
+	TCacheMode 			mode,			// Caches used
+	double 				&bestEvSum	// Out argument, all threads
+	)
+	{
+	TDealerCache shared(bench.capacity);
+	std::vector<TCacheWork> works(bench.threadsNr);
+	TCacheRunner runner;
+	runner.bench = &bench;
+	runner.mode = mode;
+	runner.shared = &shared;
+	runner.works = &works;
+	runner.elapsedSecs = 0.0;
+	if (dispatchRules(rules, runner))
+		{
+		log(LOG_ERR, "Unknown rule set\n");
+		return -1;
+		}
+
+	// Merged once the workers are done
+	TTDigest latency;
+	TDealerCacheStats stats;
+	memset((void *)&stats, 0, sizeof(stats));
+	if (mode == CACHE_SHARED)
+		shared.getStats(stats);
+	unsigned long long advices = 0;
+	bestEvSum = 0.0;
+	for (unsigned int t = 0; t < bench.threadsNr; t++)
+		{
+		advices += works[t].advices;
+		bestEvSum += works[t].bestEvSum;
+		latency.merge(works[t].latency);
+		if (mode != CACHE_PRIVATE)
+			continue;
+		stats.hits += works[t].stats.hits;
+		stats.misses += works[t].stats.misses;
+		stats.evictions += works[t].stats.evictions;
+		stats.timedHits += works[t].stats.timedHits;
+		stats.timedMisses += works[t].stats.timedMisses;
+		stats.hitNanos += works[t].stats.hitNanos;
+		stats.missNanos += works[t].stats.missNanos;
+		stats.entries += works[t].stats.entries;
+		stats.capacity += works[t].stats.capacity;
+		}
+
+	printf("%-8s %11.0f advices/s  p50 %6.2f us  p99 %6.2f us", modeNames[mode],
+			(double)advices / runner.elapsedSecs, latency.quantile(0.5), latency.quantile(0.99));
+	if (mode != CACHE_NONE)
+		{
+		unsigned long long lookups = stats.hits + stats.misses;
+		printf("  hit rate %5.1f%%  hit %4.0f ns  miss %4.0f ns  entries %u/%u  evictions %llu",
+				lookups ? 100.0 * (double)stats.hits / (double)lookups : 0.0,
+				stats.timedHits ? (double)stats.hitNanos / (double)stats.timedHits : 0.0,
+				stats.timedMisses ? (double)stats.missNanos / (double)stats.timedMisses : 0.0,
+				stats.entries, stats.capacity, stats.evictions);
+		}
+	printf("\n");
+	return 0;
+	}
+
+/* Top level and binary entry point for the dealer outcome cache benchmark
+ * @return: 0 - Success. Otherwise,
+ * 			Error
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	TCacheBench bench;
+	memset((void *)&bench, 0, sizeof(bench));
+	bench.decks = CACHE_DEFAULT_DECKS;
+	bench.seed = 1;
+	bench.advices = CACHE_DEFAULT_ADVICES;
+	bench.capacity = DEALER_CACHE_ENTRIES;
+	bench.threadsNr = std::thread::hardware_concurrency();
+	unsigned int rules = 0;
+	bool compare = false;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'j':
+				bench.threadsNr = strtoul(optarg, NULL, 10);
+				break;
+			case 'n':
+				bench.advices = strtoull(optarg, NULL, 10);
+				break;
+			case 'd':
+				bench.decks = strtoul(optarg, NULL, 10);
+				break;
+			case 'c':
+				bench.capacity = strtoul(optarg, NULL, 10);
+				break;
+			case 'S':
+				bench.seed = strtoull(optarg, NULL, 10);
+				break;
+			case 'C':
+				compare = true;
+				break;
+			case 's':
+				rules |= RULES_STAND_SOFT_17;
+				break;
+			case 'p':
+				rules |= RULES_PUSH_TIES;
+				break;
+			case '6':
+				rules |= RULES_PAY_6_5;
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+	if (!bench.threadsNr)
+		bench.threadsNr = 1;
+	if (!bench.decks || !bench.advices || !bench.capacity)
+		{
+		log(LOG_ERR, "Invalid decks, advices or capacity\n");
+		return -1;
+		}
+
+	printf("%u threads, %llu advices each, %u decks, %u entries per cache\n", bench.threadsNr,
+			bench.advices, bench.decks, bench.capacity);
+	double sums[CACHE_MODES_NR];
+	for (int mode = compare ? CACHE_NONE : CACHE_SHARED; mode < CACHE_MODES_NR; mode++)
+		if (runMode(bench, rules, (TCacheMode)mode, sums[mode]))
+			return -1;
+	if (!compare)
+		return 0;
+	// Cached distributions are the computed ones, bit for bit
+	bool same = (sums[CACHE_PRIVATE] == sums[CACHE_NONE]) &&
+			(sums[CACHE_SHARED] == sums[CACHE_NONE]);
+	printf("Advices %s\n", same ? "the same in every mode" : "DIFFER");
+	return same ? 0 : 1;
+	}
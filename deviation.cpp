@@ -0,0 +1,480 @@
+/******************************************************************************/
+/*!
+ * @file:					  deviation.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the count based deviation index generator.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <mutex>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+/* Local includes */
+#include "dealer.hpp"
+#include "deviation.hpp"
+#include "misc.hpp"
+#include "rules.hpp"
+
+/* Private defines */
+// Hands a worker claims at a time, dealt from shoes of their own seed
+#define BATCH_HANDS				100000ULL
+// Hands per deck between shuffles, as the one player engine
+#define SHUFFLE_PERIOD_HANDS	6
+// Samples a true count needs to take part in the fit
+#define FIT_MIN_SAMPLES			100
+// Fitted slopes within this many standard errors of zero do not flip
+#define FIT_MIN_SLOPE_ERRS		2.0
+#define ACE_VALUE					1
+#define SOFT_BONUS				10		// An Ace counted 11 instead of 1
+#define BLACKJACK_SCORE			21
+#define DEALER_STAND				17
+
+/*
+ * Score of a hand from its hard total and whether it holds an Ace
+ */
+	static inline unsigned int
+handScore
+	(
+	unsigned int hard,		// Aces counted 1
+	bool 			 ace,			// Holds an Ace
+	bool 			 &soft		// Out argument
+	)
+	{
+	soft = ace && (hard + SOFT_BONUS <= BLACKJACK_SCORE);
+	return soft ? hard + SOFT_BONUS : hard;
+	}
+
+/*
+ * True count bucket of TDeviationCell, as TStrategy::getAction() floors and
+ * clamps it
+ */
+	static inline unsigned int
+countBucket
+	(
+	double trueCount
+	)
+	{
+	int tc = (trueCount < TStrategy::MIN_TRUE_COUNT) ? TStrategy::MIN_TRUE_COUNT :
+			(trueCount >= TStrategy::MAX_TRUE_COUNT) ? TStrategy::MAX_TRUE_COUNT :
+			(int)floor(trueCount);
+	return (unsigned int)(tc - TStrategy::MIN_TRUE_COUNT);
+	}
+
+/*
+ * Dealer final score drawing from the shoe at 'pos' (cards are dealt from the
+ * back) without changing it
+ * @return: - Final score, above BLACKJACK_SCORE a bust. Otherwise,
+ * 			-1 - The shoe ran out
+ */
+template <typename TRules>
+	static inline int
+dealerFinal
+	(
+	const TCards 	&cardDeck,		// Shoe
+	unsigned int 	&pos,				// Cards left, in and out
+	unsigned int 	hard,				// Dealer two card hard total
+	bool 				ace				// Dealer holds an Ace
+	)
+	{
+	for (;;)
+		{
+		bool soft;
+		unsigned int score = handScore(hard, ace, soft);
+		if ((score > DEALER_STAND - 1) && !(TRules::HIT_SOFT_17 && soft &&
+				(score == DEALER_STAND)))
+			return (int)score;
+		if (!pos)
+			return -1;
+		const TCard &card = cardDeck[--pos];
+		hard += card.value;
+		ace = ace || (card.value == ACE_VALUE);
+		}
+	}
+
+/*
+ * Net result of a standing player score against the dealer final score
+ */
+template <typename TRules>
+	static inline int
+settle
+	(
+	unsigned int player,			// Player score, not busted
+	int 			 dealer			// Dealer final score
+	)
+	{
+	if ((dealer > BLACKJACK_SCORE) || ((int)player > dealer))
+		return 1;
+	if (((int)player == dealer) && TRules::PUSH_ON_TIE)
+		return 0;
+	return -1;
+	}
+
+/*
+ * Hit once, then play basic strategy, from the shoe at 'pos' without
+ * changing it
+ * @return: - 0 - Success, 'net' set. Otherwise,
+ * 			-1 - The shoe ran out
+ */
+template <typename TRules>
+	static inline int
+playHit
+	(
+	const TCards 		&cardDeck,		// Shoe
+	unsigned int 		pos,				// Cards left
+	const TStrategy 	&basic,			// Policy after the first hit
+	unsigned int 		hard,				// Player hard total
+	bool 					ace,				// Player holds an Ace
+	unsigned int 		up,				// Dealer up card value
+	unsigned int 		dealerHard,		// Dealer two card hard total
+	bool 					dealerAce,		// Dealer holds an Ace
+	int 					&net				// Out argument
+	)
+	{
+	bool soft;
+	unsigned int score;
+	do
+		{
+		if (!pos)
+			return -1;
+		const TCard &card = cardDeck[--pos];
+		hard += card.value;
+		ace = ace || (card.value == ACE_VALUE);
+		score = handScore(hard, ace, soft);
+		if (score > BLACKJACK_SCORE)
+			{
+			net = -1;
+			return 0;
+			}
+		}
+	while (basic.getAction(score, soft, up) != ACTION_STAND);
+
+	int dealer = dealerFinal<TRules>(cardDeck, pos, dealerHard, dealerAce);
+	if (dealer < 0)
+		return -1;
+	net = settle<TRules>(score, dealer);
+	return 0;
+	}
+
+/*
+ * Deviation simulation for one rule set. Instantiated by dispatchRules().
+ * Workers claim batches of hands, each dealt from shoes of their own seed, so
+ * results do not depend on which worker plays a batch.
+ */
+class TDeviationRunner
+	{
+	public:
+		TDeviationRunner(const TDeviationConfig &config, TDeviationResult &result) :
+			mConfig(config), mResult(result), mNextBatch(0) {};
+		template <typename TRules> int run(void);
+
+	private:
+		template <typename TRules> void worker(void);
+		// Play one batch of hands, adding the samples to 'tally'
+		template <typename TRules> void playBatch(unsigned long long batch,
+				const TStrategy &basic, TCards &cardDeck, TDeviationResult &tally);
+
+	private:
+		const TDeviationConfig &mConfig;
+		TDeviationResult &mResult;
+		std::atomic<unsigned long long> mNextBatch;
+		std::mutex mLock;					// Held adding a worker tally to mResult
+	};
+
+/*
+ * Play one batch of hands with basic strategy, both candidates played out at
+ * every candidate decision
+ */
+template <typename TRules>
+	void
+TDeviationRunner::playBatch
+	(
+	unsigned long long batch,			// Batch number, its shoes seed stream
+	const TStrategy 	 &basic,			// Player policy
+	TCards 				 &cardDeck,		// Shoe storage
+	TDeviationResult 	 &tally			// In and out
+	)
+	{
+	TDealer dealer(mixSeed(mConfig.seed, batch), mConfig.decks);
+	const unsigned long long shufflePeriod = (unsigned long long)SHUFFLE_PERIOD_HANDS *
+			mConfig.decks;
+	unsigned long long first = batch * BATCH_HANDS;
+	unsigned long long hands = (first + BATCH_HANDS > mConfig.hands) ?
+			mConfig.hands - first : BATCH_HANDS;
+	cardDeck.clear();
+
+	for (unsigned long long h = 0; h < hands; h++)
+		{
+		if (!(h % shufflePeriod) || cardDeck.empty())
+			dealer.shuffle(cardDeck);
+		// Dealt as the engine deals: two player cards, the hole card, the up card
+		TCard p1 = dealer.dealCard(cardDeck);
+		TCard p2 = dealer.dealCard(cardDeck);
+		TCard hole = dealer.dealCard(cardDeck);
+		TCard up = dealer.dealCard(cardDeck);
+		tally.hands++;
+
+		unsigned int hard = p1.value + p2.value;
+		bool ace = (p1.value == ACE_VALUE) || (p2.value == ACE_VALUE);
+		unsigned int dealerHard = hole.value + up.value;
+		bool dealerAce = (hole.value == ACE_VALUE) || (up.value == ACE_VALUE);
+		bool soft;
+		// Naturals settle the hand before any decision
+		if ((handScore(hard, ace, soft) == BLACKJACK_SCORE) ||
+				(handScore(dealerHard, dealerAce, soft) == BLACKJACK_SCORE))
+			continue;
+
+		for (;;)
+			{
+			unsigned int score = handScore(hard, ace, soft);
+			if (score > BLACKJACK_SCORE)
+				break;
+			if (isDeviationCandidate(score, soft))
+				{
+				// Both ways from the same cards, the shoe left as it is
+				unsigned int pos = cardDeck.size();
+				int hitNet = 0;
+				int dealerScore = dealerFinal<TRules>(cardDeck, pos, dealerHard, dealerAce);
+				if ((dealerScore >= 0) && !playHit<TRules>(cardDeck, cardDeck.size(), basic,
+						hard, ace, up.value, dealerHard, dealerAce, hitNet))
+					{
+					TDeviationCell &cell = tally.cells[soft][score][up.value];
+					unsigned int b = countBucket(dealer.getTrueCount(&hole));
+					long long diff = hitNet - settle<TRules>(score, dealerScore);
+					cell.samples[b]++;
+					cell.diffSum[b] += diff;
+					cell.diffSquaredSum[b] += (unsigned long long)(diff * diff);
+					tally.samples++;
+					}
+				}
+			if (basic.getAction(score, soft, up.value) == ACTION_STAND)
+				break;
+			TCard card = dealer.dealCard(cardDeck);
+			hard += card.value;
+			ace = ace || (card.value == ACE_VALUE);
+			}
+
+		// The dealer draws on, so the next hand starts where the engine's would
+		if (handScore(hard, ace, soft) <= BLACKJACK_SCORE)
+			for (;;)
+				{
+				unsigned int score = handScore(dealerHard, dealerAce, soft);
+				if ((score > DEALER_STAND - 1) && !(TRules::HIT_SOFT_17 && soft &&
+						(score == DEALER_STAND)))
+					break;
+				TCard card = dealer.dealCard(cardDeck);
+				dealerHard += card.value;
+				dealerAce = dealerAce || (card.value == ACE_VALUE);
+				}
+		}
+	}
+
+/*
+ * Play batches until none is left, then add the worker tally to the result
+ */
+template <typename TRules>
+	void
+TDeviationRunner::worker
+	(
+	void
+	)
+	{
+	TStrategy basic(POLICY_BASIC);
+	TCards cardDeck;
+	cardDeck.reserve(mConfig.decks * TDealer::CARDS_PER_DECK);
+	std::vector<TDeviationResult> tally(1);
+	memset((void *)tally.data(), 0, sizeof(TDeviationResult));
+	unsigned long long batches = (mConfig.hands + BATCH_HANDS - 1) / BATCH_HANDS;
+
+	for (;;)
+		{
+		unsigned long long batch = mNextBatch.fetch_add(1);
+		if (batch >= batches)
+			break;
+		playBatch<TRules>(batch, basic, cardDeck, tally[0]);
+		}
+
+	// Integer sums: the result is the same whatever the order workers add up in
+	std::lock_guard<std::mutex> lock(mLock);
+	mResult.hands += tally[0].hands;
+	mResult.samples += tally[0].samples;
+	for (unsigned int soft = 0; soft < 2; soft++)
+		for (unsigned int score = 0; score <= TStrategy::MAX_SCORE; score++)
+			for (unsigned int up = 0; up <= TStrategy::MAX_UPCARD; up++)
+				{
+				TDeviationCell &into = mResult.cells[soft][score][up];
+				const TDeviationCell &from = tally[0].cells[soft][score][up];
+				for (unsigned int b = 0; b < TStrategy::TRUE_COUNTS_NR; b++)
+					{
+					into.samples[b] += from.samples[b];
+					into.diffSum[b] += from.diffSum[b];
+					into.diffSquaredSum[b] += from.diffSquaredSum[b];
+					}
+				}
+	}
+
+/*
+ * Run the workers until every hand is played
+ * @return: - 0 - Success simulating
+ */
+template <typename TRules>
+	int
+TDeviationRunner::run
+	(
+	void
+	)
+	{
+	unsigned int threadsNr = mConfig.threads ? mConfig.threads :
+			std::thread::hardware_concurrency();
+	if (!threadsNr)
+		threadsNr = 1;
+
+	std::vector<std::thread> threads;
+	for (unsigned int t = 0; t < threadsNr; t++)
+		threads.push_back(std::thread(&TDeviationRunner::worker<TRules>, this));
+	for (unsigned int t = 0; t < threadsNr; t++)
+		threads[t].join();
+	return 0;
+	}
+
+/*
+ * Play config.hands hands in parallel and fit the index of every candidate
+ * decision
+ * @return: - 0 - Success simulating. Otherwise,
+ * 			Error (invalid configuration)
+ */
+	int
+simulateDeviations
+	(
+	const TDeviationConfig 	&config,		// In
+	TDeviationResult 			&result		// Out argument
+	)
+	{
+	int ret = -1; // Assume error
+
+	memset((void *)&result, 0, sizeof(result));
+	if ((config.rules >= RULES_VARIANTS_NR) || !config.decks || !config.hands)
+		return ret;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	TDeviationRunner runner(config, result);
+	ret = dispatchRules(config.rules, runner);
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	result.elapsedSecs = elapsed.count();
+	if (!ret)
+		fitDeviations(result);
+
+	return ret;
+	}
+
+/*
+ * Fit the index of every candidate decision
+ */
+	void
+fitDeviations
+	(
+	TDeviationResult &result		// In and out
+	)
+	{
+	for (unsigned int soft = 0; soft < 2; soft++)
+		for (unsigned int score = 0; score <= TStrategy::MAX_SCORE; score++)
+			for (unsigned int up = 0; up <= TStrategy::MAX_UPCARD; up++)
+				{
+				TDeviationCell &cell = result.cells[soft][score][up];
+				cell.flips = false;
+				cell.index = cell.indexStdErr = 0.0;
+				unsigned long long n = 0;
+				long long sum = 0;
+				// Weighted least squares over the inner true counts: the clamped
+				// ends hold a range of counts each
+				double sw = 0.0, swx = 0.0, swy = 0.0, swxx = 0.0, swxy = 0.0;
+				for (unsigned int b = 0; b < TStrategy::TRUE_COUNTS_NR; b++)
+					{
+					n += cell.samples[b];
+					sum += cell.diffSum[b];
+					if (!b || (b == TStrategy::TRUE_COUNTS_NR - 1) ||
+							(cell.samples[b] < FIT_MIN_SAMPLES))
+						continue;
+					double count = (double)cell.samples[b];
+					double mean = (double)cell.diffSum[b] / count;
+					double variance = ((double)cell.diffSquaredSum[b] / count - mean * mean) *
+							count / (count - 1.0);
+					if (variance <= 0.0)
+						continue;
+					double w = count / variance;
+					// Middle of the floored true count
+					double x = (double)((int)b + TStrategy::MIN_TRUE_COUNT) + 0.5;
+					sw += w;
+					swx += w * x;
+					swy += w * mean;
+					swxx += w * x * x;
+					swxy += w * x * mean;
+					}
+				cell.lowAction = (sum > 0) ? ACTION_HIT : ACTION_STAND;
+				double det = sw * swxx - swx * swx;
+				if (!n || (det <= 0.0))
+					continue;
+
+				double slope = (sw * swxy - swx * swy) / det;
+				double intercept = (swxx * swy - swx * swxy) / det;
+				double slopeErr = sqrt(sw / det);
+				if (fabs(slope) < FIT_MIN_SLOPE_ERRS * slopeErr)
+					continue;
+				double index = -intercept / slope;
+				if ((index <= (double)TStrategy::MIN_TRUE_COUNT) ||
+						(index >= (double)TStrategy::MAX_TRUE_COUNT + 1.0))
+					continue;
+
+				// Delta method on -intercept / slope
+				double varIntercept = swxx / det, varSlope = sw / det, cov = -swx / det;
+				double variance = (varIntercept + index * index * varSlope +
+						2.0 * index * cov) / (slope * slope);
+				cell.flips = true;
+				cell.index = index;
+				cell.indexStdErr = (variance > 0.0) ? sqrt(variance) : 0.0;
+				cell.lowAction = (slope < 0.0) ? ACTION_HIT : ACTION_STAND;
+				}
+	}
+
+/*
+ * Strategy tables of every true count from the fitted indexes
+ */
+	void
+deviationTables
+	(
+	const TDeviationResult 	&result,		// Fitted results
+	unsigned char 				tables[TStrategy::TRUE_COUNTS_NR][2][TStrategy::MAX_SCORE + 1]
+			[TStrategy::MAX_UPCARD + 1]		// Out argument
+	)
+	{
+	TStrategy basic(POLICY_BASIC);
+	for (unsigned int b = 0; b < TStrategy::TRUE_COUNTS_NR; b++)
+		{
+		double x = (double)((int)b + TStrategy::MIN_TRUE_COUNT) + 0.5;
+		for (unsigned int soft = 0; soft < 2; soft++)
+			for (unsigned int score = 0; score <= TStrategy::MAX_SCORE; score++)
+				for (unsigned int up = 0; up <= TStrategy::MAX_UPCARD; up++)
+					{
+					const TDeviationCell &cell = result.cells[soft][score][up];
+					unsigned long long n = 0;
+					for (unsigned int c = 0; c < TStrategy::TRUE_COUNTS_NR; c++)
+						n += cell.samples[c];
+					TPlayerAction action = basic.getAction(score, soft, up);
+					if (n && isDeviationCandidate(score, soft))
+						{
+						TPlayerAction highAction = (cell.lowAction == ACTION_HIT) ? ACTION_STAND :
+								ACTION_HIT;
+						action = (cell.flips && (x >= cell.index)) ? highAction : cell.lowAction;
+						}
+					tables[b][soft][score][up] = (unsigned char)action;
+					}
+		}
+	}
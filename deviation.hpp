@@ -0,0 +1,107 @@
+/******************************************************************************/
+/*!
+ * @file:					  deviation.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the count based deviation
+ *  					index generator: the Hi-Lo true count at which hit and
+ *  					stand swap as the better decision, per player total and
+ *  					dealer up card.
+ *
+ *  Hands are played with basic strategy. At every candidate decision, hit
+ *  (then basic strategy) and stand are both played out from the same point of
+ *  the same shoe, and their net result difference is added to the bucket of
+ *  the true count the player sees. Shoe luck is common to both, so the
+ *  difference converges far faster than two independent runs would.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __DEVIATION_HPP__
+#define __DEVIATION_HPP__
+
+/* Local includes */
+#include "strategy.hpp"
+
+/* Defines */
+
+// Candidate decisions: hard and soft totals where hit and stand are close
+#define DEVIATION_HARD_MIN		12
+#define DEVIATION_HARD_MAX		17
+#define DEVIATION_SOFT_MIN		17
+#define DEVIATION_SOFT_MAX		19
+
+/* Enumerations, type defines */
+
+/* Deviation simulation configuration */
+typedef struct __DeviationConfig__
+	{
+	unsigned int rules;						// TRuleFlags
+	unsigned int decks;						// Decks in the shoe
+	unsigned long long seed;				// Same seed, same results, whatever the threads
+	unsigned long long hands;				// Hands to play
+	unsigned int threads;					// Worker threads. 0, one per hardware thread
+	}TDeviationConfig;
+
+/*
+ * Hit minus stand net results of one decision, per floored true count
+ * (TStrategy::MIN_TRUE_COUNT first, ends clamped), and its fitted index
+ */
+typedef struct __DeviationCell__
+	{
+	unsigned long long samples[TStrategy::TRUE_COUNTS_NR];
+	long long diffSum[TStrategy::TRUE_COUNTS_NR];		// In bets, always whole
+	unsigned long long diffSquaredSum[TStrategy::TRUE_COUNTS_NR];
+	// Fitted by fitDeviations()
+	bool flips;									// Hit and stand swap within the true counts
+	double index;								// True count they swap at
+	double indexStdErr;
+	TPlayerAction lowAction;				// Better below the index, or everywhere
+	}TDeviationCell;
+
+/* Deviation simulation results */
+typedef struct __DeviationResult__
+	{
+	unsigned long long hands;				// Hands played
+	unsigned long long samples;			// Decisions played out both ways
+	double elapsedSecs;
+	TDeviationCell cells[2][TStrategy::MAX_SCORE + 1][TStrategy::MAX_UPCARD + 1];	// [soft]
+												// [score][up card value], candidates only
+	}TDeviationResult;
+
+/*
+ * Candidate decision of the generator
+ * @return: - True - Hit and stand are both played out at this decision
+ */
+static inline bool isDeviationCandidate(unsigned int score, bool soft)
+	{
+	return soft ? ((score >= DEVIATION_SOFT_MIN) && (score <= DEVIATION_SOFT_MAX)) :
+			((score >= DEVIATION_HARD_MIN) && (score <= DEVIATION_HARD_MAX));
+	}
+
+/*
+ * Play config.hands hands in parallel and add up the hit minus stand results
+ * of every candidate decision, then fit their indexes (see fitDeviations())
+ * @return: - 0 - Success simulating. Otherwise,
+ * 			Error (invalid configuration)
+ */
+int simulateDeviations (const TDeviationConfig &config, TDeviationResult &result);
+
+/*
+ * Fit the index of every candidate decision: weighted least squares line of
+ * the mean hit minus stand result over the inner true counts, the index being
+ * where it crosses zero. A decision flips if the line crosses within the true
+ * counts and its slope is significant.
+ */
+void fitDeviations (TDeviationResult &result);
+
+/*
+ * Strategy tables of every true count: basic strategy, with each candidate
+ * decision taking the action its fitted line favors at the middle of the
+ * floored true count. Decisions without samples keep basic strategy.
+ */
+void deviationTables (const TDeviationResult &result, unsigned char
+		tables[TStrategy::TRUE_COUNTS_NR][2][TStrategy::MAX_SCORE + 1][TStrategy::MAX_UPCARD + 1]);
+
+#endif /* __DEVIATION_HPP__ */
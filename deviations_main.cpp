@@ -0,0 +1,257 @@
+/******************************************************************************/
+/*!
+ * @file:					  deviations_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-deviations. Simulates the hit/stand deviation
+ *  					index of every candidate decision and writes them as a
+ *  					table file the 'tables' policy plays.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "deviation.hpp"
+#include "misc.hpp"
+#include "rules.hpp"
+#include "simulator.hpp"
+#include "tablefile.hpp"
+
+/* Library includes */
+#include <getopt.h>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/* Private defines */
+#define DEFAULT_OUTPUT		"deviations.tables"
+#define DEFAULT_HANDS		20000000ULL
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":hn:d:j:o:c:S:sp6";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "hands",   		required_argument,   NULL,    'n'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "threads",  		required_argument,   NULL,    'j'   },
+   { "output",   		required_argument,   NULL,    'o'   },
+   { "compare",  		required_argument,   NULL,    'c'   },
+   { "seed",   		required_argument,   NULL,    'S'   },
+   { "s17",   		no_argument,         NULL,    's'   },
+   { "push-ties",		no_argument,         NULL,    'p'   },
+   { "pay-6-5",		no_argument,         NULL,    '6'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-deviations: Hi-Lo true count at which hit and stand swap, per" << std::endl;
+   std::cout << "player total (hard " << DEVIATION_HARD_MIN << " to " << DEVIATION_HARD_MAX <<
+   		", soft " << DEVIATION_SOFT_MIN << " to " << DEVIATION_SOFT_MAX <<
+   		") and dealer up card" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Both decisions are played out on the same shoes from every candidate" << std::endl;
+   std::cout << "decision of basic strategy hands, so the index converges quickly." << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -n, --hands N" << std::endl;
+   std::cout << "      Hands to play (default " << DEFAULT_HANDS << ")." << std::endl;
+   std::cout << "   -d, --decks N, -S, --seed SEED" << std::endl;
+   std::cout << "      Shoe decks (default 6) and seed (default 1)." << std::endl;
+   std::cout << "   -j, --threads N" << std::endl;
+   std::cout << "      Worker threads (default one per hardware thread). Results do not" << std::endl;
+   std::cout << "      depend on it." << std::endl;
+   std::cout << "   -o, --output FILE" << std::endl;
+   std::cout << "      Table file to write (default " << DEFAULT_OUTPUT << "), for" << std::endl;
+   std::cout << "      'blackjack-sim --policy tables -T FILE'." << std::endl;
+   std::cout << "   -c, --compare HANDS" << std::endl;
+   std::cout << "      After writing, simulate HANDS hands with the indexes and with basic" << std::endl;
+   std::cout << "      strategy on the same shoes and print the paired gain." << std::endl;
+   std::cout << "   -s, --s17, -p, --push-ties, -6, --pay-6-5" << std::endl;
+   std::cout << "      Rule variants, as for blackjack." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Print the index grid: the index and the action at or above it, or the
+ * action at every true count
+ */
+	void
+printIndexes
+	(
+	const TDeviationResult &result		// Fitted results
+	)
+	{
+	printf("  Index and action at or above it, or action at every true count\n");
+	printf("  %-8s", "");
+	for (unsigned int up = 2; up <= TStrategy::MAX_UPCARD + 1; up++)
+		printf(" %6s", (up > TStrategy::MAX_UPCARD) ? "A" : std::to_string(up).c_str());
+	printf("\n");
+
+	double maxErr = 0.0;
+	for (unsigned int soft = 0; soft < 2; soft++)
+		for (unsigned int score = 0; score <= TStrategy::MAX_SCORE; score++)
+			{
+			if (!isDeviationCandidate(score, soft))
+				continue;
+			printf("  %s %-3u", soft ? "soft" : "hard", score);
+			for (unsigned int col = 2; col <= TStrategy::MAX_UPCARD + 1; col++)
+				{
+				const TDeviationCell &cell = result.cells[soft][score][(col >
+						TStrategy::MAX_UPCARD) ? 1 : col];
+				char text[16];
+				if (cell.flips)
+					{
+					snprintf(text, sizeof(text), "%+.1f%c", cell.index,
+							(cell.lowAction == ACTION_HIT) ? 'S' : 'H');
+					if (cell.indexStdErr > maxErr)
+						maxErr = cell.indexStdErr;
+					}
+				else
+					snprintf(text, sizeof(text), "%c", (cell.lowAction == ACTION_HIT) ? 'H' : 'S');
+				printf(" %6s", text);
+				}
+			printf("\n");
+			}
+	printf("  Largest index standard error %.2f\n", maxErr);
+	}
+
+/*
+ * Simulate the deviation tables and basic strategy hand by hand on the same
+ * shoes
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (simulation failed)
+ */
+	int
+compareTables
+	(
+	const char 						*path,		// Table file
+	const TDeviationConfig 		&dev,			// Rules, decks and seed
+	unsigned long long 			hands			// Hands per policy
+	)
+	{
+	TSimConfig config;
+	TSimResults results;
+	simInitConfig(&config);
+	config.rules = dev.rules;
+	config.decks = dev.decks;
+	config.policy = SIM_POLICY_TABLES;
+	config.pairedPolicy = SIM_POLICY_BASIC;
+	config.seed = dev.seed + 1;			// Other shoes than the indexes were fitted on
+	config.hands = hands;
+	config.tablesPath = path;
+	if (simulate(&config, &results) || !results.handsPlayed)
+		{
+		log(LOG_ERR, "Simulation failed\n");
+		return -1;
+		}
+	double n = (double)results.handsPlayed;
+	printf("Paired simulation of %llu hands\n", hands);
+	printf("  %-10s EV %+.6f bets per hand\n", "deviations", results.netUnits / n);
+	printf("  %-10s EV %+.6f bets per hand\n", policyName(POLICY_BASIC),
+			results.pairedNetUnits / n);
+	printf("  Gain       %+.6f +/- %.6f bets per hand\n", results.diffMean,
+			results.diffStdErr);
+	return 0;
+	}
+
+/* Top level and binary entry point for the deviation index generator
+ * @return: 0 - Success. Otherwise,
+ * 			Error
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	TDeviationConfig config;
+	memset((void *)&config, 0, sizeof(config));
+	config.rules = RULES_HOUSE;
+	config.decks = 6;
+	config.seed = 1;
+	config.hands = DEFAULT_HANDS;
+	std::string output(DEFAULT_OUTPUT);
+	unsigned long long compareHands = 0;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'n':
+				config.hands = strtoull(optarg, NULL, 10);
+				break;
+			case 'd':
+				config.decks = strtoul(optarg, NULL, 10);
+				break;
+			case 'j':
+				config.threads = strtoul(optarg, NULL, 10);
+				break;
+			case 'o':
+				output = optarg;
+				break;
+			case 'c':
+				compareHands = strtoull(optarg, NULL, 10);
+				break;
+			case 'S':
+				config.seed = strtoull(optarg, NULL, 10);
+				break;
+			case 's':
+				config.rules |= RULES_STAND_SOFT_17;
+				break;
+			case 'p':
+				config.rules |= RULES_PUSH_TIES;
+				break;
+			case '6':
+				config.rules |= RULES_PAY_6_5;
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+
+	// About 200 KB, kept off the stack
+	std::vector<TDeviationResult> result(1);
+	if (simulateDeviations(config, result[0]))
+		{
+		log(LOG_ERR, "Invalid deviation configuration\n");
+		return -1;
+		}
+	printf("%llu hands, %llu decisions played both ways, %u decks, rules 0x%x, %.3f s\n",
+			result[0].hands, result[0].samples, config.decks, config.rules,
+			result[0].elapsedSecs);
+	printIndexes(result[0]);
+
+	std::vector<unsigned char> tables(TStrategy::TRUE_COUNTS_NR * 2 *
+			(TStrategy::MAX_SCORE + 1) * (TStrategy::MAX_UPCARD + 1));
+	typedef unsigned char TTables[2][TStrategy::MAX_SCORE + 1][TStrategy::MAX_UPCARD + 1];
+	deviationTables(result[0], (TTables *)tables.data());
+	if (writeStrategyTableFile(output, config.rules, config.decks, (const TTables *)tables.data()))
+		{
+		log(LOG_ERR, "Could not write the table file\n");
+		return -1;
+		}
+	printf("%s: written\n", output.c_str());
+
+	if (compareHands)
+		return compareTables(output.c_str(), config, compareHands);
+	return 0;
+	}
@@ -0,0 +1,269 @@
+/******************************************************************************/
+/*!
+ * @file:					  enum_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-enum. Exact outcome of one hand from a small
+ *  					shoe, optionally checked against the simulator.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "enumerator.hpp"
+#include "misc.hpp"
+#include "rules.hpp"
+#include "simulator.hpp"
+#include "strategy.hpp"
+
+/* Library includes */
+#include <getopt.h>
+#include <iostream>
+#include <math.h>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private defines */
+// Largest accepted distance, in standard errors, between simulation and enumeration
+#define MAX_Z_SCORE		4.0
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":hd:P:x:t:c:S:sp6";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "policy",   		required_argument,   NULL,    'P'   },
+   { "remove",   		required_argument,   NULL,    'x'   },
+   { "threads",  		required_argument,   NULL,    't'   },
+   { "compare",  		required_argument,   NULL,    'c'   },
+   { "seed",   		required_argument,   NULL,    'S'   },
+   { "s17",   		no_argument,         NULL,    's'   },
+   { "push-ties",		no_argument,         NULL,    'p'   },
+   { "pay-6-5",		no_argument,         NULL,    '6'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-enum: Exact outcome of one hand dealt from a small shoe" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -d, --decks N" << std::endl;
+   std::cout << "      Decks in the shoe, 1 to " << ENUM_MAX_DECKS << " (default 1)." << std::endl;
+   std::cout << "   -x, --remove RANKS" << std::endl;
+   std::cout << "      Comma separated ranks left out of the shoe (ex: A,5,5,K)." << std::endl;
+   std::cout << "   -P, --policy NAME" << std::endl;
+   std::cout << "      Player policy: basic, mimic or never-bust (default basic)." << std::endl;
+   std::cout << "   -t, --threads N" << std::endl;
+   std::cout << "      Worker threads (default one per hardware thread)." << std::endl;
+   std::cout << "   -c, --compare HANDS" << std::endl;
+   std::cout << "      Also simulate HANDS hands from the same shoe and fail if the" << std::endl;
+   std::cout << "      results are further than " << MAX_Z_SCORE << " standard errors apart." << std::endl;
+   std::cout << "   -S, --seed SEED" << std::endl;
+   std::cout << "      Simulation seed (default 1)." << std::endl;
+   std::cout << "   -s, --s17, -p, --push-ties, -6, --pay-6-5" << std::endl;
+   std::cout << "      Rule variants, as for blackjack." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Parse a comma separated list of ranks (A, 2 to 10, J, Q, K)
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (unknown rank)
+ */
+	int
+parseRanks
+	(
+	const std::string &list,								// Ranks
+	unsigned int removed[TDealer::RANKS_NR]			// Out argument. Count per rank
+	)
+	{
+	std::stringstream ss(list);
+	std::string tok;
+	while (std::getline(ss, tok, ','))
+		{
+		unsigned int rank = 0;
+		if ((tok == "A") || (tok == "a"))
+			rank = 1;
+		else if ((tok == "J") || (tok == "j"))
+			rank = 11;
+		else if ((tok == "Q") || (tok == "q"))
+			rank = 12;
+		else if ((tok == "K") || (tok == "k"))
+			rank = 13;
+		else
+			rank = strtoul(tok.c_str(), NULL, 10);
+		if (!rank || (rank > TDealer::RANKS_NR))
+			return -1;
+		removed[rank - 1]++;
+		}
+	return 0;
+	}
+
+/*
+ * Check one probability against its simulated frequency
+ * @return: - true - Within MAX_Z_SCORE standard errors
+ */
+	bool
+checkProbability
+	(
+	const char *name,			// Printed name
+	double exact,				// Enumerated probability
+	unsigned long long hits,	// Simulated occurrences
+	unsigned long long n		// Simulated hands
+	)
+	{
+	double freq = (double)hits / (double)n;
+	double se = sqrt(exact * (1.0 - exact) / (double)n);
+	double z = (se > 0.0) ? (freq - exact) / se : 0.0;
+	bool pass = fabs(z) < MAX_Z_SCORE;
+	printf("  %-10s exact %.6f  simulated %.6f  z %+.2f  %s\n", name, exact, freq, z,
+			pass ? "ok" : "FAIL");
+	return pass;
+	}
+
+/* Top level and binary entry point for the enumerator
+ * @return: 0 - Success (and simulation within error bars). Otherwise,
+ * 			Error
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	TEnumConfig config;
+	memset((void *)&config, 0, sizeof(config));
+	config.decks = 1;
+	config.policy = POLICY_BASIC;
+	unsigned long long compareHands = 0;
+	unsigned long long seed = 1;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'd':
+				config.decks = strtoul(optarg, NULL, 10);
+				break;
+			case 'P':
+				{
+				TPolicyType policy;
+				if (policyFromName(optarg, policy))
+					{
+					log(LOG_ERR, "Unknown policy\n");
+					return -1;
+					}
+				// The enumerator plays hit and stand only
+				if (policy >= POLICY_TABLES)
+					{
+					log(LOG_ERR, "Only hit/stand policies (basic, mimic or never-bust) can be "
+							"enumerated\n");
+					return -1;
+					}
+				config.policy = policy;
+				}
+				break;
+			case 'x':
+				if (parseRanks(optarg, config.removed))
+					{
+					log(LOG_ERR, "Invalid rank list\n");
+					return -1;
+					}
+				break;
+			case 't':
+				config.threads = strtoul(optarg, NULL, 10);
+				break;
+			case 'c':
+				compareHands = strtoull(optarg, NULL, 10);
+				break;
+			case 'S':
+				seed = strtoull(optarg, NULL, 10);
+				break;
+			case 's':
+				config.rules |= RULES_STAND_SOFT_17;
+				break;
+			case 'p':
+				config.rules |= RULES_PUSH_TIES;
+				break;
+			case '6':
+				config.rules |= RULES_PAY_6_5;
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+
+	TEnumResult result;
+	if (enumerateHands(config, result))
+		{
+		log(LOG_ERR, "Invalid enumeration configuration (decks, removed cards or rules)\n");
+		return -1;
+		}
+
+	printf("Exact hand outcome (%u deck(s), policy %s, rules 0x%x)\n", config.decks,
+			policyName((TPolicyType)config.policy), config.rules);
+	printf("  EV          %+.6f bets per hand\n", result.ev);
+	printf("  Win         %.6f (natural %.6f)\n", result.pWin, result.pNatural);
+	printf("  Push        %.6f\n", result.pPush);
+	printf("  Loss        %.6f\n", result.pLoss);
+	printf("  States      %lu dealer, %lu player\n", result.dealerStates, result.playerStates);
+	printf("  Time        %.3f s\n", result.elapsedSecs);
+
+	if (!compareHands)
+		return 0;
+
+	// Same shoe, reshuffled before every hand
+	TSimConfig simConfig;
+	TSimResults sim;
+	simInitConfig(&simConfig);
+	simConfig.rules = config.rules;
+	simConfig.decks = config.decks;
+	simConfig.policy = config.policy;
+	simConfig.seed = seed;
+	simConfig.hands = compareHands;
+	simConfig.shufflePeriod = 1;
+	memcpy((void *)simConfig.removed, (const void *)config.removed, sizeof(simConfig.removed));
+	if (simulate(&simConfig, &sim) || !sim.handsPlayed)
+		{
+		log(LOG_ERR, "Simulation failed\n");
+		return -1;
+		}
+
+	// Per hand net result variance, from the outcome counts
+	double n = (double)sim.handsPlayed;
+	double natPay = (config.rules & RULES_PAY_6_5) ? 1.2 : 1.5;
+	double mean = sim.netUnits / n;
+	double sq = ((double)(sim.userWins - sim.userNaturals) + (double)sim.dealerWins +
+			(double)sim.userNaturals * natPay * natPay) / n;
+	double se = sqrt((sq - mean * mean) / n);
+	double z = (se > 0.0) ? (mean - result.ev) / se : 0.0;
+	bool pass = fabs(z) < MAX_Z_SCORE;
+
+	printf("Simulation of %llu hands (seed %llu)\n", sim.handsPlayed, seed);
+	printf("  %-10s exact %+.6f  simulated %+.6f +/- %.6f  z %+.2f  %s\n", "EV", result.ev,
+			mean, se, z, pass ? "ok" : "FAIL");
+	pass = checkProbability("Win", result.pWin, sim.userWins, sim.handsPlayed) && pass;
+	pass = checkProbability("Natural", result.pNatural, sim.userNaturals, sim.handsPlayed) && pass;
+	pass = checkProbability("Push", result.pPush, sim.pushes, sim.handsPlayed) && pass;
+	pass = checkProbability("Loss", result.pLoss, sim.dealerWins, sim.handsPlayed) && pass;
+	printf("%s\n", pass ? "PASS" : "FAIL");
+	return pass ? 0 : 1;
+	}
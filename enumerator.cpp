@@ -0,0 +1,498 @@
+/******************************************************************************/
+/*!
+ * @file:					  enumerator.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the exhaustive hand enumerator.
+ *
+ *  The shoe is reduced to card categories (Ace, 2 to 9, ten and face cards,
+ *  faces kept apart since only a face and an Ace make a natural). Both the
+ *  dealer outcome distribution and the player hand value are memoized on the
+ *  remaining category counts plus the hand state.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <atomic>
+#include <chrono>
+#include <string.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/* Local includes */
+#include "enumerator.hpp"
+#include "rules.hpp"
+#include "strategy.hpp"
+
+/* Private defines */
+#define CATS_NR				11		// Card categories
+#define CAT_ACE				0
+#define CAT_TEN				9		// Non face 10
+#define CAT_FACE				10		// Jack, Queen and King
+#define COUNT_BITS			6		// Bits per packed category count
+#define COUNT_MASK			((1ULL << COUNT_BITS) - 1)
+#define ACE_EXTRA_VAL		10		// Ace counted as 11 instead of 1
+#define DEALER_FINALS_NR	6		// Dealer stands on 17 to 21 or busts
+#define DEALER_BUST			5
+
+/* Card category values */
+static const unsigned int catValue[CATS_NR] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 10};
+
+/* Memoization key: packed category counts plus hand state */
+typedef struct __EnumKey__
+	{
+	unsigned long long counts;		// Categories CAT_ACE to CAT_TEN
+	unsigned long long state;		// Face count and hand state
+	bool operator==(const __EnumKey__ &key) const
+		{return (counts == key.counts) && (state == key.state);};
+	}TEnumKey;
+
+/* Memoization key hash */
+struct TEnumKeyHash
+	{
+	size_t operator()(const TEnumKey &key) const
+		{
+		unsigned long long h = key.counts * 0x9E3779B97F4A7C15ULL;
+		h ^= (key.state + 0x632BE59BD9B4E019ULL) * 0xC2B2AE3D27D4EB4FULL;
+		return (size_t)(h ^ (h >> 31));
+		};
+	};
+
+/* Dealer final score distribution, indexed by final score - 17 or DEALER_BUST */
+typedef struct __DealerDist__
+	{
+	double p[DEALER_FINALS_NR];
+	}TDealerDist;
+
+/* Player hand outcome */
+typedef struct __EnumOutcome__
+	{
+	double ev;
+	double win;
+	double push;
+	double loss;
+	}TEnumOutcome;
+
+/*
+ * Enumeration worker. Owns its memoization tables so threads never share
+ * state.
+ * */
+template <typename TRules>
+class TEnumWorker
+	{
+	public:
+		TEnumWorker(const TStrategy &strategy, const unsigned int counts[CATS_NR]);
+		/*
+		 * Weighted outcome of every hand starting with the player cards p1 and p2
+		 * @return: Outcome weighted by the probability of the starting cards
+		 */
+		TEnumOutcome startingHand(unsigned int p1, unsigned int p2, double &pNatural);
+		unsigned long getDealerStates(void) const {return mDealerMemo.size();};
+		unsigned long getPlayerStates(void) const {return mPlayerMemo.size();};
+
+	private:
+		void remove(unsigned int cat);
+		void restore(unsigned int cat);
+		const TDealerDist &dealerDist(unsigned int dHard, bool dAce);
+		TEnumOutcome playerValue(unsigned int pHard, bool pAce, unsigned int dHard,
+				bool dAce, unsigned int upValue);
+		// Score and softness of a hand from its hard total and Ace presence
+		static unsigned int handScore(unsigned int hard, bool ace, bool &soft)
+			{
+			soft = ace && ((hard + ACE_EXTRA_VAL) <= TRules::BLACKJACK_VAL);
+			return soft ? (hard + ACE_EXTRA_VAL) : hard;
+			};
+
+	private:
+		const TStrategy &mStrategy;
+		unsigned int mCounts[CATS_NR];
+		unsigned int mTotal;
+		TEnumKey mKey;		// Packed mCounts
+		std::unordered_map<TEnumKey, TDealerDist, TEnumKeyHash> mDealerMemo;
+		std::unordered_map<TEnumKey, TEnumOutcome, TEnumKeyHash> mPlayerMemo;
+	};
+
+template <typename TRules>
+TEnumWorker<TRules>::TEnumWorker
+	(
+	const TStrategy &strategy,				// Player policy
+	const unsigned int counts[CATS_NR]	// Shoe composition
+	) :
+	mStrategy(strategy),
+	mTotal(0)
+	{
+	mKey.counts = 0;
+	mKey.state = 0;
+	for (unsigned int cat = 0; cat < CATS_NR; cat++)
+		{
+		mCounts[cat] = counts[cat];
+		mTotal += counts[cat];
+		if (cat == CAT_FACE)
+			mKey.state = counts[cat];
+		else
+			mKey.counts |= (unsigned long long)counts[cat] << (cat * COUNT_BITS);
+		}
+	}
+
+/*
+ * Take a card of the argued category out of the shoe
+ */
+template <typename TRules>
+	void
+TEnumWorker<TRules>::remove
+	(
+	unsigned int cat
+	)
+	{
+	mCounts[cat]--;
+	mTotal--;
+	if (cat == CAT_FACE)
+		mKey.state--;
+	else
+		mKey.counts -= 1ULL << (cat * COUNT_BITS);
+	}
+
+/*
+ * Put back a card taken by remove()
+ */
+template <typename TRules>
+	void
+TEnumWorker<TRules>::restore
+	(
+	unsigned int cat
+	)
+	{
+	mCounts[cat]++;
+	mTotal++;
+	if (cat == CAT_FACE)
+		mKey.state++;
+	else
+		mKey.counts += 1ULL << (cat * COUNT_BITS);
+	}
+
+/*
+ * Dealer final score distribution from the current shoe
+ * Rules: 	- Dealer hits soft 17 if TRules::HIT_SOFT_17.
+ * 			- Dealer stands on hard 17 or higher soft or hard hands.
+ * @return: Distribution over the final scores
+ */
+template <typename TRules>
+	const TDealerDist &
+TEnumWorker<TRules>::dealerDist
+	(
+	unsigned int dHard,		// Dealer hard total
+	bool dAce					// Dealer hand holds an Ace
+	)
+	{
+	TEnumKey key = mKey;
+	key.state = (mKey.state & COUNT_MASK) | (dHard << COUNT_BITS) |
+			((unsigned long long)dAce << (COUNT_BITS + 5));
+	typename std::unordered_map<TEnumKey, TDealerDist, TEnumKeyHash>::iterator it =
+			mDealerMemo.find(key);
+	if (it != mDealerMemo.end())
+		return it->second;
+
+	TDealerDist dist;
+	memset((void *)&dist, 0, sizeof(dist));
+	bool soft;
+	unsigned int score = handScore(dHard, dAce, soft);
+	if (score > TRules::BLACKJACK_VAL)
+		dist.p[DEALER_BUST] = 1.0;
+	else if ((score >= TRules::DEALER_HIT_LIMIT) &&
+			!(TRules::HIT_SOFT_17 && soft && (score == TRules::DEALER_HIT_LIMIT)))
+		dist.p[score - TRules::DEALER_HIT_LIMIT] = 1.0;
+	else if (!mTotal)
+		dist.p[DEALER_BUST] = 1.0;	// Unreachable with ENUM_MIN_CARDS cards
+	else
+		{
+		double total = (double)mTotal;
+		for (unsigned int cat = 0; cat < CATS_NR; cat++)
+			{
+			if (!mCounts[cat])
+				continue;
+			double p = (double)mCounts[cat] / total;
+			remove(cat);
+			const TDealerDist &next = dealerDist(dHard + catValue[cat], dAce || (cat == CAT_ACE));
+			for (unsigned int i = 0; i < DEALER_FINALS_NR; i++)
+				dist.p[i] += p * next.p[i];
+			restore(cat);
+			}
+		}
+
+	return mDealerMemo.insert(std::make_pair(key, dist)).first->second;
+	}
+
+/*
+ * Player hand value when the player follows the policy from the current shoe
+ * @return: Outcome of the hand
+ */
+template <typename TRules>
+	TEnumOutcome
+TEnumWorker<TRules>::playerValue
+	(
+	unsigned int pHard,		// Player hard total
+	bool pAce,					// Player hand holds an Ace
+	unsigned int dHard,		// Dealer hard total
+	bool dAce,					// Dealer hand holds an Ace
+	unsigned int upValue		// Dealer up card value
+	)
+	{
+	TEnumOutcome out;
+	memset((void *)&out, 0, sizeof(out));
+	bool soft;
+	unsigned int score = handScore(pHard, pAce, soft);
+	if (score > TRules::BLACKJACK_VAL)
+		{
+		out.ev = -1.0;
+		out.loss = 1.0;
+		return out;
+		}
+
+	TEnumKey key = mKey;
+	key.state = (mKey.state & COUNT_MASK) | (1ULL << 63) |
+			((unsigned long long)pHard << COUNT_BITS) |
+			((unsigned long long)pAce << (COUNT_BITS + 5)) |
+			((unsigned long long)dHard << (COUNT_BITS + 6)) |
+			((unsigned long long)dAce << (COUNT_BITS + 11)) |
+			((unsigned long long)upValue << (COUNT_BITS + 12));
+	typename std::unordered_map<TEnumKey, TEnumOutcome, TEnumKeyHash>::iterator it =
+			mPlayerMemo.find(key);
+	if (it != mPlayerMemo.end())
+		return it->second;
+
+	if ((mStrategy.decide(score, soft, upValue, 0, 0) != ACTION_HIT) || !mTotal)
+		{
+		const TDealerDist &dist = dealerDist(dHard, dAce);
+		out.win = dist.p[DEALER_BUST];
+		for (unsigned int i = 0; i < DEALER_BUST; i++)
+			{
+			unsigned int final = TRules::DEALER_HIT_LIMIT + i;
+			if (TRules::PUSH_ON_TIE && (final == score))
+				out.push += dist.p[i];
+			else if (final >= score)
+				out.loss += dist.p[i];
+			else
+				out.win += dist.p[i];
+			}
+		out.ev = out.win - out.loss;
+		}
+	else
+		{
+		double total = (double)mTotal;
+		for (unsigned int cat = 0; cat < CATS_NR; cat++)
+			{
+			if (!mCounts[cat])
+				continue;
+			double p = (double)mCounts[cat] / total;
+			remove(cat);
+			TEnumOutcome next = playerValue(pHard + catValue[cat], pAce || (cat == CAT_ACE),
+					dHard, dAce, upValue);
+			restore(cat);
+			out.ev += p * next.ev;
+			out.win += p * next.win;
+			out.push += p * next.push;
+			out.loss += p * next.loss;
+			}
+		}
+
+	mPlayerMemo.insert(std::make_pair(key, out));
+	return out;
+	}
+
+/*
+ * Weighted outcome of every hand starting with the player cards p1 and p2.
+ * Cards are dealt as the engine does: two to the player, then the dealer's
+ * card facing down and the one facing up.
+ * @return: Outcome weighted by the probability of the starting cards
+ */
+template <typename TRules>
+	TEnumOutcome
+TEnumWorker<TRules>::startingHand
+	(
+	unsigned int p1,			// Player first card category
+	unsigned int p2,			// Player second card category
+	double &pNatural			// Out argument. Probability of a player natural win
+	)
+	{
+	TEnumOutcome out;
+	memset((void *)&out, 0, sizeof(out));
+	pNatural = 0.0;
+	if (!mCounts[p1])
+		return out;
+	double w1 = (double)mCounts[p1] / (double)mTotal;
+	remove(p1);
+	if (!mCounts[p2])
+		{
+		restore(p1);
+		return out;
+		}
+	double w12 = w1 * (double)mCounts[p2] / (double)mTotal;
+	remove(p2);
+
+	const double natPay = (double)TRules::NATURAL_PAY_NUM / (double)TRules::NATURAL_PAY_DEN;
+	bool userNat = ((p1 == CAT_ACE) && (p2 == CAT_FACE)) || ((p1 == CAT_FACE) && (p2 == CAT_ACE));
+	for (unsigned int hole = 0; hole < CATS_NR; hole++)
+		{
+		if (!mCounts[hole])
+			continue;
+		double wh = w12 * (double)mCounts[hole] / (double)mTotal;
+		remove(hole);
+		for (unsigned int up = 0; up < CATS_NR; up++)
+			{
+			if (!mCounts[up])
+				continue;
+			double w = wh * (double)mCounts[up] / (double)mTotal;
+			remove(up);
+
+			bool dealerNat = ((hole == CAT_ACE) && (up == CAT_FACE)) ||
+					((hole == CAT_FACE) && (up == CAT_ACE));
+			// Dealer 21 without a natural: an Ace and a non face 10
+			bool dealer21 = ((hole == CAT_ACE) && (up == CAT_TEN)) ||
+					((hole == CAT_TEN) && (up == CAT_ACE));
+			if (dealerNat && userNat)
+				out.push += w;
+			else if (dealerNat || (!userNat && dealer21))
+				{
+				out.loss += w;
+				out.ev -= w;
+				}
+			else if (userNat)
+				{
+				out.win += w;
+				out.ev += w * natPay;
+				pNatural += w;
+				}
+			else
+				{
+				TEnumOutcome hand = playerValue(catValue[p1] + catValue[p2],
+						(p1 == CAT_ACE) || (p2 == CAT_ACE), catValue[hole] + catValue[up],
+						(hole == CAT_ACE) || (up == CAT_ACE), catValue[up]);
+				out.ev += w * hand.ev;
+				out.win += w * hand.win;
+				out.push += w * hand.push;
+				out.loss += w * hand.loss;
+				}
+			restore(up);
+			}
+		restore(hole);
+		}
+	restore(p2);
+	restore(p1);
+	return out;
+	}
+
+/*
+ * Enumeration run for one rule set. Instantiated by dispatchRules().
+ */
+class TEnumRunner
+	{
+	public:
+		TEnumRunner(const TEnumConfig &config, const unsigned int counts[CATS_NR],
+				TEnumResult &result) : mConfig(config), mCounts(counts), mResult(result) {};
+		template <typename TRules> int run(void);
+
+	private:
+		const TEnumConfig &mConfig;
+		const unsigned int *mCounts;
+		TEnumResult &mResult;
+	};
+
+/*
+ * Spread the starting player hands over the worker threads and add up their
+ * outcomes in a fixed order, so results do not depend on the thread count
+ * @return: - 0 - Success enumerating
+ */
+template <typename TRules>
+	int
+TEnumRunner::run
+	(
+	void
+	)
+	{
+	const unsigned int itemsNr = CATS_NR * CATS_NR;
+	std::vector<TEnumOutcome> outcomes(itemsNr);
+	std::vector<double> naturals(itemsNr, 0.0);
+	std::atomic<unsigned int> next(0);
+	std::atomic<unsigned long> dealerStates(0);
+	std::atomic<unsigned long> playerStates(0);
+	TStrategy strategy((TPolicyType)mConfig.policy);
+
+	unsigned int threadsNr = mConfig.threads ? mConfig.threads :
+			std::thread::hardware_concurrency();
+	if (!threadsNr)
+		threadsNr = 1;
+
+	std::vector<std::thread> threads;
+	for (unsigned int t = 0; t < threadsNr; t++)
+		threads.push_back(std::thread([&]()
+			{
+			TEnumWorker<TRules> worker(strategy, mCounts);
+			for (unsigned int item = next++; item < itemsNr; item = next++)
+				outcomes[item] = worker.startingHand(item / CATS_NR, item % CATS_NR,
+						naturals[item]);
+			dealerStates += worker.getDealerStates();
+			playerStates += worker.getPlayerStates();
+			}));
+	for (unsigned int t = 0; t < threadsNr; t++)
+		threads[t].join();
+
+	for (unsigned int item = 0; item < itemsNr; item++)
+		{
+		mResult.ev += outcomes[item].ev;
+		mResult.pWin += outcomes[item].win;
+		mResult.pPush += outcomes[item].push;
+		mResult.pLoss += outcomes[item].loss;
+		mResult.pNatural += naturals[item];
+		}
+	mResult.dealerStates = dealerStates;
+	mResult.playerStates = playerStates;
+	return 0;
+	}
+
+/*
+ * Walk every dealing order reachable from the configured shoe, weighting
+ * each by its probability
+ * @return: - 0 - Success enumerating. Otherwise,
+ * 			Error (invalid configuration)
+ */
+	int
+enumerateHands
+	(
+	const TEnumConfig &config,		// In
+	TEnumResult 		&result		// Out argument
+	)
+	{
+	int ret = -1;  // Assume invalid configuration
+	memset((void *)&result, 0, sizeof(result));
+	// Count free hit/stand policies only (no table file or full basic strategy)
+	if (!config.decks || (config.decks > ENUM_MAX_DECKS) ||
+			(config.rules >= RULES_VARIANTS_NR) || (config.policy >= POLICY_TABLES))
+		return ret;
+
+	// Shoe composition per category. Jacks, Queens and Kings share CAT_FACE
+	unsigned int counts[CATS_NR];
+	unsigned int total = 0;
+	for (unsigned int cat = 0; cat < CATS_NR; cat++)
+		counts[cat] = config.decks * SUITS_NR * ((cat == CAT_FACE) ? 3 : 1);
+	for (unsigned int rank = 1; rank <= TDealer::RANKS_NR; rank++)
+		{
+		unsigned int cat = (rank > 10) ? CAT_FACE : (rank - 1);
+		if (config.removed[rank - 1] > (config.decks * SUITS_NR))
+			return ret;
+		counts[cat] -= config.removed[rank - 1];
+		}
+	for (unsigned int cat = 0; cat < CATS_NR; cat++)
+		total += counts[cat];
+	if (total < ENUM_MIN_CARDS)
+		return ret;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	TEnumRunner runner(config, counts, result);
+	ret = dispatchRules(config.rules, runner);
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	result.elapsedSecs = elapsed.count();
+	return ret;
+	}
@@ -0,0 +1,61 @@
+/******************************************************************************/
+/*!
+ * @file:					  enumerator.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the exhaustive hand
+ *  					enumerator. Computes the exact outcome of one hand dealt
+ *  					from a small (reduced) shoe under the engine rules and a
+ *  					fixed player policy.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __ENUMERATOR_HPP__
+#define __ENUMERATOR_HPP__
+
+/* Local includes */
+#include "dealer.hpp"
+
+/* Defines */
+
+// Largest shoe the enumerator accepts
+#define ENUM_MAX_DECKS		2
+// Smallest shoe the enumerator accepts. No hand can empty it
+#define ENUM_MIN_CARDS		26
+
+/* Enumerations, type defines */
+
+/* Enumeration configuration */
+typedef struct __EnumConfig__
+	{
+	unsigned int rules;		// TRuleFlags
+	unsigned int decks;		// Decks in the shoe
+	unsigned int policy;		// TPolicyType
+	unsigned int removed[TDealer::RANKS_NR];	// Cards left out of the shoe, per rank (Ace first)
+	unsigned int threads;	// Worker threads. 0, one per hardware thread
+	}TEnumConfig;
+
+/* Exact outcome of one hand */
+typedef struct __EnumResult__
+	{
+	double ev;					// Expected player net result in bets
+	double pWin;				// User wins, naturals included
+	double pNatural;			// User wins with a natural
+	double pPush;
+	double pLoss;
+	unsigned long dealerStates;	// Memoized dealer states
+	unsigned long playerStates;	// Memoized player states
+	double elapsedSecs;
+	}TEnumResult;
+
+/*
+ * Walk every dealing order reachable from the configured shoe, weighting
+ * each by its probability. Starting hands are spread over worker threads.
+ * @return: - 0 - Success enumerating. Otherwise,
+ * 			Error (invalid configuration)
+ */
+int enumerateHands (const TEnumConfig &config, TEnumResult &result);
+
+#endif /* __ENUMERATOR_HPP__ */
@@ -0,0 +1,650 @@
+/******************************************************************************/
+/*!
+ * @file:					  history.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the hand history store.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Local includes */
+#include "history.hpp"
+
+/* Private defines */
+#define BITMAP_WORD_BITS		64
+#define BITMAP_MAX_FILL			0x7FFFFFFFULL		// Fill words one marker holds
+#define BITMAP_MAX_LITERALS	0xFFFFFFFFULL		// Literal words one marker holds
+#define COLUMN_BUFFER_SIZE		(1 << 16)
+
+/* Column names, indexed by THistoryColumn */
+static const char *columnNames[HISTORY_COLUMNS_NR] =
+	{
+	"total", "soft", "up", "count", "action", "first", "result"
+	};
+
+/*
+ * Column name
+ * @return: Column name
+ */
+	const char *
+historyColumnName
+	(
+	THistoryColumn column		// Store column
+	)
+	{
+	return (column < HISTORY_COLUMNS_NR) ? columnNames[column] : "unknown";
+	}
+
+/*
+ * Column from its name
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (unknown column)
+ */
+	int
+historyColumnFromName
+	(
+	const std::string &name,		// Column name
+	THistoryColumn 	&column		// Out argument
+	)
+	{
+	for (unsigned int i = 0; i < HISTORY_COLUMNS_NR; i++)
+		if (name == columnNames[i])
+			{
+			column = (THistoryColumn)i;
+			return 0;
+			}
+	return -1;
+	}
+
+/*
+ * Run length bitmap encoder
+ * Words are added in row order; a marker word opens every fill followed by
+ * its literal words.
+ */
+class TBitmapEncoder
+	{
+	public:
+		TBitmapEncoder(void) : mFillBit(0), mFillLen(0) {};
+		void add(uint64_t word)
+			{
+			if (!word || (word == ~0ULL))
+				{
+				uint64_t bit = word ? 1 : 0;
+				if (!mLiterals.empty() || (mFillLen && (bit != mFillBit)) ||
+						(mFillLen == BITMAP_MAX_FILL))
+					flush();
+				mFillBit = bit;
+				mFillLen++;
+				return;
+				}
+			if (mLiterals.size() == BITMAP_MAX_LITERALS)
+				flush();
+			mLiterals.push_back(word);
+			};
+		// Words of the encoded bitmap, complete after the last add(). An all zero
+		// bitmap has no words
+		const std::vector<uint64_t> &finish(void)
+			{
+			flush();
+			if ((mWords.size() == 1) && !(mWords[0] >> 63) && !(mWords[0] & BITMAP_MAX_LITERALS))
+				mWords.clear();
+			return mWords;
+			};
+
+	private:
+		void flush(void)
+			{
+			if (!mFillLen && mLiterals.empty())
+				return;
+			mWords.push_back((mFillBit << 63) | (mFillLen << 32) | (uint64_t)mLiterals.size());
+			mWords.insert(mWords.end(), mLiterals.begin(), mLiterals.end());
+			mFillLen = 0;
+			mLiterals.clear();
+			};
+
+	private:
+		std::vector<uint64_t> mWords;
+		std::vector<uint64_t> mLiterals;	// Literal words after the current fill
+		uint64_t mFillBit;
+		uint64_t mFillLen;
+	};
+
+/* Run length bitmap decoder, one uncompressed word at a time */
+typedef struct __BitmapCursor__
+	{
+	const uint64_t *p;
+	const uint64_t *end;
+	uint64_t fillWord;
+	uint64_t fillLeft;
+	uint64_t literalsLeft;
+	}TBitmapCursor;
+
+/*
+ * Next uncompressed word of a bitmap
+ * @return: Word, 0 past the end
+ */
+	static inline uint64_t
+nextWord
+	(
+	TBitmapCursor &cursor		// In/Out argument
+	)
+	{
+	for (;;)
+		{
+		if (cursor.fillLeft)
+			{
+			cursor.fillLeft--;
+			return cursor.fillWord;
+			}
+		if (cursor.literalsLeft)
+			{
+			cursor.literalsLeft--;
+			return *cursor.p++;
+			}
+		if (cursor.p >= cursor.end)
+			return 0;
+		uint64_t marker = *cursor.p++;
+		cursor.fillWord = (marker >> 63) ? ~0ULL : 0;
+		cursor.fillLeft = (marker >> 32) & BITMAP_MAX_FILL;
+		cursor.literalsLeft = marker & BITMAP_MAX_LITERALS;
+		if (cursor.literalsLeft > (uint64_t)(cursor.end - cursor.p))
+			cursor.literalsLeft = cursor.end - cursor.p;
+		}
+	}
+
+/*
+ * Rows of a block holding 'lo' to 'lo + range', one bit per row. Compares
+ * into a byte per row first, a loop the compiler vectorizes, then packs the
+ * bytes eight at a time.
+ * @return: Row mask, bit i for row i of the block
+ */
+template <typename TValue>
+	static inline uint64_t
+scanMask
+	(
+	const TValue *values,		// First value of the block
+	unsigned int n,				// Rows in the block, up to BITMAP_WORD_BITS
+	int 			 lo,				// Lowest value passing
+	unsigned int range			// Highest minus lowest value passing
+	)
+	{
+	unsigned char flags[BITMAP_WORD_BITS];
+	for (unsigned int i = 0; i < n; i++)
+		flags[i] = ((unsigned int)((int)values[i] - lo) <= range) ? 1 : 0;
+	for (unsigned int i = n; i < BITMAP_WORD_BITS; i++)
+		flags[i] = 0;
+	uint64_t mask = 0;
+	for (unsigned int k = 0; k < BITMAP_WORD_BITS / 8; k++)
+		{
+		uint64_t bytes;
+		memcpy(&bytes, flags + 8 * k, sizeof(bytes));
+		mask |= ((bytes * 0x0102040810204080ULL) >> 56) << (8 * k);
+		}
+	return mask;
+	}
+
+THistoryWriter::THistoryWriter
+	(
+	void
+	) :
+	mPendingNr(0)
+	{
+	memset((void *)mFiles, 0, sizeof(mFiles));
+	memset((void *)&mMeta, 0, sizeof(mMeta));
+	}
+
+THistoryWriter::~THistoryWriter
+	(
+	void
+	)
+	{
+	for (unsigned int i = 0; i < HISTORY_COLUMNS_NR; i++)
+		if (mFiles[i])
+			fclose(mFiles[i]);
+	}
+
+/*
+ * Create the store directory and its column files
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (I/O error)
+ */
+	int
+THistoryWriter::create
+	(
+	const std::string &dir,			// Store directory
+	unsigned int 		rules,		// TRuleFlags
+	unsigned int 		decks,		// Decks in the shoe
+	unsigned int 		policy,		// TPolicyType
+	unsigned long long seed			// Simulation seed
+	)
+	{
+	int ret = -1;   // Assume error creating
+	if (mkdir(dir.c_str(), 0755) && (errno != EEXIST))
+		return ret;
+	mDir = dir;
+	memcpy(mMeta.magic, HISTORY_META_MAGIC, sizeof(mMeta.magic));
+	mMeta.version = HISTORY_VERSION;
+	mMeta.rules = rules;
+	mMeta.decks = decks;
+	mMeta.policy = policy;
+	mMeta.seed = seed;
+	for (unsigned int i = 0; i < HISTORY_COLUMNS_NR; i++)
+		{
+		std::string path = mDir + "/" + columnNames[i] + ".col";
+		mFiles[i] = fopen(path.c_str(), "wb");
+		if (!mFiles[i])
+			return ret;
+		setvbuf(mFiles[i], NULL, _IOFBF, COLUMN_BUFFER_SIZE);
+		}
+	ret = 0;
+	return ret;
+	}
+
+/*
+ * The hand ended: write its rows with its net result
+ */
+	void
+THistoryWriter::endHand
+	(
+	double net		// Hand net result, in bets
+	)
+	{
+	if (!mFiles[0] || !mPendingNr)
+		{
+		mPendingNr = 0;
+		return;
+		}
+	int16_t tenths = (int16_t)lround(net * 10.0);
+	for (unsigned int r = 0; r < mPendingNr; r++)
+		{
+		for (unsigned int c = 0; c < HISTORY_INDEXED_NR; c++)
+			putc_unlocked(mPending[r][c], mFiles[c]);
+		fwrite(&tenths, sizeof(tenths), 1, mFiles[HISTORY_RESULT]);
+		}
+	mMeta.rows += mPendingNr;
+	mMeta.hands++;
+	mPendingNr = 0;
+	}
+
+/*
+ * Flush the columns, write the metadata and build the bitmap indexes
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (I/O error)
+ */
+	int
+THistoryWriter::close
+	(
+	void
+	)
+	{
+	int ret = -1;   // Assume error closing
+	bool ok = true;
+	for (unsigned int i = 0; i < HISTORY_COLUMNS_NR; i++)
+		if (mFiles[i])
+			{
+			ok = (fclose(mFiles[i]) == 0) && ok;
+			mFiles[i] = NULL;
+			}
+	if (!ok || mDir.empty())
+		return ret;
+
+	for (unsigned int i = 0; i < HISTORY_INDEXED_NR; i++)
+		if (buildIndex((THistoryColumn)i))
+			return ret;
+	// Metadata last: a store without it is incomplete
+	std::string path = mDir + "/meta";
+	FILE *file = fopen(path.c_str(), "wb");
+	if (!file)
+		return ret;
+	ok = (fwrite(&mMeta, sizeof(mMeta), 1, file) == 1);
+	ok = (fclose(file) == 0) && ok;
+	if (!ok)
+		return ret;
+	ret = 0;
+	return ret;
+	}
+
+/*
+ * Build the bitmap index of an indexed column file
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (I/O error)
+ */
+	int
+THistoryWriter::buildIndex
+	(
+	THistoryColumn column		// Indexed column
+	)
+	{
+	int ret = -1;   // Assume error building
+	std::string path = mDir + "/" + columnNames[column];
+	const unsigned char *values = NULL;
+	size_t size = (size_t)mMeta.rows;
+	int fd = ::open((path + ".col").c_str(), O_RDONLY);
+	if (fd < 0)
+		return ret;
+	if (size)
+		{
+		void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+		if (map == MAP_FAILED)
+			{
+			::close(fd);
+			return ret;
+			}
+		madvise(map, size, MADV_SEQUENTIAL);
+		values = (const unsigned char *)map;
+		}
+	::close(fd);
+
+	// One word per value per block of 64 rows
+	TBitmapEncoder encoders[HISTORY_MAX_VALUES];
+	for (uint64_t base = 0; base < mMeta.rows; base += BITMAP_WORD_BITS)
+		{
+		uint64_t words[HISTORY_MAX_VALUES];
+		memset((void *)words, 0, sizeof(words));
+		uint64_t n = mMeta.rows - base;
+		if (n > BITMAP_WORD_BITS)
+			n = BITMAP_WORD_BITS;
+		for (uint64_t i = 0; i < n; i++)
+			words[values[base + i] & (HISTORY_MAX_VALUES - 1)] |= 1ULL << i;
+		for (unsigned int v = 0; v < HISTORY_MAX_VALUES; v++)
+			encoders[v].add(words[v]);
+		}
+	if (values)
+		munmap((void *)values, size);
+
+	THistoryIndexHeader header;
+	memset((void *)&header, 0, sizeof(header));
+	memcpy(header.magic, HISTORY_INDEX_MAGIC, sizeof(header.magic));
+	header.version = HISTORY_VERSION;
+	header.valuesNr = HISTORY_MAX_VALUES;
+	header.rows = mMeta.rows;
+	for (unsigned int v = 0; v < HISTORY_MAX_VALUES; v++)
+		header.offsets[v + 1] = header.offsets[v] + encoders[v].finish().size();
+
+	FILE *file = fopen((path + ".idx").c_str(), "wb");
+	if (!file)
+		return ret;
+	bool ok = (fwrite(&header, sizeof(header), 1, file) == 1);
+	for (unsigned int v = 0; ok && (v < HISTORY_MAX_VALUES); v++)
+		{
+		const std::vector<uint64_t> &words = encoders[v].finish();
+		ok = words.empty() || (fwrite(words.data(), sizeof(uint64_t), words.size(), file) ==
+				words.size());
+		}
+	ok = (fclose(file) == 0) && ok;
+	if (!ok)
+		return ret;
+	ret = 0;
+	return ret;
+	}
+
+THistoryStore::THistoryStore
+	(
+	void
+	) :
+	mOpen(false)
+	{
+	memset((void *)&mMeta, 0, sizeof(mMeta));
+	memset((void *)mMaps, 0, sizeof(mMaps));
+	memset((void *)mSizes, 0, sizeof(mSizes));
+	memset((void *)mIndexes, 0, sizeof(mIndexes));
+	memset((void *)mIndexSizes, 0, sizeof(mIndexSizes));
+	}
+
+THistoryStore::~THistoryStore
+	(
+	void
+	)
+	{
+	close();
+	}
+
+/*
+ * Map a store file read only
+ * @return: Mapping, NULL if it cannot be mapped or is empty ('size' 0)
+ */
+	const void *
+THistoryStore::map
+	(
+	const std::string &path,		// File path
+	size_t 				&size			// Out argument, file size
+	)
+	{
+	size = 0;
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return NULL;
+	struct stat st;
+	void *map = MAP_FAILED;
+	if (!fstat(fd, &st) && st.st_size)
+		map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (map == MAP_FAILED)
+		return NULL;
+	size = (size_t)st.st_size;
+	return map;
+	}
+
+/*
+ * Map a store and check its metadata and file sizes
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (missing files, bad magic, version or sizes)
+ */
+	int
+THistoryStore::open
+	(
+	const std::string &dir		// Store directory
+	)
+	{
+	int ret = -1;   // Assume the store cannot be used
+	close();
+	FILE *file = fopen((dir + "/meta").c_str(), "rb");
+	if (!file)
+		return ret;
+	bool ok = (fread(&mMeta, sizeof(mMeta), 1, file) == 1);
+	fclose(file);
+	if (!ok || memcmp(mMeta.magic, HISTORY_META_MAGIC, sizeof(mMeta.magic)) ||
+			(mMeta.version != HISTORY_VERSION))
+		return ret;
+	mOpen = true;
+	if (!mMeta.rows)
+		{
+		ret = 0;
+		return ret;
+		}
+
+	for (unsigned int i = 0; i < HISTORY_COLUMNS_NR; i++)
+		{
+		size_t width = (i == HISTORY_RESULT) ? sizeof(int16_t) : sizeof(unsigned char);
+		mMaps[i] = map(dir + "/" + columnNames[i] + ".col", mSizes[i]);
+		if (!mMaps[i] || (mSizes[i] != mMeta.rows * width))
+			{
+			close();
+			return ret;
+			}
+		}
+	for (unsigned int i = 0; i < HISTORY_INDEXED_NR; i++)
+		{
+		mIndexes[i] = (const unsigned char *)map(dir + "/" + columnNames[i] + ".idx",
+				mIndexSizes[i]);
+		const THistoryIndexHeader *header = (const THistoryIndexHeader *)mIndexes[i];
+		if (!header || (mIndexSizes[i] < sizeof(*header)) ||
+				memcmp(header->magic, HISTORY_INDEX_MAGIC, sizeof(header->magic)) ||
+				(header->version != HISTORY_VERSION) ||
+				(header->valuesNr != HISTORY_MAX_VALUES) || (header->rows != mMeta.rows) ||
+				(sizeof(*header) + header->offsets[HISTORY_MAX_VALUES] * sizeof(uint64_t) !=
+				mIndexSizes[i]))
+			{
+			close();
+			return ret;
+			}
+		}
+	ret = 0;
+	return ret;
+	}
+
+	void
+THistoryStore::close
+	(
+	void
+	)
+	{
+	for (unsigned int i = 0; i < HISTORY_COLUMNS_NR; i++)
+		if (mMaps[i])
+			munmap((void *)mMaps[i], mSizes[i]);
+	for (unsigned int i = 0; i < HISTORY_INDEXED_NR; i++)
+		if (mIndexes[i])
+			munmap((void *)mIndexes[i], mIndexSizes[i]);
+	memset((void *)mMaps, 0, sizeof(mMaps));
+	memset((void *)mSizes, 0, sizeof(mSizes));
+	memset((void *)mIndexes, 0, sizeof(mIndexes));
+	memset((void *)mIndexSizes, 0, sizeof(mIndexSizes));
+	mOpen = false;
+	}
+
+/*
+ * Compressed bitmap of the rows holding 'code' in an indexed column
+ * @return: Bitmap words, 'words' set to their number
+ */
+	const uint64_t *
+THistoryStore::getBitmap
+	(
+	THistoryColumn column,		// Indexed column
+	unsigned int 	code,			// Stored value
+	size_t 			&words		// Out argument
+	) const
+	{
+	words = 0;
+	if ((column >= HISTORY_INDEXED_NR) || (code >= HISTORY_MAX_VALUES) || !mIndexes[column])
+		return NULL;
+	const THistoryIndexHeader *header = (const THistoryIndexHeader *)mIndexes[column];
+	const uint64_t *payload = (const uint64_t *)(mIndexes[column] + sizeof(*header));
+	words = header->offsets[code + 1] - header->offsets[code];
+	return payload + header->offsets[code];
+	}
+
+/*
+ * Aggregate the rows passing every filter
+ * Bitmaps of the values passing an indexed filter are OR-ed, filters AND-ed,
+ * 64 rows at a time. The result column is only read for the rows passing.
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (no store open or invalid filter)
+ */
+	int
+THistoryStore::query
+	(
+	const std::vector<THistoryFilter> &filters,		// Filters, all must pass
+	bool 										 scan,		// Scan every column, no index
+	THistoryAggregate 					 &aggregate	// Out argument
+	) const
+	{
+	int ret = -1;   // Assume error querying
+	memset((void *)&aggregate, 0, sizeof(aggregate));
+	if (!mOpen)
+		return ret;
+
+	std::vector< std::vector<TBitmapCursor> > indexed;
+	std::vector<THistoryFilter> scanned;		// Filters on stored codes
+	for (unsigned int f = 0; f < filters.size(); f++)
+		{
+		THistoryFilter filter = filters[f];
+		if ((filter.column >= HISTORY_COLUMNS_NR) || (filter.lo > filter.hi))
+			return ret;
+		if (filter.column == HISTORY_COUNT)
+			{
+			filter.lo -= HISTORY_COUNT_MIN;
+			filter.hi -= HISTORY_COUNT_MIN;
+			}
+		if (filter.column != HISTORY_RESULT)
+			{
+			filter.lo = (filter.lo < 0) ? 0 : filter.lo;
+			filter.hi = (filter.hi >= HISTORY_MAX_VALUES) ? HISTORY_MAX_VALUES - 1 : filter.hi;
+			}
+		if (scan || (filter.column == HISTORY_RESULT))
+			{
+			scanned.push_back(filter);
+			continue;
+			}
+		indexed.push_back(std::vector<TBitmapCursor>());
+		for (int code = filter.lo; code <= filter.hi; code++)
+			{
+			TBitmapCursor cursor;
+			size_t words;
+			memset((void *)&cursor, 0, sizeof(cursor));
+			cursor.p = getBitmap((THistoryColumn)filter.column, code, words);
+			cursor.end = cursor.p + words;
+			if (words)
+				indexed.back().push_back(cursor);
+			}
+		// No row holds any of the values
+		if (indexed.back().empty())
+			{
+			ret = 0;
+			return ret;
+			}
+		}
+
+	const unsigned char *first = getColumn(HISTORY_FIRST);
+	const int16_t *results = getResults();
+	for (uint64_t base = 0; base < mMeta.rows; base += BITMAP_WORD_BITS)
+		{
+		uint64_t n = mMeta.rows - base;
+		uint64_t mask = (n >= BITMAP_WORD_BITS) ? ~0ULL : ((1ULL << n) - 1);
+		n = (n > BITMAP_WORD_BITS) ? BITMAP_WORD_BITS : n;
+		// Every cursor moves one word, whatever the mask
+		for (unsigned int f = 0; f < indexed.size(); f++)
+			{
+			uint64_t passing = 0;
+			for (unsigned int c = 0; c < indexed[f].size(); c++)
+				passing |= nextWord(indexed[f][c]);
+			mask &= passing;
+			}
+		for (unsigned int f = 0; mask && (f < scanned.size()); f++)
+			{
+			const THistoryFilter &filter = scanned[f];
+			unsigned int range = (unsigned int)(filter.hi - filter.lo);
+			if (filter.column == HISTORY_RESULT)
+				mask &= scanMask(results + base, n, filter.lo, range);
+			else
+				mask &= scanMask(getColumn((THistoryColumn)filter.column) + base, n,
+						filter.lo, range);
+			}
+		if (!mask)
+			continue;
+
+		aggregate.rows += __builtin_popcountll(mask);
+		if (mask == ~0ULL)
+			{
+			// Whole block: straight loops over the columns
+			for (unsigned int i = 0; i < BITMAP_WORD_BITS; i++)
+				{
+				int64_t r = results[base + i];
+				aggregate.hands += first[base + i];
+				aggregate.resultTenths += r;
+				aggregate.squaredTenths += (uint64_t)(r * r);
+				}
+			continue;
+			}
+		for (uint64_t bits = mask; bits; bits &= bits - 1)
+			{
+			uint64_t row = base + __builtin_ctzll(bits);
+			int64_t r = results[row];
+			aggregate.hands += first[row];
+			aggregate.resultTenths += r;
+			aggregate.squaredTenths += (uint64_t)(r * r);
+			}
+		}
+	ret = 0;
+	return ret;
+	}
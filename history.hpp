@@ -0,0 +1,236 @@
+/******************************************************************************/
+/*!
+ * @file:					  history.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the hand history store. A
+ *  					columnar on disk store of every player decision of a
+ *  					simulation, with compressed bitmap indexes on the low
+ *  					cardinality columns, and the queries run on it.
+ *
+ *  Store layout (a directory, host byte order):
+ *  	meta						THistoryMeta
+ *  	<column>.col			One value per row: uint8_t, int16_t for 'result'
+ *  	<column>.idx			Indexed columns: THistoryIndexHeader, then the
+ *  								compressed bitmap of every value (see below)
+ *
+ *  Rows are player decisions, in play order. A hand settled before the player
+ *  acts (naturals and dealer two card 21) is one row of action 'none'. Every
+ *  row of a hand carries the hand net result.
+ *
+ *  Bitmaps are run length compressed 64 bit words (as EWAH): a marker word,
+ *  fill bit (63), fill length in words (62 to 32) and literal words that
+ *  follow (31 to 0), then the literal words.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __HISTORY_HPP__
+#define __HISTORY_HPP__
+
+/* Library includes */
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/* Defines */
+
+#define HISTORY_META_MAGIC		"BJHISTRY"
+#define HISTORY_INDEX_MAGIC	"BJBITMAP"
+#define HISTORY_VERSION			1
+// Values an indexed column code can take
+#define HISTORY_MAX_VALUES		32
+// Floored Hi-Lo true counts, stored from HISTORY_COUNT_MIN, ends clamped
+#define HISTORY_COUNT_MIN		-5
+#define HISTORY_COUNT_MAX		10
+// Decisions one hand can take, split hands included
+#define HISTORY_MAX_PENDING	64
+
+/* Enumerations, type defines */
+
+/* Store columns. Indexed columns first */
+typedef enum __HistoryColumn__
+	{
+	HISTORY_TOTAL,			// Player score at the decision
+	HISTORY_SOFT,			// 1 if the score is soft
+	HISTORY_UP,				// Dealer up card value
+	HISTORY_COUNT,			// Floored Hi-Lo true count, hole card excluded
+	HISTORY_ACTION,		// TPlayerAction taken, HISTORY_ACTION_NONE
+	HISTORY_FIRST,			// 1 on the first row of a hand
+	HISTORY_INDEXED_NR,
+	HISTORY_RESULT = HISTORY_INDEXED_NR,	// Hand net result, tenths of a bet
+	HISTORY_COLUMNS_NR
+	}THistoryColumn;
+
+// Action of a hand settled before the player acts
+#define HISTORY_ACTION_NONE	6
+
+/* Store description */
+typedef struct __HistoryMeta__
+	{
+	char magic[8];				// HISTORY_META_MAGIC, no terminator
+	uint32_t version;			// HISTORY_VERSION
+	uint32_t rules;			// TRuleFlags
+	uint32_t decks;
+	uint32_t policy;			// TPolicyType
+	uint64_t seed;
+	uint64_t rows;
+	uint64_t hands;
+	}THistoryMeta;
+
+/* Bitmap index file header */
+typedef struct __HistoryIndexHeader__
+	{
+	char magic[8];				// HISTORY_INDEX_MAGIC, no terminator
+	uint32_t version;			// HISTORY_VERSION
+	uint32_t valuesNr;		// HISTORY_MAX_VALUES
+	uint64_t rows;
+	uint64_t offsets[HISTORY_MAX_VALUES + 1];	// Word offset of each value bitmap
+	}THistoryIndexHeader;
+
+/* Row filter: values from 'lo' to 'hi' (column values, not codes) */
+typedef struct __HistoryFilter__
+	{
+	unsigned int column;		// THistoryColumn
+	int lo;
+	int hi;
+	}THistoryFilter;
+
+/* Query aggregates over the rows passing every filter */
+typedef struct __HistoryAggregate__
+	{
+	uint64_t rows;
+	uint64_t hands;				// Rows that are the first of their hand
+	int64_t resultTenths;		// Sum of the hand net results
+	uint64_t squaredTenths;		// Sum of their squares
+	}THistoryAggregate;
+
+/*
+ * Column name (ex: "total")
+ * @return: Column name
+ */
+const char *historyColumnName (THistoryColumn column);
+
+/*
+ * Column from its name
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (unknown column)
+ */
+int historyColumnFromName (const std::string &name, THistoryColumn &column);
+
+/*
+ * The history writer class
+ * Appends rows to the column files as hands end, then writes the metadata and
+ * builds the bitmap indexes on close.
+ * */
+class THistoryWriter
+	{
+	public:
+		THistoryWriter(void);
+		// Closes the files. The store is only complete after close()
+		~THistoryWriter(void);
+		/*
+		 * Create the store directory and its column files
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (I/O error)
+		 */
+		int create(const std::string &dir, unsigned int rules, unsigned int decks,
+				unsigned int policy, unsigned long long seed);
+		// A decision of the hand in play. Kept until the hand ends
+		void addDecision(unsigned int total, bool soft, unsigned int upCard, double trueCount,
+				unsigned int action)
+			{
+			if (mPendingNr >= HISTORY_MAX_PENDING)
+				return;
+			int count = (int)floor(trueCount);
+			count = (count < HISTORY_COUNT_MIN) ? HISTORY_COUNT_MIN :
+					((count > HISTORY_COUNT_MAX) ? HISTORY_COUNT_MAX : count);
+			unsigned char *row = mPending[mPendingNr++];
+			row[HISTORY_TOTAL] = (unsigned char)total;
+			row[HISTORY_SOFT] = soft ? 1 : 0;
+			row[HISTORY_UP] = (unsigned char)upCard;
+			row[HISTORY_COUNT] = (unsigned char)(count - HISTORY_COUNT_MIN);
+			row[HISTORY_ACTION] = (unsigned char)action;
+			row[HISTORY_FIRST] = (mPendingNr == 1) ? 1 : 0;
+			};
+		// The hand ended: write its rows with its net result
+		void endHand(double net);
+		// The hand failed: drop its rows
+		void dropHand(void) {mPendingNr = 0;};
+		/*
+		 * Flush the columns, write the metadata and build the bitmap indexes
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (I/O error)
+		 */
+		int close(void);
+
+	private:
+		THistoryWriter(const THistoryWriter &);
+		THistoryWriter &operator=(const THistoryWriter &);
+		// Build the bitmap index of an indexed column file
+		int buildIndex(THistoryColumn column);
+
+	private:
+		std::string mDir;
+		FILE *mFiles[HISTORY_COLUMNS_NR];
+		THistoryMeta mMeta;
+		unsigned char mPending[HISTORY_MAX_PENDING][HISTORY_INDEXED_NR];
+		unsigned int mPendingNr;
+	};
+
+/*
+ * The history store class
+ * Read only memory mapping of a store's columns and indexes
+ * */
+class THistoryStore
+	{
+	public:
+		THistoryStore(void);
+		~THistoryStore(void);
+		/*
+		 * Map a store and check its metadata and file sizes
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (missing files, bad magic, version or sizes)
+		 */
+		int open(const std::string &dir);
+		void close(void);
+		const THistoryMeta &getMeta(void) const {return mMeta;};
+		// Values of an indexed column, one per row
+		const unsigned char *getColumn(THistoryColumn column) const
+			{return (const unsigned char *)mMaps[column];};
+		// Hand net results, one per row
+		const int16_t *getResults(void) const {return (const int16_t *)mMaps[HISTORY_RESULT];};
+		/*
+		 * Compressed bitmap of the rows holding 'code' in an indexed column
+		 * @return: Bitmap words, 'words' set to their number
+		 */
+		const uint64_t *getBitmap(THistoryColumn column, unsigned int code, size_t &words) const;
+		/*
+		 * Aggregate the rows passing every filter. Filters on indexed columns
+		 * use the bitmap indexes unless 'scan', the others scan the columns.
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (no store open or invalid filter)
+		 */
+		int query(const std::vector<THistoryFilter> &filters, bool scan,
+				THistoryAggregate &aggregate) const;
+
+	private:
+		THistoryStore(const THistoryStore &);
+		THistoryStore &operator=(const THistoryStore &);
+		// Map a store file read only
+		const void *map(const std::string &path, size_t &size);
+
+	private:
+		THistoryMeta mMeta;
+		bool mOpen;
+		const void *mMaps[HISTORY_COLUMNS_NR];
+		size_t mSizes[HISTORY_COLUMNS_NR];
+		const unsigned char *mIndexes[HISTORY_INDEXED_NR];
+		size_t mIndexSizes[HISTORY_INDEXED_NR];
+	};
+
+#endif /* __HISTORY_HPP__ */
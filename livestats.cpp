@@ -0,0 +1,276 @@
+/******************************************************************************/
+/*!
+ * @file:					  livestats.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the live stats slots and exporter.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <math.h>
+#include <new>
+#include <stdlib.h>
+
+/* Local includes */
+#include "livestats.hpp"
+#include "misc.hpp"
+
+/*
+ * Consistent copy of the slot: retry while a publish is in progress or
+ * happened during the copy
+ */
+	void
+TLiveSlot::read
+	(
+	TLiveSnapshot &snapshot		// Out argument
+	) const
+	{
+	for (;;)
+		{
+		unsigned int seq = mSeq.load(std::memory_order_acquire);
+		snapshot.hands = mHands.load(std::memory_order_relaxed);
+		snapshot.netTenths = mNetTenths.load(std::memory_order_relaxed);
+		snapshot.netSquaredTenths = mNetSquaredTenths.load(std::memory_order_relaxed);
+		snapshot.elapsedNanos = mElapsedNanos.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (!(seq & 1) && (mSeq.load(std::memory_order_relaxed) == seq))
+			return;
+		std::this_thread::yield();
+		}
+	}
+
+TLiveSlots::TLiveSlots
+	(
+	unsigned int slotsNr		// Slots, one per worker
+	) :
+	mSlots(NULL),
+	mSlotsNr(slotsNr)
+	{
+	void *mem = NULL;
+	if (posix_memalign(&mem, LIVE_CACHE_LINE, (slotsNr ? slotsNr : 1) * sizeof(TLiveSlot)))
+		throw std::bad_alloc();
+	mSlots = (TLiveSlot *)mem;
+	for (unsigned int i = 0; i < mSlotsNr; i++)
+		new (&mSlots[i]) TLiveSlot();
+	}
+
+TLiveSlots::~TLiveSlots
+	(
+	void
+	)
+	{
+	for (unsigned int i = 0; i < mSlotsNr; i++)
+		mSlots[i].~TLiveSlot();
+	free(mSlots);
+	}
+
+TLiveExporter::TLiveExporter
+	(
+	void
+	) :
+	mSlots(NULL),
+	mSlotsNr(0),
+	mCsv(NULL),
+	mPeriodSecs(0.0),
+	mStop(false)
+	{
+	}
+
+TLiveExporter::~TLiveExporter
+	(
+	void
+	)
+	{
+	if (mThread.joinable())
+		stop();
+	if (mCsv)
+		fclose(mCsv);
+	}
+
+/*
+ * Start exporting 'slotsNr' slots every 'periodSecs'
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (CSV file could not be created)
+ */
+	int
+TLiveExporter::start
+	(
+	const TLiveSlot 		*slots,			// Slots of the workers
+	unsigned int 			slotsNr,			// Slots to export
+	const std::string 	&promPath,		// Prometheus text file. Empty, none
+	const std::string 	&csvPath,		// CSV time series. Empty, none
+	double 					periodSecs		// Time between exports
+	)
+	{
+	int ret = -1; // Assume error
+
+	if (mThread.joinable() || !slots || !slotsNr || (periodSecs <= 0.0))
+		return ret;
+	if (!csvPath.empty())
+		{
+		mCsv = fopen(csvPath.c_str(), "w");
+		if (!mCsv)
+			{
+			log(LOG_ERR, "Could not create " + csvPath + "\n");
+			return ret;
+			}
+		fprintf(mCsv, "seconds,worker,hands,edge,stderr,hands_per_sec\n");
+		}
+	mSlots = slots;
+	mSlotsNr = slotsNr;
+	mPromPath = promPath;
+	mPeriodSecs = periodSecs;
+	mStop = false;
+	TLiveSnapshot none = {0, 0, 0, 0};
+	mLast.assign(slotsNr, none);
+	mStart = std::chrono::steady_clock::now();
+	mThread = std::thread(&TLiveExporter::exporter, this);
+	ret = 0;
+
+	return ret;
+	}
+
+/*
+ * Export a last time and stop
+ */
+	void
+TLiveExporter::stop
+	(
+	void
+	)
+	{
+	if (!mThread.joinable())
+		return;
+	std::unique_lock<std::mutex> lock(mLock);
+	mStop = true;
+	lock.unlock();
+	mStopped.notify_all();
+	mThread.join();
+	exportOnce();
+	}
+
+/*
+ * Exporter thread: export every period until stopped
+ */
+	void
+TLiveExporter::exporter
+	(
+	void
+	)
+	{
+	std::chrono::duration<double> period(mPeriodSecs);
+	std::unique_lock<std::mutex> lock(mLock);
+	while (!mStopped.wait_for(lock, period, [this] {return mStop;}))
+		{
+		lock.unlock();
+		exportOnce();
+		lock.lock();
+		}
+	}
+
+/*
+ * Edge and its standard error, in bets, from a worker totals
+ */
+	static void
+edgeOf
+	(
+	const TLiveSnapshot 	&snapshot,		// Worker totals
+	double 					&edge,			// Out argument
+	double 					&stdErr			// Out argument
+	)
+	{
+	edge = stdErr = 0.0;
+	if (!snapshot.hands)
+		return;
+	double n = (double)snapshot.hands;
+	edge = (double)snapshot.netTenths / 10.0 / n;
+	if (snapshot.hands < 2)
+		return;
+	double variance = ((double)snapshot.netSquaredTenths / 100.0 / n - edge * edge) *
+			n / (n - 1.0);
+	stdErr = (variance > 0.0) ? sqrt(variance / n) : 0.0;
+	}
+
+/*
+ * Read every slot and write the files
+ */
+	void
+TLiveExporter::exportOnce
+	(
+	void
+	)
+	{
+	std::chrono::duration<double> now = std::chrono::steady_clock::now() - mStart;
+	// Workers, then their total last
+	std::vector<TLiveSnapshot> snapshots(mSlotsNr + 1);
+	std::vector<double> rates(mSlotsNr + 1, 0.0);
+	TLiveSnapshot &total = snapshots[mSlotsNr];
+	total.hands = total.netSquaredTenths = total.elapsedNanos = 0;
+	total.netTenths = 0;
+	for (unsigned int w = 0; w < mSlotsNr; w++)
+		{
+		mSlots[w].read(snapshots[w]);
+		const TLiveSnapshot &last = mLast[w];
+		if (snapshots[w].elapsedNanos > last.elapsedNanos)
+			rates[w] = (double)(snapshots[w].hands - last.hands) * 1e9 /
+					(double)(snapshots[w].elapsedNanos - last.elapsedNanos);
+		mLast[w] = snapshots[w];
+		total.hands += snapshots[w].hands;
+		total.netTenths += snapshots[w].netTenths;
+		total.netSquaredTenths += snapshots[w].netSquaredTenths;
+		rates[mSlotsNr] += rates[w];
+		}
+
+	std::vector<double> edges(mSlotsNr + 1), stdErrs(mSlotsNr + 1);
+	std::vector<std::string> names(mSlotsNr + 1, "all");
+	for (unsigned int w = 0; w <= mSlotsNr; w++)
+		{
+		edgeOf(snapshots[w], edges[w], stdErrs[w]);
+		if (w < mSlotsNr)
+			names[w] = std::to_string(w);
+		}
+
+	if (mCsv)
+		{
+		for (unsigned int w = 0; w <= mSlotsNr; w++)
+			fprintf(mCsv, "%.3f,%s,%llu,%.8f,%.8f,%.0f\n", now.count(), names[w].c_str(),
+					snapshots[w].hands, edges[w], stdErrs[w], rates[w]);
+		fflush(mCsv);
+		}
+
+	if (mPromPath.empty())
+		return;
+	// Replaced whole: written aside then renamed over the previous one
+	std::string tmpPath = mPromPath + ".tmp";
+	FILE *prom = fopen(tmpPath.c_str(), "w");
+	if (!prom)
+		{
+		log(LOG_WARN, "Could not write " + tmpPath + "\n");
+		return;
+		}
+	fprintf(prom, "# HELP blackjack_sim_hands_total Hands played\n");
+	fprintf(prom, "# TYPE blackjack_sim_hands_total counter\n");
+	for (unsigned int w = 0; w <= mSlotsNr; w++)
+		fprintf(prom, "blackjack_sim_hands_total{worker=\"%s\"} %llu\n", names[w].c_str(),
+				snapshots[w].hands);
+	fprintf(prom, "# HELP blackjack_sim_edge Player net result per hand, in bets\n");
+	fprintf(prom, "# TYPE blackjack_sim_edge gauge\n");
+	for (unsigned int w = 0; w <= mSlotsNr; w++)
+		fprintf(prom, "blackjack_sim_edge{worker=\"%s\"} %.8f\n", names[w].c_str(), edges[w]);
+	fprintf(prom, "# HELP blackjack_sim_edge_stderr Standard error of the edge, in bets\n");
+	fprintf(prom, "# TYPE blackjack_sim_edge_stderr gauge\n");
+	for (unsigned int w = 0; w <= mSlotsNr; w++)
+		fprintf(prom, "blackjack_sim_edge_stderr{worker=\"%s\"} %.8f\n", names[w].c_str(),
+				stdErrs[w]);
+	fprintf(prom, "# HELP blackjack_sim_hands_per_second Hands per second of play since "
+			"the previous export\n");
+	fprintf(prom, "# TYPE blackjack_sim_hands_per_second gauge\n");
+	for (unsigned int w = 0; w <= mSlotsNr; w++)
+		fprintf(prom, "blackjack_sim_hands_per_second{worker=\"%s\"} %.0f\n", names[w].c_str(),
+				rates[w]);
+	if (fclose(prom) || rename(tmpPath.c_str(), mPromPath.c_str()))
+		log(LOG_WARN, "Could not write " + mPromPath + "\n");
+	}
@@ -0,0 +1,154 @@
+/******************************************************************************/
+/*!
+ * @file:					  livestats.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the live stats of long
+ *  					simulations: every worker publishes its running totals in
+ *  					a slot of its own, and a background exporter writes them
+ *  					as a Prometheus text file and a CSV time series.
+ *
+ *  A slot is a seqlock: the worker (single writer) bumps the sequence to odd,
+ *  stores the totals and bumps it back to even; readers retry while it is odd
+ *  or changed under them. Workers never wait and never write a cache line
+ *  another worker writes.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __LIVESTATS_HPP__
+#define __LIVESTATS_HPP__
+
+/* Library includes */
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Local includes */
+#include "simulator.hpp"
+
+/* Defines */
+
+// Cache line size, slots never share one
+#define LIVE_CACHE_LINE			64
+
+/* Enumerations, type defines */
+
+/* Totals of one worker */
+typedef struct __LiveSnapshot__
+	{
+	unsigned long long hands;				// Hands played
+	long long netTenths;						// Net result, in tenths of a bet
+	unsigned long long netSquaredTenths;	// Sum of the squared per hand results
+	unsigned long long elapsedNanos;		// Time playing
+	}TLiveSnapshot;
+
+/*
+ * Live stats slot of one worker (see TSimConfig.live)
+ */
+struct alignas(LIVE_CACHE_LINE) __LiveSlot__
+	{
+	public:
+		__LiveSlot__(void) : mSeq(0), mHands(0), mNetTenths(0), mNetSquaredTenths(0),
+				mElapsedNanos(0) {};
+		// Worker only
+		void publish(const TLiveSnapshot &snapshot)
+			{
+			unsigned int seq = mSeq.load(std::memory_order_relaxed);
+			mSeq.store(seq + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			mHands.store(snapshot.hands, std::memory_order_relaxed);
+			mNetTenths.store(snapshot.netTenths, std::memory_order_relaxed);
+			mNetSquaredTenths.store(snapshot.netSquaredTenths, std::memory_order_relaxed);
+			mElapsedNanos.store(snapshot.elapsedNanos, std::memory_order_relaxed);
+			mSeq.store(seq + 2, std::memory_order_release);
+			};
+		// Any thread. A consistent copy, never half of a publish
+		void read(TLiveSnapshot &snapshot) const;
+
+	private:
+		std::atomic<unsigned int> mSeq;		// Odd while a publish is in progress
+		std::atomic<unsigned long long> mHands;
+		std::atomic<long long> mNetTenths;
+		std::atomic<unsigned long long> mNetSquaredTenths;
+		std::atomic<unsigned long long> mElapsedNanos;
+	};
+typedef struct __LiveSlot__ TLiveSlot;
+
+static_assert(sizeof(TLiveSlot) % LIVE_CACHE_LINE == 0, "Live slots would share cache lines");
+
+/*
+ * Array of live slots, each on cache lines of its own. Allocated aligned as
+ * containers do not align beyond max_align_t before C++17
+ */
+class TLiveSlots
+	{
+	public:
+		TLiveSlots(unsigned int slotsNr);
+		~TLiveSlots(void);
+		TLiveSlot *get(void) const {return mSlots;};
+		unsigned int size(void) const {return mSlotsNr;};
+
+	private:
+		TLiveSlots(const TLiveSlots &);
+		TLiveSlots &operator=(const TLiveSlots &);
+
+	private:
+		TLiveSlot *mSlots;
+		unsigned int mSlotsNr;
+	};
+
+/*
+ * Background exporter of the live stats of a set of slots
+ * Every period, writes every worker and their total to a Prometheus text
+ * format file (replaced whole, so scrapers never read half of it) and
+ * appends them to a CSV file: seconds, worker, hands, edge, standard error
+ * and hands per second of play since the previous export.
+ */
+class TLiveExporter
+	{
+	public:
+		TLiveExporter(void);
+		~TLiveExporter(void);
+
+		/*
+		 * Start exporting 'slotsNr' slots every 'periodSecs'. Empty paths are
+		 * not written
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (CSV file could not be created)
+		 */
+		int start(const TLiveSlot *slots, unsigned int slotsNr, const std::string &promPath,
+				const std::string &csvPath, double periodSecs);
+
+		/*
+		 * Export a last time and stop. Call once the workers are done so the
+		 * files end with the final totals
+		 */
+		void stop(void);
+
+	private:
+		void exporter(void);
+		void exportOnce(void);
+
+	private:
+		const TLiveSlot *mSlots;
+		unsigned int mSlotsNr;
+		std::string mPromPath;
+		FILE *mCsv;
+		double mPeriodSecs;
+		std::thread mThread;
+		std::mutex mLock;
+		std::condition_variable mStopped;
+		bool mStop;
+		// Exporter thread only: totals of the previous export, for the rates
+		std::vector<TLiveSnapshot> mLast;
+		std::chrono::steady_clock::time_point mStart;
+	};
+
+#endif /* __LIVESTATS_HPP__ */
@@ -10,25 +10,54 @@
  ******************************************************************************/
 
 /* Local includes */
+#include "advice.hpp"
 #include "blackjack.hpp"
 #include "misc.hpp"
+#include "tablefile.hpp"
 
 /* Library includes */
 #include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <getopt.h>
 #include <unistd.h>
 #include <sstream>
 
 //! Option string for getopt for etrans. See opttab for long options.
-char optstr[] = ":h";
+char optstr[] = ":hsp6T:i:S:g:";
 
 //! Option table for getopt_long for etrans.
 struct option opttab[] = {
-   { "help",   no_argument,         NULL,    'h'   },
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "s17",   		no_argument,         NULL,    's'   },
+   { "push-ties",		no_argument,         NULL,    'p'   },
+   { "pay-6-5",		no_argument,         NULL,    '6'   },
+   { "tables",		required_argument,   NULL,    'T'   },
+   { "script",		required_argument,   NULL,    'i'   },
+   { "seed",			required_argument,   NULL,    'S'   },
+   { "golden",		required_argument,   NULL,    'g'   },
    { 0, 0, 0, 0 }
    };
 
+/*
+ * Interactive game for one rule set. Instantiated by dispatchRules() once
+ * the rules have been selected at start up.
+ */
+class TGameRunner
+	{
+	public:
+		TGameRunner(const TTableFile *tables, bool seeded, unsigned long long seed) :
+			mTables(tables), mSeeded(seeded), mSeed(seed) {};
+		template <typename TRules> int run(void);
+
+	private:
+		const TTableFile *mTables;	// Suggestions source. NULL, none
+		bool mSeeded;					// Shoes from mSeed instead of the system entropy
+		unsigned long long mSeed;
+	};
+
 /******************************************************************************/
 /*! Print usage then exit the app.
  ******************************************************************************/
@@ -48,14 +77,146 @@ usage
    std::cout << "\t- Dealer's blackjack and non-natural 21 hand (no Ace-Face card pair) wins over\n" <<
    				 "\t  user non-natural 21." << std::endl;
    std::cout << "\t- Player's blackjack wins over dealer's non-natural 21." << std::endl;
+   std::cout << "\t- Dealer wins ties. Player's blackjack pays 3:2." << std::endl;
+   std::cout << "\t- Player may double any two cards, split pairs up to " << TRuleSet<RULES_HOUSE>::MAX_SPLIT_HANDS <<
+   		" hands (one card\n\t  to split Aces), surrender late and insure against an Ace."
+   		<< std::endl;
+   std::cout << "Each prompt hints the expected value of every option, from the cards left in"
+   		<< std::endl << "the shoe." << std::endl;
    std::cout << std::endl;
    std::cout << "Options:" << std::endl;
    std::cout << "   -h, --help" << std::endl;
    std::cout << "      Print this help." << std::endl;
+   std::cout << "   -s, --s17" << std::endl;
+   std::cout << "      Dealer stands on soft 17." << std::endl;
+   std::cout << "   -p, --push-ties" << std::endl;
+   std::cout << "      Equal scores are a push (tie) instead of a dealer win." << std::endl;
+   std::cout << "   -6, --pay-6-5" << std::endl;
+   std::cout << "      Player's blackjack pays 6:5." << std::endl;
+   std::cout << "   -T, --tables FILE" << std::endl;
+   std::cout << "      Suggest each play from a table file (see blackjack-tablegen)." << std::endl;
+   std::cout << "   -i, --script FILE" << std::endl;
+   std::cout << "      Read every answer from FILE (whitespace separated, '#' comments)" << std::endl;
+   std::cout << "      instead of the console, with no delays. The game ends with the script." << std::endl;
+   std::cout << "   -S, --seed SEED" << std::endl;
+   std::cout << "      Deal the same shoes on every run." << std::endl;
+   std::cout << "   -g, --golden FILE" << std::endl;
+   std::cout << "      Check the game output against a transcript kept from an earlier run" << std::endl;
+   std::cout << "      (ex: './blackjack -S 1 -i game.txt > golden.txt'). Fails on the first" << std::endl;
+   std::cout << "      different line." << std::endl;
 
    std::cout << std::endl;
    return;
    }
+/*
+ * Check a game output against a golden transcript
+ * @return: 0 - Output and transcript are equal. Otherwise,
+ * 			Error (the first different line is reported)
+ */
+	int
+checkTranscript
+	(
+	const std::string &output,		// Game output
+	const char 			*path			// Golden transcript file
+	)
+	{
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if (!file)
+		{
+		log(LOG_ERR, "Invalid golden transcript file\n");
+		return -1;
+		}
+	std::stringstream golden;
+	golden << file.rdbuf();
+	if (golden.str() == output)
+		{
+		std::stringstream ss;
+		ss << "Output matches the golden transcript (" << output.size() << " bytes)\n";
+		log(LOG_INFO, ss.str());
+		return 0;
+		}
+
+	// First different line, both versions
+	std::istringstream outLines(output);
+	std::istringstream goldenLines(golden.str());
+	std::string outLine, goldenLine;
+	unsigned int line = 1;
+	for (;; line++)
+		{
+		bool outMore = (bool)std::getline(outLines, outLine);
+		bool goldenMore = (bool)std::getline(goldenLines, goldenLine);
+		if (!outMore)
+			outLine = "<end of output>";
+		if (!goldenMore)
+			goldenLine = "<end of transcript>";
+		if ((outLine != goldenLine) || (!outMore && !goldenMore))
+			break;
+		}
+	std::stringstream ss;
+	ss << "Output differs from the golden transcript at line " << line << ":\n" <<
+			"  expected: " << goldenLine << "\n  output:   " << outLine << "\n";
+	log(LOG_ERR, ss.str());
+	return -1;
+	}
+
+/*
+ * Play hands from the console until the user exits, under the TRules rule set
+ * @return: 0 - Success exiting black jack game. Otherwise,
+ * 			Error
+ */
+template <typename TRules>
+	int
+TGameRunner::run
+	(
+	void
+	)
+	{
+	int ret = -1; // Assume game exits with error
+	bool exit = false;
+	TDealer dealer = mSeeded ? TDealer(mSeed, 1, true) : TDealer();
+	TBlackjack<TRules> bljck(dealer, NULL);
+	TStrategy advisor(POLICY_TABLES);
+	if (mTables)
+		{
+		if (advisor.bindTables(*mTables, TRules::FLAGS, bljck.getDealer().getDecks()))
+			log(LOG_WARN, "The table file has no tables for these rules. No suggestions\n");
+		else
+			bljck.setAdvisor(&advisor);
+		}
+	// No dealer outcome cache: with few hits it slows advice down (see blackjack-dealercache -C)
+	TAdviceEngine<TRules> hints;
+	bljck.setHints(&hints);
+
+	log (LOG_INFO, "\n\n****Welcome to virtual blackjack! Get ready to start****\n\n");
+	TCards cardDeck;
+	do
+		{
+		// Play hand
+		bljck.playHand(cardDeck);
+		bljck.printStats();
+		std::string reqStr("Continue game?\n Please enter 'Y' to continue or 'N' "
+				"to exit game\n");
+		TReqInputRets retType = reqInput(reqStr, "N", "Y", MAX_VALID_INPUT_REQ_TRIES);
+		if ((retType == REQ_INPUT_ERR) || (retType == REQ_INPUT_EXIT))
+			{
+			exit = true;
+			log(LOG_ERR, "Exiting game\n");
+			}
+		else if (retType == REQ_INPUT_CONT)
+			log(LOG_INFO, "Get ready to play next hand\n");
+		else
+			{
+			std::stringstream ss;
+			ss << "Internal error, incorrect value (" << (unsigned int) retType <<
+					") returned from processing request input \n" << std::endl;
+			log(LOG_ERR,  ss.str());
+			}
+
+		}while (!exit);
+	ret = 0;
+	return ret;
+	}
+
 /* Top level and binary entry point for black jack game
  * @return: 0 - Success exiting black jack game. Otherwise,
  * 			Error
@@ -68,7 +229,12 @@ int main
    )
 	{
 	int ret = -1; // Assume game exits with error
-	bool exit = false;
+	unsigned int rules = RULES_HOUSE;
+	const char *tablesPath = NULL;
+	const char *scriptPath = NULL;
+	const char *goldenPath = NULL;
+	bool seeded = false;
+	unsigned long long seed = 0;
 	signed char    oc;
 
 	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
@@ -78,6 +244,29 @@ int main
 			case 'h':      // use config file argued
 				usage();
 				ret = 0;
+				return ret;
+			case 's':
+				rules |= RULES_STAND_SOFT_17;
+				break;
+			case 'p':
+				rules |= RULES_PUSH_TIES;
+				break;
+			case '6':
+				rules |= RULES_PAY_6_5;
+				break;
+			case 'T':
+				tablesPath = optarg;
+				break;
+			case 'i':
+				scriptPath = optarg;
+				break;
+			case 'S':
+				seeded = true;
+				seed = strtoull(optarg, NULL, 10);
+				break;
+			case 'g':
+				goldenPath = optarg;
+				break;
 			case '?':
 			default:       // invalid option
 				return ret;
@@ -85,38 +274,45 @@ int main
 			}
 		}
 
-	try
+	if (scriptPath && setInputScript(scriptPath))
 		{
-		TBlackjack bljck;;
+		log(LOG_ERR, "Invalid script file\n");
+		return ret;
+		}
+	// The output is kept until the game is over, then checked
+	std::string transcript;
+	if (goldenPath)
+		setLogCapture(&transcript);
 
-		log (LOG_INFO, "\n\n****Welcome to virtual blackjack! Get ready to start****\n\n");
-		TCards cardDeck;
-		do
+	// Mapped, not parsed: start up does not depend on the table file size
+	TTableFile tables;
+	if (tablesPath)
+		{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		if (tables.open(tablesPath))
+			{
+			log(LOG_ERR, "Invalid table file\n");
+			return ret;
+			}
+		std::chrono::duration<double, std::micro> elapsed =
+				std::chrono::steady_clock::now() - start;
+		if (isInputTyped())
 			{
-			// Play hand
-			bljck.playHand(cardDeck);
-			bljck.printStats();
-			std::string reqStr("Continue game?\n Please enter 'Y' to continue or 'N' "
-					"to exit game\n");
-			TReqInputRets retType = reqInput(reqStr, "N", "Y", MAX_VALID_INPUT_REQ_TRIES);
-			if ((retType == REQ_INPUT_ERR) || (retType == REQ_INPUT_EXIT))
-				{
-				exit = true;
-				log(LOG_ERR, "Exiting game\n");
-				}
-			else if (retType == REQ_INPUT_CONT)
-				log(LOG_INFO, "Get ready to play next hand\n");
-			else
-				{
-				std::stringstream ss;
-				ss << "Internal error, incorrect value (" << (unsigned int) retType <<
-						") returned from processing request input \n" << std::endl;
-				log(LOG_ERR,  ss.str());
-				}
-
-			}while (!exit);
-		ret = 0;
+			std::stringstream ss;
+			ss << "Table file mapped in " << elapsed.count() << " us\n";
+			log(LOG_INFO, ss.str());
+			}
+		}
 
+	try
+		{
+		TGameRunner game(tablesPath ? &tables : NULL, seeded, seed);
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		ret = dispatchRules(rules, game);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		// Off the transcript, on the error output
+		if (scriptPath)
+			fprintf(stderr, "Script played in %.3f s\n", elapsed.count());
 		}
 	catch (std::exception& err)
 		{
@@ -133,6 +329,13 @@ int main
 		log(LOG_INFO, ss.str());
 		}
 
+	if (goldenPath)
+		{
+		setLogCapture(NULL);
+		if (checkTranscript(transcript, goldenPath))
+			ret = -1;
+		}
+
 	// Black jack object destructor is called when main exits
 	return ret;
 	}
@@ -0,0 +1,609 @@
+/******************************************************************************/
+/*!
+ * @file:					  markov.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the infinite deck analytic solver.
+ *
+ *  A hand state is its hard total (0 to 21, Aces counted as 1) and whether it
+ *  holds an Ace, MARKOV_STATES states in all; a hard total over 21 busts.
+ *  Every card adds at least 1 to the hard total, so the chains have no loop
+ *  and absorb in a few draws. For each chain, row s of the system reads
+ *  	value(s) - sum over card values v of p(v) value(s + v) = absorbed(s)
+ *  for drawing states, and value(s) = absorbed(s) for the standing ones,
+ *  with one right hand side column per outcome.
+ *
+ *  Cards are dealt as the engine does (two to the player, the dealer's hole
+ *  card, then the up card) and naturals are settled first: only an Ace and a
+ *  face card make a natural, an Ace and a non face 10 is a dealer 21 that
+ *  wins before the player acts, as in the engine and the hand enumerator.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <chrono>
+#include <math.h>
+#include <string.h>
+
+/* Local includes */
+#include "markov.hpp"
+#include "rules.hpp"
+#include "strategy.hpp"
+#include "tablefile.hpp"
+
+/* Private defines */
+#define MARKOV_MAX_HARD		21		// Highest hard total standing, higher busts
+#define MARKOV_STATES		((MARKOV_MAX_HARD + 1) * 2)
+#define ACE_EXTRA_VAL		10		// Ace counted as 11 instead of 1
+#define DEALER_BUST			5		// Dealer finals index of a bust
+#define CATS_NR				11		// Card categories
+#define CAT_ACE				0
+#define CAT_TEN				9		// Non face 10
+#define CAT_FACE				10		// Jack, Queen and King
+#define RANKS_PER_SUIT		13.0
+
+/* Player hand outcome values, the columns of the player chain */
+enum TMarkovValueIdx
+	{
+	VAL_EV,
+	VAL_WIN,
+	VAL_PUSH,
+	VAL_LOSS,
+	VALUES_NR
+	};
+
+/* Player hand outcome: net result and win, push and loss probabilities */
+typedef struct __MarkovValue__
+	{
+	double v[VALUES_NR];
+	}TMarkovValue;
+
+/* Card category values and fresh deck probabilities */
+static const unsigned int catValue[CATS_NR] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 10};
+static const double catProb[CATS_NR] = {1.0 / RANKS_PER_SUIT, 1.0 / RANKS_PER_SUIT,
+		1.0 / RANKS_PER_SUIT, 1.0 / RANKS_PER_SUIT, 1.0 / RANKS_PER_SUIT, 1.0 / RANKS_PER_SUIT,
+		1.0 / RANKS_PER_SUIT, 1.0 / RANKS_PER_SUIT, 1.0 / RANKS_PER_SUIT, 1.0 / RANKS_PER_SUIT,
+		3.0 / RANKS_PER_SUIT};
+
+/*
+ * Fresh deck probability of a card value, 1 (Ace) to 10
+ * @return: Probability
+ */
+	static inline double
+valueProb
+	(
+	unsigned int value		// Card value
+	)
+	{
+	return (value == TDealer::VALUES_NR) ? 4.0 / RANKS_PER_SUIT : 1.0 / RANKS_PER_SUIT;
+	}
+
+/*
+ * Chain state of a hand
+ * @return: State index
+ */
+	static inline unsigned int
+stateOf
+	(
+	unsigned int hard,		// Hard total, at most MARKOV_MAX_HARD
+	bool ace					// The hand holds an Ace
+	)
+	{
+	return hard * 2 + (ace ? 1 : 0);
+	}
+
+/*
+ * Solve A X = B in place by Gaussian elimination with partial pivoting. A is
+ * n x n and B n x m, both row major; B holds X on return.
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (singular system)
+ */
+	static int
+solveDense
+	(
+	double 		*a,		// In/Out argument. Coefficients, destroyed
+	double 		*b,		// In/Out argument. Right hand sides, then solutions
+	unsigned int n,		// Unknowns
+	unsigned int m			// Right hand sides
+	)
+	{
+	int ret = -1;   // Assume singular system
+	for (unsigned int col = 0; col < n; col++)
+		{
+		unsigned int pivot = col;
+		for (unsigned int row = col + 1; row < n; row++)
+			if (fabs(a[row * n + col]) > fabs(a[pivot * n + col]))
+				pivot = row;
+		if (fabs(a[pivot * n + col]) < 1e-12)
+			return ret;
+		if (pivot != col)
+			{
+			for (unsigned int k = 0; k < n; k++)
+				{
+				double t = a[col * n + k];
+				a[col * n + k] = a[pivot * n + k];
+				a[pivot * n + k] = t;
+				}
+			for (unsigned int k = 0; k < m; k++)
+				{
+				double t = b[col * m + k];
+				b[col * m + k] = b[pivot * m + k];
+				b[pivot * m + k] = t;
+				}
+			}
+		for (unsigned int row = col + 1; row < n; row++)
+			{
+			double f = a[row * n + col] / a[col * n + col];
+			if (f == 0.0)
+				continue;
+			for (unsigned int k = col; k < n; k++)
+				a[row * n + k] -= f * a[col * n + k];
+			for (unsigned int k = 0; k < m; k++)
+				b[row * m + k] -= f * b[col * m + k];
+			}
+		}
+	for (unsigned int row = n; row-- > 0; )
+		for (unsigned int k = 0; k < m; k++)
+			{
+			double sum = b[row * m + k];
+			for (unsigned int c = row + 1; c < n; c++)
+				sum -= a[row * n + c] * b[c * m + k];
+			b[row * m + k] = sum / a[row * n + row];
+			}
+	ret = 0;
+	return ret;
+	}
+
+/*
+ * Solver of one rule set. Solves the dealer chain, then the player chain of
+ * every up card, then values the first decision of every starting hand.
+ */
+template <typename TRules>
+class TMarkovSolver
+	{
+	public:
+		TMarkovSolver(const TStrategy &strategy) : mStrategy(strategy) {};
+		int solve(TMarkovResult &result);
+
+	private:
+		int solveDealer(void);
+		int solvePlayer(unsigned int up);
+		TMarkovValue stand(unsigned int score, unsigned int up) const;
+		TMarkovValue drawn(unsigned int hard, bool ace, unsigned int up, bool doubled) const;
+		TMarkovValue twoCards(unsigned int v1, unsigned int v2, unsigned int up,
+				unsigned int allowed) const;
+		TMarkovValue split(unsigned int pair, unsigned int up) const;
+		// Score and softness of a hand from its hard total and Ace presence
+		static unsigned int handScore(unsigned int hard, bool ace, bool &soft)
+			{
+			soft = ace && ((hard + ACE_EXTRA_VAL) <= TRules::BLACKJACK_VAL);
+			return soft ? (hard + ACE_EXTRA_VAL) : hard;
+			};
+
+	private:
+		const TStrategy &mStrategy;
+		// Dealer final score distribution per state
+		double mDealer[MARKOV_STATES][MARKOV_DEALER_FINALS];
+		// Dealer finals per up card value, once the dealer has no two card 21
+		double mFinals[TDealer::VALUES_NR + 1][MARKOV_DEALER_FINALS];
+		// Player hand value per up card value and state, playing on without
+		// doubling or splitting
+		TMarkovValue mPlayer[TDealer::VALUES_NR + 1][MARKOV_STATES];
+	};
+
+/*
+ * Dealer chain: final score distribution of every dealer state
+ * Rules: 	- Dealer hits soft 17 if TRules::HIT_SOFT_17.
+ * 			- Dealer stands on hard 17 or higher soft or hard hands.
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (singular system)
+ */
+template <typename TRules>
+	int
+TMarkovSolver<TRules>::solveDealer
+	(
+	void
+	)
+	{
+	double a[MARKOV_STATES * MARKOV_STATES];
+	double *b = &mDealer[0][0];
+	memset((void *)a, 0, sizeof(a));
+	memset((void *)mDealer, 0, sizeof(mDealer));
+	for (unsigned int s = 0; s < MARKOV_STATES; s++)
+		{
+		unsigned int hard = s / 2;
+		bool ace = s & 1;
+		bool soft;
+		unsigned int score = handScore(hard, ace, soft);
+		a[s * MARKOV_STATES + s] = 1.0;
+		if ((score >= TRules::DEALER_HIT_LIMIT) &&
+				!(TRules::HIT_SOFT_17 && soft && (score == TRules::DEALER_HIT_LIMIT)))
+			{
+			mDealer[s][score - TRules::DEALER_HIT_LIMIT] = 1.0;
+			continue;
+			}
+		for (unsigned int v = 1; v <= TDealer::VALUES_NR; v++)
+			{
+			if ((hard + v) > MARKOV_MAX_HARD)
+				mDealer[s][DEALER_BUST] += valueProb(v);
+			else
+				a[s * MARKOV_STATES + stateOf(hard + v, ace || (v == 1))] -= valueProb(v);
+			}
+		}
+	int ret = solveDense(a, b, MARKOV_STATES, MARKOV_DEALER_FINALS);
+	if (ret)
+		return ret;
+
+	// The hole card never makes a two card 21: the dealer would have won
+	for (unsigned int up = 1; up <= TDealer::VALUES_NR; up++)
+		{
+		double total = 0.0;
+		memset((void *)mFinals[up], 0, sizeof(mFinals[up]));
+		for (unsigned int hole = 1; hole <= TDealer::VALUES_NR; hole++)
+			{
+			if ((up + hole + ACE_EXTRA_VAL == TRules::BLACKJACK_VAL) && ((up == 1) || (hole == 1)))
+				continue;
+			double p = valueProb(hole);
+			const double *next = mDealer[stateOf(up + hole, (up == 1) || (hole == 1))];
+			for (unsigned int i = 0; i < MARKOV_DEALER_FINALS; i++)
+				mFinals[up][i] += p * next[i];
+			total += p;
+			}
+		for (unsigned int i = 0; i < MARKOV_DEALER_FINALS; i++)
+			mFinals[up][i] /= total;
+		}
+	return ret;
+	}
+
+/*
+ * Outcome of a hand standing on the argued score
+ * Rule:	- House (dealer) wins in an event of a score tie, unless
+ * 		TRules::PUSH_ON_TIE.
+ * @return: Hand outcome
+ */
+template <typename TRules>
+	TMarkovValue
+TMarkovSolver<TRules>::stand
+	(
+	unsigned int score,		// Player score, at most BLACKJACK_VAL
+	unsigned int up			// Dealer up card value
+	) const
+	{
+	TMarkovValue out;
+	memset((void *)&out, 0, sizeof(out));
+	const double *finals = mFinals[up];
+	out.v[VAL_WIN] = finals[DEALER_BUST];
+	for (unsigned int i = 0; i < DEALER_BUST; i++)
+		{
+		unsigned int final = TRules::DEALER_HIT_LIMIT + i;
+		if (TRules::PUSH_ON_TIE && (final == score))
+			out.v[VAL_PUSH] += finals[i];
+		else if (final >= score)
+			out.v[VAL_LOSS] += finals[i];
+		else
+			out.v[VAL_WIN] += finals[i];
+		}
+	out.v[VAL_EV] = out.v[VAL_WIN] - out.v[VAL_LOSS];
+	return out;
+	}
+
+/*
+ * Player chain of an up card: value of every player state when the player
+ * hits or stands as the policy does once past the first decision
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (singular system)
+ */
+template <typename TRules>
+	int
+TMarkovSolver<TRules>::solvePlayer
+	(
+	unsigned int up			// Dealer up card value
+	)
+	{
+	double a[MARKOV_STATES * MARKOV_STATES];
+	double b[MARKOV_STATES * VALUES_NR];
+	memset((void *)a, 0, sizeof(a));
+	memset((void *)b, 0, sizeof(b));
+	for (unsigned int s = 0; s < MARKOV_STATES; s++)
+		{
+		unsigned int hard = s / 2;
+		bool ace = s & 1;
+		bool soft;
+		unsigned int score = handScore(hard, ace, soft);
+		a[s * MARKOV_STATES + s] = 1.0;
+		if (mStrategy.decide(score, soft, up, 0, 0) != ACTION_HIT)
+			{
+			TMarkovValue out = stand(score, up);
+			memcpy((void *)&b[s * VALUES_NR], (const void *)out.v, sizeof(out.v));
+			continue;
+			}
+		for (unsigned int v = 1; v <= TDealer::VALUES_NR; v++)
+			{
+			double p = valueProb(v);
+			if ((hard + v) > MARKOV_MAX_HARD)
+				{
+				b[s * VALUES_NR + VAL_EV] -= p;
+				b[s * VALUES_NR + VAL_LOSS] += p;
+				}
+			else
+				a[s * MARKOV_STATES + stateOf(hard + v, ace || (v == 1))] -= p;
+			}
+		}
+	int ret = solveDense(a, b, MARKOV_STATES, VALUES_NR);
+	if (!ret)
+		for (unsigned int s = 0; s < MARKOV_STATES; s++)
+			memcpy((void *)mPlayer[up][s].v, (const void *)&b[s * VALUES_NR],
+					sizeof(mPlayer[up][s].v));
+	return ret;
+	}
+
+/*
+ * Value of a hand after drawing one more card, playing on from the chain or,
+ * once doubled, standing on it
+ * @return: Hand outcome, net result on the argued bet
+ */
+template <typename TRules>
+	TMarkovValue
+TMarkovSolver<TRules>::drawn
+	(
+	unsigned int hard,		// Hard total before the card
+	bool ace,					// The hand holds an Ace
+	unsigned int up,			// Dealer up card value
+	bool doubled				// The card is a double down one
+	) const
+	{
+	TMarkovValue out;
+	memset((void *)&out, 0, sizeof(out));
+	for (unsigned int v = 1; v <= TDealer::VALUES_NR; v++)
+		{
+		double p = valueProb(v);
+		TMarkovValue next;
+		if ((hard + v) > MARKOV_MAX_HARD)
+			{
+			memset((void *)&next, 0, sizeof(next));
+			next.v[VAL_EV] = -1.0;
+			next.v[VAL_LOSS] = 1.0;
+			}
+		else if (doubled)
+			{
+			bool soft;
+			next = stand(handScore(hard + v, ace || (v == 1), soft), up);
+			}
+		else
+			next = mPlayer[up][stateOf(hard + v, ace || (v == 1))];
+		for (unsigned int i = 0; i < VALUES_NR; i++)
+			out.v[i] += p * next.v[i];
+		}
+	if (doubled)
+		out.v[VAL_EV] *= 2.0;
+	return out;
+	}
+
+/*
+ * Value of a two card hand at its first decision
+ * @return: Hand outcome, split hands added up
+ */
+template <typename TRules>
+	TMarkovValue
+TMarkovSolver<TRules>::twoCards
+	(
+	unsigned int v1,			// First card value
+	unsigned int v2,			// Second card value
+	unsigned int up,			// Dealer up card value
+	unsigned int allowed		// ALLOW_* actions on top of hit and stand
+	) const
+	{
+	TMarkovValue out;
+	bool ace = (v1 == 1) || (v2 == 1);
+	bool soft;
+	unsigned int score = handScore(v1 + v2, ace, soft);
+	unsigned int pairValue = (v1 == v2) ? v1 : 0;
+	switch (mStrategy.decide(score, soft, up, pairValue, allowed))
+		{
+		case ACTION_HIT:
+			return drawn(v1 + v2, ace, up, false);
+		case ACTION_DOUBLE:
+			return drawn(v1 + v2, ace, up, true);
+		case ACTION_SPLIT:
+			return split(v1, up);
+		case ACTION_SURRENDER:
+			memset((void *)&out, 0, sizeof(out));
+			out.v[VAL_EV] = -0.5;
+			out.v[VAL_LOSS] = 1.0;
+			return out;
+		case ACTION_STAND:
+		default:
+			return stand(score, up);
+		}
+	}
+
+/*
+ * Value of a split pair, every split hand added up. The hands are dealt one
+ * card each as they are played, so which hand resplits does not change the
+ * hands the round ends with: only how many hands exist and how many still
+ * wait for their second card. pending[H][k] is the value of the k hands
+ * waiting when H hands exist.
+ * Rules: - Split Aces take one card each and are never resplit.
+ * 		 - Up to TRules::MAX_SPLIT_HANDS hands, doubles if
+ * 		 TRules::DOUBLE_AFTER_SPLIT, no surrender.
+ * @return: Outcome of all the split hands
+ */
+template <typename TRules>
+	TMarkovValue
+TMarkovSolver<TRules>::split
+	(
+	unsigned int pair,		// Pair card value
+	unsigned int up			// Dealer up card value
+	) const
+	{
+	const unsigned int maxHands = TRules::MAX_SPLIT_HANDS;
+	const unsigned int allowed = TRules::DOUBLE_AFTER_SPLIT ? ALLOW_DOUBLE : 0;
+	TMarkovValue hand[TDealer::VALUES_NR + 1];
+	TMarkovValue pending[TRules::MAX_SPLIT_HANDS + 1][TRules::MAX_SPLIT_HANDS + 1];
+	memset((void *)pending, 0, sizeof(pending));
+
+	// Value of a split hand once dealt its second card, when not resplit
+	for (unsigned int v = 1; v <= TDealer::VALUES_NR; v++)
+		{
+		bool soft;
+		if (pair == 1)
+			hand[v] = stand(handScore(1 + v, true, soft), up);
+		else
+			hand[v] = twoCards(pair, v, up, allowed);
+		}
+	bool soft;
+	unsigned int pairScore = handScore(2 * pair, false, soft);
+	bool resplit = (pair != 1) && (mStrategy.decide(pairScore, soft, up, pair,
+			allowed | ALLOW_SPLIT) == ACTION_SPLIT);
+
+	for (unsigned int h = maxHands; h >= 2; h--)
+		for (unsigned int k = 1; k <= h; k++)
+			for (unsigned int v = 1; v <= TDealer::VALUES_NR; v++)
+				{
+				double p = valueProb(v);
+				for (unsigned int i = 0; i < VALUES_NR; i++)
+					{
+					if (resplit && (v == pair) && (h < maxHands))
+						pending[h][k].v[i] += p * pending[h + 1][k + 1].v[i];
+					else
+						pending[h][k].v[i] += p * (hand[v].v[i] + pending[h][k - 1].v[i]);
+					}
+				}
+	return pending[2][2];
+	}
+
+/*
+ * Add up every starting hand: player cards, hole card and up card
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (singular system)
+ */
+template <typename TRules>
+	int
+TMarkovSolver<TRules>::solve
+	(
+	TMarkovResult &result		// Out argument
+	)
+	{
+	int ret = solveDealer();
+	for (unsigned int up = 1; !ret && (up <= TDealer::VALUES_NR); up++)
+		ret = solvePlayer(up);
+	if (ret)
+		return ret;
+
+	const double natPay = (double)TRules::NATURAL_PAY_NUM / (double)TRules::NATURAL_PAY_DEN;
+	unsigned int first = ALLOW_DOUBLE | (TRules::LATE_SURRENDER ? ALLOW_SURRENDER : 0);
+	double upWeight[TDealer::VALUES_NR + 1];
+	memset((void *)upWeight, 0, sizeof(upWeight));
+	for (unsigned int p1 = 0; p1 < CATS_NR; p1++)
+		for (unsigned int p2 = 0; p2 < CATS_NR; p2++)
+			{
+			bool userNat = ((p1 == CAT_ACE) && (p2 == CAT_FACE)) ||
+					((p1 == CAT_FACE) && (p2 == CAT_ACE));
+			double w12 = catProb[p1] * catProb[p2];
+			unsigned int v1 = catValue[p1], v2 = catValue[p2];
+			for (unsigned int up = 0; up < CATS_NR; up++)
+				{
+				unsigned int upValue = catValue[up];
+				double wUp = w12 * catProb[up];
+				double played = 0.0;	// Weight of the hole cards the player acts on
+				double ev = 0.0;
+				for (unsigned int hole = 0; hole < CATS_NR; hole++)
+					{
+					double w = wUp * catProb[hole];
+					bool dealerNat = ((hole == CAT_ACE) && (up == CAT_FACE)) ||
+							((hole == CAT_FACE) && (up == CAT_ACE));
+					// Dealer 21 without a natural: an Ace and a non face 10
+					bool dealer21 = ((hole == CAT_ACE) && (up == CAT_TEN)) ||
+							((hole == CAT_TEN) && (up == CAT_ACE));
+					if (dealerNat && userNat)
+						result.pushes += w;
+					else if (dealerNat || (!userNat && dealer21))
+						{
+						result.losses += w;
+						ev -= w;
+						}
+					else if (userNat)
+						{
+						result.wins += w;
+						result.naturals += w;
+						ev += w * natPay;
+						}
+					else
+						played += w;
+					}
+				if (played > 0.0)
+					{
+					unsigned int allowed = first | (((v1 == v2) && (TRules::MAX_SPLIT_HANDS > 1)) ?
+							ALLOW_SPLIT : 0);
+					TMarkovValue out = twoCards(v1, v2, upValue, allowed);
+					ev += played * out.v[VAL_EV];
+					result.wins += played * out.v[VAL_WIN];
+					result.pushes += played * out.v[VAL_PUSH];
+					result.losses += played * out.v[VAL_LOSS];
+					}
+				result.ev += ev;
+				result.upEv[upValue] += ev;
+				upWeight[upValue] += wUp;
+				}
+			}
+	for (unsigned int up = 1; up <= TDealer::VALUES_NR; up++)
+		{
+		result.upEv[up] /= upWeight[up];
+		memcpy((void *)result.dealerFinals[up], (const void *)mFinals[up], sizeof(mFinals[up]));
+		}
+	result.houseEdge = -result.ev;
+	result.states = MARKOV_STATES;
+	return ret;
+	}
+
+/*
+ * Solver run for one rule set. Instantiated by dispatchRules().
+ */
+class TMarkovRunner
+	{
+	public:
+		TMarkovRunner(const TStrategy &strategy, TMarkovResult &result) :
+			mStrategy(strategy), mResult(result) {};
+		template <typename TRules> int run(void)
+			{
+			TMarkovSolver<TRules> solver(mStrategy);
+			return solver.solve(mResult);
+			};
+
+	private:
+		const TStrategy &mStrategy;
+		TMarkovResult &mResult;
+	};
+
+/*
+ * Solve the dealer and player chains and add up every starting hand
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid configuration or table file)
+ */
+	int
+solveInfiniteDeck
+	(
+	const TMarkovConfig &config,		// In
+	TMarkovResult 		 &result		// Out argument
+	)
+	{
+	int ret = -1;  // Assume invalid configuration
+	memset((void *)&result, 0, sizeof(result));
+	if ((config.rules >= RULES_VARIANTS_NR) || (config.policy >= POLICY_TYPES_NR))
+		return ret;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	TStrategy strategy((TPolicyType)config.policy);
+	TTableFile tables;
+	if ((config.policy == POLICY_TABLES) && (!config.tablesPath ||
+			tables.open(config.tablesPath) || strategy.bindTables(tables, config.rules,
+			config.tableDecks)))
+		return ret;
+	TMarkovRunner runner(strategy, result);
+	ret = dispatchRules(config.rules, runner);
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	result.elapsedSecs = elapsed.count();
+	return ret;
+	}
@@ -0,0 +1,72 @@
+/******************************************************************************/
+/*!
+ * @file:					  markov.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the infinite deck analytic
+ *  					solver: exact outcome probabilities and house edge of a
+ *  					policy and rule set when every card is drawn at its
+ *  					fresh deck probability.
+ *
+ *  Dealer and player hands are absorbing Markov chains over the (hard total,
+ *  Ace held) states the engine scores hands from. Drawing a card moves a hand
+ *  to a higher hard total, standing or busting absorbs it. The absorption
+ *  values of every state solve one small dense linear system per chain: the
+ *  dealer finals once, the player values once per up card. Doubles, splits
+ *  (resplits included) and late surrender are valued at the first decision
+ *  as the engine allows them.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __MARKOV_HPP__
+#define __MARKOV_HPP__
+
+/* Local includes */
+#include "dealer.hpp"
+
+/* Defines */
+
+// Dealer final scores: 17 to 21 and bust
+#define MARKOV_DEALER_FINALS	6
+
+/* Enumerations, type defines */
+
+/* Solver configuration */
+typedef struct __MarkovConfig__
+	{
+	unsigned int rules;			// TRuleFlags
+	unsigned int policy;			// TPolicyType
+	const char *tablesPath;		// Table file of POLICY_TABLES, played at true count 0
+	unsigned int tableDecks;	// Deck count of the tables played
+	}TMarkovConfig;
+
+/*
+ * Exact infinite deck outcome of a round. Outcomes count every hand the round
+ * ends with, split hands one by one, as the engine stats do.
+ */
+typedef struct __MarkovResult__
+	{
+	double ev;					// Expected player net result per round, in bets
+	double houseEdge;			// -ev
+	double wins;				// User wins per round, naturals included
+	double naturals;			// User wins with a natural
+	double pushes;
+	double losses;				// Dealer wins, busts and surrenders included
+	double upEv[TDealer::VALUES_NR + 1];	// Expected net result per up card value
+	double dealerFinals[TDealer::VALUES_NR + 1][MARKOV_DEALER_FINALS];	// Dealer final
+												// score per up card value, 17 first and bust last,
+												// once the dealer has no two card 21
+	unsigned int states;		// States of each chain
+	double elapsedSecs;
+	}TMarkovResult;
+
+/*
+ * Solve the dealer and player chains and add up every starting hand
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid configuration or table file)
+ */
+int solveInfiniteDeck (const TMarkovConfig &config, TMarkovResult &result);
+
+#endif /* __MARKOV_HPP__ */
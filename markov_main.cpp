@@ -0,0 +1,223 @@
+/******************************************************************************/
+/*!
+ * @file:					  markov_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-markov. Exact infinite deck house edge of a policy
+ *  					and rule set, optionally checked against the simulator.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "markov.hpp"
+#include "misc.hpp"
+#include "rules.hpp"
+#include "simulator.hpp"
+#include "strategy.hpp"
+
+/* Library includes */
+#include <getopt.h>
+#include <iostream>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private defines */
+// Largest accepted distance, in standard errors, between simulation and solution
+#define MAX_Z_SCORE				4.0
+#define MARKOV_DEFAULT_DECKS	8
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":hP:T:d:c:S:sp6";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "policy",   		required_argument,   NULL,    'P'   },
+   { "tables",   		required_argument,   NULL,    'T'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "compare",  		required_argument,   NULL,    'c'   },
+   { "seed",   		required_argument,   NULL,    'S'   },
+   { "s17",   		no_argument,         NULL,    's'   },
+   { "push-ties",		no_argument,         NULL,    'p'   },
+   { "pay-6-5",		no_argument,         NULL,    '6'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-markov: Exact infinite deck house edge of a policy, solved as" << std::endl;
+   std::cout << "absorbing Markov chains of the dealer and player hands" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -P, --policy NAME" << std::endl;
+   std::cout << "      Player policy (default basic)." << std::endl;
+   std::cout << "   -T, --tables FILE" << std::endl;
+   std::cout << "      Table file of the 'tables' policy, played at true count 0." << std::endl;
+   std::cout << "   -d, --decks N" << std::endl;
+   std::cout << "      Decks of the tables played and of the compared simulation (default "
+         << MARKOV_DEFAULT_DECKS << ")." << std::endl;
+   std::cout << "   -c, --compare HANDS" << std::endl;
+   std::cout << "      Also simulate HANDS hands, reshuffled before every hand, and fail if" << std::endl;
+   std::cout << "      the EV is further than " << MAX_Z_SCORE << " standard errors apart. A finite" << std::endl;
+   std::cout << "      shoe is slightly off the infinite deck, so use many decks." << std::endl;
+   std::cout << "   -S, --seed SEED" << std::endl;
+   std::cout << "      Simulation seed (default 1)." << std::endl;
+   std::cout << "   -s, --s17, -p, --push-ties, -6, --pay-6-5" << std::endl;
+   std::cout << "      Rule variants, as for blackjack." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Simulate the same policy and rules and check the EV against the solution
+ * @return: - 0 - Within MAX_Z_SCORE standard errors. Otherwise,
+ * 			Error or too far apart
+ */
+	static int
+compareSimulation
+	(
+	const TMarkovConfig 	&config,		// Solved configuration
+	const TMarkovResult 	&result,		// Solution
+	unsigned int 			decks,		// Simulated shoe decks
+	unsigned long long 	hands,		// Simulated hands
+	unsigned long long 	seed			// Simulation seed
+	)
+	{
+	TSimConfig simConfig;
+	TSimResults sim;
+	simInitConfig(&simConfig);
+	simConfig.rules = config.rules;
+	simConfig.decks = decks;
+	simConfig.policy = config.policy;
+	simConfig.tablesPath = config.tablesPath;
+	simConfig.seed = seed;
+	simConfig.hands = hands;
+	simConfig.shufflePeriod = 1;
+	if (simulate(&simConfig, &sim) || !sim.handsPlayed)
+		{
+		log(LOG_ERR, "Simulation failed\n");
+		return -1;
+		}
+
+	double n = (double)sim.handsPlayed;
+	double mean = (double)sim.netTenths / 10.0 / n;
+	double variance = ((double)sim.netSquaredTenths / 100.0 - n * mean * mean) / (n - 1.0);
+	double se = (variance > 0.0) ? sqrt(variance / n) : 0.0;
+	double z = (se > 0.0) ? (mean - result.ev) / se : 0.0;
+	bool pass = fabs(z) < MAX_Z_SCORE;
+	printf("Simulation of %llu hands (%u decks, seed %llu)\n", sim.handsPlayed, decks, seed);
+	printf("  %-8s exact %+.6f  simulated %+.6f +/- %.6f  z %+.2f  %s\n", "EV", result.ev,
+			mean, se, z, pass ? "ok" : "FAIL");
+	printf("  %-8s exact %.6f  simulated %.6f\n", "Wins", result.wins, (double)sim.userWins / n);
+	printf("  %-8s exact %.6f  simulated %.6f\n", "Naturals", result.naturals,
+			(double)sim.userNaturals / n);
+	printf("  %-8s exact %.6f  simulated %.6f\n", "Pushes", result.pushes, (double)sim.pushes / n);
+	printf("  %-8s exact %.6f  simulated %.6f\n", "Losses", result.losses,
+			(double)sim.dealerWins / n);
+	printf("%s\n", pass ? "PASS" : "FAIL");
+	return pass ? 0 : 1;
+	}
+
+/* Top level and binary entry point for the infinite deck solver
+ * @return: 0 - Success (and simulation within error bars). Otherwise,
+ * 			Error
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	TMarkovConfig config;
+	memset((void *)&config, 0, sizeof(config));
+	config.policy = POLICY_BASIC;
+	config.tableDecks = MARKOV_DEFAULT_DECKS;
+	unsigned long long compareHands = 0;
+	unsigned long long seed = 1;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'P':
+				{
+				TPolicyType policy;
+				if (policyFromName(optarg, policy))
+					{
+					log(LOG_ERR, "Unknown policy\n");
+					return -1;
+					}
+				config.policy = policy;
+				}
+				break;
+			case 'T':
+				config.tablesPath = optarg;
+				break;
+			case 'd':
+				config.tableDecks = strtoul(optarg, NULL, 10);
+				break;
+			case 'c':
+				compareHands = strtoull(optarg, NULL, 10);
+				break;
+			case 'S':
+				seed = strtoull(optarg, NULL, 10);
+				break;
+			case 's':
+				config.rules |= RULES_STAND_SOFT_17;
+				break;
+			case 'p':
+				config.rules |= RULES_PUSH_TIES;
+				break;
+			case '6':
+				config.rules |= RULES_PAY_6_5;
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+
+	TMarkovResult result;
+	if (solveInfiniteDeck(config, result))
+		{
+		log(LOG_ERR, "Invalid solver configuration (policy, rules or table file)\n");
+		return -1;
+		}
+
+	printf("Infinite deck outcome (policy %s, rules 0x%x)\n",
+			policyName((TPolicyType)config.policy), config.rules);
+	printf("  EV          %+.6f bets per hand\n", result.ev);
+	printf("  House edge  %.4f%%\n", 100.0 * result.houseEdge);
+	printf("  Wins        %.6f (natural %.6f)\n", result.wins, result.naturals);
+	printf("  Pushes      %.6f\n", result.pushes);
+	printf("  Losses      %.6f\n", result.losses);
+	printf("  Up card     EV       17      18      19      20      21    bust\n");
+	for (unsigned int up = 1; up <= TDealer::VALUES_NR; up++)
+		{
+		printf("  %-8s %+.4f", (up == 1) ? "A" : std::to_string(up).c_str(), result.upEv[up]);
+		for (unsigned int i = 0; i < MARKOV_DEALER_FINALS; i++)
+			printf(" %.4f", result.dealerFinals[up][i]);
+		printf("\n");
+		}
+	printf("  States      %u per chain\n", result.states);
+	printf("  Time        %.3f ms\n", 1000.0 * result.elapsedSecs);
+
+	if (!compareHands)
+		return 0;
+	return compareSimulation(config, result, config.tableDecks, compareHands, seed);
+	}
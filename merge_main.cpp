@@ -0,0 +1,206 @@
+/******************************************************************************/
+/*!
+ * @file:					  merge_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-merge. Combines the results files of the shards of
+ *  					a run and prints the run results.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "misc.hpp"
+#include "resultfile.hpp"
+#include "sidebets.hpp"
+#include "strategy.hpp"
+
+/* Library includes */
+#include <getopt.h>
+#include <iostream>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":ho:";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "output",   		required_argument,   NULL,    'o'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-merge: Combine results files of the shards of a run" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Usage: blackjack-merge [-o FILE] FILE..." << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -o, --output FILE" << std::endl;
+   std::cout << "      Write the merged results file, itself mergeable (default none)." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Print the results of the merged shards
+ */
+	void
+printResults
+	(
+	const TResultFile &file		// Merged results
+	)
+	{
+	printf("Run: rules 0x%x, %u decks, policy %s, %u seats, seed %llu, %llu hands\n",
+			file.rules, file.decks, policyName((TPolicyType)file.policy), file.seats,
+			(unsigned long long)file.seed, (unsigned long long)file.hands);
+	printf("Shards: %u of %u%s, %.3f s of play\n", file.shardsMerged, file.shardsNr,
+			(file.shardsMerged < file.shardsNr) ? " (incomplete run)" : "",
+			(double)file.elapsedMicros / 1e6);
+	if (!file.handsPlayed)
+		return;
+
+	double n = (double)file.handsPlayed;
+	double mean = (double)file.netTenths / n;
+	printf("Hands: %llu in %llu rounds, %llu errors\n", (unsigned long long)file.handsPlayed,
+			(unsigned long long)file.rounds, (unsigned long long)file.errors);
+	if (file.netSquaredTenths && (n > 1.0))
+		{
+		double variance = ((double)file.netSquaredTenths / n - mean * mean) * n / (n - 1.0);
+		printf("  EV          %+.6f +/- %.6f bets per hand\n", mean / 10.0,
+				sqrt(variance / n) / 10.0);
+		}
+	else
+		printf("  EV          %+.6f bets per hand\n", mean / 10.0);
+	printf("  Win         %.6f (natural %.6f)\n", (double)file.userWins / n,
+			(double)file.userNaturals / n);
+	printf("  Push        %.6f\n", (double)file.pushes / n);
+	printf("  Loss        %.6f (bust %.6f)\n", (double)file.dealerWins / n,
+			(double)file.userBusts / n);
+	if (file.doubles || file.splits || file.surrenders || file.insurances)
+		printf("  Actions     %llu doubles, %llu splits, %llu surrenders, %llu insurances\n",
+				(unsigned long long)file.doubles, (unsigned long long)file.splits,
+				(unsigned long long)file.surrenders, (unsigned long long)file.insurances);
+
+	// Side bets, one bet each on every dealt hand
+	static const char *PAIRS_NAMES[] = {"", "mixed", "colored", "perfect"};
+	static const char *THREE_NAMES[] = {"", "flush", "straight", "trips", "straight flush",
+			"suited trips"};
+	double bets = 0.0, net = 0.0;
+	for (unsigned int i = 0; i < SIM_PAIRS_OUTCOMES; i++)
+		{
+		bets += (double)file.pairsOutcomes[i];
+		net += (double)file.pairsOutcomes[i] * (i ? (double)PAIRS_PAYS[i] : -1.0);
+		}
+	if (bets > 0.0)
+		{
+		printf("  Pairs       EV %+.6f per bet (", net / bets);
+		for (unsigned int i = 1; i < SIM_PAIRS_OUTCOMES; i++)
+			printf("%s%s %.6f", (i > 1) ? ", " : "", PAIRS_NAMES[i],
+					(double)file.pairsOutcomes[i] / bets);
+		printf(")\n");
+		}
+	bets = net = 0.0;
+	for (unsigned int i = 0; i < SIM_THREE_OUTCOMES; i++)
+		{
+		bets += (double)file.threeOutcomes[i];
+		net += (double)file.threeOutcomes[i] * (i ? (double)THREE_PAYS[i] : -1.0);
+		}
+	if (bets > 0.0)
+		{
+		printf("  21+3        EV %+.6f per bet (", net / bets);
+		for (unsigned int i = 1; i < SIM_THREE_OUTCOMES; i++)
+			printf("%s%s %.6f", (i > 1) ? ", " : "", THREE_NAMES[i],
+					(double)file.threeOutcomes[i] / bets);
+		printf(")\n");
+		}
+
+	uint64_t histogramHands = 0;
+	for (unsigned int i = 0; i < SIM_NET_BUCKETS; i++)
+		histogramHands += file.netHistogram[i];
+	if (!histogramHands)
+		return;
+	printf("Net result per hand:\n");
+	for (unsigned int i = 0; i < SIM_NET_BUCKETS; i++)
+		if (file.netHistogram[i])
+			printf("  %+5.1f  %.6f\n", (double)((int)i - SIM_NET_TENTHS_MAX) / 10.0,
+					(double)file.netHistogram[i] / (double)histogramHands);
+	printf("EV per Hi-Lo true count (hands share):\n");
+	for (unsigned int i = 0; i < SIM_COUNT_BUCKETS; i++)
+		if (file.countHands[i])
+			printf("  %s%+3d  %+.6f  (%.6f)\n", !i ? "<=" : ((i == SIM_COUNT_BUCKETS - 1) ?
+					">=" : "  "), (int)i + SIM_COUNT_MIN, (double)file.countNetTenths[i] /
+					10.0 / (double)file.countHands[i], (double)file.countHands[i] /
+					(double)histogramHands);
+	}
+
+/* Top level and binary entry point for the results merger
+ * @return: 0 - Success. Otherwise,
+ * 			Error
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	const char *output = NULL;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'o':
+				output = optarg;
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+	if (optind >= argc)
+		{
+		usage();
+		return -1;
+		}
+
+	TResultFile merged;
+	TResultFile shard;
+	for (int i = optind; i < argc; i++)
+		{
+		if (readResultFile(argv[i], (i == optind) ? merged : shard))
+			{
+			log(LOG_ERR, std::string("Invalid results file ") + argv[i] + "\n");
+			return -1;
+			}
+		if ((i != optind) && mergeResultFiles(merged, shard))
+			{
+			log(LOG_ERR, std::string(argv[i]) + " is not another shard of the same run\n");
+			return -1;
+			}
+		}
+
+	printResults(merged);
+	if (output && writeResultFile(output, merged))
+		{
+		log(LOG_ERR, "Could not write the merged results file\n");
+		return -1;
+		}
+	return 0;
+	}
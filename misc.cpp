@@ -13,11 +13,30 @@
 #include <string>
 #include <iostream>
 #include <sstream>
-#include <boost/algorithm/string.hpp>
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /* Local includes */
 #include "misc.hpp"
 
+/* Console input script (see setInputScript()), mapped for the process life */
+typedef struct __InputScript__
+	{
+	const char *map;									// NULL, input from std::cin
+	std::vector<std::pair<size_t, size_t> > inputs;	// Offset and length of every input
+	size_t next;										// Next input to take
+	}TInputScript;
+
+static TInputScript script = {NULL, std::vector<std::pair<size_t, size_t> >(), 0};
+// Messages are kept here instead of printed. NULL, print
+static std::string *logCapture = NULL;
+
 /*
  * Prints messages for human readability
  * @return: number of characters printed
@@ -31,10 +50,180 @@ unsigned int
 	const std::string &logStr		// Message to print
 	)
 	{
-	printf("%s", logStr.c_str());
+	if (logCapture)
+		logCapture->append(logStr);
+	else
+		fwrite(logStr.data(), 1, logStr.size(), stdout);
 	return logStr.size();
 	}
 
+/*
+ * Keep the messages printed from now on in 'capture' instead of printing them
+ */
+	void
+setLogCapture
+	(
+	std::string *capture		// Messages kept. NULL, print again
+	)
+	{
+	logCapture = capture;
+	}
+
+/*
+ * Read the console input from a script file
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (file could not be read)
+ */
+	int
+setInputScript
+	(
+	const char *path		// Script file
+	)
+	{
+	int ret = -1; // Assume error reading the script
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return ret;
+	struct stat st;
+	if (fstat(fd, &st))
+		{
+		close(fd);
+		return ret;
+		}
+	// An empty script is a console closed from the start
+	if (!st.st_size)
+		{
+		close(fd);
+		script.map = "";
+		script.inputs.clear();
+		script.next = 0;
+		ret = 0;
+		return ret;
+		}
+	void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return ret;
+
+	// Split once: prompts only take the next input
+	const char *text = (const char *)map;
+	size_t size = (size_t)st.st_size;
+	script.inputs.clear();
+	for (size_t i = 0; i < size;)
+		{
+		if (text[i] == '#')
+			{
+			while ((i < size) && (text[i] != '\n'))
+				i++;
+			}
+		else if (isspace((unsigned char)text[i]))
+			i++;
+		else
+			{
+			size_t first = i;
+			while ((i < size) && !isspace((unsigned char)text[i]) && (text[i] != '#'))
+				i++;
+			script.inputs.push_back(std::make_pair(first, i - first));
+			}
+		}
+	script.map = text;
+	script.next = 0;
+	ret = 0;
+	return ret;
+	}
+
+/*
+ * A person types the input: no script and the standard input is a terminal
+ * @return: - True - Input is typed
+ */
+	bool
+isInputTyped
+	(
+	void
+	)
+	{
+	return !script.map && isatty(STDIN_FILENO);
+	}
+
+/*
+ * Give the user time to read the console. No delay unless the input is typed
+ */
+	void
+consoleDelay
+	(
+	unsigned int secs		// Delay, seconds
+	)
+	{
+	if (isInputTyped())
+		sleep(secs);
+	}
+
+/*
+ * Next console input, from the script if any, echoed after the prompt
+ * @return: - True - Input in 'input' ('length' characters, not terminated).
+ * 			Otherwise, no input left
+ */
+	static bool
+nextInput
+	(
+	std::string 	&buffer,		// Console input storage
+	const char 		*&input,		// Out argument
+	size_t 			&length		// Out argument
+	)
+	{
+	if (!script.map)
+		{
+		if (!(std::cin >> buffer))
+			return false;
+		input = buffer.data();
+		length = buffer.size();
+		return true;
+		}
+	if (script.next >= script.inputs.size())
+		return false;
+	input = script.map + script.inputs[script.next].first;
+	length = script.inputs[script.next].second;
+	script.next++;
+	buffer.assign("> ");
+	buffer.append(input, length);
+	buffer.append("\n");
+	log(LOG_INFO, buffer);
+	return true;
+	}
+
+/*
+ * Console input matches an option, case insensitive
+ * @return: - True - Input matches
+ */
+	static inline bool
+inputIs
+	(
+	const char 			*input,		// Input, not terminated
+	size_t 				length,		// Input characters
+	const std::string &option		// Option
+	)
+	{
+	return (length == option.size()) && !strncasecmp(input, option.c_str(), length);
+	}
+
+/*
+ * Seed for an independent random stream derived from a base seed
+ * (splitmix64 finalizer)
+ * @return: Stream seed
+ */
+	unsigned long long
+mixSeed
+	(
+	unsigned long long seed,		// Base seed
+	unsigned long long stream		// Stream index
+	)
+	{
+	unsigned long long z = seed + (stream + 1) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+	}
+
 /*
  * Request input from two provided options
  * When input matches exit string, return or max
@@ -56,22 +245,23 @@ TReqInputRets
 	bool success = true;  // Assume success entering user input
 	//  Tries to allow system to received bad input before exiting
 	unsigned int attempts = 0;
-	std::string upExitStr = boost::to_upper_copy<std::string>(exitStr);
-	std::string upContinStr = boost::to_upper_copy<std::string>(continueStr);
+	std::string inStr;
 	do
 	{
-	std::string inStr;
+	const char *input;
+	size_t length;
 
 	log(LOG_INFO, reqStr);
 
-	std::cin >> inStr;
-	std::string upInStr = boost::to_upper_copy<std::string>(inStr);
-	if (upInStr == upExitStr)
+	// No input left (closed console or script over)
+	if (!nextInput(inStr, input, length))
+		return REQ_INPUT_ERR;
+	if (inputIs(input, length, exitStr))
 		{
 		success = true;
 		ret = REQ_INPUT_EXIT;
 		}
-	else if (upInStr == upContinStr)
+	else if (inputIs(input, length, continueStr))
 		{
 		success = true;
 		ret = REQ_INPUT_CONT;
@@ -80,15 +270,15 @@ TReqInputRets
 		{
 		success = false;
 		log(LOG_INFO, "\nUnrecognized input. Permitted only 'Y' or 'N'\n\n");
-		sleep(1);   // Give user time to recognize error
+		consoleDelay(1);   // Give user time to recognize error
 		}
 	attempts++;
 	} while  (!success && (attempts < max_tries));
 
-	if (attempts >= max_tries)
+	if (!success)
 		{
-		printf("max tries = %d\n", max_tries);
 		std::stringstream ss;
+		ss << "max tries = " << max_tries << "\n";
 		ss << "\nError, max attempts (" << attempts << ") to received valid input from "
 				"user has been reached.\n" << std::endl;
 		log(LOG_ERR, ss.str());
@@ -96,3 +286,35 @@ TReqInputRets
 		}
 	return ret;
 	}
+
+/*
+ * Request input among several options (case insensitive)
+ * @return: - Index of the option matching the input. Otherwise,
+ * 			-1 - I/O error or max tries reached
+ */
+	int
+reqChoice
+	(
+	const std::string 				 &reqStr,		// Header string. Human readable question
+	const std::vector<std::string> &options,		// Accepted inputs
+	unsigned int 						 max_tries		// Max number of attempts before exitting with error
+	)
+	{
+	std::string inStr;
+	for (unsigned int attempts = 0; attempts < max_tries; attempts++)
+		{
+		const char *input;
+		size_t length;
+		log(LOG_INFO, reqStr);
+		if (!nextInput(inStr, input, length))
+			break;
+
+		for (unsigned int i = 0; i < options.size(); i++)
+			if (inputIs(input, length, options[i]))
+				return (int)i;
+		log(LOG_INFO, "\nUnrecognized input\n\n");
+		}
+
+	log(LOG_ERR, "\nError, no valid input received from user\n\n");
+	return -1;
+	}
@@ -13,7 +13,9 @@
 #define __MISC__
 
 /* C++ Library includes */
+#include <math.h>
 #include <string>
+#include <vector>
 
 /* Defines */
 
@@ -36,12 +38,70 @@ typedef enum __ReqInputRets__
 	REQ_INPUT_ERR 	 // I/O When requested input
 	}TReqInputRets;
 
+/*
+ * Running mean and variance of a sample (Welford), one value at a time
+ * without keeping the values
+ */
+class TRunningStats
+	{
+	public:
+		TRunningStats(void) : mCount(0), mMean(0.0), mM2(0.0) {};
+		void add(double value)
+			{
+			mCount++;
+			double delta = value - mMean;
+			mMean += delta / (double)mCount;
+			mM2 += delta * (value - mMean);
+			};
+		unsigned long long getCount(void) const {return mCount;};
+		double getMean(void) const {return mMean;};
+		// Sample variance
+		double getVariance(void) const {return (mCount > 1) ? mM2 / (double)(mCount - 1) : 0.0;};
+		// Standard error of the mean
+		double getStdErr(void) const
+			{
+			return mCount ? sqrt(getVariance() / (double)mCount) : 0.0;
+			};
+
+	private:
+		unsigned long long mCount;
+		double mMean;
+		double mM2;			// Sum of squared deviations from the mean
+	};
+
 /*
  * Prints messages for human readability
  * @return: number of characters printed
  */
 unsigned int log(TLogPrio prio, const std::string &logStr);
 
+/*
+ * Keep the messages printed from now on in 'capture' instead of printing
+ * them. NULL, print again
+ */
+void setLogCapture(std::string *capture);
+
+/*
+ * Read the console input from a script file instead of the console. The file
+ * is memory mapped and split once in whitespace separated inputs, '#' starts
+ * a comment up to the end of the line. Every input taken is echoed after its
+ * prompt. Once the script is over, input requests fail as on a closed console.
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (file could not be read)
+ */
+int setInputScript(const char *path);
+
+/*
+ * A person types the input: no script and the standard input is a terminal
+ * @return: - True - Input is typed
+ */
+bool isInputTyped(void);
+
+/*
+ * Give the user time to read the console. No delay unless the input is typed
+ */
+void consoleDelay(unsigned int secs);
+
 /*
  * Request input from two provided options
  * When input matches exit string, return or max
@@ -53,4 +113,19 @@ unsigned int log(TLogPrio prio, const std::string &logStr);
 TReqInputRets reqInput (const std::string &reqStr, const std::string &exitStr,
 		const std::string &continueStr, unsigned int max_tries);
 
+/*
+ * Request input among several options (case insensitive)
+ * @return: - Index of the option matching the input. Otherwise,
+ * 			-1 - I/O error or max tries reached
+ */
+int reqChoice (const std::string &reqStr, const std::vector<std::string> &options,
+		unsigned int max_tries);
+
+/*
+ * Seed for an independent random stream derived from a base seed, so work
+ * split in streams (sessions, threads, shards) is reproducible
+ * @return: Stream seed
+ */
+unsigned long long mixSeed(unsigned long long seed, unsigned long long stream);
+
 #endif
@@ -0,0 +1,254 @@
+/******************************************************************************/
+/*!
+ * @file:					  observe_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-observe. Benchmarks the hand loop observers: the
+ *  					same hands played by the plain engine, by an engine with
+ *  					composed null observers and by one with the analytics
+ *  					observers, then prints what the analytics observed.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "blackjack.hpp"
+#include "misc.hpp"
+#include "rules.hpp"
+#include "strategy.hpp"
+
+/* Library includes */
+#include <chrono>
+#include <getopt.h>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private defines */
+#define OBSERVE_DEFAULT_HANDS		5000000ULL
+#define OBSERVE_DEFAULT_REPEATS	3
+
+/* Engines benchmarked, all under the house rules */
+typedef TBlackjack<TRulesHouse> TPlainEngine;
+typedef TObservers<TNullObserver, TNullObserver> TNullPair;
+typedef TBlackjack<TRulesHouse, TNullPair> TNullEngine;
+typedef TObservers<TCardsObserver, TActionsObserver, TDealerObserver> TAnalytics;
+typedef TBlackjack<TRulesHouse, TAnalytics> TAnalyticsEngine;
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":hn:d:P:S:r:x:";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "hands",   		required_argument,   NULL,    'n'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "policy",   		required_argument,   NULL,    'P'   },
+   { "seed",   		required_argument,   NULL,    'S'   },
+   { "repeats",  		required_argument,   NULL,    'r'   },
+   { "max-overhead",	required_argument,   NULL,    'x'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-observe: Throughput of the hand loop with no observer, composed" << std::endl;
+   std::cout << "null observers and the analytics observers, on the same hands" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -n, --hands N" << std::endl;
+   std::cout << "      Hands each engine plays per repeat (default " << OBSERVE_DEFAULT_HANDS <<
+   		")." << std::endl;
+   std::cout << "   -d, --decks N, -P, --policy NAME, -S, --seed SEED" << std::endl;
+   std::cout << "      Shoe decks (default 6), player policy (default full, 'tables' is not" << std::endl;
+   std::cout << "      available) and seed (default 1)." << std::endl;
+   std::cout << "   -r, --repeats N" << std::endl;
+   std::cout << "      Interleaved repeats, the fastest one is kept (default " <<
+   		OBSERVE_DEFAULT_REPEATS << ")." << std::endl;
+   std::cout << "   -x, --max-overhead PCT" << std::endl;
+   std::cout << "      Fail if the null observers engine is more than PCT percent slower" << std::endl;
+   std::cout << "      than the plain engine." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Play hands on a fresh engine
+ * @return: Seconds taken
+ */
+template <typename TEngine>
+	double
+playHands
+	(
+	TEngine 				&bljck,			// Engine, fresh
+	unsigned long long hands			// Hands to play
+	)
+	{
+	TCards cardDeck;
+	cardDeck.reserve(bljck.getDealer().getDecks() * TDealer::CARDS_PER_DECK);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned long long i = 0; i < hands; i++)
+		bljck.playHand(cardDeck);
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+	}
+
+/*
+ * Print what the analytics observers saw
+ */
+	void
+printAnalytics
+	(
+	const TAnalytics &analytics,		// Observers of the last repeat
+	unsigned long long hands			// Hands played
+	)
+	{
+	static const char VALUES[] = "?A23456789T";
+	const TCardsObserver &cards = analytics.get<0>();
+	const TActionsObserver &actions = analytics.get<1>();
+	const TDealerObserver &dealer = analytics.get<2>();
+
+	unsigned long long dealt[2] = {0, 0};
+	for (unsigned int v = 1; v <= TDealer::VALUES_NR; v++)
+		for (unsigned int d = 0; d < 2; d++)
+			dealt[d] += cards.getCards(d, v);
+	printf("Cards dealt: %.3f per hand to the player, %.3f to the dealer\n",
+			(double)dealt[0] / (double)hands, (double)dealt[1] / (double)hands);
+
+	unsigned long long decisions = 0;
+	for (unsigned int a = 0; a < ACTION_TYPES_NR; a++)
+		decisions += actions.getActions((TPlayerAction)a);
+	printf("Decisions:   %.3f per hand\n", (double)decisions / (double)hands);
+	for (unsigned int a = 0; a < ACTION_TYPES_NR; a++)
+		if (actions.getActions((TPlayerAction)a))
+			printf("  %-12s %6.2f%%\n", actionName((TPlayerAction)a),
+					100.0 * (double)actions.getActions((TPlayerAction)a) / (double)decisions);
+
+	printf("Dealer final scores per up card, rounds the dealer draws in:\n");
+	printf("  Up        17      18      19      20      21    Bust\n");
+	for (unsigned int up = 1; up <= TDealer::VALUES_NR; up++)
+		{
+		unsigned long long rounds = 0;
+		for (unsigned int o = 0; o < TDealerObserver::OUTCOMES_NR; o++)
+			rounds += dealer.getOutcomes(up, o);
+		if (!rounds)
+			continue;
+		printf("  %c  ", VALUES[up]);
+		for (unsigned int o = 0; o < TDealerObserver::OUTCOMES_NR; o++)
+			printf(" %6.2f%%", 100.0 * (double)dealer.getOutcomes(up, o) / (double)rounds);
+		printf("\n");
+		}
+	}
+
+/* Top level and binary entry point for the observers benchmark
+ * @return: 0 - Success. Otherwise,
+ * 			Error (engines disagree or the overhead is over the argued maximum)
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	unsigned long long hands = OBSERVE_DEFAULT_HANDS;
+	unsigned long long seed = 1;
+	unsigned int decks = 6;
+	unsigned int repeats = OBSERVE_DEFAULT_REPEATS;
+	TPolicyType policy = POLICY_FULL_BASIC;
+	double maxOverhead = -1.0;		// Percent, negative if not checked
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'n':
+				hands = strtoull(optarg, NULL, 10);
+				break;
+			case 'd':
+				decks = strtoul(optarg, NULL, 10);
+				break;
+			case 'P':
+				if (policyFromName(optarg, policy) || (policy == POLICY_TABLES))
+					{
+					log(LOG_ERR, "Unknown or unavailable policy\n");
+					return -1;
+					}
+				break;
+			case 'S':
+				seed = strtoull(optarg, NULL, 10);
+				break;
+			case 'r':
+				repeats = strtoul(optarg, NULL, 10);
+				break;
+			case 'x':
+				maxOverhead = strtod(optarg, NULL);
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+	if (!hands || !decks || !repeats)
+		{
+		log(LOG_ERR, "Hands, decks and repeats must not be zero\n");
+		return -1;
+		}
+
+	TStrategy strategy(policy);
+	TDealer dealer(seed, decks);
+	double best[3] = {0.0, 0.0, 0.0};
+	TAnalytics analytics;
+	bool agree = true;
+	for (unsigned int r = 0; r < repeats; r++)
+		{
+		TPlainEngine plain(dealer, &strategy);
+		TNullEngine null(dealer, &strategy);
+		TAnalyticsEngine observed(dealer, &strategy);
+		double secs[3];
+		secs[0] = playHands(plain, hands);
+		secs[1] = playHands(null, hands);
+		secs[2] = playHands(observed, hands);
+		for (unsigned int e = 0; e < 3; e++)
+			if (!r || (secs[e] < best[e]))
+				best[e] = secs[e];
+
+		// Observers never change play: every engine ends with the same stats
+		const TBlackJackStats &stats = plain.getStats();
+		agree &= !memcmp(&stats, &null.getStats(), sizeof(stats)) &&
+				!memcmp(&stats, &observed.getStats(), sizeof(stats));
+		analytics = observed.getObserver();
+		}
+
+	printf("%llu hands per engine, best of %u (%u decks, %s policy, seed %llu)\n",
+			hands, repeats, decks, policyName(policy), seed);
+	static const char *NAMES[] = {"No observer", "Null observers", "Analytics"};
+	for (unsigned int e = 0; e < 3; e++)
+		printf("  %-16s %.3f s  %11.0f hands/s  %+6.2f%%\n", NAMES[e], best[e],
+				(double)hands / best[e], 100.0 * (best[e] - best[0]) / best[0]);
+	printAnalytics(analytics, hands);
+
+	if (!agree)
+		{
+		log(LOG_ERR, "Engines with observers played different hands\n");
+		return -1;
+		}
+	if ((maxOverhead >= 0.0) && (100.0 * (best[1] - best[0]) / best[0] > maxOverhead))
+		{
+		log(LOG_ERR, "Null observers overhead over the maximum\n");
+		return -1;
+		}
+	return 0;
+	}
@@ -0,0 +1,305 @@
+/******************************************************************************/
+/*!
+ * @file:					  observer.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the hand loop observers. An
+ *  					observer is the second template argument of TBlackjack
+ *  					and receives the events of every hand it plays:
+ *
+ *  	onCardDealt(card, toDealer)	Every card taken from the shoe
+ *  	onDecision(dealer, hole, score, soft, upCard, action)
+ *  											Every player decision, before it is played.
+ *  											HISTORY_ACTION_NONE once for a hand settled
+ *  											before the player acts
+ *  	onDealerStand(upCard, score)	The dealer drew to a standing score
+ *  	onDealerBust(upCard)				The dealer drew over BLACKJACK_VAL
+ *  	onHandResult(net)					Hand (round) played, net result in bets
+ *
+ *  The dealer events only take place in rounds the dealer draws in. Calls are
+ *  resolved at compile time and inlined: TNullObserver members are empty and
+ *  the engine built with it is the plain engine. Observers are composed with
+ *  TObservers<A, B, ...>, which forwards every event to each one in order.
+ *  An observer type needs its engines instantiated at the end of
+ *  blackjack.cpp, as the rule sets do.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __OBSERVER_HPP__
+#define __OBSERVER_HPP__
+
+/* Library includes */
+#include <string.h>
+
+/* Local includes */
+#include "dealer.hpp"
+#include "history.hpp"
+#include "sidebets.hpp"
+#include "strategy.hpp"
+
+/* Enumerations, type defines */
+
+/* Rare hand events (see TRareObserver) */
+typedef enum __RareEvent__
+	{
+	RARE_SEVEN_CARD_21,			// Player 21 of seven cards or more, round not split
+	RARE_SUITED_NATURAL,			// Player natural (an Ace and a face card) of a suit
+	RARE_PERFECT_PAIR,			// Perfect Pairs top tier: same rank and suit
+	RARE_STRAIGHT_FLUSH,			// 21+3 straight flush
+	RARE_SUITED_TRIPS,			// 21+3 top tier: three cards of a rank and suit
+	RARE_EVENTS_NR
+	}TRareEvent;
+
+/*
+ * The null observer
+ * Takes every event and does nothing. Default observer of TBlackjack.
+ */
+class TNullObserver
+	{
+	public:
+		void onCardDealt(const TCard &, bool) {};
+		void onDecision(const TDealer &, const TCard &, int, bool, unsigned int, int) {};
+		void onDealerStand(unsigned int, int) {};
+		void onDealerBust(unsigned int) {};
+		void onHandResult(double) {};
+	};
+
+/*
+ * Observers composition
+ * TObservers<A, B, C> forwards every event to A, then B, then C. Each observer
+ * is reached with get<I>(), 0 the first one.
+ */
+template <typename... TList>
+class TObservers;
+
+template <>
+class TObservers<> : public TNullObserver
+	{
+	};
+
+template <typename TFirst, typename... TRest>
+class TObservers<TFirst, TRest...>
+	{
+	// Observer at position I of the list, and its type
+	template <unsigned int I, typename TDummy = void>
+	struct TAt
+		{
+		typedef typename TObservers<TRest...>::template TAt<I - 1>::TType TType;
+		static TType &get(TObservers &obs) {return TObservers<TRest...>::template TAt<I - 1>::get(obs.mRest);};
+		};
+	template <typename TDummy>
+	struct TAt<0, TDummy>
+		{
+		typedef TFirst TType;
+		static TType &get(TObservers &obs) {return obs.mFirst;};
+		};
+	template <typename... TOther> friend class TObservers;
+
+	public:
+		template <unsigned int I>
+		typename TAt<I>::TType &get(void) {return TAt<I>::get(*this);};
+		template <unsigned int I>
+		const typename TAt<I>::TType &get(void) const
+			{return TAt<I>::get(const_cast<TObservers &>(*this));};
+
+		void onCardDealt(const TCard &card, bool toDealer)
+			{
+			mFirst.onCardDealt(card, toDealer);
+			mRest.onCardDealt(card, toDealer);
+			};
+		void onDecision(const TDealer &dealer, const TCard &hole, int score, bool soft,
+				unsigned int upCard, int action)
+			{
+			mFirst.onDecision(dealer, hole, score, soft, upCard, action);
+			mRest.onDecision(dealer, hole, score, soft, upCard, action);
+			};
+		void onDealerStand(unsigned int upCard, int score)
+			{
+			mFirst.onDealerStand(upCard, score);
+			mRest.onDealerStand(upCard, score);
+			};
+		void onDealerBust(unsigned int upCard)
+			{
+			mFirst.onDealerBust(upCard);
+			mRest.onDealerBust(upCard);
+			};
+		void onHandResult(double net)
+			{
+			mFirst.onHandResult(net);
+			mRest.onHandResult(net);
+			};
+
+	private:
+		TFirst mFirst;
+		TObservers<TRest...> mRest;
+	};
+
+/*
+ * Hand history observer
+ * Stores every decision in a hand history (see THistoryWriter) and ends the
+ * hand with its net result. Hands settled before the player acts are one row
+ * of action HISTORY_ACTION_NONE. The caller drops the rows of a failed hand.
+ */
+class THistoryObserver : public TNullObserver
+	{
+	public:
+		THistoryObserver(void) : mWriter(NULL) {};
+		void setWriter(THistoryWriter *writer) {mWriter = writer;};
+		THistoryWriter *getWriter(void) const {return mWriter;};
+		void onDecision(const TDealer &dealer, const TCard &hole, int score, bool soft,
+				unsigned int upCard, int action)
+			{
+			if (mWriter && (action >= 0))
+				mWriter->addDecision(score, soft, upCard, dealer.getTrueCount(&hole), action);
+			};
+		void onHandResult(double net)
+			{
+			if (mWriter)
+				mWriter->endHand(net);
+			};
+
+	private:
+		THistoryWriter *mWriter;
+	};
+
+/*
+ * Dealt cards observer
+ * Cards dealt per value (Ace 1, tens 10), player and dealer apart.
+ */
+class TCardsObserver : public TNullObserver
+	{
+	public:
+		TCardsObserver(void) {memset((void *)mCards, 0, sizeof(mCards));};
+		void onCardDealt(const TCard &card, bool toDealer) {mCards[toDealer][card.value]++;};
+		unsigned long long getCards(bool toDealer, unsigned int value) const
+			{return mCards[toDealer][value];};
+
+	private:
+		unsigned long long mCards[2][TDealer::VALUES_NR + 1];
+	};
+
+/*
+ * Player decisions observer
+ * Decisions per player action (TPlayerAction).
+ */
+class TActionsObserver : public TNullObserver
+	{
+	public:
+		TActionsObserver(void) {memset((void *)mActions, 0, sizeof(mActions));};
+		void onDecision(const TDealer &, const TCard &, int, bool, unsigned int, int action)
+			{
+			if ((action >= 0) && (action < ACTION_TYPES_NR))
+				mActions[action]++;
+			};
+		unsigned long long getActions(TPlayerAction action) const {return mActions[action];};
+
+	private:
+		unsigned long long mActions[ACTION_TYPES_NR];
+	};
+
+/*
+ * Dealer outcomes observer
+ * Final dealer scores (17 to 21, or bust) per up card value, in the rounds
+ * the dealer draws in.
+ */
+class TDealerObserver : public TNullObserver
+	{
+	public:
+		// Final scores kept: 17 to 21, then bust
+		static const unsigned int STAND_MIN = 17;
+		static const unsigned int OUTCOMES_NR = 6;
+		static const unsigned int OUTCOME_BUST = OUTCOMES_NR - 1;
+
+		TDealerObserver(void) {memset((void *)mOutcomes, 0, sizeof(mOutcomes));};
+		void onDealerStand(unsigned int upCard, int score)
+			{
+			if ((score >= (int)STAND_MIN) && (score < (int)(STAND_MIN + OUTCOME_BUST)))
+				mOutcomes[upCard][score - STAND_MIN]++;
+			};
+		void onDealerBust(unsigned int upCard) {mOutcomes[upCard][OUTCOME_BUST]++;};
+		/*
+		 * Dealer final outcomes of an up card
+		 * @return: Rounds ended at 'outcome', 0 to 4 score 17 to 21, OUTCOME_BUST
+		 */
+		unsigned long long getOutcomes(unsigned int upCard, unsigned int outcome) const
+			{return mOutcomes[upCard][outcome];};
+
+	private:
+		unsigned long long mOutcomes[TDealer::VALUES_NR + 1][OUTCOMES_NR];
+	};
+
+/*
+ * Rare events observer
+ * Rare events (TRareEvent) of the last round played, as a bit mask. The side
+ * bet tiers are those of the player first two cards and the up card.
+ */
+class TRareObserver : public TNullObserver
+	{
+	public:
+		TRareObserver(void) : mTables(&sideBetTables()), mEvents(0) {reset();};
+		void onCardDealt(const TCard &card, bool toDealer)
+			{
+			if (toDealer)
+				{
+				// The up card is the second one, the hole card the first
+				if (++mDealerCards == 2)
+					mUp = card;
+				return;
+				}
+			if (mPlayerCards < 2)
+				mFirst[mPlayerCards] = card;
+			mPlayerCards++;
+			mHard += card.value;
+			mAces += (card.value == 1);
+			};
+		void onDecision(const TDealer &, const TCard &, int, bool, unsigned int, int action)
+			{
+			if (action == ACTION_SPLIT)
+				mSplit = true;
+			};
+		void onHandResult(double)
+			{
+			mEvents = 0;
+			unsigned int first = cardCode(mFirst[0]), second = cardCode(mFirst[1]);
+			unsigned int score = (mAces && (mHard + 10 <= 21)) ? mHard + 10 : mHard;
+			if (!mSplit && (mPlayerCards >= 7) && (score == 21))
+				mEvents |= 1 << RARE_SEVEN_CARD_21;
+			// A natural as the game pays it (see verifyNatural()): an Ace and a face card
+			if ((((mFirst[0].value == 1) && mFirst[1].isFace) ||
+					((mFirst[1].value == 1) && mFirst[0].isFace)) &&
+					(mFirst[0].suit == mFirst[1].suit))
+				mEvents |= 1 << RARE_SUITED_NATURAL;
+			if (evalPairs(*mTables, first, second) == PAIRS_PERFECT)
+				mEvents |= 1 << RARE_PERFECT_PAIR;
+			TThreeOutcome three = evalThree(*mTables, first, second, cardCode(mUp));
+			if (three == THREE_STRAIGHT_FLUSH)
+				mEvents |= 1 << RARE_STRAIGHT_FLUSH;
+			else if (three == THREE_SUITED_TRIPS)
+				mEvents |= 1 << RARE_SUITED_TRIPS;
+			reset();
+			};
+		// Start over, for rounds ended by an error
+		void reset(void)
+			{
+			mPlayerCards = mDealerCards = mHard = mAces = 0;
+			mSplit = false;
+			};
+		// Events of the last round, bit 1 << TRareEvent each
+		unsigned int getEvents(void) const {return mEvents;};
+
+	private:
+		const TSideBetTables *mTables;
+		unsigned int mEvents;
+		// Round in play
+		TCard mFirst[2];			// Player first two cards
+		TCard mUp;
+		unsigned int mPlayerCards;
+		unsigned int mDealerCards;
+		unsigned int mHard;		// Player cards total, Aces one
+		unsigned int mAces;
+		bool mSplit;
+	};
+
+#endif /* __OBSERVER_HPP__ */
@@ -0,0 +1,272 @@
+/******************************************************************************/
+/*!
+ * @file:					  query_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-query. Filters and aggregates a hand history store
+ *  					(see blackjack-sim --history) from its memory mapped
+ *  					columns and bitmap indexes.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "history.hpp"
+#include "misc.hpp"
+#include "strategy.hpp"
+
+/* Library includes */
+#include <chrono>
+#include <getopt.h>
+#include <iostream>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":hw:g:x";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "where",   		required_argument,   NULL,    'w'   },
+   { "group",   		required_argument,   NULL,    'g'   },
+   { "scan",   		no_argument,         NULL,    'x'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-query: Filter and aggregate the decisions of a hand history store" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Usage: blackjack-query [options] STORE" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -w, --where COLUMN=LO[:HI]" << std::endl;
+   std::cout << "      Keep rows with COLUMN from LO to HI (either end may be left out)." << std::endl;
+   std::cout << "      Columns: total, soft (0/1), up (1 to 10), count (floored true count," << std::endl;
+   std::cout << "      " << HISTORY_COUNT_MIN << " to " << HISTORY_COUNT_MAX <<
+   		" clamped), action (stand, hit, double, split, surrender," << std::endl;
+   std::cout << "      none), first (1 on the first decision of a hand) and result (hand" << std::endl;
+   std::cout << "      net result in bets). Repeat to add filters, all must pass." << std::endl;
+   std::cout << "   -g, --group COLUMN" << std::endl;
+   std::cout << "      Aggregate per value of an indexed column." << std::endl;
+   std::cout << "   -x, --scan" << std::endl;
+   std::cout << "      Scan the columns instead of using the bitmap indexes." << std::endl;
+   std::cout << std::endl;
+   std::cout << "Ex: stood on 16 against a 10 at true count +2 or more:" << std::endl;
+   std::cout << "   blackjack-query -w total=16 -w soft=0 -w up=10 -w count=2: -w action=stand STORE" << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Column value of an option argument
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid value)
+ */
+	int
+parseValue
+	(
+	THistoryColumn 	column,		// Filtered column
+	const std::string &text,		// Value, empty for an open end
+	int 					openEnd,		// Value of an open end
+	int 					&value		// Out argument
+	)
+	{
+	if (text.empty())
+		{
+		value = openEnd;
+		return 0;
+		}
+	if (column == HISTORY_ACTION)
+		{
+		if (text == "none")
+			{
+			value = HISTORY_ACTION_NONE;
+			return 0;
+			}
+		for (int a = 0; a < ACTION_TYPES_NR; a++)
+			if (text == actionName((TPlayerAction)a))
+				{
+				value = a;
+				return 0;
+				}
+		return -1;
+		}
+	char *end;
+	if (column == HISTORY_RESULT)
+		{
+		// Bets, stored in tenths
+		double bets = strtod(text.c_str(), &end);
+		value = (int)lround(bets * 10.0);
+		}
+	else
+		value = (int)strtol(text.c_str(), &end, 10);
+	return *end ? -1 : 0;
+	}
+
+/*
+ * Filter of a --where argument
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid filter)
+ */
+	int
+parseFilter
+	(
+	const std::string &text,		// COLUMN=LO[:HI]
+	THistoryFilter 	&filter		// Out argument
+	)
+	{
+	size_t eq = text.find('=');
+	THistoryColumn column;
+	if ((eq == std::string::npos) || historyColumnFromName(text.substr(0, eq), column))
+		return -1;
+	std::string range = text.substr(eq + 1);
+	size_t colon = range.find(':');
+	std::string lo = range.substr(0, colon);
+	std::string hi = (colon == std::string::npos) ? lo : range.substr(colon + 1);
+	filter.column = column;
+	if (parseValue(column, lo, INT_MIN / 2, filter.lo) ||
+			parseValue(column, hi, INT_MAX / 2, filter.hi) || (filter.lo > filter.hi))
+		return -1;
+	return 0;
+	}
+
+/*
+ * Print the aggregates of one query
+ */
+	void
+printAggregate
+	(
+	const char 					*label,			// Row label
+	const THistoryAggregate &aggregate,
+	uint64_t 					rows				// Rows in the store
+	)
+	{
+	double n = (double)aggregate.rows;
+	if (!aggregate.rows)
+		{
+		printf("%-16s %12u rows\n", label, 0);
+		return;
+		}
+	double mean = (double)aggregate.resultTenths / n;
+	double variance = (n > 1.0) ? ((double)aggregate.squaredTenths / n - mean * mean) *
+			n / (n - 1.0) : 0.0;
+	printf("%-16s %12llu rows (%6.3f%%), %12llu hands, EV %+.4f +/- %.4f bets\n", label,
+			(unsigned long long)aggregate.rows, 100.0 * n / (double)rows,
+			(unsigned long long)aggregate.hands, mean / 10.0, sqrt(variance / n) / 10.0);
+	}
+
+/* Top level and binary entry point for the history query tool
+ * @return: 0 - Success. Otherwise,
+ * 			Error
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	std::vector<THistoryFilter> filters;
+	bool grouped = false;
+	THistoryColumn group = HISTORY_TOTAL;
+	bool scan = false;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'w':
+				{
+				THistoryFilter filter;
+				if (parseFilter(optarg, filter))
+					{
+					log(LOG_ERR, std::string("Invalid filter ") + optarg + "\n");
+					return -1;
+					}
+				filters.push_back(filter);
+				}
+				break;
+			case 'g':
+				if (historyColumnFromName(optarg, group) || (group >= HISTORY_INDEXED_NR))
+					{
+					log(LOG_ERR, "Groups are on an indexed column (not result)\n");
+					return -1;
+					}
+				grouped = true;
+				break;
+			case 'x':
+				scan = true;
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+	if (optind != argc - 1)
+		{
+		usage();
+		return -1;
+		}
+
+	THistoryStore store;
+	if (store.open(argv[optind]))
+		{
+		log(LOG_ERR, "Invalid hand history store\n");
+		return -1;
+		}
+	const THistoryMeta &meta = store.getMeta();
+	printf("%s: %llu decisions of %llu hands (rules 0x%x, %u decks, policy %s, seed %llu)\n",
+			argv[optind], (unsigned long long)meta.rows, (unsigned long long)meta.hands,
+			meta.rules, meta.decks, policyName((TPolicyType)meta.policy),
+			(unsigned long long)meta.seed);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	THistoryAggregate aggregate;
+	if (store.query(filters, scan, aggregate))
+		{
+		log(LOG_ERR, "Query failed\n");
+		return -1;
+		}
+	printAggregate("All", aggregate, meta.rows);
+	if (grouped)
+		{
+		int lo = (group == HISTORY_COUNT) ? HISTORY_COUNT_MIN : 0;
+		int hi = (group == HISTORY_COUNT) ? HISTORY_COUNT_MAX : HISTORY_MAX_VALUES - 1;
+		filters.push_back(THistoryFilter());
+		for (int v = lo; v <= hi; v++)
+			{
+			filters.back().column = group;
+			filters.back().lo = v;
+			filters.back().hi = v;
+			if (store.query(filters, scan, aggregate) || !aggregate.rows)
+				continue;
+			char label[32];
+			if (group == HISTORY_ACTION)
+				snprintf(label, sizeof(label), "%s=%s", historyColumnName(group),
+						(v == HISTORY_ACTION_NONE) ? "none" : actionName((TPlayerAction)v));
+			else
+				snprintf(label, sizeof(label), "%s=%d", historyColumnName(group), v);
+			printAggregate(label, aggregate, meta.rows);
+			}
+		}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	printf("Query time %.3f ms (%s)\n", elapsed.count() * 1e3, scan ? "column scans" :
+			"bitmap indexes");
+	return 0;
+	}
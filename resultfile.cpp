@@ -0,0 +1,198 @@
+/******************************************************************************/
+/*!
+ * @file:					  resultfile.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the simulation results file.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Local includes */
+#include "resultfile.hpp"
+
+/*
+ * Fill a results file with the results of one simulate() run (one shard)
+ */
+	void
+fillResultFile
+	(
+	TResultFile 		&file,		// Out argument
+	const TSimConfig 	&config,		// Configuration of the run
+	const TSimResults &results		// Results of the run
+	)
+	{
+	memset((void *)&file, 0, sizeof(file));
+	memcpy(file.magic, RESULT_FILE_MAGIC, sizeof(file.magic));
+	file.version = RESULT_FILE_VERSION;
+	file.fileSize = sizeof(file);
+	file.rules = config.rules;
+	file.decks = config.decks;
+	file.policy = config.policy;
+	file.seats = config.seats;
+	file.seed = config.seed;
+	file.hands = config.hands;
+	file.shardsNr = (config.shardsNr > 1) ? config.shardsNr : 1;
+	file.shardsMerged = 1;
+	file.shardMap[config.shard / 8] = (uint8_t)(1 << (config.shard % 8));
+
+	file.handsPlayed = results.handsPlayed;
+	file.rounds = results.rounds;
+	file.pushes = results.pushes;
+	file.userBusts = results.userBusts;
+	file.dealerBusts = results.dealerBusts;
+	file.userWins = results.userWins;
+	file.userNaturals = results.userNaturals;
+	file.dealerWins = results.dealerWins;
+	file.errors = results.errors;
+	file.dealerPlays = results.dealerPlays;
+	file.doubles = results.doubles;
+	file.doubleWins = results.doubleWins;
+	file.doublePushes = results.doublePushes;
+	file.splits = results.splits;
+	file.splitHands = results.splitHands;
+	file.splitWins = results.splitWins;
+	file.surrenders = results.surrenders;
+	file.insurances = results.insurances;
+	file.insuranceWins = results.insuranceWins;
+	file.elapsedMicros = (uint64_t)llround(results.elapsedSecs * 1e6);
+	file.netTenths = results.netTenths;
+	file.netSquaredTenths = results.netSquaredTenths;
+	for (unsigned int i = 0; i < SIM_NET_BUCKETS; i++)
+		file.netHistogram[i] = results.netHistogram[i];
+	for (unsigned int i = 0; i < SIM_COUNT_BUCKETS; i++)
+		{
+		file.countHands[i] = results.countHands[i];
+		file.countNetTenths[i] = results.countNetTenths[i];
+		}
+	for (unsigned int i = 0; i < SIM_PAIRS_OUTCOMES; i++)
+		file.pairsOutcomes[i] = results.pairsOutcomes[i];
+	for (unsigned int i = 0; i < SIM_THREE_OUTCOMES; i++)
+		file.threeOutcomes[i] = results.threeOutcomes[i];
+	}
+
+/*
+ * Add the shards of 'from' to 'into'
+ * Integer sums and a union of shard sets only: merging is exact, commutative
+ * and associative.
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (not the same run or a shard in both files)
+ */
+	int
+mergeResultFiles
+	(
+	TResultFile 		&into,		// In/Out argument
+	const TResultFile &from			// Shards added
+	)
+	{
+	int ret = -1;   // Assume error merging
+	if ((into.rules != from.rules) || (into.decks != from.decks) ||
+			(into.policy != from.policy) || (into.seats != from.seats) ||
+			(into.seed != from.seed) || (into.hands != from.hands) ||
+			(into.shardsNr != from.shardsNr))
+		return ret;
+	for (unsigned int i = 0; i < sizeof(into.shardMap); i++)
+		if (into.shardMap[i] & from.shardMap[i])
+			return ret;
+
+	for (unsigned int i = 0; i < sizeof(into.shardMap); i++)
+		into.shardMap[i] |= from.shardMap[i];
+	into.shardsMerged += from.shardsMerged;
+	into.handsPlayed += from.handsPlayed;
+	into.rounds += from.rounds;
+	into.pushes += from.pushes;
+	into.userBusts += from.userBusts;
+	into.dealerBusts += from.dealerBusts;
+	into.userWins += from.userWins;
+	into.userNaturals += from.userNaturals;
+	into.dealerWins += from.dealerWins;
+	into.errors += from.errors;
+	into.dealerPlays += from.dealerPlays;
+	into.doubles += from.doubles;
+	into.doubleWins += from.doubleWins;
+	into.doublePushes += from.doublePushes;
+	into.splits += from.splits;
+	into.splitHands += from.splitHands;
+	into.splitWins += from.splitWins;
+	into.surrenders += from.surrenders;
+	into.insurances += from.insurances;
+	into.insuranceWins += from.insuranceWins;
+	into.elapsedMicros += from.elapsedMicros;
+	into.netTenths += from.netTenths;
+	into.netSquaredTenths += from.netSquaredTenths;
+	for (unsigned int i = 0; i < SIM_NET_BUCKETS; i++)
+		into.netHistogram[i] += from.netHistogram[i];
+	for (unsigned int i = 0; i < SIM_COUNT_BUCKETS; i++)
+		{
+		into.countHands[i] += from.countHands[i];
+		into.countNetTenths[i] += from.countNetTenths[i];
+		}
+	for (unsigned int i = 0; i < SIM_PAIRS_OUTCOMES; i++)
+		into.pairsOutcomes[i] += from.pairsOutcomes[i];
+	for (unsigned int i = 0; i < SIM_THREE_OUTCOMES; i++)
+		into.threeOutcomes[i] += from.threeOutcomes[i];
+	return 0;
+	}
+
+/*
+ * Write a results file
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (I/O error)
+ */
+	int
+writeResultFile
+	(
+	const std::string &path,		// File path
+	const TResultFile &file			// In
+	)
+	{
+	int ret = -1;   // Assume error writing
+	// Written aside and renamed so a merge never reads a partial file
+	std::string tmpPath = path + ".tmp";
+	FILE *out = fopen(tmpPath.c_str(), "wb");
+	if (!out)
+		return ret;
+	bool ok = (fwrite(&file, sizeof(file), 1, out) == 1);
+	ok = (fclose(out) == 0) && ok;
+	if (!ok || rename(tmpPath.c_str(), path.c_str()))
+		{
+		unlink(tmpPath.c_str());
+		return ret;
+		}
+	ret = 0;
+	return ret;
+	}
+
+/*
+ * Read a results file and check its header
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (I/O error, bad magic, version or size)
+ */
+	int
+readResultFile
+	(
+	const std::string &path,		// File path
+	TResultFile 		&file			// Out argument
+	)
+	{
+	int ret = -1;   // Assume error reading
+	FILE *in = fopen(path.c_str(), "rb");
+	if (!in)
+		return ret;
+	bool ok = (fread(&file, sizeof(file), 1, in) == 1) && (fgetc(in) == EOF);
+	fclose(in);
+	if (!ok || memcmp(file.magic, RESULT_FILE_MAGIC, sizeof(file.magic)) ||
+			(file.version != RESULT_FILE_VERSION) || (file.fileSize != sizeof(file)) ||
+			!file.shardsNr || (file.shardsNr > SIM_MAX_SHARDS) ||
+			(file.shardsMerged > file.shardsNr))
+		return ret;
+	ret = 0;
+	return ret;
+	}
@@ -0,0 +1,108 @@
+/******************************************************************************/
+/*!
+ * @file:					  resultfile.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the simulation results file.
+ *  					A versioned binary file of the results of one or more
+ *  					shards of a run (see TSimConfig::shardsNr). Every result
+ *  					is an integer, so merging shard files is exact and gives
+ *  					the same file whatever the merge order.
+ *
+ *  File layout (host byte order): one TResultFile.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __RESULTFILE_HPP__
+#define __RESULTFILE_HPP__
+
+/* Library includes */
+#include <stdint.h>
+#include <string>
+
+/* Local includes */
+#include "simulator.hpp"
+
+/* Defines */
+
+#define RESULT_FILE_MAGIC		"BJRESULT"
+#define RESULT_FILE_VERSION	2
+
+/* Enumerations, type defines */
+
+/* Results file */
+typedef struct __ResultFile__
+	{
+	char magic[8];				// RESULT_FILE_MAGIC, no terminator
+	uint32_t version;			// RESULT_FILE_VERSION
+	uint32_t fileSize;		// sizeof(TResultFile)
+	// Run, the same in every shard file of the run
+	uint32_t rules;			// TSimRules flags
+	uint32_t decks;
+	uint32_t policy;			// TSimPolicy
+	uint32_t seats;			// 0, one player engine
+	uint64_t seed;				// Run seed, before the shard streams
+	uint64_t hands;			// Hands (table rounds) of the whole run
+	uint32_t shardsNr;		// Shards the run is split in
+	uint32_t shardsMerged;	// Shards in this file
+	uint8_t shardMap[SIM_MAX_SHARDS / 8];	// Bit set per shard in this file
+	// Results, added up on merge (see TSimResults)
+	uint64_t handsPlayed;
+	uint64_t rounds;
+	uint64_t pushes;
+	uint64_t userBusts;
+	uint64_t dealerBusts;
+	uint64_t userWins;
+	uint64_t userNaturals;
+	uint64_t dealerWins;
+	uint64_t errors;
+	uint64_t dealerPlays;
+	uint64_t doubles;
+	uint64_t doubleWins;
+	uint64_t doublePushes;
+	uint64_t splits;
+	uint64_t splitHands;
+	uint64_t splitWins;
+	uint64_t surrenders;
+	uint64_t insurances;
+	uint64_t insuranceWins;
+	uint64_t elapsedMicros;	// Time playing, every shard added up
+	int64_t netTenths;
+	uint64_t netSquaredTenths;
+	uint64_t netHistogram[SIM_NET_BUCKETS];
+	uint64_t countHands[SIM_COUNT_BUCKETS];
+	int64_t countNetTenths[SIM_COUNT_BUCKETS];
+	uint64_t pairsOutcomes[SIM_PAIRS_OUTCOMES];	// Side bets, since version 2
+	uint64_t threeOutcomes[SIM_THREE_OUTCOMES];
+	}TResultFile;
+
+/*
+ * Fill a results file with the results of one simulate() run (one shard)
+ */
+void fillResultFile (TResultFile &file, const TSimConfig &config,
+		const TSimResults &results);
+
+/*
+ * Add the shards of 'from' to 'into'
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (not the same run or a shard in both files)
+ */
+int mergeResultFiles (TResultFile &into, const TResultFile &from);
+
+/*
+ * Write a results file
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (I/O error)
+ */
+int writeResultFile (const std::string &path, const TResultFile &file);
+
+/*
+ * Read a results file and check its header
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (I/O error, bad magic, version or size)
+ */
+int readResultFile (const std::string &path, TResultFile &file);
+
+#endif /* __RESULTFILE_HPP__ */
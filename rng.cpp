@@ -0,0 +1,220 @@
+/******************************************************************************/
+/*!
+ * @file:					  rng.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the batch random number generator.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <string.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define RNG_HAS_AVX2
+#endif
+
+/* Local includes */
+#include "misc.hpp"
+#include "rng.hpp"
+
+/* Private defines */
+// Lane steps per refill, two 32 bit values per 64 bit output
+#define RNG_STEPS		(RNG_BATCH_WORDS / 2 / RNG_LANES)
+
+static inline uint64_t rotl(uint64_t x, int k)
+	{
+	return (x << k) | (x >> (64 - k));
+	}
+
+/*
+ * Refill with scalar code: the lanes one after the other, each output stored
+ * where the AVX2 refill stores it
+ */
+	static void
+refillScalar
+	(
+	uint64_t state[4][RNG_LANES],		// Lanes state, in and out
+	uint32_t *buffer						// RNG_BATCH_WORDS values, out argument
+	)
+	{
+	for (unsigned int lane = 0; lane < RNG_LANES; lane++)
+		{
+		uint64_t s0 = state[0][lane], s1 = state[1][lane];
+		uint64_t s2 = state[2][lane], s3 = state[3][lane];
+		for (unsigned int step = 0; step < RNG_STEPS; step++)
+			{
+			uint64_t result = rotl(s1 * 5, 7) * 9;
+			unsigned int pos = 2 * (step * RNG_LANES + lane);
+			buffer[pos] = (uint32_t)result;
+			buffer[pos + 1] = (uint32_t)(result >> 32);
+			uint64_t t = s1 << 17;
+			s2 ^= s0;
+			s3 ^= s1;
+			s1 ^= s2;
+			s0 ^= s3;
+			s2 ^= t;
+			s3 = rotl(s3, 45);
+			}
+		state[0][lane] = s0;
+		state[1][lane] = s1;
+		state[2][lane] = s2;
+		state[3][lane] = s3;
+		}
+	}
+
+#ifdef RNG_HAS_AVX2
+/*
+ * Refill with AVX2: the four lanes stepped at once. AVX2 has no 64 bit
+ * multiply, times 5 and times 9 are a shift and an add
+ */
+	__attribute__((target("avx2"))) static void
+refillAvx2
+	(
+	uint64_t state[4][RNG_LANES],		// Lanes state, in and out
+	uint32_t *buffer						// RNG_BATCH_WORDS values, out argument
+	)
+	{
+	__m256i s0 = _mm256_loadu_si256((const __m256i *)state[0]);
+	__m256i s1 = _mm256_loadu_si256((const __m256i *)state[1]);
+	__m256i s2 = _mm256_loadu_si256((const __m256i *)state[2]);
+	__m256i s3 = _mm256_loadu_si256((const __m256i *)state[3]);
+	__m256i *out = (__m256i *)buffer;
+	for (unsigned int step = 0; step < RNG_STEPS; step++)
+		{
+		__m256i five = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+		__m256i rot = _mm256_or_si256(_mm256_slli_epi64(five, 7), _mm256_srli_epi64(five, 57));
+		_mm256_storeu_si256(out + step, _mm256_add_epi64(_mm256_slli_epi64(rot, 3), rot));
+		__m256i t = _mm256_slli_epi64(s1, 17);
+		s2 = _mm256_xor_si256(s2, s0);
+		s3 = _mm256_xor_si256(s3, s1);
+		s1 = _mm256_xor_si256(s1, s2);
+		s0 = _mm256_xor_si256(s0, s3);
+		s2 = _mm256_xor_si256(s2, t);
+		s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 19));
+		}
+	_mm256_storeu_si256((__m256i *)state[0], s0);
+	_mm256_storeu_si256((__m256i *)state[1], s1);
+	_mm256_storeu_si256((__m256i *)state[2], s2);
+	_mm256_storeu_si256((__m256i *)state[3], s3);
+	}
+#endif
+
+TBatchRng::TBatchRng
+	(
+	unsigned long long seed		// Lanes seed
+	) :
+	mPos(RNG_BATCH_WORDS),
+	mSimd(hasSimd())
+	{
+	this->seed(seed);
+	}
+
+/*
+ * Restart the lanes from a seed: each state word of each lane is a
+ * SplitMix64 output, never all zero
+ */
+	void
+TBatchRng::seed
+	(
+	unsigned long long seed		// Lanes seed
+	)
+	{
+	for (unsigned int word = 0; word < 4; word++)
+		for (unsigned int lane = 0; lane < RNG_LANES; lane++)
+			mState[word][lane] = mixSeed(seed, lane * 4 + word);
+	mPos = RNG_BATCH_WORDS;
+	}
+
+/*
+ * Restart the lanes from entropy words: each state word of each lane is the
+ * SplitMix64 output of one of them, on a stream of its own
+ */
+	void
+TBatchRng::seed
+	(
+	const uint64_t *entropy,		// Entropy words
+	unsigned int 	wordsNr			// Entropy words, not 0
+	)
+	{
+	for (unsigned int word = 0; word < 4; word++)
+		for (unsigned int lane = 0; lane < RNG_LANES; lane++)
+			mState[word][lane] = mixSeed(entropy[(lane * 4 + word) % wordsNr], lane * 4 + word);
+	mPos = RNG_BATCH_WORDS;
+	}
+
+/*
+ * The CPU has AVX2
+ * @return: - True - AVX2 refills available
+ */
+	bool
+TBatchRng::hasSimd
+	(
+	void
+	)
+	{
+#ifdef RNG_HAS_AVX2
+	static const bool avx2 = __builtin_cpu_supports("avx2");
+	return avx2;
+#else
+	return false;
+#endif
+	}
+
+/*
+ * Step the lanes with AVX2 or scalar code
+ * @return: - True - AVX2 refills
+ */
+	bool
+TBatchRng::useSimd
+	(
+	bool simd		// AVX2 if the CPU has it
+	)
+	{
+	mSimd = simd && hasSimd();
+	return mSimd;
+	}
+
+/*
+ * Refill the buffer with the next step of every lane
+ */
+	void
+TBatchRng::refill
+	(
+	void
+	)
+	{
+#ifdef RNG_HAS_AVX2
+	if (mSimd)
+		refillAvx2(mState, mBuffer);
+	else
+#endif
+		refillScalar(mState, mBuffer);
+	mPos = 0;
+	}
+
+/*
+ * Next uniform 32 bit values, a buffer at a time
+ */
+	void
+TBatchRng::fill
+	(
+	uint32_t 		*words,		// Out argument
+	unsigned int 	wordsNr		// Values to fill
+	)
+	{
+	while (wordsNr)
+		{
+		if (mPos == RNG_BATCH_WORDS)
+			refill();
+		unsigned int copied = RNG_BATCH_WORDS - mPos;
+		if (copied > wordsNr)
+			copied = wordsNr;
+		memcpy((void *)words, (const void *)(mBuffer + mPos), copied * sizeof(*words));
+		mPos += copied;
+		words += copied;
+		wordsNr -= copied;
+		}
+	}
@@ -0,0 +1,103 @@
+/******************************************************************************/
+/*!
+ * @file:					  rng.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the batch random number
+ *  					generator the dealer shuffles and draws with.
+ *
+ *  Four xoshiro256** streams (lanes) are stepped together and their outputs
+ *  interleaved into a buffer, refilled in one go when used up: with AVX2, a
+ *  step of the four lanes is a handful of 256 bit instructions. The scalar
+ *  refill produces the very same values, so seeded shoes do not depend on the
+ *  CPU. Bounded draws use Lemire's multiply and shift, a division only on the
+ *  rare rejection path.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __RNG_HPP__
+#define __RNG_HPP__
+
+/* Library includes */
+#include <stdint.h>
+
+/* Defines */
+
+// Generator lanes, one 64 bit AVX2 element each
+#define RNG_LANES				4
+// 32 bit values per refill
+#define RNG_BATCH_WORDS		512
+// 64 bit entropy words a generator is seeded with, 256 bits
+#define RNG_ENTROPY_WORDS	4
+
+/* Enumerations, type defines */
+
+/*
+ * Batch random number generator
+ * One per dealer, so every worker thread draws from a buffer of its own.
+ */
+class TBatchRng
+	{
+	public:
+		TBatchRng(unsigned long long seed = 0);
+		// Restart the lanes from 'seed'. Same seed, same values
+		void seed(unsigned long long seed);
+		// Restart the lanes from 'wordsNr' entropy words, spread over every lane
+		void seed(const uint64_t *entropy, unsigned int wordsNr);
+		/*
+		 * Step the lanes with AVX2 if the CPU has it (default) or with scalar
+		 * code, for benchmarks. Values do not change.
+		 * @return: - True - AVX2 refills
+		 */
+		bool useSimd(bool simd);
+		// The CPU has AVX2
+		static bool hasSimd(void);
+
+		// Next uniform 32 bit value
+		uint32_t next(void)
+			{
+			if (mPos == RNG_BATCH_WORDS)
+				refill();
+			return mBuffer[mPos++];
+			};
+		// Uniform in [0, range), range not 0. Lemire's method: unbiased, no
+		// division unless the draw lands in the rejection zone
+		uint32_t bounded(uint32_t range)
+			{
+			uint64_t m = (uint64_t)next() * range;
+			uint32_t low = (uint32_t)m;
+			if (low < range)
+				{
+				uint32_t threshold = (uint32_t)-range % range;
+				while (low < threshold)
+					{
+					m = (uint64_t)next() * range;
+					low = (uint32_t)m;
+					}
+				}
+			return (uint32_t)(m >> 32);
+			};
+		// Uniform in [0, 1), 53 bits
+		double uniform(void)
+			{
+			uint64_t high = (uint64_t)next() << 21;
+			return (double)(high | (next() >> 11)) * (1.0 / 9007199254740992.0);
+			};
+		// Next 'wordsNr' uniform 32 bit values, copied a buffer at a time
+		void fill(uint32_t *words, unsigned int wordsNr);
+
+	private:
+		void refill(void);
+
+	private:
+		// Unaligned loads and stores: dealers are allocated by containers and
+		// new, which do not align beyond max_align_t before C++17
+		uint64_t mState[4][RNG_LANES];	// Xoshiro256** state word, per lane
+		uint32_t mBuffer[RNG_BATCH_WORDS];
+		unsigned int mPos;			// Next value of the buffer
+		bool mSimd;
+	};
+
+#endif /* __RNG_HPP__ */
@@ -0,0 +1,96 @@
+/******************************************************************************/
+/*!
+ * @file:					  rules.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Compile time house rule sets. Every rule variant is its
+ *  					own type so engines specialized on it carry no rule
+ *  					branches at run time.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __RULES_HPP__
+#define __RULES_HPP__
+
+/* Enumerations, type defines */
+
+/*
+ * Rule variant flags. A rule set is the OR of its flags, zero being the
+ * virtual blackjack house rules (dealer hits soft 17, dealer wins ties and
+ * naturals pay 3:2).
+ */
+typedef enum __RuleFlags__
+	{
+	RULES_HOUSE				= 0,
+	RULES_STAND_SOFT_17	= 1 << 0,	// Dealer stands on soft 17 (S17)
+	RULES_PUSH_TIES		= 1 << 1,	// Equal scores are a push instead of a dealer win
+	RULES_PAY_6_5			= 1 << 2,	// Naturals pay 6:5 instead of 3:2
+	RULES_VARIANTS_NR		= 1 << 3	// Number of rule sets
+	}TRuleFlags;
+
+/*
+ * Rule set for the argued flags
+ * */
+template <unsigned int Flags>
+struct TRuleSet
+	{
+	static const unsigned int FLAGS = Flags;
+	static const unsigned int BLACKJACK_VAL = 21;
+	// Dealer stands on this score or higher (see HIT_SOFT_17)
+	static const unsigned int DEALER_HIT_LIMIT = 17;
+	// Dealer hits a soft DEALER_HIT_LIMIT
+	static const bool HIT_SOFT_17 = !(Flags & RULES_STAND_SOFT_17);
+	// Equal scores are a push. Otherwise the dealer wins ties
+	static const bool PUSH_ON_TIE = (Flags & RULES_PUSH_TIES) != 0;
+	// Natural payout, NATURAL_PAY_NUM to NATURAL_PAY_DEN
+	static const unsigned int NATURAL_PAY_NUM = (Flags & RULES_PAY_6_5) ? 6 : 3;
+	static const unsigned int NATURAL_PAY_DEN = (Flags & RULES_PAY_6_5) ? 5 : 2;
+	// Hands a player can split up to. Split Aces take one card each and are
+	// not split again
+	static const unsigned int MAX_SPLIT_HANDS = 4;
+	// Doubling down is allowed on any first two cards, split hands included
+	static const bool DOUBLE_AFTER_SPLIT = true;
+	// Half the bet can be surrendered on the first two cards, once the dealer
+	// has checked for a two card 21 (late surrender)
+	static const bool LATE_SURRENDER = true;
+	// Insurance (half the bet, offered on an Ace up card) pays this to 1 when
+	// the hole card makes a two card 21
+	static const unsigned int INSURANCE_PAY = 2;
+	};
+
+/* Virtual blackjack house rules */
+typedef TRuleSet<RULES_HOUSE> TRulesHouse;
+
+/*
+ * Call visitor.run<TRules>() with the rule set matching the argued flags.
+ * Used once at start up so every hand after it runs a specialized engine.
+ * @return: - Visitor return value. Otherwise,
+ * 			-1 - Unknown rule set
+ */
+template <typename TVisitor>
+	int
+dispatchRules
+	(
+	unsigned int flags,			// TRuleFlags combination
+	TVisitor &visitor				// Functor with a template<typename TRules> int run()
+	)
+	{
+	switch (flags)
+		{
+		case 0: return visitor.template run< TRuleSet<0> >();
+		case 1: return visitor.template run< TRuleSet<1> >();
+		case 2: return visitor.template run< TRuleSet<2> >();
+		case 3: return visitor.template run< TRuleSet<3> >();
+		case 4: return visitor.template run< TRuleSet<4> >();
+		case 5: return visitor.template run< TRuleSet<5> >();
+		case 6: return visitor.template run< TRuleSet<6> >();
+		case 7: return visitor.template run< TRuleSet<7> >();
+		default:
+			break;
+		}
+	return -1;
+	}
+
+#endif /* __RULES_HPP__ */
@@ -0,0 +1,315 @@
+/******************************************************************************/
+/*!
+ * @file:					  shoefile.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the shoe corpus file reader and writer.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+/* Local includes */
+#include "misc.hpp"
+#include "shoefile.hpp"
+
+/* Private defines */
+#define FACE_MIN_RANK		11		// Jacks, Queens and Kings
+#define FNV_OFFSET			2166136261U
+#define FNV_PRIME				16777619U
+#define SHOE_MAX_DECKS		8
+
+/*
+ * FNV-1a hash of a shoe's card codes
+ * @return: Hash
+ */
+	static uint32_t
+shoeChecksum
+	(
+	const unsigned char 	*codes,		// Card codes
+	unsigned int 			cardsNr		// Cards
+	)
+	{
+	uint32_t h = FNV_OFFSET;
+	for (unsigned int i = 0; i < cardsNr; i++)
+		{
+		h ^= codes[i];
+		h *= FNV_PRIME;
+		}
+	return h;
+	}
+
+TShoeFile::TShoeFile
+	(
+	void
+	) :
+	mMap(NULL),
+	mSize(0),
+	mHeader(NULL),
+	mIndex(NULL)
+	{
+	for (unsigned int rank = 1; rank <= TDealer::RANKS_NR; rank++)
+		for (unsigned int suit = 0; suit < SUITS_NR; suit++)
+			{
+			TCard &card = mCards[(rank - 1) * SUITS_NR + suit];
+			card.isFace = (rank >= FACE_MIN_RANK);
+			card.value = card.isFace ? TDealer::VALUES_NR : rank;
+			card.rank = rank;
+			card.suit = suit;
+			}
+	}
+
+TShoeFile::~TShoeFile
+	(
+	void
+	)
+	{
+	close();
+	}
+
+/*
+ * Map a shoe file and check its header and index
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (cannot map, bad magic, version or layout)
+ */
+	int
+TShoeFile::open
+	(
+	const std::string &path		// Shoe file path
+	)
+	{
+	int ret = -1;   // Assume the file cannot be used
+	close();
+
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return ret;
+	struct stat st;
+	if (fstat(fd, &st) || ((size_t)st.st_size < sizeof(TShoeFileHeader)))
+		{
+		::close(fd);
+		return ret;
+		}
+	void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	// The mapping holds its own reference to the file
+	::close(fd);
+	if (map == MAP_FAILED)
+		return ret;
+	mMap = (const unsigned char *)map;
+	mSize = (size_t)st.st_size;
+
+	const TShoeFileHeader *header = (const TShoeFileHeader *)mMap;
+	uint64_t shoesSize = header->shoesNr * header->cardsPerShoe;
+	if (memcmp(header->magic, SHOE_FILE_MAGIC, sizeof(header->magic)) ||
+			(header->version != SHOE_FILE_VERSION) ||
+			(header->headerSize != sizeof(TShoeFileHeader)) ||
+			(header->entrySize != sizeof(TShoeIndexEntry)) ||
+			(header->fileSize != mSize) || !header->decks ||
+			(header->cardsPerShoe != header->decks * TDealer::CARDS_PER_DECK) ||
+			!header->shoesNr || (header->cardsOffset % SHOE_FILE_ALIGN) ||
+			(header->shoesNr > (mSize - sizeof(TShoeFileHeader)) / sizeof(TShoeIndexEntry)) ||
+			(header->cardsOffset < sizeof(TShoeFileHeader) + header->shoesNr *
+					sizeof(TShoeIndexEntry)) || (header->cardsOffset > mSize) ||
+			(shoesSize / header->cardsPerShoe != header->shoesNr) ||
+			(shoesSize > mSize - header->cardsOffset))
+		{
+		close();
+		return ret;
+		}
+
+	const TShoeIndexEntry *index = (const TShoeIndexEntry *)(mMap + sizeof(TShoeFileHeader));
+	for (uint64_t i = 0; i < header->shoesNr; i++)
+		if ((index[i].cards != header->cardsPerShoe) || (index[i].offset < header->cardsOffset) ||
+				(index[i].offset > mSize - index[i].cards))
+			{
+			close();
+			return ret;
+			}
+
+	// Dealers walk the shoes in order: read ahead aggressively, drop pages behind
+	madvise(map, mSize, MADV_SEQUENTIAL);
+	mHeader = header;
+	mIndex = index;
+	ret = 0;
+	return ret;
+	}
+
+/*
+ * Unmap the file. Shoes returned before are no longer valid.
+ */
+	void
+TShoeFile::close
+	(
+	void
+	)
+	{
+	if (mMap)
+		munmap((void *)mMap, mSize);
+	mMap = NULL;
+	mSize = 0;
+	mHeader = NULL;
+	mIndex = NULL;
+	}
+
+/*
+ * Check every shoe against its index checksum and card codes
+ * @return: - 0 - Every shoe intact. Otherwise,
+ * 			Error (file not open or a shoe corrupted)
+ */
+	int
+TShoeFile::verify
+	(
+	void
+	) const
+	{
+	int ret = -1;   // Assume a shoe is corrupted
+	if (!mHeader)
+		return ret;
+	for (uint64_t i = 0; i < mHeader->shoesNr; i++)
+		{
+		const unsigned char *codes = mMap + mIndex[i].offset;
+		unsigned int counts[TDealer::CARDS_PER_DECK];
+		memset((void *)counts, 0, sizeof(counts));
+		for (unsigned int c = 0; c < mIndex[i].cards; c++)
+			{
+			if (codes[c] >= TDealer::CARDS_PER_DECK)
+				return ret;
+			counts[codes[c]]++;
+			}
+		// Every card of every deck, once
+		for (unsigned int code = 0; code < TDealer::CARDS_PER_DECK; code++)
+			if (counts[code] != mHeader->decks)
+				return ret;
+		if (shoeChecksum(codes, mIndex[i].cards) != mIndex[i].checksum)
+			return ret;
+		}
+	ret = 0;
+	return ret;
+	}
+
+/*
+ * Check the codes of a range of shoes are card codes
+ * @return: - 0 - Every code valid. Otherwise,
+ * 			Error (file not open, no such shoes or a code out of range)
+ */
+	int
+TShoeFile::checkCodes
+	(
+	unsigned long long first,		// First shoe checked
+	unsigned long long count		// Shoes checked
+	) const
+	{
+	int ret = -1;   // Assume a code is out of range
+	if (!mHeader || (first > mHeader->shoesNr) || (count > mHeader->shoesNr - first))
+		return ret;
+	for (uint64_t i = first; i < first + count; i++)
+		{
+		const unsigned char *codes = mMap + mIndex[i].offset;
+		// Branch free over the shoe, one test per shoe
+		unsigned char highest = 0;
+		for (unsigned int c = 0; c < mIndex[i].cards; c++)
+			highest = (codes[c] > highest) ? codes[c] : highest;
+		if (highest >= TDealer::CARDS_PER_DECK)
+			return ret;
+		}
+	ret = 0;
+	return ret;
+	}
+
+/*
+ * Hash of the index checksums, one number naming the whole corpus
+ * @return: Digest, 0 if the file is not open
+ */
+	uint64_t
+TShoeFile::getDigest
+	(
+	void
+	) const
+	{
+	if (!mHeader)
+		return 0;
+	uint64_t h = mixSeed(mHeader->seed, mHeader->shoesNr);
+	for (uint64_t i = 0; i < mHeader->shoesNr; i++)
+		h = mixSeed(h, mIndex[i].checksum);
+	return h;
+	}
+
+/*
+ * Write the first 'shoesNr' shoes a seeded dealer shuffles as a shoe file
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid arguments or I/O error)
+ */
+	int
+writeShoeFile
+	(
+	const std::string 	&path,		// Shoe file path
+	unsigned long long 	seed,			// Dealer seed
+	unsigned int 			decks,		// Decks per shoe
+	unsigned long long 	shoesNr		// Shoes to write
+	)
+	{
+	int ret = -1;   // Assume error writing the file
+	if (!decks || (decks > SHOE_MAX_DECKS) || !shoesNr)
+		return ret;
+
+	TShoeFileHeader header;
+	memset((void *)&header, 0, sizeof(header));
+	memcpy(header.magic, SHOE_FILE_MAGIC, sizeof(header.magic));
+	header.version = SHOE_FILE_VERSION;
+	header.headerSize = sizeof(TShoeFileHeader);
+	header.entrySize = sizeof(TShoeIndexEntry);
+	header.decks = decks;
+	header.cardsPerShoe = decks * TDealer::CARDS_PER_DECK;
+	header.shoesNr = shoesNr;
+	header.seed = seed;
+	uint64_t indexEnd = sizeof(header) + shoesNr * sizeof(TShoeIndexEntry);
+	header.cardsOffset = (indexEnd + SHOE_FILE_ALIGN - 1) / SHOE_FILE_ALIGN * SHOE_FILE_ALIGN;
+	header.fileSize = header.cardsOffset + shoesNr * header.cardsPerShoe;
+
+	// Written aside and renamed so readers never map a partial file
+	std::string tmpPath = path + ".tmp";
+	FILE *file = fopen(tmpPath.c_str(), "wb");
+	if (!file)
+		return ret;
+
+	// Shoes first, the index of their checksums once they are all written
+	std::vector<TShoeIndexEntry> index(shoesNr);
+	std::vector<unsigned char> codes(header.cardsPerShoe);
+	TDealer dealer(seed, decks);
+	TCards shoe;
+	bool ok = (fseek(file, (long)header.cardsOffset, SEEK_SET) == 0);
+	for (uint64_t i = 0; ok && (i < shoesNr); i++)
+		{
+		dealer.shuffle(shoe);
+		for (unsigned int c = 0; c < shoe.size(); c++)
+			codes[c] = (shoe[c].rank - 1) * SUITS_NR + shoe[c].suit;
+		index[i].offset = header.cardsOffset + i * header.cardsPerShoe;
+		index[i].cards = header.cardsPerShoe;
+		index[i].checksum = shoeChecksum(codes.data(), header.cardsPerShoe);
+		ok = (fwrite(codes.data(), 1, codes.size(), file) == codes.size());
+		}
+	std::vector<unsigned char> padding(header.cardsOffset - indexEnd, 0);
+	ok = ok && (fseek(file, 0, SEEK_SET) == 0) &&
+			(fwrite(&header, sizeof(header), 1, file) == 1) &&
+			(fwrite(index.data(), sizeof(TShoeIndexEntry), index.size(), file) == index.size()) &&
+			(padding.empty() || (fwrite(padding.data(), 1, padding.size(), file) ==
+					padding.size()));
+	ok = (fclose(file) == 0) && ok;
+	if (!ok || rename(tmpPath.c_str(), path.c_str()))
+		{
+		unlink(tmpPath.c_str());
+		return ret;
+		}
+
+	ret = 0;
+	return ret;
+	}
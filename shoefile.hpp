@@ -0,0 +1,139 @@
+/******************************************************************************/
+/*!
+ * @file:					  shoefile.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the shoe corpus file. A
+ *  					versioned binary file of shuffled shoes, one byte per
+ *  					card, written once by blackjack-shoegen and memory mapped
+ *  					read only by dealers that deal from it instead of
+ *  					shuffling (see TDealer::setShoeFile()), so runs of
+ *  					different engines and policies on the same corpus deal the
+ *  					very same shoes with no generator work at all.
+ *
+ *  File layout (host byte order):
+ *  	TShoeFileHeader
+ *  	TShoeIndexEntry[shoesNr]		Index, one entry per shoe
+ *  	Cards, SHOE_FILE_ALIGN aligned	shoesNr shoes of cardsPerShoe card codes
+ *
+ *  A card code is (rank - 1) * SUITS_NR + suit, 0 to CARDS_PER_DECK - 1.
+ *  Shoes are stored in the order the dealer holds them: the last card is the
+ *  first dealt.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __SHOEFILE_HPP__
+#define __SHOEFILE_HPP__
+
+/* Library includes */
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+/* Local includes */
+#include "dealer.hpp"
+
+/* Defines */
+
+#define SHOE_FILE_MAGIC			"BJCORPUS"
+#define SHOE_FILE_VERSION		1
+#define SHOE_FILE_ALIGN			4096
+
+/* Enumerations, type defines */
+
+/* File header */
+typedef struct __ShoeFileHeader__
+	{
+	char magic[8];				// SHOE_FILE_MAGIC, no terminator
+	uint32_t version;			// SHOE_FILE_VERSION
+	uint32_t headerSize;		// sizeof(TShoeFileHeader)
+	uint32_t entrySize;		// sizeof(TShoeIndexEntry)
+	uint32_t decks;			// Decks per shoe
+	uint32_t cardsPerShoe;
+	uint32_t reserved;
+	uint64_t shoesNr;
+	uint64_t seed;				// Seed of the dealer that shuffled the shoes
+	uint64_t cardsOffset;	// Offset of the first shoe from the start of the file
+	uint64_t fileSize;
+	}TShoeFileHeader;
+
+/* Index entry */
+typedef struct __ShoeIndexEntry__
+	{
+	uint64_t offset;			// Shoe offset from the start of the file
+	uint32_t cards;			// Cards in the shoe
+	uint32_t checksum;		// FNV-1a hash of the shoe card codes
+	}TShoeIndexEntry;
+
+/*
+ * The shoe file class
+ * Read only memory mapping of a shoe corpus, read ahead as dealers walk it.
+ * Shoes returned point into the mapping, valid until the file is closed.
+ * */
+class TShoeFile
+	{
+	public:
+		TShoeFile(void);
+		~TShoeFile(void);
+		/*
+		 * Map a shoe file and check its header and index
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (cannot map, bad magic, version or layout)
+		 */
+		int open(const std::string &path);
+		void close(void);
+		/*
+		 * Check every shoe against its index checksum and card codes
+		 * @return: - 0 - Every shoe intact. Otherwise,
+		 * 			Error (file not open or a shoe corrupted)
+		 */
+		int verify(void) const;
+		/*
+		 * Check the codes of shoes 'first' to 'first + count - 1' are card codes,
+		 * the only check getCard() needs (verify() checks the whole corpus)
+		 * @return: - 0 - Every code valid. Otherwise,
+		 * 			Error (file not open, no such shoes or a code out of range)
+		 */
+		int checkCodes(unsigned long long first, unsigned long long count) const;
+		/*
+		 * Card codes of a shoe, getCardsPerShoe() of them
+		 * @return: Card codes or NULL if the file has no such shoe
+		 */
+		const unsigned char *getShoe(unsigned long long shoe) const
+			{
+			return (mHeader && (shoe < mHeader->shoesNr)) ? mMap + mIndex[shoe].offset : NULL;
+			};
+		// Card of a card code
+		const TCard &getCard(unsigned char code) const {return mCards[code];};
+		unsigned long long getShoesNr(void) const {return mHeader ? mHeader->shoesNr : 0;};
+		unsigned int getDecks(void) const {return mHeader ? mHeader->decks : 0;};
+		unsigned int getCardsPerShoe(void) const {return mHeader ? mHeader->cardsPerShoe : 0;};
+		unsigned long long getSeed(void) const {return mHeader ? mHeader->seed : 0;};
+		// Hash of the index checksums, one number naming the whole corpus
+		uint64_t getDigest(void) const;
+
+	private:
+		TShoeFile(const TShoeFile &);
+		TShoeFile &operator=(const TShoeFile &);
+
+	private:
+		const unsigned char *mMap;
+		size_t mSize;
+		const TShoeFileHeader *mHeader;
+		const TShoeIndexEntry *mIndex;
+		TCard mCards[TDealer::CARDS_PER_DECK];	// Card per card code
+	};
+
+/*
+ * Write the first 'shoesNr' shoes a dealer of 'decks' decks seeded with 'seed'
+ * shuffles as a shoe file. A corpus of seed S deals the shoes a seeded run of
+ * seed S would.
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid arguments or I/O error)
+ */
+int writeShoeFile (const std::string &path, unsigned long long seed, unsigned int decks,
+		unsigned long long shoesNr);
+
+#endif /* __SHOEFILE_HPP__ */
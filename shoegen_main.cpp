@@ -0,0 +1,222 @@
+/******************************************************************************/
+/*!
+ * @file:					  shoegen_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-shoegen. Writes a shoe corpus file, checks one
+ *  					and times the simulator dealing from it against shuffling
+ *  					the same shoes.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "misc.hpp"
+#include "shoefile.hpp"
+#include "simulator.hpp"
+#include "strategy.hpp"
+
+/* Library includes */
+#include <chrono>
+#include <getopt.h>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+/* Private defines */
+#define SHOEGEN_DEFAULT_SHOES		100000ULL
+#define SHOEGEN_DEFAULT_DECKS		6
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":ho:n:d:S:v:b:P:";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "output",   		required_argument,   NULL,    'o'   },
+   { "shoes",   		required_argument,   NULL,    'n'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "seed",   		required_argument,   NULL,    'S'   },
+   { "verify",  		required_argument,   NULL,    'v'   },
+   { "bench",  		required_argument,   NULL,    'b'   },
+   { "policy",   		required_argument,   NULL,    'P'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-shoegen: Shoe corpus files, the shuffled shoes of a seeded dealer" << std::endl;
+   std::cout << "stored one byte per card, dealt by 'blackjack-sim --shoes FILE' instead of" << std::endl;
+   std::cout << "shuffling" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -o, --output FILE" << std::endl;
+   std::cout << "      Write a corpus." << std::endl;
+   std::cout << "   -n, --shoes N, -d, --decks N, -S, --seed SEED" << std::endl;
+   std::cout << "      Shoes (default " << SHOEGEN_DEFAULT_SHOES << "), decks per shoe (default "
+         << SHOEGEN_DEFAULT_DECKS << ") and dealer seed" << std::endl;
+   std::cout << "      (default 1) of the corpus written." << std::endl;
+   std::cout << "   -v, --verify FILE" << std::endl;
+   std::cout << "      Check every shoe of a corpus and print its digest." << std::endl;
+   std::cout << "   -b, --bench HANDS" << std::endl;
+   std::cout << "      Simulate HANDS hands dealing the corpus and shuffling from its seed," << std::endl;
+   std::cout << "      print both speeds and whether the results are the same." << std::endl;
+   std::cout << "   -P, --policy NAME" << std::endl;
+   std::cout << "      Policy of the benchmark (default basic)." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Simulate the same hands shuffling and dealing the corpus
+ * @return: - 0 - Same results. Otherwise,
+ * 			Error or results differ
+ */
+	static int
+bench
+	(
+	const std::string 	&path,		// Corpus file
+	const TShoeFile 		&shoes,		// Open corpus
+	unsigned long long 	hands,		// Hands to play
+	unsigned int 			policy		// TSimPolicy
+	)
+	{
+	TSimConfig config;
+	TSimResults shuffled, dealt;
+	simInitConfig(&config);
+	config.decks = shoes.getDecks();
+	config.seed = shoes.getSeed();
+	config.policy = policy;
+	config.hands = hands;
+	if (simulate(&config, &shuffled))
+		{
+		log(LOG_ERR, "Simulation failed\n");
+		return -1;
+		}
+	config.shoesPath = path.c_str();
+	if (simulate(&config, &dealt))
+		{
+		log(LOG_ERR, "Simulation off the corpus failed\n");
+		return -1;
+		}
+	bool same = (shuffled.handsPlayed == dealt.handsPlayed) &&
+			(shuffled.netTenths == dealt.netTenths) &&
+			(shuffled.netSquaredTenths == dealt.netSquaredTenths) &&
+			(shuffled.userWins == dealt.userWins) && (shuffled.pushes == dealt.pushes);
+	printf("Shuffled: %llu hands in %.3f s (%.0f hands/s), EV %+.6f\n", shuffled.handsPlayed,
+			shuffled.elapsedSecs, (double)shuffled.handsPlayed / shuffled.elapsedSecs,
+			(double)shuffled.netTenths / 10.0 / (double)shuffled.handsPlayed);
+	printf("Corpus:   %llu hands in %.3f s (%.0f hands/s), EV %+.6f\n", dealt.handsPlayed,
+			dealt.elapsedSecs, (double)dealt.handsPlayed / dealt.elapsedSecs,
+			(double)dealt.netTenths / 10.0 / (double)dealt.handsPlayed);
+	printf("Speed up %.2fx, results %s\n", shuffled.elapsedSecs / dealt.elapsedSecs,
+			same ? "the same" : "DIFFER (more hands than the corpus shoes?)");
+	return same ? 0 : 1;
+	}
+
+/* Top level and binary entry point for the shoe corpus tool
+ * @return: 0 - Success. Otherwise,
+ * 			Error
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	std::string output, verifyPath;
+	unsigned long long shoesNr = SHOEGEN_DEFAULT_SHOES;
+	unsigned int decks = SHOEGEN_DEFAULT_DECKS;
+	unsigned long long seed = 1;
+	unsigned long long benchHands = 0;
+	unsigned int policy = POLICY_BASIC;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'o':
+				output = optarg;
+				break;
+			case 'n':
+				shoesNr = strtoull(optarg, NULL, 10);
+				break;
+			case 'd':
+				decks = strtoul(optarg, NULL, 10);
+				break;
+			case 'S':
+				seed = strtoull(optarg, NULL, 10);
+				break;
+			case 'v':
+				verifyPath = optarg;
+				break;
+			case 'b':
+				benchHands = strtoull(optarg, NULL, 10);
+				break;
+			case 'P':
+				{
+				TPolicyType type;
+				if (policyFromName(optarg, type))
+					{
+					log(LOG_ERR, "Unknown policy\n");
+					return -1;
+					}
+				policy = type;
+				}
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+	if (output.empty() && verifyPath.empty())
+		{
+		usage();
+		return -1;
+		}
+
+	if (!output.empty())
+		{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		if (writeShoeFile(output, seed, decks, shoesNr))
+			{
+			log(LOG_ERR, "Cannot write the shoe file (decks, shoes or I/O error)\n");
+			return -1;
+			}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		printf("Wrote %llu shoes of %u decks (seed %llu) to %s in %.3f s\n", shoesNr, decks, seed,
+				output.c_str(), elapsed.count());
+		if (verifyPath.empty())
+			verifyPath = output;
+		}
+
+	TShoeFile shoes;
+	if (shoes.open(verifyPath))
+		{
+		log(LOG_ERR, "Not a shoe file\n");
+		return -1;
+		}
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	int ret = shoes.verify();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	printf("%s: %llu shoes of %u decks (seed %llu), digest %016llx, %s (checked in %.3f s)\n",
+			verifyPath.c_str(), shoes.getShoesNr(), shoes.getDecks(), shoes.getSeed(),
+			(unsigned long long)shoes.getDigest(), ret ? "CORRUPTED" : "intact", elapsed.count());
+	if (ret || !benchHands)
+		return ret;
+	return bench(verifyPath, shoes, benchHands, policy);
+	}
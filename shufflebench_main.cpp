@@ -0,0 +1,288 @@
+/******************************************************************************/
+/*!
+ * @file:					  shufflebench_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-shufflebench. Benchmarks the batch random number
+ *  					generator and the shuffles built on it: values per second
+ *  					of the scalar and AVX2 refills, and the cost per shuffled
+ *  					card at the shoe sizes tables deal.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "dealer.hpp"
+#include "misc.hpp"
+#include "rng.hpp"
+
+/* Library includes */
+#include <chrono>
+#include <getopt.h>
+#include <iostream>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/* Private defines */
+#define BENCH_DEFAULT_SHUFFLES	100000ULL
+#define BENCH_DEFAULT_REPEATS		3
+// 32 bit values per fill benchmark repeat
+#define BENCH_VALUES					(1ULL << 26)
+
+/* Shuffles benchmarked */
+typedef enum __BenchShuffle__
+	{
+	BENCH_ERASE_MT,				// Draw and erase, std::mt19937_64 (the former seeded shuffle)
+	BENCH_FISHER_YATES_MT,		// Fisher-Yates, std::mt19937_64 and uniform_int_distribution
+	BENCH_FISHER_YATES_SCALAR,	// Fisher-Yates, batch generator, scalar refills
+	BENCH_FISHER_YATES_SIMD,	// Fisher-Yates, batch generator, AVX2 refills
+	BENCH_DEALER,					// TDealer::shuffle(), seeded
+	BENCH_SHUFFLES_NR
+	}TBenchShuffle;
+
+static const char *SHUFFLE_NAMES[BENCH_SHUFFLES_NR] =
+	{
+	"Erase, mt19937_64", "Fisher-Yates, mt19937", "Fisher-Yates, batch", "Fisher-Yates, AVX2",
+	"TDealer::shuffle"
+	};
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":hn:d:r:";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "shuffles",		required_argument,   NULL,    'n'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "repeats",  		required_argument,   NULL,    'r'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-shufflebench: Throughput of the batch random number generator and" << std::endl;
+   std::cout << "cost per shuffled card of the shuffles, at 6 and 8 deck shoes by default" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -n, --shuffles N" << std::endl;
+   std::cout << "      Shuffles per shoe size and repeat (default " << BENCH_DEFAULT_SHUFFLES <<
+   		")." << std::endl;
+   std::cout << "   -d, --decks N" << std::endl;
+   std::cout << "      Benchmark an N deck shoe instead, repeatable." << std::endl;
+   std::cout << "   -r, --repeats N" << std::endl;
+   std::cout << "      Repeats, the fastest one is kept (default " << BENCH_DEFAULT_REPEATS <<
+   		")." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Fill BENCH_VALUES values
+ * @return: Seconds taken
+ */
+	static double
+fillValues
+	(
+	TBatchRng 				&rng,			// Generator
+	std::vector<uint32_t> &values		// Scratch buffer
+	)
+	{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned long long done = 0; done < BENCH_VALUES; done += values.size())
+		rng.fill(values.data(), values.size());
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+	}
+
+/*
+ * Shuffle a shoe 'shuffles' times
+ * @return: Seconds taken
+ */
+	static double
+shuffleShoes
+	(
+	TBenchShuffle 			shuffle,			// Shuffle benchmarked
+	const TCards 			&fresh,			// Shoe cards
+	unsigned long long 	shuffles,		// Shuffles
+	unsigned int 			&check			// Out argument, first card of every shoe
+	)
+	{
+	TDealer dealer(1, fresh.size() / TDealer::CARDS_PER_DECK);
+	TBatchRng rng(1);
+	rng.useSimd(shuffle == BENCH_FISHER_YATES_SIMD);
+	std::mt19937_64 generator(1);
+	TCards cardDeck, cardDeckTmp;
+	cardDeck.reserve(fresh.size());
+	cardDeckTmp.reserve(fresh.size());
+	check = 0;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned long long s = 0; s < shuffles; s++)
+		{
+		switch (shuffle)
+			{
+			case BENCH_ERASE_MT:
+				cardDeck.clear();
+				cardDeckTmp.assign(fresh.begin(), fresh.end());
+				while (!cardDeckTmp.empty())
+					{
+					std::uniform_int_distribution<unsigned int> uniDist(0, cardDeckTmp.size() - 1);
+					unsigned int sel = uniDist(generator);
+					cardDeck.push_back(cardDeckTmp[sel]);
+					cardDeckTmp.erase(cardDeckTmp.begin() + sel);
+					}
+				break;
+			case BENCH_FISHER_YATES_MT:
+				cardDeck.assign(fresh.begin(), fresh.end());
+				for (unsigned int i = cardDeck.size(); i > 1; i--)
+					{
+					std::uniform_int_distribution<unsigned int> uniDist(0, i - 1);
+					std::swap(cardDeck[i - 1], cardDeck[uniDist(generator)]);
+					}
+				break;
+			case BENCH_FISHER_YATES_SCALAR:
+			case BENCH_FISHER_YATES_SIMD:
+				cardDeck.assign(fresh.begin(), fresh.end());
+				for (unsigned int i = cardDeck.size(); i > 1; i--)
+					std::swap(cardDeck[i - 1], cardDeck[rng.bounded(i)]);
+				break;
+			case BENCH_DEALER:
+			default:
+				dealer.shuffle(cardDeck);
+				break;
+			}
+		// Keeps the shuffles from being optimized out
+		check += cardDeck.back().rank;
+		}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+	}
+
+/* Top level and binary entry point for the shuffle benchmark
+ * @return: 0 - Success. Otherwise,
+ * 			Error (the scalar and AVX2 refills differ)
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	unsigned long long shuffles = BENCH_DEFAULT_SHUFFLES;
+	unsigned int repeats = BENCH_DEFAULT_REPEATS;
+	std::vector<unsigned int> decks;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'n':
+				shuffles = strtoull(optarg, NULL, 10);
+				break;
+			case 'd':
+				decks.push_back(strtoul(optarg, NULL, 10));
+				if (!decks.back())
+					{
+					log(LOG_ERR, "Decks must not be zero\n");
+					return -1;
+					}
+				break;
+			case 'r':
+				repeats = strtoul(optarg, NULL, 10);
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+	if (!shuffles || !repeats)
+		{
+		log(LOG_ERR, "Shuffles and repeats must not be zero\n");
+		return -1;
+		}
+	if (decks.empty())
+		{
+		decks.push_back(6);
+		decks.push_back(8);
+		}
+
+	// Both refills must produce the same values, or seeded shoes would depend on the CPU
+	bool simd = TBatchRng::hasSimd();
+	std::vector<uint32_t> scalarValues(RNG_BATCH_WORDS * 8), simdValues(RNG_BATCH_WORDS * 8);
+	TBatchRng scalar(7), vector(7);
+	scalar.useSimd(false);
+	scalar.fill(scalarValues.data(), scalarValues.size());
+	vector.fill(simdValues.data(), simdValues.size());
+	if (simd && memcmp(scalarValues.data(), simdValues.data(), scalarValues.size() *
+			sizeof(uint32_t)))
+		{
+		log(LOG_ERR, "Scalar and AVX2 refills differ\n");
+		return -1;
+		}
+
+	double fillBest[2] = {0.0, 0.0};
+	for (unsigned int r = 0; r < repeats; r++)
+		for (unsigned int v = 0; v < (simd ? 2U : 1U); v++)
+			{
+			TBatchRng rng(r);
+			rng.useSimd(v);
+			double secs = fillValues(rng, scalarValues);
+			if (!r || (secs < fillBest[v]))
+				fillBest[v] = secs;
+			}
+	printf("Batch generator, 32 bit values, best of %u%s\n", repeats, simd ? "" :
+			" (no AVX2 on this CPU)");
+	printf("  %-22s %8.3f ns/value  %7.0f M values/s\n", "Scalar refills",
+			fillBest[0] * 1e9 / (double)BENCH_VALUES, (double)BENCH_VALUES / fillBest[0] / 1e6);
+	if (simd)
+		printf("  %-22s %8.3f ns/value  %7.0f M values/s\n", "AVX2 refills",
+				fillBest[1] * 1e9 / (double)BENCH_VALUES, (double)BENCH_VALUES / fillBest[1] / 1e6);
+
+	for (unsigned int d = 0; d < decks.size(); d++)
+		{
+		// Fresh shoe, in dealing order
+		TDealer dealer(1, decks[d]);
+		TCards fresh;
+		dealer.shuffle(fresh);
+		double best[BENCH_SHUFFLES_NR];
+		unsigned int check = 0;
+		for (unsigned int r = 0; r < repeats; r++)
+			for (unsigned int s = 0; s < BENCH_SHUFFLES_NR; s++)
+				{
+				if ((s == BENCH_FISHER_YATES_SIMD) && !simd)
+					continue;
+				unsigned int sum;
+				double secs = shuffleShoes((TBenchShuffle)s, fresh, shuffles, sum);
+				check += sum;
+				if (!r || (secs < best[s]))
+					best[s] = secs;
+				}
+		printf("%u deck shoe, %zu cards, %llu shuffles, best of %u (check %u)\n", decks[d],
+				fresh.size(), shuffles, repeats, check);
+		double cards = (double)shuffles * (double)fresh.size();
+		for (unsigned int s = 0; s < BENCH_SHUFFLES_NR; s++)
+			{
+			if ((s == BENCH_FISHER_YATES_SIMD) && !simd)
+				continue;
+			printf("  %-22s %8.2f ns/card  %8.2f us/shoe  %6.2fx\n", SHUFFLE_NAMES[s],
+					best[s] * 1e9 / cards, best[s] * 1e6 / (double)shuffles,
+					best[BENCH_ERASE_MT] / best[s]);
+			}
+		}
+	return 0;
+	}
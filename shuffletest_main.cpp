@@ -0,0 +1,351 @@
+/******************************************************************************/
+/*!
+ * @file:					  shuffletest_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-shuffletest. Verifies that the dealer shuffles are
+ *  					uniform: worker threads shuffle shoes and count where
+ *  					every card lands, which cards follow which and the color
+ *  					runs, then the merged counts are tested and a pass/fail
+ *  					report printed.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "dealer.hpp"
+#include "misc.hpp"
+#include "rng.hpp"
+#include "sidebets.hpp"
+
+/* Library includes */
+#include <chrono>
+#include <getopt.h>
+#include <iostream>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+/* Private defines */
+#define TEST_DEFAULT_SHUFFLES		10000000ULL
+#define TEST_DEFAULT_ALPHA			0.001
+// Card codes counted (see cardCode())
+#define TEST_CODES					TDealer::CARDS_PER_DECK
+
+/* Counts of the shuffles of one worker, added up at the end */
+typedef struct __ShuffleCounts__
+	{
+	std::vector<unsigned long long> positions;		// [position][card code]
+	std::vector<unsigned long long> pairs;			// [card code][next card code]
+	unsigned long long runs;								// Color runs, all shoes
+	unsigned long long shuffles;
+	}TShuffleCounts;
+
+/* Shuffle test configuration */
+typedef struct __ShuffleTest__
+	{
+	unsigned int decks;
+	unsigned long long seed;
+	bool entropy;				// Reseed every shoe from system entropy
+	bool broken;				// Swap with any card instead of Fisher-Yates
+	}TShuffleTest;
+
+/* One test result */
+typedef struct __TestResult__
+	{
+	const char *name;
+	double statistic;
+	double df;					// Chi-square degrees of freedom, 0 for a z test
+	double pValue;
+	}TTestResult;
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":hn:d:j:S:a:eb";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "shuffles",		required_argument,   NULL,    'n'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "threads",  		required_argument,   NULL,    'j'   },
+   { "seed",   		required_argument,   NULL,    'S'   },
+   { "alpha",   		required_argument,   NULL,    'a'   },
+   { "entropy",  		no_argument,         NULL,    'e'   },
+   { "broken",   		no_argument,         NULL,    'b'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-shuffletest: Uniformity tests of the dealer shuffles" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Every shoe shuffled is counted: card code (rank and suit) per shoe position," << std::endl;
+   std::cout << "card code pairs of adjacent positions and color runs. The merged counts are" << std::endl;
+   std::cout << "tested with position by card and adjacency chi-square tests and a runs test." << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -n, --shuffles N" << std::endl;
+   std::cout << "      Shoes to shuffle (default " << TEST_DEFAULT_SHUFFLES << ")." << std::endl;
+   std::cout << "   -d, --decks N, -S, --seed SEED" << std::endl;
+   std::cout << "      Shoe decks (default 1) and seed (default 1) of the worker dealers." << std::endl;
+   std::cout << "   -j, --threads N" << std::endl;
+   std::cout << "      Worker threads (default one per hardware thread)." << std::endl;
+   std::cout << "   -e, --entropy" << std::endl;
+   std::cout << "      Reseed every shoe from system entropy, as dealers built without a seed" << std::endl;
+   std::cout << "      do. Slower, not reproducible." << std::endl;
+   std::cout << "   -a, --alpha P" << std::endl;
+   std::cout << "      Significance level of every test (default " << TEST_DEFAULT_ALPHA << ")." << std::endl;
+   std::cout << "   -b, --broken" << std::endl;
+   std::cout << "      Shuffle with the classic biased swap of every card with any card, to" << std::endl;
+   std::cout << "      check the tests catch it. Expected to fail." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Worker thread: shuffle 'shuffles' shoes and count them
+ */
+	static void
+worker
+	(
+	const TShuffleTest 	*test,			// Test configuration
+	unsigned int 			stream,			// Worker seed stream
+	unsigned long long 	shuffles,		// Shoes to shuffle
+	TShuffleCounts 		*counts			// Out argument
+	)
+	{
+	TDealer dealer(mixSeed(test->seed, stream), test->decks);
+	TBatchRng rng(mixSeed(test->seed, stream));
+	TCards cardDeck, fresh;
+	dealer.shuffle(fresh);
+	unsigned int size = fresh.size();
+	counts->positions.assign((size_t)size * TEST_CODES, 0);
+	counts->pairs.assign(TEST_CODES * TEST_CODES, 0);
+	counts->runs = 0;
+	counts->shuffles = shuffles;
+	std::vector<unsigned char> codes(size);
+
+	for (unsigned long long s = 0; s < shuffles; s++)
+		{
+		if (test->broken)
+			{
+			cardDeck.assign(fresh.begin(), fresh.end());
+			for (unsigned int i = 0; i < size; i++)
+				std::swap(cardDeck[i], cardDeck[rng.bounded(size)]);
+			}
+		else
+			{
+			if (test->entropy)
+				dealer.reseed();
+			dealer.shuffle(cardDeck);
+			}
+		// Dealt from the back: position 0 is the first card dealt
+		for (unsigned int pos = 0; pos < size; pos++)
+			codes[pos] = cardCode(cardDeck[size - 1 - pos]);
+		unsigned long long *positions = counts->positions.data();
+		unsigned int runs = 1;
+		for (unsigned int pos = 0; pos < size; pos++)
+			positions[(size_t)pos * TEST_CODES + codes[pos]]++;
+		for (unsigned int pos = 1; pos < size; pos++)
+			{
+			counts->pairs[codes[pos - 1] * TEST_CODES + codes[pos]]++;
+			// Suits 0 and 1 are black, 2 and 3 red
+			runs += ((codes[pos - 1] ^ codes[pos]) >> 1) & 1;
+			}
+		counts->runs += runs;
+		}
+	}
+
+/*
+ * Upper tail probability of a chi-square statistic, Wilson-Hilferty normal
+ * approximation: accurate at the thousands of degrees of freedom tested
+ * @return: P value
+ */
+	static double
+chiSquareTail
+	(
+	double statistic,		// Chi-square statistic
+	double df				// Degrees of freedom
+	)
+	{
+	double scale = 2.0 / (9.0 * df);
+	double z = (cbrt(statistic / df) - (1.0 - scale)) / sqrt(scale);
+	return 0.5 * erfc(z / sqrt(2.0));
+	}
+
+/*
+ * Test the merged counts
+ */
+	static void
+testCounts
+	(
+	const TShuffleCounts 		&counts,		// Merged counts
+	unsigned int 					decks,		// Shoe decks
+	std::vector<TTestResult> 	&results,	// Out argument
+	double 							&worstZ		// Out argument, largest position cell deviation
+	)
+	{
+	double shuffles = (double)counts.shuffles;
+	unsigned int size = decks * TDealer::CARDS_PER_DECK;
+
+	// Every code is 'decks' of the cards of every position
+	double expected = shuffles * (double)decks / (double)size;
+	double chi = 0.0;
+	worstZ = 0.0;
+	for (size_t i = 0; i < counts.positions.size(); i++)
+		{
+		double diff = (double)counts.positions[i] - expected;
+		chi += diff * diff / expected;
+		if (fabs(diff) / sqrt(expected) > worstZ)
+			worstZ = fabs(diff) / sqrt(expected);
+		}
+	double df = (double)(size - 1) * (double)(TEST_CODES - 1);
+	TTestResult position = {"Position by card", chi, df, chiSquareTail(chi, df)};
+	results.push_back(position);
+
+	// A code follows another with probability decks^2 / (size (size - 1)), itself
+	// decks (decks - 1) / (size (size - 1)), at each of the size - 1 adjacencies
+	double perPair = shuffles / (double)size;
+	double other = perPair * (double)decks * (double)decks;
+	double same = perPair * (double)decks * (double)(decks - 1);
+	chi = 0.0;
+	unsigned int cells = 0;
+	for (unsigned int a = 0; a < TEST_CODES; a++)
+		for (unsigned int b = 0; b < TEST_CODES; b++)
+			{
+			double cellExpected = (a == b) ? same : other;
+			if (cellExpected <= 0.0)
+				continue;
+			double diff = (double)counts.pairs[a * TEST_CODES + b] - cellExpected;
+			chi += diff * diff / cellExpected;
+			cells++;
+			}
+	df = (double)(cells - 1);
+	TTestResult adjacency = {"Adjacent cards", chi, df, chiSquareTail(chi, df)};
+	results.push_back(adjacency);
+
+	// Wald-Wolfowitz runs of the two colors, half of the shoe each
+	double n = (double)size, half = n / 2.0;
+	double meanRuns = 1.0 + 2.0 * half * half / n;
+	double varRuns = 2.0 * half * half * (2.0 * half * half - n) / (n * n * (n - 1.0));
+	double z = ((double)counts.runs - shuffles * meanRuns) / sqrt(shuffles * varRuns);
+	TTestResult runs = {"Color runs", z, 0.0, erfc(fabs(z) / sqrt(2.0))};
+	results.push_back(runs);
+	}
+
+/* Top level and binary entry point for the shuffle verification
+ * @return: 0 - Success, every test passed. Otherwise,
+ * 			Error or a test failed
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	TShuffleTest test;
+	memset((void *)&test, 0, sizeof(test));
+	test.decks = 1;
+	test.seed = 1;
+	unsigned long long shuffles = TEST_DEFAULT_SHUFFLES;
+	unsigned int threadsNr = std::thread::hardware_concurrency();
+	double alpha = TEST_DEFAULT_ALPHA;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'n':
+				shuffles = strtoull(optarg, NULL, 10);
+				break;
+			case 'd':
+				test.decks = strtoul(optarg, NULL, 10);
+				break;
+			case 'j':
+				threadsNr = strtoul(optarg, NULL, 10);
+				break;
+			case 'S':
+				test.seed = strtoull(optarg, NULL, 10);
+				break;
+			case 'a':
+				alpha = strtod(optarg, NULL);
+				break;
+			case 'e':
+				test.entropy = true;
+				break;
+			case 'b':
+				test.broken = true;
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+	if (!threadsNr)
+		threadsNr = 1;
+	if (!test.decks || (shuffles < threadsNr) || (alpha <= 0.0) || (alpha >= 1.0))
+		{
+		log(LOG_ERR, "Invalid decks, shuffles or alpha\n");
+		return -1;
+		}
+
+	std::vector<TShuffleCounts> counts(threadsNr);
+	std::vector<std::thread> threads;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned int t = 0; t < threadsNr; t++)
+		threads.push_back(std::thread(worker, &test, t, shuffles / threadsNr +
+				((t < shuffles % threadsNr) ? 1 : 0), &counts[t]));
+	for (unsigned int t = 0; t < threadsNr; t++)
+		threads[t].join();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	// Merged once the workers are done, no counter is ever shared
+	TShuffleCounts &total = counts[0];
+	for (unsigned int t = 1; t < threadsNr; t++)
+		{
+		for (size_t i = 0; i < total.positions.size(); i++)
+			total.positions[i] += counts[t].positions[i];
+		for (size_t i = 0; i < total.pairs.size(); i++)
+			total.pairs[i] += counts[t].pairs[i];
+		total.runs += counts[t].runs;
+		total.shuffles += counts[t].shuffles;
+		}
+
+	std::vector<TTestResult> results;
+	double worstZ;
+	testCounts(total, test.decks, results, worstZ);
+	printf("%llu shoes of %u decks, %u threads, %.3f s (%.0f shoes/s)%s%s\n", total.shuffles,
+			test.decks, threadsNr, elapsed.count(), (double)total.shuffles / elapsed.count(),
+			test.entropy ? ", reseeded from system entropy" : "",
+			test.broken ? ", BROKEN shuffle" : "");
+	bool passed = true;
+	for (unsigned int r = 0; r < results.size(); r++)
+		{
+		bool pass = (results[r].pValue >= alpha);
+		passed &= pass;
+		if (results[r].df > 0.0)
+			printf("  %-18s chi2 %14.1f  df %8.0f  p %.4f  %s\n", results[r].name,
+					results[r].statistic, results[r].df, results[r].pValue, pass ? "PASS" : "FAIL");
+		else
+			printf("  %-18s z    %14.3f  %11s  p %.4f  %s\n", results[r].name,
+					results[r].statistic, "", results[r].pValue, pass ? "PASS" : "FAIL");
+		}
+	printf("  Largest position by card deviation %.2f standard deviations\n", worstZ);
+	printf("%s at alpha %g\n", passed ? "PASS" : "FAIL", alpha);
+	return passed ? 0 : -1;
+	}
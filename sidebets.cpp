@@ -0,0 +1,139 @@
+/******************************************************************************/
+/*!
+ * @file:					  sidebets.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the side bets lookup tables.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <string.h>
+
+/* Local includes */
+#include "sidebets.hpp"
+
+/* Private defines */
+#define SUIT_MASK		((1 << SIDE_CODE_SUIT_BITS) - 1)
+// Suits 0 and 1 are black, 2 and 3 red
+#define SUIT_COLOR(suit)	((suit) >> 1)
+
+// Perfect Pairs: mixed 6:1, colored 12:1, perfect 25:1
+const unsigned int PAIRS_PAYS[PAIRS_OUTCOMES_NR] = {0, 6, 12, 25};
+// 21+3: flush 5:1, straight 10:1, three of a kind 30:1, straight flush 40:1,
+// suited trips 100:1
+const unsigned int THREE_PAYS[THREE_OUTCOMES_NR] = {0, 5, 10, 30, 40, 100};
+
+/*
+ * Side bets tables, built once on construction
+ */
+class TSideBetTablesBuilder
+	{
+	public:
+		TSideBetTablesBuilder(void);
+		TSideBetTables mTables;
+	};
+
+/*
+ * Fill every entry. Runs once, so it reads like the rules it encodes
+ */
+TSideBetTablesBuilder::TSideBetTablesBuilder
+	(
+	void
+	)
+	{
+	memset((void *)&mTables, 0, sizeof(mTables));
+	const unsigned int RANKS_NR = TDealer::RANKS_NR;
+
+	for (unsigned int a = 0; a < SIDE_CODES_NR; a++)
+		for (unsigned int b = 0; b < SIDE_CODES_NR; b++)
+			{
+			unsigned int rankA = a >> SIDE_CODE_SUIT_BITS, rankB = b >> SIDE_CODE_SUIT_BITS;
+			unsigned int suitA = a & SUIT_MASK, suitB = b & SUIT_MASK;
+			TPairsOutcome outcome = PAIRS_NONE;
+			if ((rankA >= RANKS_NR) || (rankA != rankB))
+				outcome = PAIRS_NONE;
+			else if (suitA == suitB)
+				outcome = PAIRS_PERFECT;
+			else if (SUIT_COLOR(suitA) == SUIT_COLOR(suitB))
+				outcome = PAIRS_COLORED;
+			else
+				outcome = PAIRS_MIXED;
+			mTables.pairs[(a << SIDE_CODE_BITS) | b] = (unsigned char)outcome;
+			}
+
+	for (unsigned int a = 0; a < RANKS_NR; a++)
+		for (unsigned int b = 0; b < RANKS_NR; b++)
+			for (unsigned int c = 0; c < RANKS_NR; c++)
+				{
+				// Sorted ranks, Ace 0 (low)
+				unsigned int r[3] = {a, b, c};
+				for (unsigned int i = 0; i < 2; i++)
+					for (unsigned int j = 0; j < 2 - i; j++)
+						if (r[j] > r[j + 1])
+							{
+							unsigned int t = r[j];
+							r[j] = r[j + 1];
+							r[j + 1] = t;
+							}
+				bool trips = (r[0] == r[2]);
+				bool straight = ((r[1] == r[0] + 1) && (r[2] == r[1] + 1)) ||
+						// Q-K-A, the Ace high
+						((r[0] == 0) && (r[1] == RANKS_NR - 2) && (r[2] == RANKS_NR - 1));
+
+				TThreeOutcome plain = trips ? THREE_OF_A_KIND : (straight ? THREE_STRAIGHT :
+						THREE_NONE);
+				TThreeOutcome suited = trips ? THREE_SUITED_TRIPS : (straight ?
+						THREE_STRAIGHT_FLUSH : THREE_FLUSH);
+				mTables.three[(a * RANKS_NR + b) * RANKS_NR + c] =
+						(unsigned char)(plain | (suited << 4));
+				}
+	}
+
+/*
+ * Side bets tables, built on the first call
+ * @return: Tables
+ */
+	const TSideBetTables &
+sideBetTables
+	(
+	void
+	)
+	{
+	static const TSideBetTablesBuilder builder;
+	return builder.mTables;
+	}
+
+/*
+ * Perfect Pairs net result of a run
+ * @return: Net result in bets
+ */
+	double
+pairsNet
+	(
+	const unsigned long long outcomes[PAIRS_OUTCOMES_NR]		// Hands per outcome
+	)
+	{
+	double net = -(double)outcomes[PAIRS_NONE];
+	for (unsigned int i = PAIRS_NONE + 1; i < PAIRS_OUTCOMES_NR; i++)
+		net += (double)outcomes[i] * (double)PAIRS_PAYS[i];
+	return net;
+	}
+
+/*
+ * 21+3 net result of a run
+ * @return: Net result in bets
+ */
+	double
+threeNet
+	(
+	const unsigned long long outcomes[THREE_OUTCOMES_NR]		// Hands per outcome
+	)
+	{
+	double net = -(double)outcomes[THREE_NONE];
+	for (unsigned int i = THREE_NONE + 1; i < THREE_OUTCOMES_NR; i++)
+		net += (double)outcomes[i] * (double)THREE_PAYS[i];
+	return net;
+	}
@@ -0,0 +1,108 @@
+/******************************************************************************/
+/*!
+ * @file:					  sidebets.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the side bets: Perfect Pairs on
+ *  					the player first two cards and 21+3 on those two plus the
+ *  					dealer up card. Both are resolved with lookup tables
+ *  					indexed by packed card codes, built once.
+ *
+ *  Packed card code: (rank - 1) << 2 | suit, 0 to 51. Suits 0 and 1 (spades,
+ *  clubs) are black, 2 and 3 (diamonds, hearts) red.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __SIDEBETS_HPP__
+#define __SIDEBETS_HPP__
+
+/* Local includes */
+#include "dealer.hpp"
+
+/* Defines */
+
+// Packed card codes, a 2 bit suit under the rank
+#define SIDE_CODE_SUIT_BITS	2
+#define SIDE_CODE_BITS			6
+#define SIDE_CODES_NR			(1 << SIDE_CODE_BITS)
+
+/* Enumerations, type defines */
+
+/* Perfect Pairs outcomes, best last */
+typedef enum __PairsOutcome__
+	{
+	PAIRS_NONE,				// Loses the bet
+	PAIRS_MIXED,			// Same rank, colors differ
+	PAIRS_COLORED,			// Same rank and color, suits differ
+	PAIRS_PERFECT,			// Same rank and suit
+	PAIRS_OUTCOMES_NR
+	}TPairsOutcome;
+
+/* 21+3 outcomes, best last */
+typedef enum __ThreeOutcome__
+	{
+	THREE_NONE,				// Loses the bet
+	THREE_FLUSH,
+	THREE_STRAIGHT,		// Ace low (A-2-3) or high (Q-K-A)
+	THREE_OF_A_KIND,
+	THREE_STRAIGHT_FLUSH,
+	THREE_SUITED_TRIPS,	// Same rank and suit
+	THREE_OUTCOMES_NR
+	}TThreeOutcome;
+
+// Bets won per bet, by outcome. PAIRS_NONE and THREE_NONE lose the bet
+extern const unsigned int PAIRS_PAYS[PAIRS_OUTCOMES_NR];
+extern const unsigned int THREE_PAYS[THREE_OUTCOMES_NR];
+
+/*
+ * Side bets lookup tables
+ * Perfect Pairs: one byte per pair of packed codes. 21+3: one byte per rank
+ * triple, the outcome of unsuited cards in the low nibble and of three cards
+ * of a suit in the high one, so the table stays in the L1 cache.
+ */
+typedef struct __SideBetTables__
+	{
+	unsigned char pairs[SIDE_CODES_NR * SIDE_CODES_NR];
+	unsigned char three[TDealer::RANKS_NR * TDealer::RANKS_NR * TDealer::RANKS_NR];
+	}TSideBetTables;
+
+/*
+ * Side bets tables, built on the first call
+ * @return: Tables
+ */
+const TSideBetTables &sideBetTables(void);
+
+// Packed card code
+static inline unsigned int cardCode(const TCard &card)
+	{
+	return ((unsigned int)(card.rank - 1) << SIDE_CODE_SUIT_BITS) | card.suit;
+	}
+
+// Perfect Pairs outcome of the player first two cards, from their packed codes
+static inline TPairsOutcome evalPairs(const TSideBetTables &tables, unsigned int first,
+		unsigned int second)
+	{
+	return (TPairsOutcome)tables.pairs[(first << SIDE_CODE_BITS) | second];
+	}
+
+// 21+3 outcome of the player first two cards and the dealer up card, from their
+// packed codes
+static inline TThreeOutcome evalThree(const TSideBetTables &tables, unsigned int first,
+		unsigned int second, unsigned int up)
+	{
+	unsigned int index = ((first >> SIDE_CODE_SUIT_BITS) * TDealer::RANKS_NR +
+			(second >> SIDE_CODE_SUIT_BITS)) * TDealer::RANKS_NR + (up >> SIDE_CODE_SUIT_BITS);
+	unsigned int suited = !(((first ^ second) | (second ^ up)) & ((1 << SIDE_CODE_SUIT_BITS) - 1));
+	return (TThreeOutcome)((tables.three[index] >> (suited << 2)) & 0xF);
+	}
+
+/*
+ * Side bets net result of a run, one bet each per hand
+ * @return: Net result in bets
+ */
+double pairsNet(const unsigned long long outcomes[PAIRS_OUTCOMES_NR]);
+double threeNet(const unsigned long long outcomes[THREE_OUTCOMES_NR]);
+
+#endif /* __SIDEBETS_HPP__ */
@@ -0,0 +1,460 @@
+/******************************************************************************/
+/*!
+ * @file:					  sim_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-sim. Plays one shard of a simulation run and
+ *  					writes its results file (see blackjack-merge). The shard
+ *  					can be played by several worker threads, and their live
+ *  					stats exported while they play.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "livestats.hpp"
+#include "misc.hpp"
+#include "resultfile.hpp"
+#include "rules.hpp"
+#include "sidebets.hpp"
+#include "simulator.hpp"
+#include "strategy.hpp"
+#include "topology.hpp"
+
+/* Library includes */
+#include <getopt.h>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+/* Private defines */
+// Stratified runs time one plain hand per this many stratified hands
+#define STRATIFIED_TIMING_SHARE		10
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":hn:d:k:P:T:F:S:x:o:H:j:E:C:I:zi:w:asp6";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "hands",   		required_argument,   NULL,    'n'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "seats",   		required_argument,   NULL,    'k'   },
+   { "policy",   		required_argument,   NULL,    'P'   },
+   { "tables",   		required_argument,   NULL,    'T'   },
+   { "shoes",   		required_argument,   NULL,    'F'   },
+   { "seed",   		required_argument,   NULL,    'S'   },
+   { "shard",   		required_argument,   NULL,    'x'   },
+   { "output",   		required_argument,   NULL,    'o'   },
+   { "history",  		required_argument,   NULL,    'H'   },
+   { "threads",  		required_argument,   NULL,    'j'   },
+   { "export-prom",	required_argument,   NULL,    'E'   },
+   { "export-csv",	required_argument,   NULL,    'C'   },
+   { "export-interval",	required_argument,   NULL,    'I'   },
+   { "stratified",	no_argument,         NULL,    'z'   },
+   { "importance",	required_argument,   NULL,    'i'   },
+   { "tilt",   		required_argument,   NULL,    'w'   },
+   { "affinity",		no_argument,         NULL,    'a'   },
+   { "s17",   		no_argument,         NULL,    's'   },
+   { "push-ties",		no_argument,         NULL,    'p'   },
+   { "pay-6-5",		no_argument,         NULL,    '6'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-sim: One shard of a simulation run, written as a results file" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -n, --hands N" << std::endl;
+   std::cout << "      Hands (table rounds) of the whole run (default 1000000)." << std::endl;
+   std::cout << "   -x, --shard I/N" << std::endl;
+   std::cout << "      Play shard I (0 to N - 1) of N only (default 0/1). Shards play their" << std::endl;
+   std::cout << "      share of the hands on their own seed stream." << std::endl;
+   std::cout << "   -o, --output FILE" << std::endl;
+   std::cout << "      Results file to write (default none)." << std::endl;
+   std::cout << "   -H, --history DIR" << std::endl;
+   std::cout << "      Write every decision to a hand history store (see blackjack-query)." << std::endl;
+   std::cout << "      One player engine, one thread only." << std::endl;
+   std::cout << "   -j, --threads N" << std::endl;
+   std::cout << "      Worker threads playing the shard (default 1). Each plays a sub-shard on" << std::endl;
+   std::cout << "      its own seed stream: shard I/N of N threads is shards I*N to I*N+N-1 of" << std::endl;
+   std::cout << "      N times as many, so shards of a run must use the same thread count." << std::endl;
+   std::cout << "   -a, --affinity" << std::endl;
+   std::cout << "      Pin every worker to a CPU, spread round robin over the NUMA nodes, so its" << std::endl;
+   std::cout << "      shoe, engine and stats are allocated on its node. Results are added up" << std::endl;
+   std::cout << "      per node first and the hands per second of every node printed." << std::endl;
+   std::cout << "   -E, --export-prom FILE, -C, --export-csv FILE" << std::endl;
+   std::cout << "      Export the live stats of every worker (hands, edge, standard error," << std::endl;
+   std::cout << "      hands per second) and their total while playing, as a Prometheus text" << std::endl;
+   std::cout << "      file and a CSV time series. One player engine only." << std::endl;
+   std::cout << "   -I, --export-interval SECS" << std::endl;
+   std::cout << "      Time between exports (default 10)." << std::endl;
+   std::cout << "   -z, --stratified" << std::endl;
+   std::cout << "      Deal every hand off the top of a fresh shoe, stratified on the player" << std::endl;
+   std::cout << "      cards and the up card, and print the EV of the strata weighted with" << std::endl;
+   std::cout << "      their exact probabilities, and how many more hands a plain run needs." << std::endl;
+   std::cout << "      One player engine, whole run, one thread, no results file." << std::endl;
+   std::cout << "   -i, --importance TARGET, -w, --tilt W" << std::endl;
+   std::cout << "      Deal every hand off the top of a fresh weighted shoe, its favored cards" << std::endl;
+   std::cout << "      weighing W (default " << SIM_DEFAULT_TILT << "), and print the rare event frequencies" << std::endl;
+   std::cout << "      weighted with the likelihood ratio of the hand cards. TARGET 'low-cards'" << std::endl;
+   std::cout << "      (Aces to fours, seven card 21s) or 'suited' (the suit of the first card," << std::endl;
+   std::cout << "      suited naturals and side bet top tiers). Same limits as --stratified." << std::endl;
+   std::cout << "   -d, --decks N, -k, --seats N, -P, --policy NAME, -S, --seed SEED" << std::endl;
+   std::cout << "      Shoe decks (default 6), table seats (default 0, one player engine)," << std::endl;
+   std::cout << "      player policy and run seed (default 1)." << std::endl;
+   std::cout << "   -T, --tables FILE" << std::endl;
+   std::cout << "      Table file for the 'tables' policy (see blackjack-tablegen)." << std::endl;
+   std::cout << "   -F, --shoes FILE" << std::endl;
+   std::cout << "      Deal the shoes of a shoe corpus (see blackjack-shoegen) instead of" << std::endl;
+   std::cout << "      shuffling, every shard and thread its own slice of it." << std::endl;
+   std::cout << "   -s, --s17, -p, --push-ties, -6, --pay-6-5" << std::endl;
+   std::cout << "      Rule variants, as for blackjack." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Worker thread: play one sub-shard. Pinned workers copy their configuration
+ * and play into results of their own, first touched on their node
+ */
+	static void
+worker
+	(
+	const TSimConfig 		*config,			// Sub-shard configuration
+	const TCpuPlacement 	*placement,		// CPU to pin to, NULL not pinned
+	TSimResults 			*results,		// Out argument
+	int 						*ret				// Out argument, simulate() return code
+	)
+	{
+	if (!placement)
+		{
+		*ret = simulate(config, results);
+		return;
+		}
+	// Unpinned, the worker still plays: placement only changes the speed
+	TTopology::pin(placement->cpu);
+	TSimConfig local = *config;
+	TSimResults *localResults = new TSimResults;
+	*ret = simulate(&local, localResults);
+	*results = *localResults;
+	delete localResults;
+	}
+
+/* Top level and binary entry point for the shard simulator
+ * @return: 0 - Success. Otherwise,
+ * 			Error
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	TSimConfig config;
+	simInitConfig(&config);
+	config.decks = 6;
+	config.seed = 1;
+	const char *output = NULL;
+	unsigned int threadsNr = 1;
+	bool affinity = false;
+	std::string promPath, csvPath;
+	double exportSecs = 10.0;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'n':
+				config.hands = strtoull(optarg, NULL, 10);
+				break;
+			case 'd':
+				config.decks = strtoul(optarg, NULL, 10);
+				break;
+			case 'k':
+				config.seats = strtoul(optarg, NULL, 10);
+				break;
+			case 'P':
+				{
+				TPolicyType policy;
+				if (policyFromName(optarg, policy))
+					{
+					log(LOG_ERR, "Unknown policy\n");
+					return -1;
+					}
+				config.policy = policy;
+				}
+				break;
+			case 'T':
+				config.tablesPath = optarg;
+				break;
+			case 'F':
+				config.shoesPath = optarg;
+				break;
+			case 'S':
+				config.seed = strtoull(optarg, NULL, 10);
+				break;
+			case 'x':
+				if ((sscanf(optarg, "%u/%u", &config.shard, &config.shardsNr) != 2) ||
+						!config.shardsNr || (config.shard >= config.shardsNr))
+					{
+					log(LOG_ERR, "Invalid shard, expected I/N with I below N\n");
+					return -1;
+					}
+				break;
+			case 'o':
+				output = optarg;
+				break;
+			case 'H':
+				config.historyPath = optarg;
+				break;
+			case 'j':
+				threadsNr = strtoul(optarg, NULL, 10);
+				break;
+			case 'E':
+				promPath = optarg;
+				break;
+			case 'C':
+				csvPath = optarg;
+				break;
+			case 'I':
+				exportSecs = strtod(optarg, NULL);
+				break;
+			case 'z':
+				config.stratified = 1;
+				break;
+			case 'i':
+				if (!strcmp(optarg, "low-cards"))
+					config.importance = SIM_IMPORTANCE_LOW_CARDS;
+				else if (!strcmp(optarg, "suited"))
+					config.importance = SIM_IMPORTANCE_SUITED;
+				else
+					{
+					log(LOG_ERR, "Unknown importance target\n");
+					return -1;
+					}
+				break;
+			case 'w':
+				config.importanceTilt = strtod(optarg, NULL);
+				break;
+			case 'a':
+				affinity = true;
+				break;
+			case 's':
+				config.rules |= RULES_STAND_SOFT_17;
+				break;
+			case 'p':
+				config.rules |= RULES_PUSH_TIES;
+				break;
+			case '6':
+				config.rules |= RULES_PAY_6_5;
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+
+	unsigned int shardsNr = config.shardsNr ? config.shardsNr : 1;
+	if (!threadsNr || (shardsNr * threadsNr > SIM_MAX_SHARDS) || (exportSecs <= 0.0) ||
+			((threadsNr > 1) && config.historyPath))
+		{
+		log(LOG_ERR, "Invalid threads or export interval\n");
+		return -1;
+		}
+	if (config.seats && (config.policy == POLICY_FULL_BASIC))
+		{
+		log(LOG_ERR, "Table seats hit and stand only, the 'full' policy needs the one player"
+				" engine\n");
+		return -1;
+		}
+	// Stratified and weighted hands add up as dealt, the results file would not
+	// weight them
+	if ((config.stratified || config.importance) && ((threadsNr > 1) || (shardsNr > 1) ||
+			output))
+		{
+		log(LOG_ERR, "Stratified and importance sampled runs are whole runs of one thread,"
+				" without results file\n");
+		return -1;
+		}
+
+	// Workers play sub-shards of the shard, each publishing to a slot of its own
+	bool live = !promPath.empty() || !csvPath.empty();
+	TLiveSlots slots(live ? threadsNr : 0);
+	std::vector<TSimConfig> configs(threadsNr, config);
+	std::vector<TSimResults> results(threadsNr);
+	std::vector<int> rets(threadsNr, -1);
+	for (unsigned int t = 0; t < threadsNr; t++)
+		{
+		if (threadsNr > 1)
+			{
+			configs[t].shard = config.shard * threadsNr + t;
+			configs[t].shardsNr = shardsNr * threadsNr;
+			}
+		configs[t].live = live ? &slots.get()[t] : NULL;
+		}
+	// Pinned workers are spread over the nodes. Otherwise, one node of them all
+	TTopology topology;
+	std::vector<TCpuPlacement> placements;
+	if (affinity)
+		{
+		if (topology.load())
+			return -1;
+		topology.place(threadsNr, placements);
+		}
+	unsigned int nodesNr = affinity ? topology.nodesNr() : 1;
+	if (nodesNr > threadsNr)
+		nodesNr = threadsNr;
+	TLiveExporter exporter;
+	if (live && exporter.start(slots.get(), threadsNr, promPath, csvPath, exportSecs))
+		return -1;
+	std::vector<std::thread> threads;
+	for (unsigned int t = 0; t < threadsNr; t++)
+		threads.push_back(std::thread(worker, &configs[t], affinity ? &placements[t] : NULL,
+				&results[t], &rets[t]));
+	for (unsigned int t = 0; t < threadsNr; t++)
+		threads[t].join();
+	exporter.stop();
+
+	// Added up per node first, the node totals into the shard second
+	TResultFile file;
+	std::vector<TResultFile> nodeFiles(nodesNr);
+	std::vector<double> nodeSecs(nodesNr, 0.0);
+	std::vector<unsigned int> nodeThreads(nodesNr, 0);
+	unsigned long long pairsOutcomes[SIM_PAIRS_OUTCOMES] = {0};
+	unsigned long long threeOutcomes[SIM_THREE_OUTCOMES] = {0};
+	for (unsigned int t = 0; t < threadsNr; t++)
+		{
+		if (rets[t])
+			{
+			log(LOG_ERR, "Invalid simulation configuration\n");
+			return -1;
+			}
+		unsigned int node = affinity ? placements[t].node : 0;
+		// Stratified hands are allocated by stratum and importance sampled ones dealt
+		// from a tilted shoe: their plain mean is biased
+		if (config.stratified || config.importance)
+			printf("Shard %u/%u: %llu hands, %.3f s\n", configs[t].shard,
+					configs[t].shardsNr ? configs[t].shardsNr : 1, results[t].handsPlayed,
+					results[t].elapsedSecs);
+		else
+			printf("Shard %u/%u: %llu hands, EV %+.6f bets per hand, %.3f s\n",
+					configs[t].shard, configs[t].shardsNr ? configs[t].shardsNr : 1,
+					results[t].handsPlayed, results[t].handsPlayed ?
+					(double)results[t].netTenths / 10.0 / (double)results[t].handsPlayed : 0.0,
+					results[t].elapsedSecs);
+		for (unsigned int i = 0; i < SIM_PAIRS_OUTCOMES; i++)
+			pairsOutcomes[i] += results[t].pairsOutcomes[i];
+		for (unsigned int i = 0; i < SIM_THREE_OUTCOMES; i++)
+			threeOutcomes[i] += results[t].threeOutcomes[i];
+		TResultFile shardFile;
+		fillResultFile(nodeThreads[node] ? shardFile : nodeFiles[node], configs[t], results[t]);
+		if (nodeThreads[node] && mergeResultFiles(nodeFiles[node], shardFile))
+			return -1;
+		nodeThreads[node]++;
+		if (results[t].elapsedSecs > nodeSecs[node])
+			nodeSecs[node] = results[t].elapsedSecs;
+		}
+	file = nodeFiles[0];
+	for (unsigned int n = 1; n < nodesNr; n++)
+		if (mergeResultFiles(file, nodeFiles[n]))
+			return -1;
+	if (affinity)
+		{
+		double totalRate = 0.0;
+		for (unsigned int n = 0; n < nodesNr; n++)
+			{
+			// The node plays until its slowest worker is done
+			double rate = nodeSecs[n] > 0.0 ? (double)nodeFiles[n].handsPlayed / nodeSecs[n] :
+					0.0;
+			totalRate += rate;
+			printf("Node %u: %u threads on %zu CPUs, %llu hands, %.0f hands/s, %.0f per"
+					" thread\n", topology.nodeId(n), nodeThreads[n], topology.cpus(n).size(),
+					(unsigned long long)nodeFiles[n].handsPlayed, rate, rate / nodeThreads[n]);
+			}
+		printf("All %u nodes: %.0f hands/s\n", nodesNr, totalRate);
+		}
+	if (threadsNr > 1)
+		printf("Shard %u/%u: %llu hands, EV %+.6f bets per hand, %u threads\n", config.shard,
+				shardsNr, (unsigned long long)file.handsPlayed, file.handsPlayed ?
+				(double)file.netTenths / 10.0 / (double)file.handsPlayed : 0.0, threadsNr);
+	if (config.stratified)
+		{
+		printf("Stratified: EV %+.6f +/- %.6f bets per hand off the top, %u strata\n",
+				results[0].stratifiedEv, results[0].stratifiedStdErr, results[0].strataNr);
+		if (results[0].stratifiedStdErr > 0.0)
+			{
+			double handsRatio = results[0].plainStdErr * results[0].plainStdErr /
+					(results[0].stratifiedStdErr * results[0].stratifiedStdErr);
+			printf("  A plain run would have +/- %.6f, needing %.1f times the hands\n",
+					results[0].plainStdErr, handsRatio);
+			// Stratified hands cost a fresh shoe each: time plain hands to weigh both
+			TSimConfig plain = config;
+			TSimResults plainResults;
+			plain.stratified = 0;
+			plain.hands = config.hands / STRATIFIED_TIMING_SHARE;
+			if (plain.hands && !simulate(&plain, &plainResults) &&
+					(plainResults.elapsedSecs > 0.0))
+				{
+				double plainSecs = plainResults.elapsedSecs / (double)plainResults.handsPlayed *
+						(double)results[0].handsPlayed * handsRatio;
+				printf("  Wall clock: %.3f s stratified, %.3f s for a plain run of the same"
+						" error (%.0f plain hands/s), %.2fx\n", results[0].elapsedSecs, plainSecs,
+						(double)plainResults.handsPlayed / plainResults.elapsedSecs,
+						plainSecs / results[0].elapsedSecs);
+				}
+			}
+		}
+	if (config.importance)
+		{
+		static const char *names[SIM_RARE_EVENTS] = {"Seven card 21", "Suited natural",
+				"Perfect pair", "Straight flush", "Suited trips"};
+		printf("Importance sampled: EV %+.6f +/- %.6f bets per hand off the top, mean weight"
+				" %.4f\n", results[0].weightedEv, results[0].weightedEvStdErr,
+				results[0].meanWeight);
+		printf("  %-16s %10s %12s %12s %12s %8s\n", "Event", "Dealt", "Per hand", "Std err",
+				"Plain err", "Hands x");
+		for (unsigned int e = 0; e < SIM_RARE_EVENTS; e++)
+			{
+			double ratio = results[0].rareStdErrs[e] ? results[0].rarePlainStdErrs[e] *
+					results[0].rarePlainStdErrs[e] / (results[0].rareStdErrs[e] *
+					results[0].rareStdErrs[e]) : 0.0;
+			printf("  %-16s %10llu %12.4e %12.4e %12.4e %8.1f\n", names[e],
+					results[0].rareHits[e], results[0].rareRates[e], results[0].rareStdErrs[e],
+					results[0].rarePlainStdErrs[e], ratio);
+			}
+		}
+	unsigned long long dealt = 0;
+	for (unsigned int i = 0; i < SIM_PAIRS_OUTCOMES; i++)
+		dealt += pairsOutcomes[i];
+	// Side bet outcomes are counted as dealt, not weighted by stratum or likelihood
+	if (dealt && !config.stratified && !config.importance)
+		printf("Side bets: Perfect Pairs EV %+.6f, 21+3 EV %+.6f per bet\n",
+				pairsNet(pairsOutcomes) / (double)dealt,
+				threeNet(threeOutcomes) / (double)dealt);
+	if (!output)
+		return 0;
+
+	if (writeResultFile(output, file))
+		{
+		log(LOG_ERR, "Could not write the results file\n");
+		return -1;
+		}
+	return 0;
+	}
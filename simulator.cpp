@@ -0,0 +1,781 @@
+/******************************************************************************/
+/*!
+ * @file:					  simulator.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the libblackjack batch simulation API.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <chrono>
+#include <exception>
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/* Local includes */
+#include "blackjack.hpp"
+#include "history.hpp"
+#include "livestats.hpp"
+#include "misc.hpp"
+#include "table.hpp"
+#include "shoefile.hpp"
+#include "simulator.hpp"
+#include "tablefile.hpp"
+
+/* Private defines */
+#define SIM_DEFAULT_HANDS		1000000ULL
+#define SIM_MAX_DECKS			8
+// Stratified runs: share of the hands, in percent, and least hands per stratum
+// of the pilot pass estimating the strata variances
+#define SIM_PILOT_PERCENT		10
+#define SIM_PILOT_MIN_HANDS		20
+// Importance sampled runs: cards of each hand drawn weighted, per target
+#define SIM_SUITED_WEIGHTED_CARDS	4
+#define SIM_LOW_WEIGHTED_CARDS		10
+// Struct sizes of the SIM_API_STABLE_VERSION layouts, up to their last field
+#define SIM_STABLE_CONFIG_SIZE		(offsetof(TSimConfig, shoesPath) + sizeof(const char *))
+#define SIM_STABLE_RESULTS_SIZE		(offsetof(TSimResults, meanWeight) + sizeof(double))
+
+static_assert((SIM_PAIRS_OUTCOMES == PAIRS_OUTCOMES_NR) && (SIM_THREE_OUTCOMES ==
+		THREE_OUTCOMES_NR), "Side bet outcomes of the C interface and the engine differ");
+static_assert(SIM_RARE_EVENTS == RARE_EVENTS_NR, "Rare events of the C interface and the "
+		"observer differ");
+
+/*
+ * Simulation run for one rule set. Instantiated by dispatchRules() so the
+ * hand loop runs on an engine specialized on the configured rules.
+ */
+class TSimRunner
+	{
+	public:
+		TSimRunner(const TSimConfig &config, TSimResults &results) :
+			mConfig(config), mResults(results) {};
+		template <typename TRules> int run(void);
+
+	private:
+		// Rounds of the multi seat table engine
+		template <typename TRules> int runTable(const TDealer &dealer,
+				const TStrategy &strategy);
+		// Two policies hand by hand on the same shoes
+		template <typename TRules> int runPaired(const TDealer &dealer,
+				const TStrategy &strategy, const TStrategy &paired);
+		// One player engine hands off the top of the shoe, stratified
+		template <typename TRules> int runStratified(const TDealer &dealer,
+				const TStrategy &strategy);
+		// One player engine hands off the top of weighted shoes
+		template <typename TRules> int runImportance(const TDealer &dealer,
+				const TStrategy &strategy);
+		// One player engine hands stored in a hand history
+		template <typename TRules> int runHistory(const TDealer &dealer,
+				const TStrategy &strategy);
+		// Add a one player engine hand to the histogram and count buckets
+		void addHand(double trueCount, double net);
+		// Publish the one player engine totals to the live stats slot
+		void publishLive(unsigned long long hands,
+				std::chrono::steady_clock::time_point start);
+		// Copy the one player engine stats into the results
+		template <typename TRules, typename TObserver>
+				void copyStats(const TBlackjack<TRules, TObserver> &bljck);
+
+	private:
+		const TSimConfig &mConfig;
+		TSimResults &mResults;
+	};
+
+/*
+ * Play the configured hands on a TRules engine
+ * @return: - 0 - Success simulating
+ */
+template <typename TRules>
+	int
+TSimRunner::run
+	(
+	void
+	)
+	{
+	bool paired = (mConfig.pairedPolicy != SIM_POLICY_NR);
+	TStrategy strategy((TPolicyType)mConfig.policy);
+	TStrategy pairedStrategy((TPolicyType)(paired ? mConfig.pairedPolicy : mConfig.policy));
+	// Mapped for the run only, every simulation in the process shares its pages
+	TTableFile tables;
+	if ((mConfig.policy == SIM_POLICY_TABLES) || (paired &&
+			(mConfig.pairedPolicy == SIM_POLICY_TABLES)))
+		{
+		if (!mConfig.tablesPath || tables.open(mConfig.tablesPath))
+			return -1;
+		if ((mConfig.policy == SIM_POLICY_TABLES) &&
+				strategy.bindTables(tables, TRules::FLAGS, mConfig.decks))
+			return -1;
+		if ((mConfig.pairedPolicy == SIM_POLICY_TABLES) &&
+				pairedStrategy.bindTables(tables, TRules::FLAGS, mConfig.decks))
+			return -1;
+		}
+	TDealer dealer(mConfig.seed, mConfig.decks);
+	if (dealer.setRemovedRanks(mConfig.removed))
+		return -1;
+	// Shards deal from their own slice of the corpus, the way they play on their
+	// own seed streams
+	TShoeFile shoes;
+	if (mConfig.shoesPath)
+		{
+		unsigned int shardsNr = mConfig.shardsNr ? mConfig.shardsNr : 1;
+		if (shoes.open(mConfig.shoesPath) || (shoes.getShoesNr() < shardsNr) ||
+				dealer.setShoeFile(&shoes, mConfig.shard * (shoes.getShoesNr() / shardsNr),
+				shoes.getShoesNr() / shardsNr))
+			return -1;
+		}
+	if (mConfig.seats)
+		return runTable<TRules>(dealer, strategy);
+	if (paired)
+		return runPaired<TRules>(dealer, strategy, pairedStrategy);
+	if (mConfig.historyPath)
+		return runHistory<TRules>(dealer, strategy);
+	if (mConfig.stratified)
+		return runStratified<TRules>(dealer, strategy);
+	if (mConfig.importance != SIM_IMPORTANCE_NONE)
+		return runImportance<TRules>(dealer, strategy);
+	TBlackjack<TRules> bljck(dealer, &strategy);
+	if (mConfig.shufflePeriod)
+		bljck.setShufflePeriod(mConfig.shufflePeriod);
+	TCards cardDeck;
+	cardDeck.reserve(mConfig.decks * 52);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned long long i = 0; i < mConfig.hands; i++)
+		{
+		double trueCount = bljck.isShuffleDue() ? 0.0 : bljck.getDealer().getTrueCount();
+		bljck.playHand(cardDeck);
+		addHand(trueCount, bljck.getLastHandNet());
+		if (mConfig.live && !((i + 1) & (SIM_LIVE_HANDS - 1)))
+			publishLive(i + 1, start);
+		}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	if (mConfig.live)
+		publishLive(mConfig.hands, start);
+
+	copyStats(bljck);
+	mResults.elapsedSecs = elapsed.count();
+	return 0;
+	}
+
+/*
+ * Add a one player engine hand to the histogram and count buckets
+ * Net results are multiples of a tenth of a bet under every rule set, so they
+ * add up exactly as integers, whatever the order shards are merged in.
+ */
+	void
+TSimRunner::addHand
+	(
+	double trueCount,		// Hi-Lo true count at the start of the hand
+	double net				// Hand net result, in bets
+	)
+	{
+	long long tenths = llround(net * 10.0);
+	mResults.netTenths += tenths;
+	mResults.netSquaredTenths += (unsigned long long)(tenths * tenths);
+	long long bucket = tenths + SIM_NET_TENTHS_MAX;
+	mResults.netHistogram[(bucket < 0) ? 0 : ((bucket >= SIM_NET_BUCKETS) ?
+			SIM_NET_BUCKETS - 1 : bucket)]++;
+	int count = (int)floor(trueCount) - SIM_COUNT_MIN;
+	count = (count < 0) ? 0 : ((count >= SIM_COUNT_BUCKETS) ? SIM_COUNT_BUCKETS - 1 : count);
+	mResults.countHands[count]++;
+	mResults.countNetTenths[count] += tenths;
+	}
+
+/*
+ * Publish the one player engine totals to the live stats slot. Called every
+ * SIM_LIVE_HANDS hands: the slot is the worker own cache line, no lock taken
+ */
+	void
+TSimRunner::publishLive
+	(
+	unsigned long long 								hands,	// Hands played so far
+	std::chrono::steady_clock::time_point 	start		// Start of the hand loop
+	)
+	{
+	TLiveSnapshot snapshot;
+	snapshot.hands = hands;
+	snapshot.netTenths = mResults.netTenths;
+	snapshot.netSquaredTenths = mResults.netSquaredTenths;
+	snapshot.elapsedNanos = (unsigned long long)std::chrono::duration_cast<
+			std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	mConfig.live->publish(snapshot);
+	}
+
+/*
+ * Play the configured hands on an engine storing every decision in the hand
+ * history of TSimConfig.historyPath (see THistoryObserver)
+ * @return: - 0 - Success simulating
+ */
+template <typename TRules>
+	int
+TSimRunner::runHistory
+	(
+	const TDealer 		&dealer,			// Configured dealer
+	const TStrategy 	&strategy		// Player policy
+	)
+	{
+	TBlackjack<TRules, THistoryObserver> bljck(dealer, &strategy);
+	if (mConfig.shufflePeriod)
+		bljck.setShufflePeriod(mConfig.shufflePeriod);
+	TCards cardDeck;
+	cardDeck.reserve(mConfig.decks * TDealer::CARDS_PER_DECK);
+	THistoryWriter history;
+	if (history.create(mConfig.historyPath, TRules::FLAGS, mConfig.decks,
+			mConfig.policy, mConfig.seed))
+		return -1;
+	bljck.getObserver().setWriter(&history);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned long long i = 0; i < mConfig.hands; i++)
+		{
+		double trueCount = bljck.isShuffleDue() ? 0.0 : bljck.getDealer().getTrueCount();
+		if (bljck.playHand(cardDeck))
+			history.dropHand();
+		addHand(trueCount, bljck.getLastHandNet());
+		if (mConfig.live && !((i + 1) & (SIM_LIVE_HANDS - 1)))
+			publishLive(i + 1, start);
+		}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	if (mConfig.live)
+		publishLive(mConfig.hands, start);
+	if (history.close())
+		return -1;
+
+	copyStats(bljck);
+	mResults.elapsedSecs = elapsed.count();
+	return 0;
+	}
+
+/* Hands and net results of a stratum of a stratified run */
+typedef struct __Stratum__
+	{
+	unsigned int top[TDealer::MAX_TOP_CARDS];	// Cards forced, in dealing order: player
+												// cards, hole card (any) and up card
+	double probability;						// Exact, from the shoe composition
+	unsigned long long hands;
+	long long netTenths;
+	unsigned long long netSquaredTenths;
+	}TStratum;
+
+/*
+ * Mean and sample variance of a stratum net results, in bets
+ */
+	static void
+stratumStats
+	(
+	const TStratum 	&stratum,		// Stratum played
+	double 				&mean,			// Out argument
+	double 				&variance		// Out argument
+	)
+	{
+	mean = variance = 0.0;
+	if (!stratum.hands)
+		return;
+	double n = (double)stratum.hands;
+	mean = (double)stratum.netTenths / 10.0 / n;
+	if (stratum.hands > 1)
+		variance = ((double)stratum.netSquaredTenths / 100.0 - n * mean * mean) / (n - 1.0);
+	if (variance < 0.0)
+		variance = 0.0;
+	}
+
+/*
+ * Play the configured hands off the top of fresh shoes, stratified on the
+ * player cards and the dealer up card
+ * The probability of every (player pair, up card) stratum is exact from the
+ * shoe composition. A pilot pass plays a share of the hands in proportion to
+ * them, to estimate the variance of each stratum, and the rest of the hands
+ * go where they cut the variance of the combined estimate most (Neyman
+ * allocation, in proportion to probability times standard deviation). The
+ * strata means are combined with their exact probabilities, so the estimate
+ * carries none of the variance of which cards were dealt.
+ * @return: - 0 - Success simulating. Otherwise,
+ * 			Error (fewer hands than the pilot pass needs)
+ */
+template <typename TRules>
+	int
+TSimRunner::runStratified
+	(
+	const TDealer 		&dealer,			// Configured dealer
+	const TStrategy 	&strategy		// Player policy
+	)
+	{
+	// Shoe composition, per card value
+	TDealer probe(dealer);
+	TCards cardDeck;
+	cardDeck.reserve(mConfig.decks * TDealer::CARDS_PER_DECK);
+	if (probe.shuffle(cardDeck))
+		return -1;
+	const unsigned int *left = probe.getCardsLeft();
+	double size = (double)cardDeck.size();
+	if (size < TDealer::MAX_TOP_CARDS)
+		return -1;
+
+	std::vector<TStratum> strata;
+	unsigned long long pilotHands = 0;
+	for (unsigned int a = 1; a <= TDealer::VALUES_NR; a++)
+		for (unsigned int b = a; b <= TDealer::VALUES_NR; b++)
+			for (unsigned int up = 1; up <= TDealer::VALUES_NR; up++)
+				{
+				double second = (double)left[b] - ((b == a) ? 1.0 : 0.0);
+				double third = (double)left[up] - ((up == a) ? 1.0 : 0.0) -
+						((up == b) ? 1.0 : 0.0);
+				if (!left[a] || (second <= 0.0) || (third <= 0.0))
+					continue;
+				TStratum stratum;
+				memset((void *)&stratum, 0, sizeof(stratum));
+				stratum.top[0] = a;
+				stratum.top[1] = b;
+				stratum.top[3] = up;
+				// Either player card first
+				stratum.probability = ((b == a) ? 1.0 : 2.0) * (double)left[a] / size *
+						second / (size - 1.0) * third / (size - 2.0);
+				unsigned long long pilot = (unsigned long long)(stratum.probability *
+						(double)mConfig.hands * SIM_PILOT_PERCENT / 100.0);
+				stratum.hands = (pilot < SIM_PILOT_MIN_HANDS) ? SIM_PILOT_MIN_HANDS : pilot;
+				pilotHands += stratum.hands;
+				strata.push_back(stratum);
+				}
+	if (pilotHands > mConfig.hands)
+		{
+		log(LOG_ERR, "Stratified runs need at least " + std::to_string(pilotHands) +
+				" hands\n");
+		return -1;
+		}
+
+	TBlackjack<TRules> bljck(dealer, &strategy);
+	bljck.setShufflePeriod(1);
+	TDealer &shoe = bljck.getDealer();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned int pass = 0; pass < 2; pass++)
+		{
+		// Pilot pass hands, then the hands allocated to each stratum
+		std::vector<unsigned long long> hands(strata.size());
+		if (!pass)
+			for (unsigned int s = 0; s < strata.size(); s++)
+				hands[s] = strata[s].hands;
+		else
+			{
+			std::vector<double> share(strata.size());
+			double shares = 0.0, neyman = 0.0;
+			for (unsigned int s = 0; s < strata.size(); s++)
+				{
+				double mean, variance;
+				stratumStats(strata[s], mean, variance);
+				share[s] = strata[s].probability * sqrt(variance);
+				neyman += share[s];
+				}
+			// Hands the pilot pass already played count towards the allocation
+			for (unsigned int s = 0; s < strata.size(); s++)
+				{
+				share[s] = neyman ? (double)mConfig.hands * share[s] / neyman -
+						(double)strata[s].hands : strata[s].probability;
+				if (share[s] < 0.0)
+					share[s] = 0.0;
+				shares += share[s];
+				}
+			unsigned long long rest = mConfig.hands - pilotHands, allocated = 0;
+			for (unsigned int s = 0; s < strata.size(); s++)
+				{
+				hands[s] = shares ? (unsigned long long)((double)rest * share[s] / shares) : 0;
+				allocated += hands[s];
+				}
+			// Rounding leftovers, a hand each
+			for (unsigned int s = 0; (allocated < rest) && (s < strata.size()); s++)
+				if (share[s] > 0.0)
+					{
+					hands[s]++;
+					allocated++;
+					}
+			hands[0] += rest - allocated;
+			}
+
+		for (unsigned int s = 0; s < strata.size(); s++)
+			{
+			TStratum &stratum = strata[s];
+			if (!hands[s] || shoe.setTopValues(stratum.top, TDealer::MAX_TOP_CARDS))
+				continue;
+			if (pass)
+				stratum.hands += hands[s];
+			for (unsigned long long i = 0; i < hands[s]; i++)
+				{
+				bljck.playHand(cardDeck);
+				long long tenths = llround(bljck.getLastHandNet() * 10.0);
+				stratum.netTenths += tenths;
+				stratum.netSquaredTenths += (unsigned long long)(tenths * tenths);
+				addHand(0.0, bljck.getLastHandNet());
+				}
+			}
+		}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	shoe.setTopValues(NULL, 0);
+
+	// Exact weights: the variance of the estimate is the strata variances only
+	double ev = 0.0, variance = 0.0, spread = 0.0;
+	for (unsigned int s = 0; s < strata.size(); s++)
+		{
+		double mean, stratumVariance;
+		stratumStats(strata[s], mean, stratumVariance);
+		ev += strata[s].probability * mean;
+		if (strata[s].hands)
+			variance += strata[s].probability * strata[s].probability * stratumVariance /
+					(double)strata[s].hands;
+		}
+	// Variance of a hand off the top: within plus between the strata
+	for (unsigned int s = 0; s < strata.size(); s++)
+		{
+		double mean, stratumVariance;
+		stratumStats(strata[s], mean, stratumVariance);
+		spread += strata[s].probability * (stratumVariance + (mean - ev) * (mean - ev));
+		}
+
+	copyStats(bljck);
+	mResults.elapsedSecs = elapsed.count();
+	mResults.strataNr = strata.size();
+	mResults.stratifiedEv = ev;
+	mResults.stratifiedStdErr = sqrt(variance);
+	mResults.plainStdErr = sqrt(spread / (double)mConfig.hands);
+	return 0;
+	}
+
+/*
+ * Play the configured hands off the top of fresh weighted shoes, the rare
+ * events and the net result of each hand weighted with its likelihood ratio
+ * The shoe deals the cards of the target more often, so the rare events take
+ * place far more often than in plain hands, and the likelihood ratio of the
+ * cards the hand was dealt (plain over weighted probability) takes the bias
+ * back out: the weighted means are unbiased estimates of the plain ones. A
+ * fresh shoe per hand keeps each ratio to the cards of its hand.
+ * @return: - 0 - Success simulating. Otherwise,
+ * 			Error (invalid target or tilt)
+ */
+template <typename TRules>
+	int
+TSimRunner::runImportance
+	(
+	const TDealer 		&dealer,			// Configured dealer
+	const TStrategy 	&strategy		// Player policy
+	)
+	{
+	double tilt = mConfig.importanceTilt ? mConfig.importanceTilt : SIM_DEFAULT_TILT;
+	// The suited events are in the first four cards, seven card 21s in the first
+	// cards of the player: later cards drawn weighted would only add weight noise
+	bool suited = (mConfig.importance == SIM_IMPORTANCE_SUITED);
+	double rankWeights[TDealer::RANKS_NR];
+	for (unsigned int r = 0; r < TDealer::RANKS_NR; r++)
+		rankWeights[r] = ((mConfig.importance == SIM_IMPORTANCE_LOW_CARDS) && (r < 4)) ?
+				tilt : 1.0;
+
+	TBlackjack<TRules, TRareObserver> bljck(dealer, &strategy);
+	bljck.setShufflePeriod(1);
+	TDealer &shoe = bljck.getDealer();
+	if (shoe.setDrawWeights(rankWeights, suited ? tilt : 1.0, suited ?
+			SIM_SUITED_WEIGHTED_CARDS : SIM_LOW_WEIGHTED_CARDS))
+		return -1;
+	TCards cardDeck;
+	cardDeck.reserve(mConfig.decks * TDealer::CARDS_PER_DECK);
+	TRunningStats weights;
+	TRunningStats net;
+	TRunningStats rare[SIM_RARE_EVENTS];
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned long long i = 0; i < mConfig.hands; i++)
+		{
+		if (bljck.playHand(cardDeck))
+			{
+			bljck.getObserver().reset();
+			continue;
+			}
+		double weight = shoe.getLikelihood();
+		unsigned int events = bljck.getObserver().getEvents();
+		addHand(0.0, bljck.getLastHandNet());
+		weights.add(weight);
+		net.add(weight * bljck.getLastHandNet());
+		for (unsigned int e = 0; e < SIM_RARE_EVENTS; e++)
+			{
+			bool hit = events & (1 << e);
+			mResults.rareHits[e] += hit;
+			rare[e].add(hit ? weight : 0.0);
+			}
+		}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	shoe.setDrawWeights(NULL);
+
+	copyStats(bljck);
+	mResults.elapsedSecs = elapsed.count();
+	mResults.weightedEv = net.getMean();
+	mResults.weightedEvStdErr = net.getStdErr();
+	mResults.meanWeight = weights.getMean();
+	for (unsigned int e = 0; e < SIM_RARE_EVENTS; e++)
+		{
+		double rate = rare[e].getMean();
+		mResults.rareRates[e] = rate;
+		mResults.rareStdErrs[e] = rare[e].getStdErr();
+		mResults.rarePlainStdErrs[e] = (rare[e].getCount() && (rate > 0.0) && (rate < 1.0)) ?
+				sqrt(rate * (1.0 - rate) / (double)rare[e].getCount()) : 0.0;
+		}
+	return 0;
+	}
+
+/*
+ * Play the configured hands with two policies on the same shoes
+ * Both engines shuffle the same shoe at the same hand and every hand starts
+ * from the same cards for both, so most of the shoe luck cancels out in the
+ * per hand difference of their results.
+ * @return: - 0 - Success simulating
+ */
+template <typename TRules>
+	int
+TSimRunner::runPaired
+	(
+	const TDealer 		&dealer,			// Configured dealer
+	const TStrategy 	&strategy,		// Policy of the results
+	const TStrategy 	&paired			// Policy compared against
+	)
+	{
+	TBlackjack<TRules> bljck(dealer, &strategy);
+	TBlackjack<TRules> pairedBljck(dealer, &paired);
+	if (mConfig.shufflePeriod)
+		{
+		bljck.setShufflePeriod(mConfig.shufflePeriod);
+		pairedBljck.setShufflePeriod(mConfig.shufflePeriod);
+		}
+	TCards cardDeck;
+	TCards pairedDeck;
+	cardDeck.reserve(mConfig.decks * TDealer::CARDS_PER_DECK);
+	pairedDeck.reserve(mConfig.decks * TDealer::CARDS_PER_DECK);
+	TRunningStats net;
+	TRunningStats pairedNet;
+	TRunningStats diff;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned long long i = 0; i < mConfig.hands; i++)
+		{
+		// Same cards and count for both, capacity reserved: no allocation
+		pairedDeck.assign(cardDeck.begin(), cardDeck.end());
+		pairedBljck.followShoe(bljck);
+		bljck.playHand(cardDeck);
+		pairedBljck.playHand(pairedDeck);
+		net.add(bljck.getLastHandNet());
+		pairedNet.add(pairedBljck.getLastHandNet());
+		diff.add(bljck.getLastHandNet() - pairedBljck.getLastHandNet());
+		}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	copyStats(bljck);
+	mResults.elapsedSecs = elapsed.count();
+	mResults.netTenths = llround(mResults.netUnits * 10.0);
+	mResults.pairedNetUnits = pairedBljck.getNetUnits();
+	mResults.diffMean = diff.getMean();
+	mResults.diffStdErr = diff.getStdErr();
+	mResults.unpairedStdErr = sqrt((net.getVariance() + pairedNet.getVariance()) /
+			(double)(diff.getCount() ? diff.getCount() : 1));
+	return 0;
+	}
+
+/*
+ * Copy the one player engine stats into the results
+ */
+template <typename TRules, typename TObserver>
+	void
+TSimRunner::copyStats
+	(
+	const TBlackjack<TRules, TObserver> &bljck		// Engine that played the hands
+	)
+	{
+	const TBlackJackStats &stats = bljck.getStats();
+	mResults.handsPlayed = stats.successPlyd;
+	mResults.pushes = stats.pushes;
+	mResults.userBusts = stats.userBusts;
+	mResults.dealerBusts = stats.dealerBusts;
+	mResults.userWins = stats.userWins;
+	mResults.userNaturals = stats.userNaturals;
+	mResults.dealerWins = stats.dealerWins;
+	mResults.errors = stats.errors;
+	mResults.netUnits = bljck.getNetUnits();
+	mResults.rounds = stats.successPlyd;
+	mResults.doubles = stats.doubles;
+	mResults.doubleWins = stats.doubleWins;
+	mResults.doublePushes = stats.doublePushes;
+	mResults.splits = stats.splits;
+	mResults.splitHands = stats.splitHands;
+	mResults.splitWins = stats.splitWins;
+	mResults.surrenders = stats.surrenders;
+	mResults.insurances = stats.insurances;
+	mResults.insuranceWins = stats.insuranceWins;
+	memcpy(mResults.pairsOutcomes, stats.pairsOutcomes, sizeof(mResults.pairsOutcomes));
+	memcpy(mResults.threeOutcomes, stats.threeOutcomes, sizeof(mResults.threeOutcomes));
+	}
+
+/*
+ * Play the configured rounds on a TRules table and add up every seat
+ * @return: - 0 - Success simulating
+ */
+template <typename TRules>
+	int
+TSimRunner::runTable
+	(
+	const TDealer 		&dealer,			// Configured dealer
+	const TStrategy 	&strategy		// Policy every seat plays
+	)
+	{
+	TBlackjackTable<TRules> table(dealer, &strategy, mConfig.seats);
+	if (mConfig.shufflePeriod)
+		table.setShufflePeriod(mConfig.shufflePeriod);
+	TCards cardDeck;
+	cardDeck.reserve(mConfig.decks * TDealer::CARDS_PER_DECK);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned long long i = 0; i < mConfig.hands; i++)
+		table.playRound(cardDeck);
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	for (unsigned int s = 0; s < table.getSeats(); s++)
+		{
+		const TBlackJackStats &stats = table.getStats(s);
+		mResults.handsPlayed += stats.successPlyd;
+		mResults.pushes += stats.pushes;
+		mResults.userBusts += stats.userBusts;
+		mResults.dealerBusts += stats.dealerBusts;
+		mResults.userWins += stats.userWins;
+		mResults.userNaturals += stats.userNaturals;
+		mResults.dealerWins += stats.dealerWins;
+		mResults.errors += stats.errors;
+		mResults.netUnits += table.getNetUnits(s);
+		for (unsigned int i = 0; i < SIM_PAIRS_OUTCOMES; i++)
+			mResults.pairsOutcomes[i] += stats.pairsOutcomes[i];
+		for (unsigned int i = 0; i < SIM_THREE_OUTCOMES; i++)
+			mResults.threeOutcomes[i] += stats.threeOutcomes[i];
+		}
+	mResults.netTenths = llround(mResults.netUnits * 10.0);
+	mResults.elapsedSecs = elapsed.count();
+	mResults.rounds = table.getRounds();
+	mResults.dealerPlays = table.getDealerPlays();
+	return 0;
+	}
+
+/*
+ * Fill a configuration with the default values
+ */
+	void
+simInitConfig
+	(
+	TSimConfig *config		// Out argument
+	)
+	{
+	if (!config)
+		return;
+
+	memset((void *)config, 0, sizeof(*config));
+	config->apiVersion = SIM_API_VERSION;
+	config->configSize = sizeof(TSimConfig);
+	config->resultsSize = sizeof(TSimResults);
+	config->rules = SIM_RULES_HOUSE;
+	config->decks = 1;
+	config->policy = SIM_POLICY_BASIC;
+	config->seed = 0;
+	config->hands = SIM_DEFAULT_HANDS;
+	config->pairedPolicy = SIM_POLICY_NR;
+	}
+
+/*
+ * Play config->hands hands of a configuration of this layout and return the
+ * game stats
+ * @return: - 0 - Success simulating. Otherwise,
+ * 			Error (invalid configuration)
+ */
+	static int
+simulateLayout
+	(
+	const TSimConfig *config,		// In
+	TSimResults 	  *results		// Out argument
+	)
+	{
+	int ret = -1;   // Assume error simulating
+	if (			(config->rules >= SIM_RULES_NR) || (config->policy >= SIM_POLICY_NR) ||
+			!config->decks || (config->decks > SIM_MAX_DECKS) ||
+			(config->seats > SIM_MAX_SEATS) || (config->pairedPolicy > SIM_POLICY_NR) ||
+			(config->seats && (config->policy == SIM_POLICY_FULL_BASIC)) ||
+			((config->pairedPolicy != SIM_POLICY_NR) && config->seats) ||
+			(config->historyPath && (config->seats || (config->pairedPolicy != SIM_POLICY_NR))) ||
+			(config->live && (config->seats || (config->pairedPolicy != SIM_POLICY_NR))) ||
+			(config->stratified && (config->seats || (config->pairedPolicy != SIM_POLICY_NR) ||
+			config->historyPath || config->live || (config->shardsNr > 1))) ||
+			(config->importance >= SIM_IMPORTANCE_NR) || (config->importanceTilt < 0.0) ||
+			((config->importance != SIM_IMPORTANCE_NONE) && (config->seats ||
+			(config->pairedPolicy != SIM_POLICY_NR) || config->historyPath || config->live ||
+			(config->shardsNr > 1) || config->stratified)) ||
+			(config->shoesPath && (config->stratified ||
+			(config->importance != SIM_IMPORTANCE_NONE))) ||
+			(config->shardsNr > SIM_MAX_SHARDS) || (config->shard >= (config->shardsNr ?
+			config->shardsNr : 1)))
+		return ret;
+
+	memset((void *)results, 0, sizeof(*results));
+	// A shard plays its share of the hands on its own seed stream
+	TSimConfig shardConfig = *config;
+	if (config->shardsNr > 1)
+		{
+		shardConfig.hands = config->hands / config->shardsNr +
+				((config->shard < (config->hands % config->shardsNr)) ? 1 : 0);
+		shardConfig.seed = mixSeed(config->seed, config->shard);
+		}
+	try
+		{
+		TSimRunner runner(shardConfig, *results);
+		ret = dispatchRules(config->rules, runner);
+		}
+	catch (std::exception &e)
+		{
+		// Never let exceptions cross the C interface
+		ret = -1;
+		}
+
+	return ret;
+	}
+
+/*
+ * Play config->hands hands and return the game stats. Structs of an older
+ * stable layout are copied into this layout, the fields they lack taking
+ * their default values, and only the results fields the caller has are
+ * written back.
+ * @return: - 0 - Success simulating. Otherwise,
+ * 			Error (invalid configuration or API version)
+ */
+	int
+simulate
+	(
+	const TSimConfig *config,		// In
+	TSimResults 	  *results		// Out argument
+	)
+	{
+	int ret = -1;   // Assume error simulating
+	if (!config || !results || (config->apiVersion < SIM_API_STABLE_VERSION) ||
+			(config->apiVersion > SIM_API_VERSION) ||
+			(config->configSize < SIM_STABLE_CONFIG_SIZE) ||
+			(config->resultsSize < SIM_STABLE_RESULTS_SIZE))
+		return ret;
+	if ((config->configSize >= sizeof(TSimConfig)) &&
+			(config->resultsSize >= sizeof(TSimResults)))
+		return simulateLayout(config, results);
+
+	TSimConfig current;
+	simInitConfig(&current);
+	memcpy((void *)&current, (const void *)config, (config->configSize < sizeof(current)) ?
+			config->configSize : sizeof(current));
+	current.configSize = sizeof(current);
+	current.resultsSize = sizeof(TSimResults);
+	TSimResults currentResults;
+	ret = simulateLayout(&current, &currentResults);
+	memcpy((void *)results, (const void *)&currentResults,
+			(config->resultsSize < sizeof(currentResults)) ? config->resultsSize :
+			sizeof(currentResults));
+	return ret;
+	}
@@ -0,0 +1,231 @@
+/******************************************************************************/
+/*!
+ * @file:					  simulator.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The libblackjack batch simulation API. Plays hands in
+ *  					process without console I/O. Usable from C and C++.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __SIMULATOR_HPP__
+#define __SIMULATOR_HPP__
+
+/* Defines */
+
+/*
+ * Version of the TSimConfig/TSimResults layout. From SIM_API_STABLE_VERSION on
+ * the layouts only grow: new fields are appended and the version bumped, and
+ * simulate() accepts the smaller structs of callers built against an older
+ * stable version (see TSimConfig configSize and resultsSize).
+ */
+#define SIM_API_VERSION				15
+#define SIM_API_STABLE_VERSION	15
+
+// Card ranks, Ace (1) to King (13)
+#define SIM_RANKS_NR			13
+
+// Seats at a multi seat table
+#define SIM_MAX_SEATS		7
+
+// Shards a run can be split in (see TSimConfig::shardsNr)
+#define SIM_MAX_SHARDS		4096
+
+// Hands between live stats publishes (see TSimConfig::live), a power of two
+#define SIM_LIVE_HANDS		4096
+
+// Per hand net result histogram, in tenths of a bet from -SIM_NET_TENTHS_MAX
+#define SIM_NET_TENTHS_MAX	90
+#define SIM_NET_BUCKETS		(2 * SIM_NET_TENTHS_MAX + 1)
+
+// Hi-Lo true count buckets, floored true count at the start of the hand
+#define SIM_COUNT_MIN		-5
+#define SIM_COUNT_BUCKETS	16
+// Side bet outcomes: Perfect Pairs (none, mixed, colored, perfect) and 21+3
+// (none, flush, straight, three of a kind, straight flush, suited trips)
+#define SIM_PAIRS_OUTCOMES	4
+#define SIM_THREE_OUTCOMES	6
+// Rare events of importance sampled runs: seven card 21, suited natural, Perfect
+// Pairs perfect pair, 21+3 straight flush and 21+3 suited trips
+#define SIM_RARE_EVENTS		5
+// Weight of the favored cards of importance sampled runs by default
+#define SIM_DEFAULT_TILT	4.0
+
+/* Enumerations, type defines */
+
+/* Rule set flags, OR-ed together. Same values as TRuleFlags */
+typedef enum __SimRules__
+	{
+	SIM_RULES_HOUSE			= 0,			// Virtual blackjack rules (see './blackjack -h')
+	SIM_RULES_STAND_SOFT_17	= 1 << 0,	// Dealer stands on soft 17
+	SIM_RULES_PUSH_TIES		= 1 << 1,	// Equal scores are a push
+	SIM_RULES_PAY_6_5			= 1 << 2,	// Naturals pay 6:5 instead of 3:2
+	SIM_RULES_NR				= 1 << 3
+	}TSimRules;
+
+/* Player policies. Same values as TPolicyType */
+typedef enum __SimPolicy__
+	{
+	SIM_POLICY_BASIC,				// Hit/stand basic strategy
+	SIM_POLICY_MIMIC_DEALER,	// Play as the dealer does
+	SIM_POLICY_NEVER_BUST,		// Never hit a hand that could bust
+	SIM_POLICY_TABLES,			// Per true count tables of the table file at tablesPath
+	SIM_POLICY_FULL_BASIC,		// Basic strategy with doubles, splits and surrender
+	SIM_POLICY_NR
+	}TSimPolicy;
+
+/* Importance sampling targets: cards the weighted shoe deals more often */
+typedef enum __SimImportance__
+	{
+	SIM_IMPORTANCE_NONE,			// Plain shoe
+	SIM_IMPORTANCE_LOW_CARDS,	// Aces to fours, for seven card 21s
+	SIM_IMPORTANCE_SUITED,		// The suit of the first card dealt, for suited naturals
+										// and the side bet top tiers
+	SIM_IMPORTANCE_NR
+	}TSimImportance;
+
+/* Simulation configuration. Initialize with simInitConfig() */
+typedef struct __SimConfig__
+	{
+	unsigned int apiVersion;	// SIM_API_STABLE_VERSION to SIM_API_VERSION
+	unsigned int configSize;	// sizeof(TSimConfig) of the caller. Fields past it take
+										// their simInitConfig() values
+	unsigned int resultsSize;	// sizeof(TSimResults) of the caller. Fields past it are
+										// not written
+	unsigned int rules;			// TSimRules flags
+	unsigned int decks;			// Decks in the shoe
+	unsigned int policy;			// TSimPolicy
+	unsigned long long seed;	// Shuffle seed. Same seed, same results
+	unsigned long long hands;	// Hands to play
+	unsigned int shufflePeriod;	// Hands between shuffles. 0, six hands per deck
+	unsigned int removed[SIM_RANKS_NR];	// Cards left out of the shoe, per rank (Ace first)
+	const char *tablesPath;		// Table file (see tablefile.hpp) for SIM_POLICY_TABLES
+	unsigned int seats;			// 0, one player hands engine. 1 to SIM_MAX_SEATS,
+										// table engine playing rounds of that many seats.
+										// Seats hit and stand only: SIM_POLICY_FULL_BASIC is
+										// one player engine only
+	unsigned int pairedPolicy;	// SIM_POLICY_NR, single policy run. Otherwise, TSimPolicy
+										// played against 'policy' hand by hand on the same
+										// shoes (common random numbers). One player engine only
+	unsigned int shard;			// Shard played, 0 to shardsNr - 1
+	unsigned int shardsNr;		// 0 or 1, whole run. Otherwise, the hands are split in
+										// that many shards with their own seed streams
+	const char *historyPath;	// Hand history store directory (see history.hpp) to
+										// write, NULL none. One player engine, unpaired only
+	struct __LiveSlot__ *live;	// Live stats slot (see livestats.hpp) the run totals
+										// are published to every SIM_LIVE_HANDS hands, NULL
+										// none. One player engine, unpaired only
+	unsigned int stratified;	// Non zero, stratified run: every hand is dealt off the
+										// top of a fresh shoe, its player cards and up card
+										// forced by stratum, and the strata are combined with
+										// their exact probabilities (see TSimResults
+										// stratifiedEv). One player engine, unpaired, whole
+										// run only, no hand history or live stats
+	unsigned int importance;	// TSimImportance. Otherwise SIM_IMPORTANCE_NONE, every hand
+										// is dealt off a fresh weighted shoe and the rare
+										// events are estimated weighted with the likelihood
+										// ratio of its cards (see TSimResults rareRates).
+										// Same limits as stratified runs, not stratified
+	double importanceTilt;		// Weight of the favored cards, the others weigh 1. 0,
+										// SIM_DEFAULT_TILT
+	const char *shoesPath;		// Shoe corpus file (see shoefile.hpp) the shoes are dealt
+										// from instead of shuffled, NULL none. Each shard deals
+										// its share of the corpus, replayed from its start when
+										// used up. Full shoes of 'decks' decks, not stratified
+										// nor importance sampled
+	}TSimConfig;
+
+/*
+ * Simulation results. Table runs add up every seat. Outcomes (pushes to
+ * dealerWins) count split hands one by one.
+ */
+typedef struct __SimResults__
+	{
+	unsigned long long handsPlayed;	// Successfully played (seat) hands
+	unsigned long long pushes;
+	unsigned long long userBusts;
+	unsigned long long dealerBusts;
+	unsigned long long userWins;
+	unsigned long long userNaturals;	// User wins with a natural
+	unsigned long long dealerWins;
+	unsigned long long errors;			// General processing errors
+	double netUnits;						// Player net result in bets
+	double elapsedSecs;					// Wall time playing hands
+	unsigned long long rounds;			// Table rounds. Hands for the one player engine
+	unsigned long long dealerPlays;	// Rounds the dealer had to draw in (table engine)
+	unsigned long long doubles;		// Doubled hands
+	unsigned long long doubleWins;
+	unsigned long long doublePushes;
+	unsigned long long splits;			// Split decisions
+	unsigned long long splitHands;	// Hands the splits ended with
+	unsigned long long splitWins;
+	unsigned long long surrenders;
+	unsigned long long insurances;	// Insurance bets taken
+	unsigned long long insuranceWins;
+	double pairedNetUnits;				// Paired runs: 'pairedPolicy' net result in bets
+	double diffMean;						// Paired runs: mean per hand 'policy' minus
+												// 'pairedPolicy' net result, in bets
+	double diffStdErr;					// Paired standard error of diffMean
+	double unpairedStdErr;				// Standard error diffMean would have from two
+												// independent runs of as many hands
+	long long netTenths;					// Exact player net result, in tenths of a bet
+	unsigned long long netSquaredTenths;	// Sum of the squared per hand net results in
+												// tenths (one player engine)
+	unsigned long long netHistogram[SIM_NET_BUCKETS];	// Hands per net result in tenths,
+												// -SIM_NET_TENTHS_MAX first (one player engine)
+	unsigned long long countHands[SIM_COUNT_BUCKETS];	// Hands per true count bucket,
+												// SIM_COUNT_MIN first, ends clamped (one player engine)
+	long long countNetTenths[SIM_COUNT_BUCKETS];	// Net result per true count bucket
+	unsigned long long pairsOutcomes[SIM_PAIRS_OUTCOMES];	// Hands per Perfect Pairs outcome,
+												// one bet on every dealt hand
+	unsigned long long threeOutcomes[SIM_THREE_OUTCOMES];	// Hands per 21+3 outcome
+	unsigned int strataNr;				// Stratified runs: (player cards, up card) strata
+												// the shoe can deal
+	double stratifiedEv;				// Stratified runs: player net result per hand off the
+												// top of the shoe, in bets. The plain stats above
+												// add up the hands as allocated, not weighted
+	double stratifiedStdErr;			// Standard error of stratifiedEv
+	double plainStdErr;					// Standard error a plain run of as many hands off
+												// the top of the shoe would have
+	unsigned long long rareHits[SIM_RARE_EVENTS];	// Importance sampled runs: hands
+												// each rare event took place in, as dealt
+	double rareRates[SIM_RARE_EVENTS];	// Weighted frequency per hand off the top
+	double rareStdErrs[SIM_RARE_EVENTS];	// Standard error of rareRates
+	double rarePlainStdErrs[SIM_RARE_EVENTS];	// Standard error a plain run of as many
+												// hands would have
+	double weightedEv;					// Importance sampled runs: player net result per
+												// hand off the top, in bets, weighted
+	double weightedEvStdErr;			// Standard error of weightedEv
+	double meanWeight;					// Mean likelihood ratio, 1 but for sampling noise
+	}TSimResults;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Fill a configuration with the layout of this header and the default
+ * values: house rules, one deck,
+ * basic strategy, seed 0, one million hands, six hands per deck between
+ * shuffles, a full shoe, no table file, the one player engine, no paired
+ * policy, no hand history, no live stats, no stratification and no importance
+ * sampling.
+ */
+void simInitConfig (TSimConfig *config);
+
+/*
+ * Play config->hands hands (table rounds if config->seats) and return the
+ * game stats. A shard plays its share of the hands only, the results of all
+ * the shards add up as one run of config->hands hands.
+ * @return: - 0 - Success simulating. Otherwise,
+ * 			Error (invalid configuration or API version)
+ */
+int simulate (const TSimConfig *config, TSimResults *results);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SIMULATOR_HPP__ */
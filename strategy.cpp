@@ -0,0 +1,280 @@
+/******************************************************************************/
+/*!
+ * @file:					  strategy.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements automated player policies.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <string.h>
+
+/* Local includes */
+#include "strategy.hpp"
+#include "tablefile.hpp"
+
+/* Private defines */
+#define ACE_UPCARD				1
+#define DEALER_STAND_SCORE		17
+
+/* Policy command line names, indexed by TPolicyType */
+static const char *policyNames[POLICY_TYPES_NR] =
+	{
+	"basic", "mimic", "never-bust", "tables", "full"
+	};
+
+/* Action names, indexed by TPlayerAction */
+static const char *actionNames[ACTION_TYPES_NR] =
+	{
+	"stand", "hit", "double", "double", "split", "surrender"
+	};
+
+/*
+ * Policy from its command line name
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (unknown name)
+ */
+	int
+policyFromName
+	(
+	const std::string &name,		// Policy name
+	TPolicyType 		&policy		// Out argument
+	)
+	{
+	for (unsigned int i = 0; i < POLICY_TYPES_NR; i++)
+		if (name == policyNames[i])
+			{
+			policy = (TPolicyType)i;
+			return 0;
+			}
+	return -1;
+	}
+
+/*
+ * Policy command line name
+ * @return: Policy name
+ */
+	const char *
+policyName
+	(
+	TPolicyType policy
+	)
+	{
+	return (policy < POLICY_TYPES_NR) ? policyNames[policy] : "unknown";
+	}
+
+/*
+ * Player action human readable name
+ * @return: Action name
+ */
+	const char *
+actionName
+	(
+	TPlayerAction action
+	)
+	{
+	return (action < ACTION_TYPES_NR) ? actionNames[action] : "unknown";
+	}
+
+TStrategy::TStrategy
+	(
+	TPolicyType policy		// Policy the decision table is built from
+	) :
+	mPolicy(policy)
+	{
+	memset((void *)mTable, ACTION_STAND, sizeof(mTable));
+	memset((void *)mCountTables, 0, sizeof(mCountTables));
+	memset((void *)mSplit, 0, sizeof(mSplit));
+	switch (policy)
+		{
+		case POLICY_MIMIC_DEALER:
+			fillMimicDealer();
+			break;
+		case POLICY_NEVER_BUST:
+			fillNeverBust();
+			break;
+		case POLICY_TABLES:
+			// Basic strategy until bound
+			fillBasic();
+			break;
+		case POLICY_FULL_BASIC:
+			fillBasic();
+			fillFullBasic();
+			break;
+		case POLICY_BASIC:
+		default:
+			mPolicy = POLICY_BASIC;
+			fillBasic();
+			break;
+		}
+	}
+
+/*
+ * Use the argued table file tables of a rule set and deck count. Only
+ * pointers into the mapping are kept, so every strategy bound to one file
+ * shares its pages.
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (not a POLICY_TABLES strategy or a true count missing)
+ */
+	int
+TStrategy::bindTables
+	(
+	const TTableFile &file,		// Open table file
+	unsigned int 		rules,		// TRuleFlags
+	unsigned int 		decks			// Decks in the shoe
+	)
+	{
+	if (mPolicy != POLICY_TABLES)
+		return -1;
+
+	const TTable *tables[TRUE_COUNTS_NR];
+	for (int tc = MIN_TRUE_COUNT; tc <= MAX_TRUE_COUNT; tc++)
+		{
+		tables[tc - MIN_TRUE_COUNT] = (const TTable *)file.find(TABLE_STRATEGY, rules,
+				decks, tc);
+		if (!tables[tc - MIN_TRUE_COUNT])
+			return -1;
+		}
+	memcpy((void *)mCountTables, (const void *)tables, sizeof(mCountTables));
+	return 0;
+	}
+
+/*
+ * Hit/stand basic strategy
+ * Rules: 	- Hard 11 or lower: hit.
+ * 			- Hard 12: stand against 4 to 6, otherwise hit.
+ * 			- Hard 13 to 16: stand against 2 to 6, otherwise hit.
+ * 			- Soft 17 or lower: hit.
+ * 			- Soft 18: stand against 2 to 8, otherwise hit.
+ * 			- Hard 17 and soft 19 or higher: stand.
+ */
+	void
+TStrategy::fillBasic
+	(
+	void
+	)
+	{
+	for (unsigned int up = ACE_UPCARD; up <= MAX_UPCARD; up++)
+		{
+		bool weakUp = (up >= 2) && (up <= 6);
+		for (unsigned int score = 0; score <= MAX_SCORE; score++)
+			{
+			// Hard hands
+			if (score <= 11)
+				mTable[0][score][up] = ACTION_HIT;
+			else if (score == 12)
+				mTable[0][score][up] = ((up >= 4) && (up <= 6)) ? ACTION_STAND : ACTION_HIT;
+			else if (score <= 16)
+				mTable[0][score][up] = weakUp ? ACTION_STAND : ACTION_HIT;
+
+			// Soft hands
+			if (score <= 17)
+				mTable[1][score][up] = ACTION_HIT;
+			else if (score == 18)
+				mTable[1][score][up] = ((up >= 2) && (up <= 8)) ? ACTION_STAND : ACTION_HIT;
+			}
+		}
+	}
+
+/*
+ * Mimic the dealer
+ * Rules: 	- Hit 16 or lower and soft 17.
+ */
+	void
+TStrategy::fillMimicDealer
+	(
+	void
+	)
+	{
+	for (unsigned int up = ACE_UPCARD; up <= MAX_UPCARD; up++)
+		for (unsigned int score = 0; score <= MAX_SCORE; score++)
+			{
+			if (score < DEALER_STAND_SCORE)
+				{
+				mTable[0][score][up] = ACTION_HIT;
+				mTable[1][score][up] = ACTION_HIT;
+				}
+			else if (score == DEALER_STAND_SCORE)
+				mTable[1][score][up] = ACTION_HIT;
+			}
+	}
+
+/*
+ * Never bust
+ * Rules: 	- Hit hard 11 or lower and any soft hand below 18.
+ */
+	void
+TStrategy::fillNeverBust
+	(
+	void
+	)
+	{
+	for (unsigned int up = ACE_UPCARD; up <= MAX_UPCARD; up++)
+		for (unsigned int score = 0; score <= MAX_SCORE; score++)
+			{
+			if (score <= 11)
+				mTable[0][score][up] = ACTION_HIT;
+			if (score < 18)
+				mTable[1][score][up] = ACTION_HIT;
+			}
+	}
+
+/*
+ * Doubles, splits and surrender on top of the hit/stand basic strategy
+ * (multi deck, dealer hits soft 17, double after split)
+ * Rules: 	- Hard 9: double against 3 to 6. Hard 10: against 2 to 9.
+ * 			  Hard 11: against any up card.
+ * 			- Soft 13 and 14: double against 5 and 6. Soft 15 and 16: against
+ * 			  4 to 6. Soft 17: against 3 to 6, otherwise hit.
+ * 			- Soft 18: double against 2 to 6, otherwise as basic. Soft 19:
+ * 			  double against 6, otherwise stand.
+ * 			- Surrender hard 16 against 9, 10 and Ace, hard 15 against 10 and Ace.
+ * 			- Split Aces and 8s always. 9s against 2 to 6, 8 and 9. 7s, 3s and
+ * 			  2s against 2 to 7. 6s against 2 to 6. 4s against 5 and 6.
+ */
+	void
+TStrategy::fillFullBasic
+	(
+	void
+	)
+	{
+	for (unsigned int up = ACE_UPCARD; up <= MAX_UPCARD; up++)
+		{
+		bool weakUp = (up >= 2) && (up <= 6);
+		// Hard doubles
+		if ((up >= 3) && (up <= 6))
+			mTable[0][9][up] = ACTION_DOUBLE;
+		if ((up >= 2) && (up <= 9))
+			mTable[0][10][up] = ACTION_DOUBLE;
+		mTable[0][11][up] = ACTION_DOUBLE;
+
+		// Soft doubles
+		if ((up == 5) || (up == 6))
+			mTable[1][13][up] = mTable[1][14][up] = ACTION_DOUBLE;
+		if ((up >= 4) && (up <= 6))
+			mTable[1][15][up] = mTable[1][16][up] = ACTION_DOUBLE;
+		if ((up >= 3) && (up <= 6))
+			mTable[1][17][up] = ACTION_DOUBLE;
+		if (weakUp)
+			mTable[1][18][up] = ACTION_DOUBLE_STAND;
+		if (up == 6)
+			mTable[1][19][up] = ACTION_DOUBLE_STAND;
+
+		// Late surrender
+		if ((up == ACE_UPCARD) || (up >= 9))
+			mTable[0][16][up] = ACTION_SURRENDER;
+		if ((up == ACE_UPCARD) || (up == MAX_UPCARD))
+			mTable[0][15][up] = ACTION_SURRENDER;
+
+		// Splits
+		mSplit[ACE_UPCARD][up] = true;
+		mSplit[8][up] = true;
+		mSplit[9][up] = weakUp || (up == 8) || (up == 9);
+		mSplit[7][up] = mSplit[3][up] = mSplit[2][up] = weakUp || (up == 7);
+		mSplit[6][up] = weakUp;
+		mSplit[4][up] = (up == 5) || (up == 6);
+		}
+	}
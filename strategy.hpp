@@ -0,0 +1,174 @@
+/******************************************************************************/
+/*!
+ * @file:					  strategy.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines automated player policies.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __STRATEGY_HPP__
+#define __STRATEGY_HPP__
+
+/* Library includes */
+#include <math.h>
+#include <stddef.h>
+#include <string>
+
+/* Typedefines */
+
+/* Player decisions. Decision tables may also hold the 'if allowed' entries */
+typedef enum __PlayerAction__
+	{
+	ACTION_STAND,
+	ACTION_HIT,
+	ACTION_DOUBLE,				// Double down, hit if not allowed
+	ACTION_DOUBLE_STAND,		// Double down, stand if not allowed
+	ACTION_SPLIT,
+	ACTION_SURRENDER,			// Surrender, hit if not allowed
+	ACTION_TYPES_NR
+	}TPlayerAction;
+
+/* Actions allowed on top of hit and stand, OR-ed together (see TStrategy::decide()) */
+typedef enum __ActionAllow__
+	{
+	ALLOW_DOUBLE		= 1 << 0,
+	ALLOW_SPLIT			= 1 << 1,
+	ALLOW_SURRENDER	= 1 << 2
+	}TActionAllow;
+
+/* Built in player policies */
+typedef enum __PolicyType__
+	{
+	POLICY_BASIC,			// Hit/stand basic strategy
+	POLICY_MIMIC_DEALER,	// Play as the dealer does (hit up to 16 and on soft 17)
+	POLICY_NEVER_BUST,	// Never hit a hand that could bust
+	POLICY_TABLES,			// Per true count tables from a table file (see bindTables())
+	POLICY_FULL_BASIC,	// Basic strategy with doubles, splits and surrender
+	POLICY_TYPES_NR
+	}TPolicyType;
+
+class TTableFile;
+
+/*
+ * Policy from its command line name ("basic", "mimic", "never-bust", "tables"
+ * or "full")
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (unknown name)
+ */
+int policyFromName (const std::string &name, TPolicyType &policy);
+
+/*
+ * Policy command line name
+ * @return: Policy name
+ */
+const char *policyName (TPolicyType policy);
+
+/*
+ * Player action human readable name
+ * @return: Action name
+ */
+const char *actionName (TPlayerAction action);
+
+/*
+ * The strategy class
+ * Automated player policy. Decisions are a single table lookup indexed by
+ * the player score, whether the score is soft and the dealer up card value.
+ * A POLICY_TABLES strategy plays basic strategy until bound to the tables of
+ * a mapped table file, then looks up the table of the floored true count.
+ * Pairs have their own split table. Only POLICY_FULL_BASIC doubles, splits or
+ * surrenders, and only count based policies take insurance.
+ * */
+class TStrategy
+	{
+	public:
+		// Highest score handled by the table. Any score above it is a bust
+		static const unsigned int MAX_SCORE = 21;
+		// Dealer up card values, Ace counted as 1
+		static const unsigned int MAX_UPCARD = 10;
+		// True counts with their own table, lower and higher ones are clamped
+		static const int MIN_TRUE_COUNT = -5;
+		static const int MAX_TRUE_COUNT = 10;
+		static const unsigned int TRUE_COUNTS_NR = MAX_TRUE_COUNT - MIN_TRUE_COUNT + 1;
+		// Hi-Lo true count from which count based policies take insurance
+		static const int INSURANCE_TRUE_COUNT = 3;
+
+		TStrategy(TPolicyType policy = POLICY_BASIC);
+		~TStrategy(void){};
+		/*
+		 * Use the argued table file tables of a rule set and deck count. The
+		 * file must stay open while the strategy is in use.
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (not a POLICY_TABLES strategy or a true count missing)
+		 */
+		int bindTables(const TTableFile &file, unsigned int rules, unsigned int decks);
+		// Decisions depend on the true count (bound to table file tables)
+		bool usesCount(void) const {return mCountTables[0] != NULL;};
+		/*
+		 * Decision table entry. Hit/stand engines call decide() with no actions
+		 * allowed instead, so 'if allowed' entries fall back to hit or stand.
+		 * @return: - Decision table entry
+		 */
+		TPlayerAction getAction(unsigned int score, bool soft, unsigned int upCard,
+				double trueCount = 0.0) const
+			{
+			if (score > MAX_SCORE)
+				return ACTION_STAND;
+			if (!usesCount())
+				return (TPlayerAction)mTable[soft][score][upCard];
+
+			int tc = (trueCount < MIN_TRUE_COUNT) ? MIN_TRUE_COUNT :
+					(trueCount >= MAX_TRUE_COUNT) ? MAX_TRUE_COUNT : (int)floor(trueCount);
+			return (TPlayerAction)(*mCountTables[tc - MIN_TRUE_COUNT])[soft][score][upCard];
+			};
+		/*
+		 * Player decision among hit, stand and the allowed actions
+		 * @return: - Any TPlayerAction but the 'if allowed' ones
+		 */
+		TPlayerAction decide(unsigned int score, bool soft, unsigned int upCard,
+				unsigned int pairValue, unsigned int allowed, double trueCount = 0.0) const
+			{
+			if ((allowed & ALLOW_SPLIT) && mSplit[pairValue][upCard])
+				return ACTION_SPLIT;
+			TPlayerAction action = getAction(score, soft, upCard, trueCount);
+			switch (action)
+				{
+				case ACTION_DOUBLE:
+					return (allowed & ALLOW_DOUBLE) ? ACTION_DOUBLE : ACTION_HIT;
+				case ACTION_DOUBLE_STAND:
+					return (allowed & ALLOW_DOUBLE) ? ACTION_DOUBLE : ACTION_STAND;
+				case ACTION_SURRENDER:
+					return (allowed & ALLOW_SURRENDER) ? ACTION_SURRENDER : ACTION_HIT;
+				default:
+					return action;
+				}
+			};
+		// Take insurance at the argued true count
+		bool takeInsurance(double trueCount) const
+			{
+			return usesCount() && (trueCount >= INSURANCE_TRUE_COUNT);
+			};
+		TPolicyType getPolicy(void) const {return mPolicy;};
+
+	private:
+		// Fill decision table for the argued policy
+		void fillBasic(void);
+		void fillMimicDealer(void);
+		void fillNeverBust(void);
+		void fillFullBasic(void);
+
+	private:
+		// Decisions indexed by [soft][score][up card value]
+		typedef unsigned char TTable[2][MAX_SCORE + 1][MAX_UPCARD + 1];
+
+		TPolicyType mPolicy;
+		TTable mTable;
+		// Split decisions indexed by [pair card value][up card value]
+		bool mSplit[MAX_UPCARD + 1][MAX_UPCARD + 1];
+		// Table file tables per true count, from MIN_TRUE_COUNT. NULL if not bound
+		const TTable *mCountTables[TRUE_COUNTS_NR];
+	};
+
+#endif /* __STRATEGY_HPP__ */
@@ -0,0 +1,305 @@
+/******************************************************************************/
+/*!
+ * @file:					  sweep.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the parameter sweep engine.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <chrono>
+#include <exception>
+#include <math.h>
+#include <memory>
+#include <string.h>
+
+/* Local includes */
+#include "blackjack.hpp"
+#include "misc.hpp"
+#include "rules.hpp"
+#include "sweep.hpp"
+#include "tablefile.hpp"
+
+/* Private defines */
+#define SWEEP_MAX_DECKS				8
+
+/*
+ * Configuration of the sweep playing off a shared shoe stream
+ * The rule set is a template argument of the engine, so configurations of
+ * different rule sets are played through this interface, a call per shoe.
+ */
+class TSweepLane
+	{
+	public:
+		TSweepLane(const TSweepConfig &config) : mConfig(config), mHands(0),
+				mShoes(0), mNetTenths(0), mNetSquaredTenths(0) {};
+		virtual ~TSweepLane(void) {};
+		/*
+		 * Play the hands of the next shoe of the stream, up to 'hands' in total.
+		 * None if the configuration is ahead of the stream
+		 */
+		virtual void playShoe(unsigned long long hands) = 0;
+		// Hands played so far
+		unsigned long long getHands(void) const {return mHands;};
+		// Shoes dealt so far and, of them, the ones taken from the stream
+		unsigned long long getShoes(void) const {return mShoes;};
+		virtual unsigned long long getSharedShoes(void) const = 0;
+		virtual void getResult(TSweepResult &result) const = 0;
+
+	protected:
+		// Add a hand net result, in bets
+		void addHand(double net)
+			{
+			long long tenths = llround(net * 10.0);
+			mNetTenths += tenths;
+			mNetSquaredTenths += (unsigned long long)(tenths * tenths);
+			};
+
+	protected:
+		TSweepConfig mConfig;
+		unsigned long long mHands;
+		unsigned long long mShoes;
+		long long mNetTenths;
+		unsigned long long mNetSquaredTenths;
+	};
+
+/*
+ * Configuration of a TRules engine, dealing its shoes from the stream leader
+ */
+template <typename TRules>
+class TRulesLane : public TSweepLane
+	{
+	public:
+		TRulesLane(const TSweepConfig &config, const TStrategy &strategy,
+				const TDealer &leader, const TCards &shoe) :
+			TSweepLane(config), mStrategy(strategy), mBljck(leader, &mStrategy),
+			mLeader(leader)
+			{
+			mBljck.getDealer().setShoeSource(&leader, &shoe);
+			if (config.shufflePeriod)
+				mBljck.setShufflePeriod(config.shufflePeriod);
+			mCardDeck.reserve(config.decks * TDealer::CARDS_PER_DECK);
+			};
+
+		/*
+		 * Play hands until the engine shuffles again: the shuffle at the first
+		 * one takes the shoe the leader just shuffled. A shoe run out mid hand
+		 * makes the engine shuffle the next one of the stream itself, the one
+		 * the leader shuffles next round, so that round is sat out.
+		 */
+		void playShoe(unsigned long long hands)
+			{
+			const TDealer &dealer = mBljck.getDealer();
+			if (dealer.getShuffles() >= mLeader.getShuffles())
+				return;
+			do
+				{
+				mBljck.playHand(mCardDeck);
+				addHand(mBljck.getLastHandNet());
+				mHands++;
+				}
+			while ((mHands < hands) && !mBljck.isShuffleDue());
+			mShoes = dealer.getShuffles();
+			};
+		unsigned long long getSharedShoes(void) const
+			{return mBljck.getDealer().getSourceShoes();};
+		void getResult(TSweepResult &result) const
+			{
+			const TBlackJackStats &stats = mBljck.getStats();
+			memset((void *)&result, 0, sizeof(result));
+			result.config = mConfig;
+			result.hands = mHands;
+			result.shoes = mShoes;
+			result.userWins = stats.userWins;
+			result.dealerWins = stats.dealerWins;
+			result.pushes = stats.pushes;
+			result.netTenths = mNetTenths;
+			result.netSquaredTenths = mNetSquaredTenths;
+			if (!mHands)
+				return;
+			double n = (double)mHands;
+			result.ev = (double)mNetTenths / 10.0 / n;
+			double variance = ((double)mNetSquaredTenths / 100.0 - n * result.ev * result.ev) /
+					((n > 1.0) ? n - 1.0 : 1.0);
+			result.evStdErr = (variance > 0.0) ? sqrt(variance / n) : 0.0;
+			};
+
+	private:
+		TStrategy mStrategy;
+		TBlackjack<TRules> mBljck;		// Plays with mStrategy, declared first
+		const TDealer &mLeader;			// Dealer shuffling the stream
+		TCards mCardDeck;
+	};
+
+/*
+ * Builds the lane of a configuration on the engine of its rule set
+ */
+class TLaneFactory
+	{
+	public:
+		TLaneFactory(const TSweepConfig &config, const TStrategy &strategy,
+				const TDealer &leader, const TCards &shoe) :
+			mConfig(config), mStrategy(strategy), mLeader(leader), mShoe(shoe), mLane(NULL) {};
+		template <typename TRules> int run(void)
+			{
+			mLane = new TRulesLane<TRules>(mConfig, mStrategy, mLeader, mShoe);
+			return 0;
+			};
+		TSweepLane *getLane(void) const {return mLane;};
+
+	private:
+		const TSweepConfig &mConfig;
+		const TStrategy &mStrategy;
+		const TDealer &mLeader;
+		const TCards &mShoe;
+		TSweepLane *mLane;
+	};
+
+/*
+ * Play the configurations of one deck count over their shoe stream: the
+ * leader shuffles a shoe, every configuration still short of hands deals
+ * its next shoe from it
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid rule set or policy tables)
+ */
+	static int
+runStream
+	(
+	const std::vector<TSweepConfig> &configs,		// Configurations of the grid
+	unsigned int 						decks,			// Deck count of the stream
+	unsigned long long 				hands,			// Hands per configuration
+	unsigned long long 				seed,				// Stream seed
+	const TTableFile 					*tables,			// Table file, NULL none
+	std::vector<TSweepResult> 		&results,		// Out argument, per configuration
+	TSweepStats 						&stats			// Out argument, added to
+	)
+	{
+	int ret = -1;   // Assume error sweeping
+	TDealer leader(seed, decks);
+	TCards shoe;
+	shoe.reserve(decks * TDealer::CARDS_PER_DECK);
+	// Owned, freed on every way out (invalid configuration or allocation failure)
+	std::vector< std::unique_ptr<TSweepLane> > lanes;
+	std::vector<unsigned int> indexes;
+	bool valid = true;
+	for (unsigned int c = 0; valid && (c < configs.size()); c++)
+		{
+		if (configs[c].decks != decks)
+			continue;
+		TStrategy strategy((TPolicyType)configs[c].policy);
+		if ((configs[c].policy == POLICY_TABLES) && (!tables ||
+				strategy.bindTables(*tables, configs[c].rules, decks)))
+			{
+			valid = false;
+			break;
+			}
+		TLaneFactory factory(configs[c], strategy, leader, shoe);
+		if (dispatchRules(configs[c].rules, factory))
+			valid = false;
+		else
+			{
+			lanes.push_back(std::unique_ptr<TSweepLane>(factory.getLane()));
+			indexes.push_back(c);
+			}
+		}
+
+	if (valid)
+		{
+		unsigned long long shuffled = 0, dealt = 0, shared = 0;
+		bool playing = !lanes.empty();
+		while (playing)
+			{
+			leader.shuffle(shoe);
+			shuffled++;
+			playing = false;
+			for (unsigned int l = 0; l < lanes.size(); l++)
+				{
+				if (lanes[l]->getHands() >= hands)
+					continue;
+				lanes[l]->playShoe(hands);
+				playing |= (lanes[l]->getHands() < hands);
+				}
+			}
+		// Shoes shuffled out of turn by the configurations are not shared
+		for (unsigned int l = 0; l < lanes.size(); l++)
+			{
+			dealt += lanes[l]->getShoes();
+			shared += lanes[l]->getSharedShoes();
+			}
+		shuffled += dealt - shared;
+		// Full shoes, all of the same size
+		stats.shoesShuffled += shuffled;
+		stats.shoesDealt += dealt;
+		stats.cardsShuffled += shuffled * decks * TDealer::CARDS_PER_DECK;
+		if (dealt > shuffled)
+			stats.cardsSaved += (dealt - shuffled) * decks * TDealer::CARDS_PER_DECK;
+		for (unsigned int l = 0; l < lanes.size(); l++)
+			lanes[l]->getResult(results[indexes[l]]);
+		stats.streams++;
+		ret = 0;
+		}
+	return ret;
+	}
+
+/*
+ * Play every configuration of the grid over the shoe stream of its deck count
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid configuration or table file)
+ */
+	int
+runSweep
+	(
+	const std::vector<TSweepConfig> &configs,		// Configurations of the grid
+	unsigned long long 				hands,			// Hands per configuration
+	unsigned long long 				seed,				// Shoe streams seed
+	const char 							*tablesPath,	// Table file, NULL none
+	std::vector<TSweepResult> 		&results,		// Out argument, per configuration
+	TSweepStats 						&stats			// Out argument
+	)
+	{
+	int ret = -1;   // Assume error sweeping
+	memset((void *)&stats, 0, sizeof(stats));
+	results.assign(configs.size(), TSweepResult());
+	if (configs.empty() || (configs.size() > SWEEP_MAX_CONFIGS) || !hands)
+		return ret;
+	bool tablesUsed = false;
+	for (unsigned int c = 0; c < configs.size(); c++)
+		{
+		if (!configs[c].decks || (configs[c].decks > SWEEP_MAX_DECKS) ||
+				(configs[c].rules >= RULES_VARIANTS_NR) || (configs[c].policy >= POLICY_TYPES_NR))
+			return ret;
+		tablesUsed |= (configs[c].policy == POLICY_TABLES);
+		}
+	TTableFile tables;
+	if (tablesUsed && (!tablesPath || tables.open(tablesPath)))
+		return ret;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	try
+		{
+		// One stream per deck count, in the order the grid lists them
+		std::vector<unsigned int> decks;
+		ret = 0;
+		for (unsigned int c = 0; !ret && (c < configs.size()); c++)
+			{
+			bool done = false;
+			for (unsigned int d = 0; d < decks.size(); d++)
+				done |= (decks[d] == configs[c].decks);
+			if (done)
+				continue;
+			decks.push_back(configs[c].decks);
+			ret = runStream(configs, configs[c].decks, hands, seed, tablesUsed ? &tables : NULL,
+					results, stats);
+			}
+		}
+	catch (std::exception &e)
+		{
+		ret = -1;
+		}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	stats.elapsedSecs = elapsed.count();
+	return ret;
+	}
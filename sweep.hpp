@@ -0,0 +1,85 @@
+/******************************************************************************/
+/*!
+ * @file:					  sweep.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the parameter sweep engine:
+ *  					a grid of configurations (decks, hands per shoe, rule set
+ *  					and policy) played in one pass over shared shoes.
+ *
+ *  Configurations of the same deck count are compatible: one dealer shuffles
+ *  their shoe stream and every configuration deals its next shoe from it
+ *  (see TDealer::setShoeSource()), playing as many hands off it as its own
+ *  shuffle period. Each configuration plays the very shoes an independent
+ *  simulate() run of the same seed would, so results match a run per
+ *  configuration, but every shoe is shuffled once for all of them. A
+ *  configuration whose shoe runs out mid hand shuffles the next shoe of the
+ *  stream itself, as the run would, and sits out the round the leader
+ *  shuffles that one.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __SWEEP_HPP__
+#define __SWEEP_HPP__
+
+/* Library includes */
+#include <vector>
+
+/* Defines */
+
+// Configurations a sweep can play at once
+#define SWEEP_MAX_CONFIGS		1024
+
+/* Enumerations, type defines */
+
+/* One configuration of the grid */
+typedef struct __SweepConfig__
+	{
+	unsigned int decks;				// Decks in the shoe
+	unsigned int shufflePeriod;	// Hands dealt per shoe. 0, six hands per deck
+	unsigned int rules;				// TRuleFlags
+	unsigned int policy;				// TPolicyType
+	}TSweepConfig;
+
+/* Results of one configuration */
+typedef struct __SweepResult__
+	{
+	TSweepConfig config;
+	unsigned long long hands;			// Hands played
+	unsigned long long shoes;			// Shoes dealt
+	unsigned long long userWins;
+	unsigned long long dealerWins;
+	unsigned long long pushes;
+	long long netTenths;					// Player net result, in tenths of a bet
+	unsigned long long netSquaredTenths;	// Sum of the squared per hand net results
+	double ev;								// Net result per hand, in bets
+	double evStdErr;						// Standard error of ev
+	}TSweepResult;
+
+/* Work shared by the sweep */
+typedef struct __SweepStats__
+	{
+	unsigned int streams;					// Shoe streams, one per deck count
+	unsigned long long shoesShuffled;	// Shoes the streams and the configurations
+													// running out mid hand shuffled
+	unsigned long long shoesDealt;		// Shoes the configurations dealt, as many as
+													// independent runs would shuffle
+	unsigned long long cardsShuffled;	// Cards of the shoes shuffled
+	unsigned long long cardsSaved;		// Cards of the shoes copied instead of shuffled
+	double elapsedSecs;
+	}TSweepStats;
+
+/*
+ * Play 'hands' hands of every configuration over shared shoe streams seeded
+ * with 'seed', from full shoes. 'tablesPath' is the table file of the
+ * POLICY_TABLES configurations, NULL if none.
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid configuration or table file)
+ */
+int runSweep (const std::vector<TSweepConfig> &configs, unsigned long long hands,
+		unsigned long long seed, const char *tablesPath, std::vector<TSweepResult> &results,
+		TSweepStats &stats);
+
+#endif /* __SWEEP_HPP__ */
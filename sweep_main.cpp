@@ -0,0 +1,343 @@
+/******************************************************************************/
+/*!
+ * @file:					  sweep_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-sweep. Plays a grid of deck counts, hands per
+ *  					shoe, rule sets and policies in one pass over shared shoe
+ *  					streams, and prints a results table and the work shared.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "misc.hpp"
+#include "rules.hpp"
+#include "simulator.hpp"
+#include "strategy.hpp"
+#include "sweep.hpp"
+
+/* Library includes */
+#include <chrono>
+#include <getopt.h>
+#include <iostream>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/* Private defines */
+#define SWEEP_DEFAULT_HANDS		1000000ULL
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":hn:d:p:r:P:T:S:c";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "hands",   		required_argument,   NULL,    'n'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "periods",  		required_argument,   NULL,    'p'   },
+   { "rules",   		required_argument,   NULL,    'r'   },
+   { "policies",		required_argument,   NULL,    'P'   },
+   { "tables",   		required_argument,   NULL,    'T'   },
+   { "seed",   		required_argument,   NULL,    'S'   },
+   { "compare",  		no_argument,         NULL,    'c'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-sweep: Every combination of the argued deck counts, hands per shoe," << std::endl;
+   std::cout << "rule sets and policies, played in one pass. Configurations of the same deck" << std::endl;
+   std::cout << "count deal the same shoes, each shuffled once for all of them, and play the" << std::endl;
+   std::cout << "hands an independent blackjack-sim run of the same seed would." << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -n, --hands N" << std::endl;
+   std::cout << "      Hands per configuration (default " << SWEEP_DEFAULT_HANDS << ")." << std::endl;
+   std::cout << "   -d, --decks LIST" << std::endl;
+   std::cout << "      Comma separated deck counts (default 6)." << std::endl;
+   std::cout << "   -p, --periods LIST" << std::endl;
+   std::cout << "      Comma separated hands dealt per shoe, the penetration (default 0, six" << std::endl;
+   std::cout << "      hands per deck)." << std::endl;
+   std::cout << "   -r, --rules LIST" << std::endl;
+   std::cout << "      Comma separated rule sets, each 'house' or variants joined by '+' (s17," << std::endl;
+   std::cout << "      push-ties, pay-6-5). Ex: 'house,s17,s17+pay-6-5' (default house)." << std::endl;
+   std::cout << "   -P, --policies LIST" << std::endl;
+   std::cout << "      Comma separated policies (default basic)." << std::endl;
+   std::cout << "   -T, --tables FILE, -S, --seed SEED" << std::endl;
+   std::cout << "      Table file of the 'tables' policy and shoe seed (default 1)." << std::endl;
+   std::cout << "   -c, --compare" << std::endl;
+   std::cout << "      Also run every configuration alone, check the results are the same and" << std::endl;
+   std::cout << "      print both times." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Parse a comma separated list of numbers
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (not a number)
+ */
+	static int
+parseNumbers
+	(
+	const std::string 			&list,		// Numbers
+	std::vector<unsigned int> 	&numbers		// Out argument
+	)
+	{
+	std::stringstream ss(list);
+	std::string tok;
+	numbers.clear();
+	while (std::getline(ss, tok, ','))
+		{
+		char *end;
+		unsigned long number = strtoul(tok.c_str(), &end, 10);
+		if (tok.empty() || *end)
+			return -1;
+		numbers.push_back(number);
+		}
+	return numbers.empty() ? -1 : 0;
+	}
+
+/*
+ * Parse a comma separated list of rule sets
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (unknown rule variant)
+ */
+	static int
+parseRules
+	(
+	const std::string 			&list,		// Rule sets
+	std::vector<unsigned int> 	&rules		// Out argument, TRuleFlags
+	)
+	{
+	std::stringstream ss(list);
+	std::string set;
+	rules.clear();
+	while (std::getline(ss, set, ','))
+		{
+		std::stringstream variants(set);
+		std::string tok;
+		unsigned int flags = RULES_HOUSE;
+		while (std::getline(variants, tok, '+'))
+			{
+			if (tok == "s17")
+				flags |= RULES_STAND_SOFT_17;
+			else if (tok == "push-ties")
+				flags |= RULES_PUSH_TIES;
+			else if (tok == "pay-6-5")
+				flags |= RULES_PAY_6_5;
+			else if (tok != "house")
+				return -1;
+			}
+		rules.push_back(flags);
+		}
+	return rules.empty() ? -1 : 0;
+	}
+
+/*
+ * Rule set name, as parseRules() reads it
+ * @return: Name
+ */
+	static std::string
+rulesName
+	(
+	unsigned int flags		// TRuleFlags
+	)
+	{
+	std::string name;
+	if (flags & RULES_STAND_SOFT_17)
+		name += "+s17";
+	if (flags & RULES_PUSH_TIES)
+		name += "+push-ties";
+	if (flags & RULES_PAY_6_5)
+		name += "+pay-6-5";
+	return name.empty() ? std::string("house") : name.substr(1);
+	}
+
+/*
+ * Run every configuration alone and check it against the sweep
+ * @return: - 0 - Every configuration matches. Otherwise,
+ * 			A configuration differs or failed
+ */
+	static int
+compareAlone
+	(
+	const std::vector<TSweepResult> &results,		// Sweep results
+	unsigned long long 				hands,			// Hands per configuration
+	unsigned long long 				seed,				// Shoe seed
+	const char 							*tablesPath,	// Table file, NULL none
+	double 								sweepSecs		// Sweep time
+	)
+	{
+	int ret = -1;   // Assume a configuration differs
+	unsigned int matches = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned int c = 0; c < results.size(); c++)
+		{
+		TSimConfig config;
+		TSimResults alone;
+		simInitConfig(&config);
+		config.rules = results[c].config.rules;
+		config.decks = results[c].config.decks;
+		config.policy = results[c].config.policy;
+		config.shufflePeriod = results[c].config.shufflePeriod;
+		config.tablesPath = tablesPath;
+		config.seed = seed;
+		config.hands = hands;
+		if (simulate(&config, &alone))
+			{
+			log(LOG_ERR, "Simulation failed\n");
+			return ret;
+			}
+		if ((alone.handsPlayed == results[c].hands) && (alone.netTenths ==
+				results[c].netTenths) && (alone.netSquaredTenths == results[c].netSquaredTenths))
+			matches++;
+		}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	printf("Alone: %u runs in %.3f s, the sweep %.3f s (%.2fx). %u of %u results the same\n",
+			(unsigned int)results.size(), elapsed.count(), sweepSecs, elapsed.count() /
+			sweepSecs, matches, (unsigned int)results.size());
+	if (matches == results.size())
+		ret = 0;
+	return ret;
+	}
+
+/* Top level and binary entry point for the parameter sweep
+ * @return: 0 - Success. Otherwise,
+ * 			Error
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	unsigned long long hands = SWEEP_DEFAULT_HANDS;
+	unsigned long long seed = 1;
+	std::vector<unsigned int> decks(1, 6), periods(1, 0), rules(1, RULES_HOUSE);
+	std::vector<unsigned int> policies(1, POLICY_BASIC);
+	const char *tablesPath = NULL;
+	bool compare = false;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'n':
+				hands = strtoull(optarg, NULL, 10);
+				break;
+			case 'd':
+				if (parseNumbers(optarg, decks))
+					{
+					log(LOG_ERR, "Invalid deck counts\n");
+					return -1;
+					}
+				break;
+			case 'p':
+				if (parseNumbers(optarg, periods))
+					{
+					log(LOG_ERR, "Invalid hands per shoe\n");
+					return -1;
+					}
+				break;
+			case 'r':
+				if (parseRules(optarg, rules))
+					{
+					log(LOG_ERR, "Unknown rule variant\n");
+					return -1;
+					}
+				break;
+			case 'P':
+				{
+				std::stringstream ss(optarg);
+				std::string tok;
+				policies.clear();
+				while (std::getline(ss, tok, ','))
+					{
+					TPolicyType policy;
+					if (policyFromName(tok, policy))
+						{
+						log(LOG_ERR, "Unknown policy\n");
+						return -1;
+						}
+					policies.push_back(policy);
+					}
+				}
+				break;
+			case 'T':
+				tablesPath = optarg;
+				break;
+			case 'S':
+				seed = strtoull(optarg, NULL, 10);
+				break;
+			case 'c':
+				compare = true;
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+
+	// Deck count outermost, so the table lists each stream together
+	std::vector<TSweepConfig> configs;
+	for (unsigned int d = 0; d < decks.size(); d++)
+		for (unsigned int p = 0; p < periods.size(); p++)
+			for (unsigned int r = 0; r < rules.size(); r++)
+				for (unsigned int c = 0; c < policies.size(); c++)
+					{
+					TSweepConfig config;
+					config.decks = decks[d];
+					config.shufflePeriod = periods[p];
+					config.rules = rules[r];
+					config.policy = policies[c];
+					configs.push_back(config);
+					}
+
+	std::vector<TSweepResult> results;
+	TSweepStats stats;
+	if (runSweep(configs, hands, seed, tablesPath, results, stats))
+		{
+		log(LOG_ERR, "Invalid sweep (deck counts, hands, policies or table file)\n");
+		return -1;
+		}
+
+	printf("%-5s %-6s %-22s %-10s %10s %10s %10s %9s\n", "Decks", "Period", "Rules", "Policy",
+			"Hands", "EV", "Std err", "Shoes");
+	for (unsigned int c = 0; c < results.size(); c++)
+		{
+		const TSweepConfig &config = results[c].config;
+		printf("%-5u %-6u %-22s %-10s %10llu %+10.5f %10.5f %9llu\n", config.decks,
+				config.shufflePeriod ? config.shufflePeriod : 6 * config.decks,
+				rulesName(config.rules).c_str(), policyName((TPolicyType)config.policy),
+				results[c].hands, results[c].ev, results[c].evStdErr, results[c].shoes);
+		}
+	double handsNr = (double)hands * (double)results.size();
+	printf("%u configurations, %u shoe streams, %.3f s (%.0f hands/s)\n",
+			(unsigned int)results.size(), stats.streams, stats.elapsedSecs, handsNr /
+			stats.elapsedSecs);
+	printf("Shared: %llu shoes shuffled for %llu dealt (%.1f per shuffle), %llu of %llu"
+			" cards not shuffled\n", stats.shoesShuffled, stats.shoesDealt,
+			(double)stats.shoesDealt / (double)stats.shoesShuffled, stats.cardsSaved,
+			stats.cardsSaved + stats.cardsShuffled);
+	if (compare)
+		return compareAlone(results, hands, seed, tablesPath, stats.elapsedSecs);
+	return 0;
+	}
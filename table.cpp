@@ -0,0 +1,243 @@
+/******************************************************************************/
+/*!
+ * @file:					  table.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the multi seat table engine.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <string.h>
+
+/* Local includes */
+#include "table.hpp"
+
+template <typename TRules>
+TBlackjackTable<TRules>::TBlackjackTable
+	(
+	const TDealer 		&dealer,			// Dealer and shoe
+	const TStrategy 	*strategy,		// Policy every seat plays
+	unsigned int 		seats				// Seats, 1 to TABLE_MAX_SEATS
+	) :
+	mDealer(dealer),
+	mStrategy(strategy),
+	mSideBets(&sideBetTables()),
+	mSeats(seats ? ((seats > TABLE_MAX_SEATS) ? TABLE_MAX_SEATS : seats) : 1),
+	mRounds(0),
+	mDealerPlays(0)
+	{
+	memset((void *)mHands, 0, sizeof(mHands));
+	memset((void *)mStats, 0, sizeof(mStats));
+	memset((void *)&mDealerHand, 0, sizeof(mDealerHand));
+	memset((void *)&mUpCard, 0, sizeof(mUpCard));
+	memset((void *)&mHoleCard, 0, sizeof(mHoleCard));
+	mShufflePeriod = SHUFFLE_PERIOD_HANDS * dealer.getDecks() / (mSeats + 1);
+	if (!mShufflePeriod)
+		mShufflePeriod = 1;
+	}
+
+/*
+ * Seat plays its hand out from the strategy. The hole card is not counted
+ */
+template <typename TRules>
+	void
+TBlackjackTable<TRules>::playSeat
+	(
+	TSeatHand 	 &seat,			// In/Out argument
+	TCards 		 &cardDeck,		// In
+	unsigned int upCard			// Dealer up card value
+	)
+	{
+	for (;;)
+		{
+		bool soft;
+		unsigned int seatScore = score(seat, soft);
+		if (seatScore > BLACKJACK_VAL)
+			{
+			seat.outcome = SEAT_BUSTED;
+			return;
+			}
+		double trueCount = mStrategy->usesCount() ? mDealer.getTrueCount(&mHoleCard) : 0.0;
+		if (mStrategy->decide(seatScore, soft, upCard, 0, 0, trueCount) != ACTION_HIT)
+			return;
+		addCard(seat, mDealer.dealCard(cardDeck));
+		}
+	}
+
+/*
+ * Dealer draws as the rules dictate
+ * Rules: 	- Dealer must hit on soft 17 (unless TRules::HIT_SOFT_17 is false).
+ * 			- Dealer must stand on hard 17 or higher soft or hard hands.
+ * @return: Dealer score, over BLACKJACK_VAL if busted
+ */
+template <typename TRules>
+	unsigned int
+TBlackjackTable<TRules>::playDealer
+	(
+	TCards &cardDeck		// In
+	)
+	{
+	for (;;)
+		{
+		bool soft;
+		unsigned int dealerScore = score(mDealerHand, soft);
+		if ((dealerScore > TRules::DEALER_HIT_LIMIT) || ((dealerScore ==
+				TRules::DEALER_HIT_LIMIT) && !(TRules::HIT_SOFT_17 && soft)))
+			return dealerScore;
+		addCard(mDealerHand, mDealer.dealCard(cardDeck));
+		}
+	}
+
+/*
+ * Settle a seat that stood against the dealer final score
+ * Rule:	- House (dealer) wins in an event of a score tie, unless
+ * 		TRules::PUSH_ON_TIE.
+ */
+template <typename TRules>
+	void
+TBlackjackTable<TRules>::settle
+	(
+	unsigned int seat,				// Seat index
+	unsigned int seatScore,			// Seat final score, not busted
+	unsigned int dealerScore		// Dealer final score
+	)
+	{
+	TBlackJackStats &stats = mStats[seat];
+	if (dealerScore > BLACKJACK_VAL)
+		{
+		stats.dealerBusts++;
+		stats.userWins++;
+		mHands[seat].outcome = SEAT_WON;
+		}
+	else if (TRules::PUSH_ON_TIE && (dealerScore == seatScore))
+		{
+		stats.pushes++;
+		mHands[seat].outcome = SEAT_PUSHED;
+		}
+	else if (dealerScore >= seatScore)
+		{
+		stats.dealerWins++;
+		mHands[seat].outcome = SEAT_LOST;
+		}
+	else
+		{
+		stats.userWins++;
+		mHands[seat].outcome = SEAT_WON;
+		}
+	}
+
+/*
+ * Play one round
+ * Rules:	- Naturals and a dealer two card 21 are settled before any seat
+ * 		plays, as in TBlackjack::initBlackjackChks().
+ * 			- The dealer only draws if a seat stood.
+ * @return: - 0 - Success playing the round. Otherwise,
+ * 			Error
+ */
+template <typename TRules>
+	int
+TBlackjackTable<TRules>::playRound
+	(
+	TCards &cardDeck		// Shoe
+	)
+	{
+	if (!mStrategy)
+		return -1;
+	if (isShuffleDue() || cardDeck.empty())
+		mDealer.shuffle(cardDeck);
+
+	// Casino order: a card to every seat and the up card, then the second round
+	memset((void *)mHands, 0, mSeats * sizeof(TSeatHand));
+	memset((void *)&mDealerHand, 0, sizeof(mDealerHand));
+	for (unsigned int s = 0; s < mSeats; s++)
+		{
+		TCard card = mDealer.dealCard(cardDeck);
+		addCard(mHands[s], card);
+		mHands[s].first = (unsigned char)cardCode(card);
+		}
+	mUpCard = mDealer.dealCard(cardDeck);
+	addCard(mDealerHand, mUpCard);
+	unsigned int up = cardCode(mUpCard);
+	for (unsigned int s = 0; s < mSeats; s++)
+		{
+		TCard card = mDealer.dealCard(cardDeck);
+		addCard(mHands[s], card);
+		// Side bets on the first two cards and the up card
+		unsigned int second = cardCode(card);
+		mStats[s].pairsOutcomes[evalPairs(*mSideBets, mHands[s].first, second)]++;
+		mStats[s].threeOutcomes[evalThree(*mSideBets, mHands[s].first, second, up)]++;
+		}
+	mHoleCard = mDealer.dealCard(cardDeck);
+	addCard(mDealerHand, mHoleCard);
+	mRounds++;
+
+	bool dealerNatural = isNatural(mDealerHand);
+	bool dealer21 = isTwoCard21(mDealerHand);
+	unsigned int live = 0;		// Seats left to play against the dealer
+	for (unsigned int s = 0; s < mSeats; s++)
+		{
+		TSeatHand &seat = mHands[s];
+		TBlackJackStats &stats = mStats[s];
+		stats.successPlyd++;
+		bool seatNatural = isNatural(seat);
+		if (dealerNatural && seatNatural)
+			{
+			stats.pushes++;
+			seat.outcome = SEAT_PUSHED;
+			}
+		else if (dealerNatural)
+			{
+			stats.dealerWins++;
+			seat.outcome = SEAT_LOST;
+			}
+		else if (seatNatural)
+			{
+			stats.userWins++;
+			stats.userNaturals++;
+			seat.outcome = SEAT_NATURAL;
+			}
+		else if (dealer21)
+			{
+			stats.dealerWins++;
+			seat.outcome = SEAT_LOST;
+			}
+		else
+			{
+			playSeat(seat, cardDeck, mUpCard.value);
+			if (seat.outcome == SEAT_BUSTED)
+				{
+				stats.dealerWins++;
+				stats.userBusts++;
+				}
+			else
+				live++;
+			}
+		}
+
+	// Nobody left to beat: the dealer only turns the hole card
+	if (!live)
+		return 0;
+
+	mDealerPlays++;
+	unsigned int dealerScore = playDealer(cardDeck);
+	for (unsigned int s = 0; s < mSeats; s++)
+		if (mHands[s].outcome == SEAT_LIVE)
+			{
+			bool soft;
+			settle(s, score(mHands[s], soft), dealerScore);
+			}
+	return 0;
+	}
+
+/* Rule set specializations built into the library (see dispatchRules()) */
+template class TBlackjackTable< TRuleSet<0> >;
+template class TBlackjackTable< TRuleSet<1> >;
+template class TBlackjackTable< TRuleSet<2> >;
+template class TBlackjackTable< TRuleSet<3> >;
+template class TBlackjackTable< TRuleSet<4> >;
+template class TBlackjackTable< TRuleSet<5> >;
+template class TBlackjackTable< TRuleSet<6> >;
+template class TBlackjackTable< TRuleSet<7> >;
@@ -0,0 +1,150 @@
+/******************************************************************************/
+/*!
+ * @file:					  table.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the multi seat table engine.
+ *  					One to TABLE_MAX_SEATS automated players against one
+ *  					dealer hand and one shoe.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __TABLE_HPP__
+#define __TABLE_HPP__
+
+/* Local includes */
+#include "blackjack.hpp"
+
+/* Defines */
+
+// Seats at a table
+#define TABLE_MAX_SEATS		7
+
+/*
+ * Seat hand state
+ * Only what the rules need is kept: the hard total (Aces counted 1), whether
+ * an Ace is held and the card count. A seat fits in a few bytes so all the
+ * seats of a table share a cache line.
+ */
+typedef struct __SeatHand__
+	{
+	unsigned char hard;			// Hard total, Aces counted as 1
+	unsigned char cardsNr;
+	bool ace;						// Holds an Ace
+	bool face;						// Holds a face card
+	signed char outcome;			// Seat outcome of the round (see TBlackjackTable)
+	unsigned char first;			// Packed code of the first card (side bets)
+	}TSeatHand;
+
+/*
+ * The blackjack table class
+ * Plays rounds of 'seats' automated players against one dealer hand under the
+ * compile time rule set TRules (see rules.hpp). Cards are dealt in casino
+ * order: one to each seat, the dealer up card, a second one to each seat and
+ * the dealer hole card. The dealer hand is resolved once per round and not at
+ * all when no seat is left to play against. Seats hit and stand only.
+ * */
+template <typename TRules>
+class TBlackjackTable
+	{
+	// Seat outcome of a round
+	enum {
+		SEAT_LIVE			= 0,		// Stood, waiting for the dealer
+		SEAT_BUSTED			= 1,
+		SEAT_NATURAL		= 2,		// Won with a natural
+		SEAT_PUSHED			= 3,
+		SEAT_LOST			= 4,		// Lost to a dealer natural or two card 21
+		SEAT_WON				= 5
+	};
+
+	static const unsigned int BLACKJACK_VAL = TRules::BLACKJACK_VAL;
+	// Ace counted high adds this much to the hard total
+	static const unsigned int ACE_SOFT_BONUS = 10;
+	// Hands, seats and dealer, dealt per deck between shuffles (six rounds of one seat)
+	static const unsigned int SHUFFLE_PERIOD_HANDS = 12;
+	// Function members
+	public:
+		/*
+		 * Table of 'seats' players (1 to TABLE_MAX_SEATS, clamped), all playing
+		 * the argued strategy
+		 */
+		TBlackjackTable(const TDealer &dealer, const TStrategy *strategy, unsigned int seats);
+		~TBlackjackTable(void){};
+		/*
+		 * Play one round: deal, seats play in order, dealer plays if needed and
+		 * every seat is settled
+		 * @return: - 0 - Success playing the round. Otherwise,
+		 * 			Error
+		 */
+		int playRound(TCards &cardDeck);
+		// The next round starts with a shuffle
+		bool isShuffleDue(void) const {return !(mRounds % mShufflePeriod);};
+		// Rounds played between shuffles. Defaults to about six seat hands per deck
+		void setShufflePeriod(unsigned int rounds) {mShufflePeriod = rounds ? rounds : 1;};
+		unsigned int getSeats(void) const {return mSeats;};
+		// Rounds played and rounds the dealer had to draw in
+		unsigned long long getRounds(void) const {return mRounds;};
+		unsigned long long getDealerPlays(void) const {return mDealerPlays;};
+		// Game results stats of a seat
+		const TBlackJackStats &getStats(unsigned int seat) const {return mStats[seat];};
+		// Player net result of a seat in bets, naturals paid at the rule set payout
+		double getNetUnits(unsigned int seat) const
+			{
+			return (double)mStats[seat].userWins - (double)mStats[seat].dealerWins +
+					(double)mStats[seat].userNaturals * (double)(TRules::NATURAL_PAY_NUM -
+					TRules::NATURAL_PAY_DEN) / (double)TRules::NATURAL_PAY_DEN;
+			};
+		// Dealer dealing the rounds (card counts)
+		const TDealer &getDealer(void) const {return mDealer;};
+
+	private:
+		// Add a card to a hand
+		static void addCard(TSeatHand &hand, const TCard &card)
+			{
+			hand.hard += card.value;
+			hand.ace |= (card.value == 1);
+			hand.face |= card.isFace;
+			hand.cardsNr++;
+			};
+		// Best score of a hand, sets 'soft' when an Ace counts high
+		static unsigned int score(const TSeatHand &hand, bool &soft)
+			{
+			soft = hand.ace && (hand.hard + ACE_SOFT_BONUS <= BLACKJACK_VAL);
+			return soft ? hand.hard + ACE_SOFT_BONUS : hand.hard;
+			};
+		// Two card 21
+		static bool isTwoCard21(const TSeatHand &hand)
+			{
+			return (hand.cardsNr == 2) && hand.ace && (hand.hard + ACE_SOFT_BONUS == BLACKJACK_VAL);
+			};
+		// Face card and Ace, the only natural under the house rules
+		static bool isNatural(const TSeatHand &hand) {return isTwoCard21(hand) && hand.face;};
+		// Seat plays its hand out. The hole card is not counted
+		void playSeat(TSeatHand &seat, TCards &cardDeck, unsigned int upCard);
+		/*
+		 * Dealer draws as the rules dictate
+		 * @return: Dealer score, over BLACKJACK_VAL if busted
+		 */
+		unsigned int playDealer(TCards &cardDeck);
+		// Settle a seat that stood against the dealer final score
+		void settle(unsigned int seat, unsigned int seatScore, unsigned int dealerScore);
+
+	private:
+		// Seat hands, contiguous and reused every round
+		TSeatHand mHands[TABLE_MAX_SEATS];
+		TBlackJackStats mStats[TABLE_MAX_SEATS];
+		TSeatHand mDealerHand;
+		TCard mUpCard;
+		TCard mHoleCard;
+		TDealer mDealer;
+		const TStrategy *mStrategy;
+		const TSideBetTables *mSideBets;
+		unsigned int mSeats;
+		unsigned int mShufflePeriod;	// Rounds played between shuffles
+		unsigned long long mRounds;
+		unsigned long long mDealerPlays;
+	};
+
+#endif /* __TABLE_HPP__ */
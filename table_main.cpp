@@ -0,0 +1,212 @@
+/******************************************************************************/
+/*!
+ * @file:					  table_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-table. Simulates rounds at a multi seat table and
+ *  					reports seat hand throughput.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "misc.hpp"
+#include "rules.hpp"
+#include "sidebets.hpp"
+#include "simulator.hpp"
+#include "strategy.hpp"
+
+/* Library includes */
+#include <getopt.h>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":hn:k:d:P:T:S:csp6";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "rounds",   		required_argument,   NULL,    'n'   },
+   { "seats",   		required_argument,   NULL,    'k'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "policy",   		required_argument,   NULL,    'P'   },
+   { "tables",   		required_argument,   NULL,    'T'   },
+   { "seed",   		required_argument,   NULL,    'S'   },
+   { "compare",  		no_argument,         NULL,    'c'   },
+   { "s17",   		no_argument,         NULL,    's'   },
+   { "push-ties",		no_argument,         NULL,    'p'   },
+   { "pay-6-5",		no_argument,         NULL,    '6'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-table: Rounds of 1 to " << SIM_MAX_SEATS <<
+   		" automated seats against one dealer hand" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -n, --rounds N" << std::endl;
+   std::cout << "      Rounds to play (default 1000000)." << std::endl;
+   std::cout << "   -k, --seats N" << std::endl;
+   std::cout << "      Seats at the table (default " << SIM_MAX_SEATS << ")." << std::endl;
+   std::cout << "   -d, --decks N, -P, --policy NAME, -S, --seed SEED" << std::endl;
+   std::cout << "      Shoe decks (default 6), player policy (hit/stand policies only) and seed" << std::endl;
+   std::cout << "      (default 1)." << std::endl;
+   std::cout << "   -T, --tables FILE" << std::endl;
+   std::cout << "      Table file for the 'tables' policy (see blackjack-tablegen)." << std::endl;
+   std::cout << "   -c, --compare" << std::endl;
+   std::cout << "      Also play as many hands on the one player engine and compare" << std::endl;
+   std::cout << "      throughput." << std::endl;
+   std::cout << "   -s, --s17, -p, --push-ties, -6, --pay-6-5" << std::endl;
+   std::cout << "      Rule variants, as for blackjack." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Print the results of one simulation
+ */
+	void
+printResults
+	(
+	const char 				*name,		// Engine name
+	const TSimResults 	&results
+	)
+	{
+	double n = (double)results.handsPlayed;
+	printf("%s: %llu hands in %llu rounds, %.3f s\n", name, results.handsPlayed,
+			results.rounds, results.elapsedSecs);
+	printf("  EV          %+.6f bets per hand\n", results.netUnits / n);
+	printf("  Win         %.6f (natural %.6f)\n", (double)results.userWins / n,
+			(double)results.userNaturals / n);
+	printf("  Push        %.6f\n", (double)results.pushes / n);
+	printf("  Loss        %.6f (bust %.6f)\n", (double)results.dealerWins / n,
+			(double)results.userBusts / n);
+	if (results.dealerPlays)
+		printf("  Dealer      drew in %.2f%% of the rounds\n",
+				100.0 * (double)results.dealerPlays / (double)results.rounds);
+	unsigned long long dealt = 0;
+	for (unsigned int i = 0; i < SIM_PAIRS_OUTCOMES; i++)
+		dealt += results.pairsOutcomes[i];
+	if (dealt)
+		printf("  Side bets   Perfect Pairs EV %+.6f, 21+3 EV %+.6f per bet\n",
+				pairsNet(results.pairsOutcomes) / (double)dealt,
+				threeNet(results.threeOutcomes) / (double)dealt);
+	printf("  Throughput  %.0f hands/s, %.0f rounds/s\n", n / results.elapsedSecs,
+			(double)results.rounds / results.elapsedSecs);
+	}
+
+/* Top level and binary entry point for the table simulator
+ * @return: 0 - Success. Otherwise,
+ * 			Error
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	TSimConfig config;
+	simInitConfig(&config);
+	config.decks = 6;
+	config.seats = SIM_MAX_SEATS;
+	config.seed = 1;
+	bool compare = false;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'n':
+				config.hands = strtoull(optarg, NULL, 10);
+				break;
+			case 'k':
+				config.seats = strtoul(optarg, NULL, 10);
+				break;
+			case 'd':
+				config.decks = strtoul(optarg, NULL, 10);
+				break;
+			case 'P':
+				{
+				TPolicyType policy;
+				if (policyFromName(optarg, policy))
+					{
+					log(LOG_ERR, "Unknown policy\n");
+					return -1;
+					}
+				config.policy = policy;
+				}
+				break;
+			case 'T':
+				config.tablesPath = optarg;
+				break;
+			case 'S':
+				config.seed = strtoull(optarg, NULL, 10);
+				break;
+			case 'c':
+				compare = true;
+				break;
+			case 's':
+				config.rules |= RULES_STAND_SOFT_17;
+				break;
+			case 'p':
+				config.rules |= RULES_PUSH_TIES;
+				break;
+			case '6':
+				config.rules |= RULES_PAY_6_5;
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+
+	if (!config.seats)
+		{
+		log(LOG_ERR, "A table has at least one seat\n");
+		return -1;
+		}
+	if (config.policy == POLICY_FULL_BASIC)
+		{
+		log(LOG_ERR, "Table seats hit and stand only, the 'full' policy cannot be played\n");
+		return -1;
+		}
+
+	TSimResults table;
+	if (simulate(&config, &table))
+		{
+		log(LOG_ERR, "Invalid simulation configuration\n");
+		return -1;
+		}
+	printResults("Table", table);
+	if (!compare)
+		return 0;
+
+	TSimResults single;
+	config.hands = table.handsPlayed;
+	config.seats = 0;
+	if (simulate(&config, &single))
+		{
+		log(LOG_ERR, "One player simulation failed\n");
+		return -1;
+		}
+	printResults("One player engine", single);
+	printf("Table seat hands/s are %.2fx the one player engine hands/s\n",
+			((double)table.handsPlayed / table.elapsedSecs) /
+			((double)single.handsPlayed / single.elapsedSecs));
+	return 0;
+	}
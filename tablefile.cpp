@@ -0,0 +1,519 @@
+/******************************************************************************/
+/*!
+ * @file:					  tablefile.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the precomputed table file reader and generator.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Local includes */
+#include "rules.hpp"
+#include "tablefile.hpp"
+
+/* Private defines */
+#define ACE_VALUE				1
+#define TEN_VALUE				10
+#define MAX_HARD				26		// Highest hard total a hand can reach before busting
+#define DEALER_STAND			17
+#define FINAL_BUST			(TABLE_DEALER_FINALS - 1)
+#define HILO_LOW_MIN			2		// Hi-Lo +1 cards: 2 to 6
+#define HILO_LOW_MAX			6
+
+/* Payload sizes per section type */
+static const uint64_t strategySize = 2 * (TStrategy::MAX_SCORE + 1) *
+		(TStrategy::MAX_UPCARD + 1);
+static const uint64_t dealerSize = (TStrategy::MAX_UPCARD + 1) * TABLE_DEALER_FINALS *
+		sizeof(double);
+static const uint64_t evSize = 2 * (TStrategy::MAX_SCORE + 1) * (TStrategy::MAX_UPCARD + 1) *
+		TABLE_EV_ACTIONS * sizeof(double);
+
+TTableFile::TTableFile
+	(
+	void
+	) :
+	mMap(NULL),
+	mSize(0),
+	mHeader(NULL),
+	mSections(NULL)
+	{
+
+	}
+
+TTableFile::~TTableFile
+	(
+	void
+	)
+	{
+	close();
+	}
+
+/*
+ * Map a table file and check its header and directory
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (cannot map, bad magic, version or layout)
+ */
+	int
+TTableFile::open
+	(
+	const std::string &path		// Table file path
+	)
+	{
+	int ret = -1;   // Assume the file cannot be used
+	close();
+
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return ret;
+	struct stat st;
+	if (fstat(fd, &st) || ((size_t)st.st_size < sizeof(TTableFileHeader)))
+		{
+		::close(fd);
+		return ret;
+		}
+	void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	// The mapping holds its own reference to the file
+	::close(fd);
+	if (map == MAP_FAILED)
+		return ret;
+	mMap = (const unsigned char *)map;
+	mSize = (size_t)st.st_size;
+
+	const TTableFileHeader *header = (const TTableFileHeader *)mMap;
+	if (memcmp(header->magic, TABLE_FILE_MAGIC, sizeof(header->magic)) ||
+			(header->version != TABLE_FILE_VERSION) ||
+			(header->headerSize != sizeof(TTableFileHeader)) ||
+			(header->sectionSize != sizeof(TTableSection)) ||
+			(header->fileSize != mSize) ||
+			((uint64_t)header->sectionsNr * sizeof(TTableSection) >
+					mSize - sizeof(TTableFileHeader)))
+		{
+		close();
+		return ret;
+		}
+
+	const TTableSection *sections = (const TTableSection *)(mMap + sizeof(TTableFileHeader));
+	for (unsigned int i = 0; i < header->sectionsNr; i++)
+		{
+		const TTableSection &section = sections[i];
+		uint64_t size = (section.type == TABLE_STRATEGY) ? strategySize :
+				(section.type == TABLE_DEALER) ? dealerSize :
+				(section.type == TABLE_EV) ? evSize : section.size;
+		if ((section.size != size) || (section.offset % TABLE_ALIGN) ||
+				(section.offset > mSize) || (section.size > mSize - section.offset))
+			{
+			close();
+			return ret;
+			}
+		}
+
+	mHeader = header;
+	mSections = sections;
+	ret = 0;
+	return ret;
+	}
+
+/*
+ * Unmap the file. Payloads found before are no longer valid.
+ */
+	void
+TTableFile::close
+	(
+	void
+	)
+	{
+	if (mMap)
+		munmap((void *)mMap, mSize);
+	mMap = NULL;
+	mSize = 0;
+	mHeader = NULL;
+	mSections = NULL;
+	}
+
+/*
+ * Section payload lookup
+ * @return: Payload or NULL if the file has no such section
+ */
+	const void *
+TTableFile::find
+	(
+	TTableType 	 type,			// Section type
+	unsigned int rules,			// TRuleFlags
+	unsigned int decks,			// Decks in the shoe
+	int 			 trueCount		// Floored Hi-Lo true count
+	) const
+	{
+	for (unsigned int i = 0; i < getSectionsNr(); i++)
+		{
+		const TTableSection &section = mSections[i];
+		if ((section.type == (uint32_t)type) && (section.rules == rules) &&
+				(section.decks == decks) && (section.trueCount == trueCount))
+			return mMap + section.offset;
+		}
+	return NULL;
+	}
+
+/*
+ * Card value probabilities of a mid shoe with the argued Hi-Lo true count.
+ * Half the shoe is left and the dealt half holds as many more low (2 to 6) than
+ * high (10 value and Aces) cards as the running count says. The remaining low
+ * cards are taken evenly from 2 to 6 and high ones added to 10s and Aces in
+ * their 16:4 shoe proportion. Cards are then drawn as from an infinite shoe.
+ */
+	static void
+countProbabilities
+	(
+	unsigned int decks,		// Decks in the shoe
+	double 		 trueCount,	// Hi-Lo true count
+	double 		 p[TEN_VALUE + 1]	// Out argument, indexed by card value
+	)
+	{
+	double left = (double)decks / 2.0;		// Decks left
+	double shift = trueCount * left / 2.0;	// Low cards dealt over their share
+	double count[TEN_VALUE + 1];
+	double total = 0.0;
+	for (unsigned int v = ACE_VALUE; v <= TEN_VALUE; v++)
+		{
+		count[v] = (v == TEN_VALUE) ? 16.0 * left : 4.0 * left;
+		if ((v >= HILO_LOW_MIN) && (v <= HILO_LOW_MAX))
+			count[v] -= shift / 5.0;
+		else if (v == ACE_VALUE)
+			count[v] += shift / 5.0;
+		else if (v == TEN_VALUE)
+			count[v] += shift * 4.0 / 5.0;
+		if (count[v] < 0.0)
+			count[v] = 0.0;
+		total += count[v];
+		}
+	p[0] = 0.0;
+	for (unsigned int v = ACE_VALUE; v <= TEN_VALUE; v++)
+		p[v] = count[v] / total;
+	}
+
+/*
+ * Dealer final score distribution per up card, given the dealer has no two
+ * card 21 (those hands end before the player acts)
+ */
+template <typename TRules>
+	static void
+dealerTable
+	(
+	const double p[TEN_VALUE + 1],		// Card value probabilities
+	double out[TStrategy::MAX_UPCARD + 1][TABLE_DEALER_FINALS]	// Out argument
+	)
+	{
+	// Final distribution from every [hard total][an Ace held] state
+	double dist[MAX_HARD + 1][2][TABLE_DEALER_FINALS];
+	memset((void *)dist, 0, sizeof(dist));
+	for (int hard = MAX_HARD; hard >= 2; hard--)
+		for (int ace = 0; ace <= 1; ace++)
+			{
+			bool soft = ace && (hard + TEN_VALUE <= (int)TRules::BLACKJACK_VAL);
+			int score = soft ? hard + TEN_VALUE : hard;
+			if (score > (int)TRules::BLACKJACK_VAL)
+				{
+				dist[hard][ace][FINAL_BUST] = 1.0;
+				continue;
+				}
+			if ((score >= DEALER_STAND) && !(TRules::HIT_SOFT_17 && soft &&
+					(score == DEALER_STAND)))
+				{
+				dist[hard][ace][score - DEALER_STAND] = 1.0;
+				continue;
+				}
+			for (int v = ACE_VALUE; v <= TEN_VALUE; v++)
+				for (int f = 0; f < TABLE_DEALER_FINALS; f++)
+					dist[hard][ace][f] += p[v] * dist[hard + v][ace || (v == ACE_VALUE)][f];
+			}
+
+	memset((void *)out, 0, dealerSize);
+	for (int up = ACE_VALUE; up <= TEN_VALUE; up++)
+		{
+		// Hole card that would make a two card 21
+		int natural = (up == ACE_VALUE) ? TEN_VALUE : (up == TEN_VALUE) ? ACE_VALUE : 0;
+		double norm = 1.0 - (natural ? p[natural] : 0.0);
+		for (int hole = ACE_VALUE; hole <= TEN_VALUE; hole++)
+			{
+			if (hole == natural)
+				continue;
+			int ace = (up == ACE_VALUE) || (hole == ACE_VALUE);
+			for (int f = 0; f < TABLE_DEALER_FINALS; f++)
+				out[up][f] += p[hole] / norm * dist[up + hole][ace][f];
+			}
+		}
+	}
+
+/*
+ * Optimal hit/stand decisions and their expected values against each dealer
+ * up card, for the argued card probabilities
+ */
+template <typename TRules>
+	static void
+playerTables
+	(
+	const double p[TEN_VALUE + 1],		// Card value probabilities
+	const double dealer[TStrategy::MAX_UPCARD + 1][TABLE_DEALER_FINALS],
+	unsigned char strategy[2][TStrategy::MAX_SCORE + 1][TStrategy::MAX_UPCARD + 1],
+	double ev[2][TStrategy::MAX_SCORE + 1][TStrategy::MAX_UPCARD + 1][TABLE_EV_ACTIONS]
+	)
+	{
+	const int maxScore = (int)TStrategy::MAX_SCORE;
+	memset((void *)strategy, ACTION_HIT, strategySize);
+	memset((void *)ev, 0, evSize);
+	for (int up = ACE_VALUE; up <= TEN_VALUE; up++)
+		{
+		const double *d = dealer[up];
+		// Best expected value from every [hard total][an Ace held] state
+		double best[MAX_HARD + 1][2];
+		for (int hard = MAX_HARD; hard >= 2; hard--)
+			for (int ace = 0; ace <= 1; ace++)
+				{
+				bool soft = ace && (hard + TEN_VALUE <= maxScore);
+				int score = soft ? hard + TEN_VALUE : hard;
+				if (score > maxScore)
+					{
+					best[hard][ace] = -1.0;
+					continue;
+					}
+
+				// Stand: win on a dealer bust or lower final score
+				double stand = d[FINAL_BUST];
+				for (int f = 0; f < FINAL_BUST; f++)
+					{
+					int dealerScore = DEALER_STAND + f;
+					if (dealerScore < score)
+						stand += d[f];
+					else if (dealerScore > score)
+						stand -= d[f];
+					else if (!TRules::PUSH_ON_TIE)
+						stand -= d[f];
+					}
+				double hit = 0.0;
+				for (int v = ACE_VALUE; v <= TEN_VALUE; v++)
+					hit += p[v] * ((hard + v > MAX_HARD) ? -1.0 :
+							best[hard + v][ace || (v == ACE_VALUE)]);
+				best[hard][ace] = (hit > stand) ? hit : stand;
+
+				// Hands holding an Ace that cannot count 11 are hard hands
+				if (ace && !soft)
+					continue;
+				strategy[soft][score][up] = (hit > stand) ? ACTION_HIT : ACTION_STAND;
+				ev[soft][score][up][ACTION_STAND] = stand;
+				ev[soft][score][up][ACTION_HIT] = hit;
+				}
+		}
+	}
+
+/*
+ * Append a payload, TABLE_ALIGN aligned, and its directory entry
+ */
+	static void
+appendSection
+	(
+	std::vector<unsigned char> &payloads,		// Offsets from the payloads start
+	std::vector<TTableSection> &sections,
+	TTableType 						type,				// Section type
+	unsigned int 					rules,			// TRuleFlags
+	unsigned int 					decks,			// Decks in the shoe
+	int 								trueCount,		// Floored Hi-Lo true count
+	const void 						*data,			// Payload
+	uint64_t 						size				// Payload size
+	)
+	{
+	TTableSection section;
+	memset((void *)&section, 0, sizeof(section));
+	section.type = type;
+	section.rules = rules;
+	section.decks = decks;
+	section.trueCount = trueCount;
+	section.offset = payloads.size();
+	section.size = size;
+	sections.push_back(section);
+
+	const unsigned char *bytes = (const unsigned char *)data;
+	payloads.insert(payloads.end(), bytes, bytes + size);
+	payloads.resize((payloads.size() + TABLE_ALIGN - 1) / TABLE_ALIGN * TABLE_ALIGN, 0);
+	}
+
+/*
+ * Tables of every true count for one rule set. Instantiated by dispatchRules().
+ */
+class TTableGenerator
+	{
+	public:
+		TTableGenerator(unsigned int decks, std::vector<unsigned char> &payloads,
+				std::vector<TTableSection> &sections) :
+			mDecks(decks), mPayloads(payloads), mSections(sections) {};
+		template <typename TRules> int run(void);
+
+	private:
+		// Append a payload and its directory entry
+		void append(TTableType type, int trueCount, const void *data, uint64_t size,
+				unsigned int rules);
+
+	private:
+		unsigned int mDecks;
+		std::vector<unsigned char> &mPayloads;		// Offsets from the payloads start
+		std::vector<TTableSection> &mSections;
+	};
+
+	void
+TTableGenerator::append
+	(
+	TTableType 	 type,			// Section type
+	int 			 trueCount,		// Floored Hi-Lo true count
+	const void 	 *data,			// Payload
+	uint64_t 	 size,			// Payload size
+	unsigned int rules			// TRuleFlags
+	)
+	{
+	appendSection(mPayloads, mSections, type, rules, mDecks, trueCount, data, size);
+	}
+
+/*
+ * Build and append the tables of every true count
+ * @return: - 0 - Success
+ */
+template <typename TRules>
+	int
+TTableGenerator::run
+	(
+	void
+	)
+	{
+	double p[TEN_VALUE + 1];
+	double dealer[TStrategy::MAX_UPCARD + 1][TABLE_DEALER_FINALS];
+	unsigned char strategy[2][TStrategy::MAX_SCORE + 1][TStrategy::MAX_UPCARD + 1];
+	double ev[2][TStrategy::MAX_SCORE + 1][TStrategy::MAX_UPCARD + 1][TABLE_EV_ACTIONS];
+	for (int tc = TStrategy::MIN_TRUE_COUNT; tc <= TStrategy::MAX_TRUE_COUNT; tc++)
+		{
+		// Middle of the floored true count range
+		countProbabilities(mDecks, (double)tc + 0.5, p);
+		dealerTable<TRules>(p, dealer);
+		playerTables<TRules>(p, dealer, strategy, ev);
+		append(TABLE_STRATEGY, tc, strategy, strategySize, TRules::FLAGS);
+		append(TABLE_EV, tc, ev, evSize, TRules::FLAGS);
+		append(TABLE_DEALER, tc, dealer, dealerSize, TRules::FLAGS);
+		}
+	return 0;
+	}
+
+/*
+ * Write a table file of the argued sections
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (I/O error)
+ */
+	static int
+writeSections
+	(
+	const std::string 					&path,		// Output file
+	const std::vector<unsigned char> &payloads,	// Offsets from the payloads start
+	std::vector<TTableSection> 		&sections	// Offsets moved to the file start
+	)
+	{
+	int ret = -1;   // Assume error writing the file
+
+	TTableFileHeader header;
+	memset((void *)&header, 0, sizeof(header));
+	memcpy(header.magic, TABLE_FILE_MAGIC, sizeof(header.magic));
+	header.version = TABLE_FILE_VERSION;
+	header.headerSize = sizeof(TTableFileHeader);
+	header.sectionSize = sizeof(TTableSection);
+	header.sectionsNr = sections.size();
+	uint64_t directoryEnd = sizeof(header) + sections.size() * sizeof(TTableSection);
+	uint64_t payloadsStart = (directoryEnd + TABLE_ALIGN - 1) / TABLE_ALIGN * TABLE_ALIGN;
+	header.fileSize = payloadsStart + payloads.size();
+	for (unsigned int i = 0; i < sections.size(); i++)
+		sections[i].offset += payloadsStart;
+
+	// Written aside and renamed so readers never map a partial file
+	std::string tmpPath = path + ".tmp";
+	FILE *file = fopen(tmpPath.c_str(), "wb");
+	if (!file)
+		return ret;
+	std::vector<unsigned char> padding(payloadsStart - directoryEnd, 0);
+	bool ok = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+			(fwrite(sections.data(), sizeof(TTableSection), sections.size(), file) ==
+					sections.size()) &&
+			(padding.empty() || (fwrite(padding.data(), 1, padding.size(), file) ==
+					padding.size())) &&
+			(fwrite(payloads.data(), 1, payloads.size(), file) == payloads.size());
+	ok = (fclose(file) == 0) && ok;
+	if (!ok || rename(tmpPath.c_str(), path.c_str()))
+		{
+		unlink(tmpPath.c_str());
+		return ret;
+		}
+
+	ret = 0;
+	return ret;
+	}
+
+/*
+ * Build the strategy, expected value and dealer outcome tables of every argued
+ * rule set and deck count and write them as a table file
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid arguments or I/O error)
+ */
+	int
+generateTableFile
+	(
+	const std::string 					&path,		// Output file
+	const std::vector<unsigned int> 	&rules,		// TRuleFlags of each rule set
+	const std::vector<unsigned int> 	&decks		// Deck counts
+	)
+	{
+	int ret = -1;   // Assume error writing the file
+	if (rules.empty() || decks.empty())
+		return ret;
+
+	std::vector<unsigned char> payloads;
+	std::vector<TTableSection> sections;
+	for (unsigned int r = 0; r < rules.size(); r++)
+		for (unsigned int d = 0; d < decks.size(); d++)
+			{
+			if ((rules[r] >= RULES_VARIANTS_NR) || !decks[d])
+				return ret;
+			TTableGenerator generator(decks[d], payloads, sections);
+			dispatchRules(rules[r], generator);
+			}
+
+	return writeSections(path, payloads, sections);
+	}
+
+/*
+ * Write per true count strategy tables of one rule set and deck count as a
+ * table file
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid arguments or I/O error)
+ */
+	int
+writeStrategyTableFile
+	(
+	const std::string &path,		// Output file
+	unsigned int 		rules,		// TRuleFlags
+	unsigned int 		decks,		// Decks in the shoe
+	const unsigned char strategy[TStrategy::TRUE_COUNTS_NR][2][TStrategy::MAX_SCORE + 1]
+			[TStrategy::MAX_UPCARD + 1]		// Decisions, MIN_TRUE_COUNT first
+	)
+	{
+	if ((rules >= RULES_VARIANTS_NR) || !decks)
+		return -1;
+
+	std::vector<unsigned char> payloads;
+	std::vector<TTableSection> sections;
+	for (int tc = TStrategy::MIN_TRUE_COUNT; tc <= TStrategy::MAX_TRUE_COUNT; tc++)
+		appendSection(payloads, sections, TABLE_STRATEGY, rules, decks, tc,
+				strategy[tc - TStrategy::MIN_TRUE_COUNT], strategySize);
+	return writeSections(path, payloads, sections);
+	}
@@ -0,0 +1,134 @@
+/******************************************************************************/
+/*!
+ * @file:					  tablefile.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the precomputed table file.
+ *  					A versioned binary file of strategy, expected value and
+ *  					dealer outcome tables per rule set, deck count and true
+ *  					count, written once by blackjack-tablegen and memory
+ *  					mapped read only by its users, so processes on one host
+ *  					share a single page cache copy.
+ *
+ *  File layout (host byte order):
+ *  	TTableFileHeader
+ *  	TTableSection[sectionsNr]		Directory
+ *  	Payloads, TABLE_ALIGN aligned		At each section offset
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __TABLEFILE_HPP__
+#define __TABLEFILE_HPP__
+
+/* Library includes */
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* Local includes */
+#include "strategy.hpp"
+
+/* Defines */
+
+#define TABLE_FILE_MAGIC		"BJTABLES"
+#define TABLE_FILE_VERSION		1
+#define TABLE_ALIGN				64
+// Dealer outcomes per up card: final 17 to 21 and bust
+#define TABLE_DEALER_FINALS	6
+// Player expected values per decision: stand and hit
+#define TABLE_EV_ACTIONS		2
+
+/* Enumerations, type defines */
+
+/* Section types */
+typedef enum __TableType__
+	{
+	TABLE_STRATEGY	= 1,	// unsigned char [2][MAX_SCORE + 1][MAX_UPCARD + 1] TPlayerAction
+	TABLE_DEALER	= 2,	// double [MAX_UPCARD + 1][TABLE_DEALER_FINALS] probabilities
+	TABLE_EV			= 3	// double [2][MAX_SCORE + 1][MAX_UPCARD + 1][TABLE_EV_ACTIONS]
+	}TTableType;
+
+/* File header */
+typedef struct __TableFileHeader__
+	{
+	char magic[8];				// TABLE_FILE_MAGIC, no terminator
+	uint32_t version;			// TABLE_FILE_VERSION
+	uint32_t headerSize;		// sizeof(TTableFileHeader)
+	uint32_t sectionSize;	// sizeof(TTableSection)
+	uint32_t sectionsNr;
+	uint64_t fileSize;
+	}TTableFileHeader;
+
+/* Directory entry */
+typedef struct __TableSection__
+	{
+	uint32_t type;				// TTableType
+	uint32_t rules;			// TRuleFlags
+	uint32_t decks;
+	int32_t trueCount;		// Floored Hi-Lo true count
+	uint64_t offset;			// Payload offset from the start of the file
+	uint64_t size;				// Payload size
+	}TTableSection;
+
+/*
+ * The table file class
+ * Read only memory mapping of a table file. Lookups return pointers into the
+ * mapping, valid until the file is closed.
+ * */
+class TTableFile
+	{
+	public:
+		TTableFile(void);
+		~TTableFile(void);
+		/*
+		 * Map a table file and check its header and directory
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (cannot map, bad magic, version or layout)
+		 */
+		int open(const std::string &path);
+		void close(void);
+		/*
+		 * Section payload lookup
+		 * @return: Payload or NULL if the file has no such section
+		 */
+		const void *find(TTableType type, unsigned int rules, unsigned int decks,
+				int trueCount) const;
+		unsigned int getSectionsNr(void) const {return mHeader ? mHeader->sectionsNr : 0;};
+		const TTableSection &getSection(unsigned int i) const {return mSections[i];};
+
+	private:
+		TTableFile(const TTableFile &);
+		TTableFile &operator=(const TTableFile &);
+
+	private:
+		const unsigned char *mMap;
+		size_t mSize;
+		const TTableFileHeader *mHeader;
+		const TTableSection *mSections;
+	};
+
+/*
+ * Build the strategy, expected value and dealer outcome tables of every argued
+ * rule set and deck count, for true counts TStrategy::MIN_TRUE_COUNT to
+ * TStrategy::MAX_TRUE_COUNT, and write them as a table file
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid arguments or I/O error)
+ */
+int generateTableFile (const std::string &path, const std::vector<unsigned int> &rules,
+		const std::vector<unsigned int> &decks);
+
+/*
+ * Write per true count strategy tables (TStrategy::MIN_TRUE_COUNT first) of
+ * one rule set and deck count as a table file a POLICY_TABLES strategy binds
+ * to. The file holds no expected value or dealer outcome tables.
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid arguments or I/O error)
+ */
+int writeStrategyTableFile (const std::string &path, unsigned int rules, unsigned int decks,
+		const unsigned char strategy[TStrategy::TRUE_COUNTS_NR][2][TStrategy::MAX_SCORE + 1]
+		[TStrategy::MAX_UPCARD + 1]);
+
+#endif /* __TABLEFILE_HPP__ */
@@ -0,0 +1,272 @@
+/******************************************************************************/
+/*!
+ * @file:					  tablegen_main.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: blackjack-tablegen. Writes a precomputed table file and
+ *  					inspects existing ones.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Local includes */
+#include "misc.hpp"
+#include "rules.hpp"
+#include "simulator.hpp"
+#include "tablefile.hpp"
+
+/* Library includes */
+#include <chrono>
+#include <getopt.h>
+#include <iostream>
+#include <math.h>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private defines */
+#define DEFAULT_OUTPUT		"blackjack.tables"
+#define DEFAULT_DECKS		"1,2,6,8"
+#define COMPARE_DECKS		6
+
+//! Option string for getopt. See opttab for long options.
+char optstr[] = ":ho:d:ai:c:S:sp6";
+
+//! Option table for getopt_long.
+struct option opttab[] = {
+   { "help",   		no_argument,         NULL,    'h'   },
+   { "output",   		required_argument,   NULL,    'o'   },
+   { "decks",   		required_argument,   NULL,    'd'   },
+   { "all-rules",		no_argument,         NULL,    'a'   },
+   { "info",   		required_argument,   NULL,    'i'   },
+   { "compare",  		required_argument,   NULL,    'c'   },
+   { "seed",   		required_argument,   NULL,    'S'   },
+   { "s17",   		no_argument,         NULL,    's'   },
+   { "push-ties",		no_argument,         NULL,    'p'   },
+   { "pay-6-5",		no_argument,         NULL,    '6'   },
+   { 0, 0, 0, 0 }
+   };
+
+/******************************************************************************/
+/*! Print usage then exit the app.
+ ******************************************************************************/
+   void
+usage
+   (
+   void
+   )
+   {
+   std::cout << "blackjack-tablegen: Precomputed strategy, expected value and dealer outcome" << std::endl;
+   std::cout << "tables per rule set, deck count and Hi-Lo true count (" <<
+   		TStrategy::MIN_TRUE_COUNT << " to " << TStrategy::MAX_TRUE_COUNT << ")" << std::endl;
+   std::cout << std::endl;
+   std::cout << "Options:" << std::endl;
+   std::cout << "   -o, --output FILE" << std::endl;
+   std::cout << "      Table file to write (default " << DEFAULT_OUTPUT << ")." << std::endl;
+   std::cout << "   -d, --decks LIST" << std::endl;
+   std::cout << "      Comma separated deck counts (default " << DEFAULT_DECKS << ")." << std::endl;
+   std::cout << "   -a, --all-rules" << std::endl;
+   std::cout << "      Tables for every rule variant instead of the selected one." << std::endl;
+   std::cout << "   -s, --s17, -p, --push-ties, -6, --pay-6-5" << std::endl;
+   std::cout << "      Rule variants, as for blackjack." << std::endl;
+   std::cout << "   -i, --info FILE" << std::endl;
+   std::cout << "      Map an existing table file and print its directory." << std::endl;
+   std::cout << "   -c, --compare HANDS" << std::endl;
+   std::cout << "      After writing, simulate HANDS hands from a " << COMPARE_DECKS <<
+   		" deck shoe with the" << std::endl;
+   std::cout << "      tables and with basic strategy on the same shoes and print both" << std::endl;
+   std::cout << "      results and the paired gain." << std::endl;
+   std::cout << "   -S, --seed SEED" << std::endl;
+   std::cout << "      Simulation seed (default 1)." << std::endl;
+   std::cout << std::endl;
+   }
+
+/*
+ * Parse a comma separated list of deck counts
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid count)
+ */
+	int
+parseDecks
+	(
+	const std::string 			&list,		// Deck counts
+	std::vector<unsigned int> 	&decks		// Out argument
+	)
+	{
+	std::stringstream ss(list);
+	std::string tok;
+	decks.clear();
+	while (std::getline(ss, tok, ','))
+		{
+		unsigned int d = strtoul(tok.c_str(), NULL, 10);
+		if (!d)
+			return -1;
+		decks.push_back(d);
+		}
+	return decks.empty() ? -1 : 0;
+	}
+
+/*
+ * Map a table file and print its directory
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (invalid table file)
+ */
+	int
+printInfo
+	(
+	const char *path		// Table file
+	)
+	{
+	TTableFile file;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (file.open(path))
+		{
+		log(LOG_ERR, "Invalid table file\n");
+		return -1;
+		}
+	std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+
+	printf("%s: %u sections, mapped in %.1f us\n", path, file.getSectionsNr(), elapsed.count());
+	printf("  %-9s %-6s %-6s %-11s %-10s %s\n", "Type", "Rules", "Decks", "True count",
+			"Offset", "Size");
+	for (unsigned int i = 0; i < file.getSectionsNr(); i++)
+		{
+		const TTableSection &s = file.getSection(i);
+		const char *type = (s.type == TABLE_STRATEGY) ? "strategy" :
+				(s.type == TABLE_EV) ? "ev" : (s.type == TABLE_DEALER) ? "dealer" : "unknown";
+		printf("  %-9s 0x%-4x %-6u %-11d %-10llu %llu\n", type, s.rules, s.decks, s.trueCount,
+				(unsigned long long)s.offset, (unsigned long long)s.size);
+		}
+	return 0;
+	}
+
+/*
+ * Simulate the table file policy and basic strategy hand by hand on the same
+ * shoes
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (simulation failed)
+ */
+	int
+compareTables
+	(
+	const char 			*path,		// Table file
+	unsigned int 		rules,		// TRuleFlags
+	unsigned long long hands,		// Hands per policy
+	unsigned long long seed			// Simulation seed
+	)
+	{
+	TSimConfig config;
+	TSimResults results;
+	simInitConfig(&config);
+	config.rules = rules;
+	config.decks = COMPARE_DECKS;
+	config.policy = SIM_POLICY_TABLES;
+	config.pairedPolicy = SIM_POLICY_BASIC;
+	config.seed = seed;
+	config.hands = hands;
+	config.tablesPath = path;
+	if (simulate(&config, &results) || !results.handsPlayed)
+		{
+		log(LOG_ERR, "Simulation failed (does the file hold these rules and decks?)\n");
+		return -1;
+		}
+	double n = (double)results.handsPlayed;
+	printf("Paired simulation of %llu hands (%u decks, rules 0x%x, seed %llu)\n", hands,
+			COMPARE_DECKS, rules, seed);
+	printf("  %-7s EV %+.6f bets per hand\n", policyName(POLICY_TABLES),
+			results.netUnits / n);
+	printf("  %-7s EV %+.6f bets per hand\n", policyName(POLICY_BASIC),
+			results.pairedNetUnits / n);
+	printf("  Gain    %+.6f +/- %.6f bets per hand (%.0f paired hands/s)\n",
+			results.diffMean, results.diffStdErr, n / results.elapsedSecs);
+	return 0;
+	}
+
+/* Top level and binary entry point for the table generator
+ * @return: 0 - Success. Otherwise,
+ * 			Error
+ * */
+int main
+	(
+   int   argc,          // Argument count
+   char  **argv         // Argument strings
+   )
+	{
+	std::string output(DEFAULT_OUTPUT);
+	std::vector<unsigned int> decks;
+	parseDecks(DEFAULT_DECKS, decks);
+	unsigned int rules = RULES_HOUSE;
+	bool allRules = false;
+	const char *infoPath = NULL;
+	unsigned long long compareHands = 0;
+	unsigned long long seed = 1;
+	signed char    oc;
+
+	while ((oc = getopt_long(argc, argv, optstr, opttab, NULL)) != -1)
+		{
+		switch (oc)
+			{
+			case 'h':
+				usage();
+				return 0;
+			case 'o':
+				output = optarg;
+				break;
+			case 'd':
+				if (parseDecks(optarg, decks))
+					{
+					log(LOG_ERR, "Invalid deck list\n");
+					return -1;
+					}
+				break;
+			case 'a':
+				allRules = true;
+				break;
+			case 'i':
+				infoPath = optarg;
+				break;
+			case 'c':
+				compareHands = strtoull(optarg, NULL, 10);
+				break;
+			case 'S':
+				seed = strtoull(optarg, NULL, 10);
+				break;
+			case 's':
+				rules |= RULES_STAND_SOFT_17;
+				break;
+			case 'p':
+				rules |= RULES_PUSH_TIES;
+				break;
+			case '6':
+				rules |= RULES_PAY_6_5;
+				break;
+			case '?':
+			default:       // invalid option
+				usage();
+				return -1;
+			}
+		}
+
+	if (infoPath)
+		return printInfo(infoPath);
+
+	std::vector<unsigned int> ruleSets;
+	for (unsigned int r = 0; r < RULES_VARIANTS_NR; r++)
+		if (allRules || (r == rules))
+			ruleSets.push_back(r);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (generateTableFile(output, ruleSets, decks))
+		{
+		log(LOG_ERR, "Could not write the table file\n");
+		return -1;
+		}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	printf("%s: %u rule set(s), %u deck count(s), written in %.3f s\n", output.c_str(),
+			(unsigned int)ruleSets.size(), (unsigned int)decks.size(), elapsed.count());
+
+	if (compareHands)
+		return compareTables(output.c_str(), rules, compareHands, seed);
+	return 0;
+	}
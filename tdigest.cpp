@@ -0,0 +1,177 @@
+/******************************************************************************/
+/*!
+ * @file:					  tdigest.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the merging t-digest (Dunning and Ertl).
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <algorithm>
+#include <limits>
+
+/* Local includes */
+#include "tdigest.hpp"
+
+/* Private defines */
+// Buffered samples, in multiples of the compression, before merging
+#define BUFFER_FACTOR		5
+
+TTDigest::TTDigest
+	(
+	double compression		// Centroids kept, about
+	) :
+	mCompression(compression),
+	mTotal(0.0),
+	mBufferTotal(0.0),
+	mMin(std::numeric_limits<double>::max()),
+	mMax(-std::numeric_limits<double>::max())
+	{
+	mBuffer.reserve(BUFFER_FACTOR * (unsigned int)compression);
+	}
+
+/*
+ * Add a sample of the argued weight
+ */
+	void
+TTDigest::add
+	(
+	double x,				// Sample
+	double weight			// Sample weight
+	)
+	{
+	TCentroid c = {x, weight};
+	mBuffer.push_back(c);
+	mBufferTotal += weight;
+	if (x < mMin)
+		mMin = x;
+	if (x > mMax)
+		mMax = x;
+	if (mBuffer.size() >= (BUFFER_FACTOR * (unsigned int)mCompression))
+		compress();
+	}
+
+/*
+ * Add every sample of another digest
+ */
+	void
+TTDigest::merge
+	(
+	const TTDigest &digest
+	)
+	{
+	mBuffer.insert(mBuffer.end(), digest.mCentroids.begin(), digest.mCentroids.end());
+	mBuffer.insert(mBuffer.end(), digest.mBuffer.begin(), digest.mBuffer.end());
+	mBufferTotal += digest.mTotal + digest.mBufferTotal;
+	if (digest.mMin < mMin)
+		mMin = digest.mMin;
+	if (digest.mMax > mMax)
+		mMax = digest.mMax;
+	compress();
+	}
+
+/*
+ * Remove all samples
+ */
+	void
+TTDigest::clear
+	(
+	void
+	)
+	{
+	mCentroids.clear();
+	mBuffer.clear();
+	mTotal = 0.0;
+	mBufferTotal = 0.0;
+	mMin = std::numeric_limits<double>::max();
+	mMax = -std::numeric_limits<double>::max();
+	}
+
+/*
+ * Merge the buffered samples into the centroids. Two neighbours are merged
+ * while the result stays within the size bound 4 * n * q * (1 - q) / compression
+ * at both of its ends.
+ */
+	void
+TTDigest::compress
+	(
+	void
+	)
+	{
+	if (mBuffer.empty())
+		return;
+
+	mBuffer.insert(mBuffer.end(), mCentroids.begin(), mCentroids.end());
+	std::sort(mBuffer.begin(), mBuffer.end());
+	mTotal += mBufferTotal;
+	mBufferTotal = 0.0;
+	mCentroids.clear();
+
+	double soFar = 0.0;		// Weight of the centroids already emitted
+	TCentroid cur = mBuffer[0];
+	for (unsigned int i = 1; i < mBuffer.size(); i++)
+		{
+		const TCentroid &next = mBuffer[i];
+		double q0 = soFar / mTotal;
+		double q2 = (soFar + cur.weight + next.weight) / mTotal;
+		double bound = 4.0 * mTotal * std::min(q0 * (1.0 - q0), q2 * (1.0 - q2)) /
+				mCompression;
+		if ((cur.weight + next.weight) <= bound)
+			{
+			double weight = cur.weight + next.weight;
+			cur.mean += (next.mean - cur.mean) * next.weight / weight;
+			cur.weight = weight;
+			}
+		else
+			{
+			mCentroids.push_back(cur);
+			soFar += cur.weight;
+			cur = next;
+			}
+		}
+	mCentroids.push_back(cur);
+	mBuffer.clear();
+	}
+
+/*
+ * Estimated quantile, interpolating between centroid centers
+ * @return: Value below which a fraction 'q' (0 to 1) of the samples fall.
+ * 			0 if the digest is empty.
+ */
+	double
+TTDigest::quantile
+	(
+	double q
+	)
+	{
+	compress();
+	if (mCentroids.empty())
+		return 0.0;
+	if (q <= 0.0)
+		return mMin;
+	if (q >= 1.0)
+		return mMax;
+
+	double index = q * mTotal;
+	double cum = 0.0;
+	double prevMid = 0.0;
+	double prevMean = mMin;
+	for (unsigned int i = 0; i < mCentroids.size(); i++)
+		{
+		double mid = cum + mCentroids[i].weight / 2.0;
+		if (index <= mid)
+			{
+			double t = (mid > prevMid) ? (index - prevMid) / (mid - prevMid) : 0.0;
+			return prevMean + t * (mCentroids[i].mean - prevMean);
+			}
+		prevMid = mid;
+		prevMean = mCentroids[i].mean;
+		cum += mCentroids[i].weight;
+		}
+
+	double t = (mTotal > prevMid) ? (index - prevMid) / (mTotal - prevMid) : 0.0;
+	return prevMean + t * (mMax - prevMean);
+	}
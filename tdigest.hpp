@@ -0,0 +1,69 @@
+/******************************************************************************/
+/*!
+ * @file:					  tdigest.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines a merging t-digest. A bounded
+ *  					memory, mergeable quantile sketch.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __TDIGEST_HPP__
+#define __TDIGEST_HPP__
+
+/* Library includes */
+#include <vector>
+
+/*
+ * The t-digest class
+ * Keeps at most about 'compression' centroids, small ones at the tails, so
+ * extreme quantiles stay accurate. Digests built on different threads can be
+ * merged.
+ * */
+class TTDigest
+	{
+	public:
+		TTDigest(double compression = 100.0);
+		~TTDigest(void){};
+		// Add a sample of the argued weight
+		void add(double x, double weight = 1.0);
+		// Add every sample of another digest
+		void merge(const TTDigest &digest);
+		/*
+		 * Estimated quantile
+		 * @return: Value below which a fraction 'q' (0 to 1) of the samples fall.
+		 * 			0 if the digest is empty.
+		 */
+		double quantile(double q);
+		// Samples added (total weight)
+		double getCount(void) const {return mTotal + mBufferTotal;};
+		// Remove all samples
+		void clear(void);
+		// Centroids kept after compression, a bound on the memory in use
+		unsigned int getCentroidsNr(void) {compress(); return mCentroids.size();};
+
+	private:
+		// Merge the buffered samples into the centroids
+		void compress(void);
+
+	private:
+		/* Centroid, mean and weight of the samples merged in it */
+		typedef struct __Centroid__
+			{
+			double mean;
+			double weight;
+			bool operator<(const __Centroid__ &c) const {return mean < c.mean;};
+			}TCentroid;
+
+		double mCompression;
+		std::vector<TCentroid> mCentroids;
+		std::vector<TCentroid> mBuffer;	// Samples not merged yet
+		double mTotal;							// Weight in mCentroids
+		double mBufferTotal;					// Weight in mBuffer
+		double mMin;
+		double mMax;
+	};
+
+#endif /* __TDIGEST_HPP__ */
@@ -0,0 +1,187 @@
+/******************************************************************************/
+/*!
+ * @file:					  topology.cpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: Implements the CPU topology and worker placement.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+/* Library includes */
+#include <algorithm>
+#include <dirent.h>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Local includes */
+#include "misc.hpp"
+#include "topology.hpp"
+
+/*
+ * Parse a kernel CPU list: comma separated CPUs and ranges
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (malformed list)
+ */
+	int
+parseCpuList
+	(
+	const std::string &list,		// CPU list, trailing new line allowed
+	std::vector<int> 	&cpus			// Out argument, appended
+	)
+	{
+	int ret = -1;   // Assume error parsing
+	const char *pos = list.c_str();
+	while (*pos && (*pos != '\n'))
+		{
+		char *end;
+		long first = strtol(pos, &end, 10);
+		if ((end == pos) || (first < 0))
+			return ret;
+		long last = first;
+		pos = end;
+		if (*pos == '-')
+			{
+			last = strtol(pos + 1, &end, 10);
+			if ((end == pos + 1) || (last < first))
+				return ret;
+			pos = end;
+			}
+		for (long cpu = first; cpu <= last; cpu++)
+			cpus.push_back((int)cpu);
+		if (*pos == ',')
+			pos++;
+		else if (*pos && (*pos != '\n'))
+			return ret;
+		}
+	ret = 0;
+	return ret;
+	}
+
+TTopology::TTopology
+	(
+	void
+	)
+	{
+	}
+
+/*
+ * Read the nodes and their allowed CPUs
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (the allowed CPUs could not be read)
+ */
+	int
+TTopology::load
+	(
+	const char *sysfsPath		// Node directory
+	)
+	{
+	int ret = -1;   // Assume error reading the topology
+	mNodeIds.clear();
+	mCpus.clear();
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if (sched_getaffinity(0, sizeof(allowed), &allowed))
+		{
+		log(LOG_ERR, "Could not read the CPUs the process may run on\n");
+		return ret;
+		}
+
+	// nodeN directories, in node order
+	std::vector<unsigned int> ids;
+	DIR *dir = opendir(sysfsPath);
+	if (dir)
+		{
+		struct dirent *entry;
+		while ((entry = readdir(dir)) != NULL)
+			{
+			char *end;
+			if (strncmp(entry->d_name, "node", 4))
+				continue;
+			unsigned long id = strtoul(entry->d_name + 4, &end, 10);
+			if ((end != entry->d_name + 4) && !*end)
+				ids.push_back(id);
+			}
+		closedir(dir);
+		}
+	std::sort(ids.begin(), ids.end());
+
+	for (unsigned int i = 0; i < ids.size(); i++)
+		{
+		std::ifstream in((std::string(sysfsPath) + "/node" + std::to_string(ids[i]) +
+				"/cpulist").c_str());
+		std::string list;
+		std::vector<int> cpus, usable;
+		if (!std::getline(in, list) || parseCpuList(list, cpus))
+			continue;
+		for (unsigned int c = 0; c < cpus.size(); c++)
+			if ((cpus[c] < CPU_SETSIZE) && CPU_ISSET(cpus[c], &allowed))
+				usable.push_back(cpus[c]);
+		// Memory only nodes, or nodes the process is kept off
+		if (usable.empty())
+			continue;
+		mNodeIds.push_back(ids[i]);
+		mCpus.push_back(usable);
+		}
+
+	// No NUMA information: one node of every allowed CPU
+	if (mCpus.empty())
+		{
+		std::vector<int> usable;
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+			if (CPU_ISSET(cpu, &allowed))
+				usable.push_back(cpu);
+		mNodeIds.push_back(0);
+		mCpus.push_back(usable);
+		}
+	ret = 0;
+	return ret;
+	}
+
+/*
+ * Place the workers round robin over the nodes, then over the CPUs of each
+ */
+	void
+TTopology::place
+	(
+	unsigned int 					workersNr,		// Workers to place
+	std::vector<TCpuPlacement> &placements		// Out argument
+	) const
+	{
+	placements.resize(workersNr);
+	for (unsigned int w = 0; w < workersNr; w++)
+		{
+		unsigned int node = w % mCpus.size();
+		unsigned int turn = w / mCpus.size();
+		placements[w].node = node;
+		placements[w].cpu = mCpus[node][turn % mCpus[node].size()];
+		}
+	}
+
+/*
+ * Pin the calling thread
+ * @return: - 0 - Success. Otherwise,
+ * 			Error
+ */
+	int
+TTopology::pin
+	(
+	int cpu		// CPU to run on
+	)
+	{
+	int ret = -1;   // Assume error pinning
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+		{
+		log(LOG_ERR, "Could not pin a worker to CPU " + std::to_string(cpu) + "\n");
+		return ret;
+		}
+	ret = 0;
+	return ret;
+	}
@@ -0,0 +1,89 @@
+/******************************************************************************/
+/*!
+ * @file:					  topology.hpp
+ * @author  Original:     David Olave
+ * @date    Created:      October 19th, 2026
+ *
+ *  @Description: The header file that defines the CPU topology simulation
+ *  					workers are placed on: the NUMA nodes of the host and the
+ *  					CPUs of each the process may run on.
+ *
+ *  Nodes are read from sysfs. Hosts without it (or without NUMA) are one node
+ *  of every allowed CPU. Workers are spread round robin over the nodes, so
+ *  every node plays its share, and pinned to a CPU of theirs. A pinned worker
+ *  allocates its shoe, engine and stats itself: the kernel places pages on
+ *  the node of the CPU that first touches them.
+ *
+ *  Copyright David Olave 2026
+ ******************************************************************************/
+
+#ifndef __TOPOLOGY_HPP__
+#define __TOPOLOGY_HPP__
+
+/* Library includes */
+#include <string>
+#include <vector>
+
+/* Defines */
+
+// Where the kernel lists the NUMA nodes, a nodeN directory each
+#define TOPOLOGY_SYSFS_NODES		"/sys/devices/system/node"
+
+/* Enumerations, type defines */
+
+/* CPU a worker is placed on */
+typedef struct __CpuPlacement__
+	{
+	int cpu;						// CPU the worker is pinned to
+	unsigned int node;		// Node index (see TTopology::nodesNr()), not the sysfs number
+	}TCpuPlacement;
+
+/*
+ * NUMA nodes and their CPUs
+ */
+class TTopology
+	{
+	public:
+		TTopology(void);
+
+		/*
+		 * Read the nodes of 'sysfsPath' and keep the CPUs the process may run on.
+		 * Without nodes, one node of every allowed CPU
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error (the allowed CPUs could not be read)
+		 */
+		int load(const char *sysfsPath = TOPOLOGY_SYSFS_NODES);
+
+		// Nodes with at least one allowed CPU
+		unsigned int nodesNr(void) const {return mCpus.size();};
+		// Sysfs number of node index 'node'
+		unsigned int nodeId(unsigned int node) const {return mNodeIds[node];};
+		// Allowed CPUs of node index 'node', ascending
+		const std::vector<int> &cpus(unsigned int node) const {return mCpus[node];};
+
+		/*
+		 * Place 'workersNr' workers: worker w on node w % nodesNr(), on the CPUs
+		 * of the node in turn. More workers than CPUs share them
+		 */
+		void place(unsigned int workersNr, std::vector<TCpuPlacement> &placements) const;
+
+		/*
+		 * Pin the calling thread to 'cpu'
+		 * @return: - 0 - Success. Otherwise,
+		 * 			Error
+		 */
+		static int pin(int cpu);
+
+	private:
+		std::vector<unsigned int> mNodeIds;
+		std::vector<std::vector<int> > mCpus;
+	};
+
+/*
+ * Parse a kernel CPU list ("0-3,8,10-11")
+ * @return: - 0 - Success. Otherwise,
+ * 			Error (malformed list)
+ */
+int parseCpuList(const std::string &list, std::vector<int> &cpus);
+
+#endif /* __TOPOLOGY_HPP__ */